@@ -6,6 +6,7 @@
 #include "ruuvi_interface_spi_lis2dh12.h"
 #include "ruuvi_interface_yield.h"
 #include "ruuvi_interface_log.h"
+#include "ruuvi_interface_profile.h"
 #include "lis2dh12_reg.h"
 
 #include <stdlib.h>
@@ -17,12 +18,20 @@
 #define RUUVI_NRF5_SDK15_LIS2GH12_LOG_LEVEL RI_LOG_LEVEL_DEBUG
 #endif
 
+#ifndef RUUVI_NRF5_SDK15_LIS2GH12_LOG_COMPILE_LEVEL
+#define RUUVI_NRF5_SDK15_LIS2GH12_LOG_COMPILE_LEVEL RI_LOG_COMPILE_LEVEL
+#endif
+
 #define LOGD(fmt, ...) \
   do { \
-    char buff[1024] = {0}; \
-    snprintf(buff, sizeof(buff), ":%d:%s(): " fmt, \
-            __LINE__, __func__, ##__VA_ARGS__); \
-            ri_log(RUUVI_NRF5_SDK15_LIS2GH12_LOG_LEVEL, buff); \
+    if (RI_LOG_IS_COMPILED (RUUVI_NRF5_SDK15_LIS2GH12_LOG_COMPILE_LEVEL, \
+                            RUUVI_NRF5_SDK15_LIS2GH12_LOG_LEVEL)) \
+    { \
+        char buff[1024] = {0}; \
+        snprintf(buff, sizeof(buff), ":%d:%s(): " fmt, \
+                __LINE__, __func__, ##__VA_ARGS__); \
+        ri_log_module(RI_LOG_MODULE_SENSOR, RUUVI_NRF5_SDK15_LIS2GH12_LOG_LEVEL, buff); \
+    } \
   } while (0)
 #else
 #define LOGD(fmt, ...)
@@ -73,6 +82,9 @@ typedef union
     uint8_t u8bit[2]; //!< Buffer
 } axis1bit16_t;
 
+RI_PROFILE_ZONE_DEF (m_zone_data_get, "lis2dh12 data_get");
+RI_PROFILE_ZONE_DEF (m_zone_fifo_read, "lis2dh12 fifo_read");
+
 /**
  * @brief lis2dh12 sensor settings structure.
  */
@@ -959,6 +971,7 @@ rd_status_t ri_lis2dh12_data_get (rd_sensor_data_t * const
 {
     if (NULL == data) { return RD_ERROR_NULL; }
 
+    RI_PROFILE_ENTER (m_zone_data_get);
     rd_status_t err_code = RD_SUCCESS;
     int32_t lis_ret_code;
     axis3bit16_t raw_acceleration = {0};
@@ -1006,6 +1019,7 @@ rd_status_t ri_lis2dh12_data_get (rd_sensor_data_t * const
                                  data->fields);
     }
 
+    RI_PROFILE_EXIT (m_zone_data_get);
     return err_code;
 }
 
@@ -1032,6 +1046,7 @@ rd_status_t ri_lis2dh12_fifo_read (size_t * num_elements,
 {
     if (NULL == num_elements || NULL == p_data) { return RD_ERROR_NULL; }
 
+    RI_PROFILE_ENTER (m_zone_fifo_read);
     uint8_t elements = 0;
     rd_status_t err_code = RD_SUCCESS;
     int32_t lis_ret_code;
@@ -1041,6 +1056,7 @@ rd_status_t ri_lis2dh12_fifo_read (size_t * num_elements,
     if (!elements)
     {
         *num_elements = 0;
+        RI_PROFILE_EXIT (m_zone_fifo_read);
         return RD_SUCCESS;
     }
 
@@ -1080,6 +1096,7 @@ rd_status_t ri_lis2dh12_fifo_read (size_t * num_elements,
     }
 
     *num_elements = elements;
+    RI_PROFILE_EXIT (m_zone_fifo_read);
     return err_code;
 }
 
@@ -3,6 +3,7 @@
 #include "ruuvi_driver_error.h"
 #include "ruuvi_driver_sensor.h"
 #include "ruuvi_interface_gpio.h"
+#include <stddef.h>
 /**
  * @addtogroup ADC
  *
@@ -21,6 +22,9 @@
 /** @brief Enable implementation selected by application */
 #if RI_ADC_ENABLED
 #  define RUUVI_NRF5_SDK15_ADC_ENABLED RUUVI_NRF5_SDK15_ENABLED
+#  if RI_ADC_STREAM_ENABLED
+#    define RUUVI_NRF5_SDK15_ADC_STREAM_ENABLED RUUVI_NRF5_SDK15_ENABLED
+#  endif
 #endif
 
 /* Analog input channels of device */
@@ -156,6 +160,30 @@ typedef struct
     float divider;
 } ri_adc_get_data_t;
 
+/**
+ * @brief Called when a block of continuous samples is full.
+ *
+ * Called in interrupt context. Samples are interleaved by channel in ascending
+ * channel number order, i.e. each scan of all configured channels is stored
+ * consecutively. Block is handed back to ADC when callback returns,
+ * so process or copy the samples before returning.
+ *
+ * @param[in] p_samples Raw samples, convert with @ref ri_adc_raw_to_absolute
+ *                      or @ref ri_adc_raw_to_ratio.
+ * @param[in] num_samples Number of samples in block.
+ */
+typedef void (*ri_adc_stream_cb_t) (const int16_t * const p_samples,
+                                    const size_t num_samples);
+
+/* ADC continuous sampling config struct. */
+typedef struct
+{
+    uint32_t samplerate_hz;      //!< Scans per second, each scan samples all configured channels.
+    int16_t * p_buffer;          //!< Buffer of 2 * block_samples, halves are filled alternately.
+    size_t block_samples;        //!< Samples per block, multiple of configured channels.
+    ri_adc_stream_cb_t callback; //!< Called on each full block.
+} ri_adc_stream_config_t;
+
 /**
  * @brief Check if ADC is initialized.
  *
@@ -218,6 +246,22 @@ rd_status_t ri_adc_stop (uint8_t channel_num);
 rd_status_t ri_adc_get_raw_data (uint8_t channel_num,
                                  int16_t * p_data);
 
+/**
+ * @brief Get raw ADC data of all configured channels in one scan.
+ *
+ * Blocks until the scan is complete, one channel takes 12 us with default
+ * acquisition time. Scan is completed by ADC interrupt, call only from a context
+ * of lower priority than ADC interrupt with interrupts enabled.
+ *
+ * @param[out] p_data Raw ADC data, in ascending channel number order.
+ * @param[in] num_samples Size of p_data, must equal the number of configured channels.
+ * @retval RD_SUCCESS on success.
+ * @retval RD_ERROR_NULL if p_data is NULL.
+ * @retval RD_ERROR_INVALID_STATE if ADC is not initialized or continuous sampling is running.
+ * @retval RD_ERROR_INVALID_PARAM if num_samples does not match configured channels.
+ */
+rd_status_t ri_adc_scan_raw (int16_t * const p_data, const size_t num_samples);
+
 /**
  * @brief Get ADC data in volts.
  *
@@ -246,6 +290,79 @@ rd_status_t ri_adc_get_data_ratio (uint8_t channel_num,
                                    ri_adc_get_data_t * p_config,
                                    float * p_data);
 
+/**
+ * @brief Convert raw ADC sample to volts.
+ *
+ * @param[in] channel_num ADC channel which produced the sample.
+ * @param[in] p_config ADC output config.
+ * @param[in] raw Raw sample, e.g. from continuous sampling.
+ * @param[out] p_data ADC data in volts.
+ * @retval RD_SUCCESS on success.
+ * @retval RD_ERROR_INVALID_PARAM if channel is not configured or config is invalid.
+ * @retval RD_ERROR_NULL if either pointer is NULL.
+ */
+rd_status_t ri_adc_raw_to_absolute (uint8_t channel_num,
+                                    ri_adc_get_data_t * p_config,
+                                    const int16_t raw,
+                                    float * p_data);
+
+/**
+ * @brief Convert raw ADC sample to ratio to VDD.
+ *
+ * @param[in] channel_num ADC channel which produced the sample.
+ * @param[in] p_config ADC output config.
+ * @param[in] raw Raw sample, e.g. from continuous sampling.
+ * @param[out] p_data ADC data as a ratio to VDD.
+ * @retval RD_SUCCESS on success.
+ * @retval RD_ERROR_INVALID_PARAM if channel is not configured or config is invalid.
+ * @retval RD_ERROR_NULL if either pointer is NULL.
+ */
+rd_status_t ri_adc_raw_to_ratio (uint8_t channel_num,
+                                 ri_adc_get_data_t * p_config,
+                                 const int16_t raw,
+                                 float * p_data);
+
+/**
+ * @brief Start continuous sampling of all configured channels.
+ *
+ * Hardware timer triggers a scan of all configured channels at given rate
+ * and results are written by DMA into alternating halves of the buffer.
+ * Callback is called with each full half while the other half is being filled.
+ * Single-shot sampling and channel configuration are unavailable until
+ * @ref ri_adc_stream_stop. Oversampling is supported with one channel only.
+ *
+ * On nRF52 requires RI_ADC_STREAM_ENABLED, which reserves TIMER2 and one PPI channel.
+ * Conversion of one channel takes 12 us with default acquisition time, which
+ * limits the rate to 1 / (12 us * channels).
+ *
+ * @param[in] p_config Rate, buffer and callback. Buffer must remain valid until stopped.
+ * @retval RD_SUCCESS on success.
+ * @retval RD_ERROR_NULL if p_config, buffer or callback is NULL.
+ * @retval RD_ERROR_INVALID_STATE if ADC is not initialized, no channels are configured
+ *                                or sampling is already running.
+ * @retval RD_ERROR_INVALID_PARAM if rate is 0 or too high for channel count, or block
+ *                                is not a multiple of channel count.
+ * @retval RD_ERROR_NOT_SUPPORTED if platform has no continuous sampling.
+ */
+rd_status_t ri_adc_stream_start (const ri_adc_stream_config_t * const p_config);
+
+/**
+ * @brief Stop continuous sampling.
+ *
+ * Partially filled block is discarded. Callback is not called after return.
+ *
+ * @retval RD_SUCCESS on success or if sampling was not running.
+ */
+rd_status_t ri_adc_stream_stop (void);
+
+/**
+ * @brief Check if continuous sampling is running.
+ *
+ * @retval true if continuous sampling is running.
+ * @retval false if ADC is idle or in single-shot use.
+ */
+bool ri_adc_stream_is_running (void);
+
 /**
  * @brief Return true if given channel  index can be used by underlying implementation.
  *
@@ -0,0 +1,113 @@
+/**
+ * @addtogroup ADC
+ */
+/*@{*/
+/**
+ * @file ruuvi_interface_adc_stream.c
+ * @author Otso Jousimaa <otso@ojousima.net>
+ * @date 2026-10-19
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ *
+ * Stream is opened and closed in thread context while hardware is stopped,
+ * blocks are finished only by ADC interrupt while hardware runs.
+ */
+#include "ruuvi_interface_adc_stream.h"
+#if RI_ADC_STREAM_ENABLED
+#include <string.h>
+
+#define US_PER_S (1000000U) //!< Microseconds per second.
+
+static ri_adc_stream_config_t m_config;
+static volatile bool m_running;
+static uint8_t m_next_half;            //!< Half of buffer which DMA finishes next.
+static ri_adc_stream_stats_t m_stats;
+
+rd_status_t ri_adc_stream_open (const ri_adc_stream_config_t * const p_config,
+                                const size_t channels,
+                                const ri_adc_stream_limits_t * const p_limits)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if ( (NULL == p_config) || (NULL == p_config->p_buffer)
+            || (NULL == p_config->callback) || (NULL == p_limits))
+    {
+        err_code |= RD_ERROR_NULL;
+    }
+    else if (m_running || (0U == channels))
+    {
+        err_code |= RD_ERROR_INVALID_STATE;
+    }
+    else if ( (0U == p_config->samplerate_hz)
+              || ( (0U != p_limits->max_scan_us)
+                   && (p_config->samplerate_hz > (US_PER_S / (p_limits->max_scan_us * channels))))
+              || (0U == p_config->block_samples)
+              || (p_limits->max_block < p_config->block_samples)
+              || (0U != (p_config->block_samples % channels)))
+    {
+        err_code |= RD_ERROR_INVALID_PARAM;
+    }
+    else
+    {
+        m_config = *p_config;
+        m_next_half = 0;
+        memset (&m_stats, 0, sizeof (m_stats));
+        m_running = true;
+    }
+
+    return err_code;
+}
+
+void ri_adc_stream_close (void)
+{
+    m_running = false;
+}
+
+bool ri_adc_stream_block_done (const int16_t * const p_block, const size_t num_samples)
+{
+    bool requeue = false;
+
+    if (m_running)
+    {
+        const int16_t * const p_expected = m_config.p_buffer
+                                           + (m_next_half * m_config.block_samples);
+
+        if ( (p_expected == p_block) && (m_config.block_samples == num_samples))
+        {
+            m_config.callback (p_block, num_samples);
+            m_next_half ^= 1U;
+            m_stats.blocks++;
+            // Callback may stop the stream.
+            requeue = m_running;
+        }
+        else
+        {
+            m_stats.out_of_order++;
+        }
+    }
+
+    return requeue;
+}
+
+bool ri_adc_stream_is_running (void)
+{
+    return m_running;
+}
+
+rd_status_t ri_adc_stream_stats_get (ri_adc_stream_stats_t * const p_stats)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if (NULL == p_stats)
+    {
+        err_code |= RD_ERROR_NULL;
+    }
+    else
+    {
+        *p_stats = m_stats;
+    }
+
+    return err_code;
+}
+
+/*@}*/
+#endif
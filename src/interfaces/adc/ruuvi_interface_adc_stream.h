@@ -0,0 +1,88 @@
+#ifndef RUUVI_INTERFACE_ADC_STREAM_H
+#define RUUVI_INTERFACE_ADC_STREAM_H
+/**
+ * @addtogroup ADC
+ */
+/*@{*/
+/**
+ * @file ruuvi_interface_adc_stream.h
+ * @author Otso Jousimaa <otso@ojousima.net>
+ * @date 2026-10-19
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ *
+ * @brief Platform independent bookkeeping of continuous ADC sampling.
+ *
+ * Platform implementation of @ref ri_adc_stream_start validates and records the
+ * stream with @ref ri_adc_stream_open before it starts the hardware, and passes
+ * each block finished by DMA to @ref ri_adc_stream_block_done. Blocks alternate
+ * between the two halves of application buffer, a block which is not the
+ * expected half is not handed to application and not queued again.
+ */
+#include "ruuvi_driver_enabled_modules.h"
+#include "ruuvi_driver_error.h"
+#include "ruuvi_interface_adc_mcu.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/** @brief Limits of platform ADC. */
+typedef struct
+{
+    uint32_t max_scan_us;   //!< Time to sample one channel, limits rate of a scan.
+    size_t max_block;       //!< Largest block DMA can fill.
+} ri_adc_stream_limits_t;
+
+/** @brief Statistics of continuous sampling since @ref ri_adc_stream_open. */
+typedef struct
+{
+    uint32_t blocks;        //!< Blocks handed to application.
+    uint32_t out_of_order;  //!< Blocks which were not the expected half of buffer.
+} ri_adc_stream_stats_t;
+
+/**
+ * @brief Validate and record a stream before starting hardware.
+ *
+ * @param[in] p_config Stream configuration, see @ref ri_adc_stream_start.
+ * @param[in] channels Number of configured channels.
+ * @param[in] p_limits Limits of platform ADC.
+ * @retval RD_SUCCESS if stream may be started, stream is running.
+ * @retval RD_ERROR_NULL if a pointer, buffer or callback is NULL.
+ * @retval RD_ERROR_INVALID_STATE if no channels are configured or stream is running.
+ * @retval RD_ERROR_INVALID_PARAM if rate is 0 or too high for channel count, or block
+ *                                is 0, too large or not a multiple of channel count.
+ */
+rd_status_t ri_adc_stream_open (const ri_adc_stream_config_t * const p_config,
+                                const size_t channels,
+                                const ri_adc_stream_limits_t * const p_limits);
+
+/**
+ * @brief Stop handing blocks to application.
+ *
+ * Called after hardware has been stopped, or if starting it failed.
+ */
+void ri_adc_stream_close (void);
+
+/**
+ * @brief Hand a finished block to application.
+ *
+ * Called from ADC interrupt.
+ *
+ * @param[in] p_block Block filled by DMA.
+ * @param[in] num_samples Number of samples in block.
+ * @retval true if block was handed to application and should be queued again.
+ * @retval false if stream is not running, was stopped by callback or block is not
+ *               the expected half.
+ */
+bool ri_adc_stream_block_done (const int16_t * const p_block, const size_t num_samples);
+
+/**
+ * @brief Get statistics of stream.
+ *
+ * @param[out] p_stats Statistics since latest @ref ri_adc_stream_open.
+ * @retval RD_SUCCESS on success.
+ * @retval RD_ERROR_NULL if p_stats is NULL.
+ */
+rd_status_t ri_adc_stream_stats_get (ri_adc_stream_stats_t * const p_stats);
+
+/*@}*/
+#endif
@@ -0,0 +1,245 @@
+/**
+ * @addtogroup Radio
+ */
+/*@{*/
+/**
+ * @file ruuvi_interface_communication_batch.c
+ * @author Otso Jousimaa <otso@ojousima.net>
+ * @date 2026-10-19
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ */
+#include "ruuvi_interface_communication_batch.h"
+#if RI_COMM_ENABLED
+#include "ruuvi_interface_atomic.h"
+#include "ruuvi_interface_communication_tx_gate.h"
+#include <string.h>
+
+#define BATCH_BUFFERS (2U) //!< One buffer is filled while other is sent.
+
+static uint8_t m_buffer[BATCH_BUFFERS][RI_COMM_BATCH_SIZE];
+static volatile size_t m_length[BATCH_BUFFERS]; //!< Bytes in buffer.
+static volatile uint8_t m_fill;     //!< Buffer being filled.
+static volatile uint8_t m_sending;  //!< Buffer being sent, valid while gate is owned.
+static volatile bool m_flush;       //!< Send buffer being filled even if it is not full.
+static ri_atomic_t m_fill_lock;     //!< Set while buffer being filled is written or swapped.
+static ri_comm_batch_send_fp_t m_send;
+static ri_comm_batch_arm_fp_t m_arm;
+static ri_comm_batch_stats_t m_stats;
+
+/** @brief Buffer cannot hold another message of maximum length. */
+static bool batch_full (const size_t length)
+{
+    return (RI_COMM_BATCH_SIZE - length) < RI_COMM_MESSAGE_MAX_LENGTH;
+}
+
+static bool batch_pending (void)
+{
+    const size_t length = m_length[m_fill];
+    return (0U != length) && (m_flush || batch_full (length));
+}
+
+/** @brief Swap buffers and send the filled one, called by owner of m_gate. */
+static rd_status_t batch_start (void)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if (!ri_atomic_flag (&m_fill_lock, true))
+    {
+        // Preempted an append, appending context kicks the gate afterwards.
+        err_code |= RD_ERROR_BUSY;
+    }
+    else
+    {
+        const uint8_t sending = m_fill;
+        const size_t length = m_length[sending];
+
+        if (0U == length)
+        {
+            (void) ri_atomic_flag (&m_fill_lock, false);
+            err_code |= RD_ERROR_NOT_FOUND;
+        }
+        else
+        {
+            // Other buffer was emptied when its transfer was done.
+            m_sending = sending;
+            m_fill = sending ^ 1U;
+            m_flush = false;
+            (void) ri_atomic_flag (&m_fill_lock, false);
+            err_code |= m_send (m_buffer[sending], length);
+
+            if (RD_SUCCESS == err_code)
+            {
+                m_stats.batches++;
+                m_stats.bytes += length;
+            }
+            else
+            {
+                m_stats.failed++;
+                m_length[sending] = 0;
+            }
+        }
+    }
+
+    return err_code;
+}
+
+static ri_comm_tx_gate_t m_gate =
+{
+    .owned = RI_ATOMIC_FLAG_INIT,
+    .pending = batch_pending,
+    .start = batch_start
+};
+
+/** @brief Copy message into buffer being filled if it fits. */
+static rd_status_t batch_write (const uint8_t * const p_data, const size_t length,
+                                bool * const p_written)
+{
+    rd_status_t err_code = RD_SUCCESS;
+    bool arm = false;
+
+    if (!ri_atomic_flag (&m_fill_lock, true))
+    {
+        err_code |= RD_ERROR_BUSY;
+    }
+    else
+    {
+        const uint8_t fill = m_fill;
+        const size_t used = m_length[fill];
+
+        if (length <= (RI_COMM_BATCH_SIZE - used))
+        {
+            memcpy (&m_buffer[fill][used], p_data, length);
+            m_length[fill] = used + length;
+            m_stats.messages++;
+            arm = (0U == used) && (NULL != m_arm);
+            *p_written = true;
+        }
+
+        (void) ri_atomic_flag (&m_fill_lock, false);
+    }
+
+    if (arm)
+    {
+        m_arm();
+    }
+
+    return err_code;
+}
+
+rd_status_t ri_comm_batch_init (const ri_comm_batch_send_fp_t send,
+                                const ri_comm_batch_arm_fp_t arm)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if (NULL == send)
+    {
+        err_code |= RD_ERROR_NULL;
+    }
+    else
+    {
+        m_send = send;
+        m_arm = arm;
+        m_length[0] = 0;
+        m_length[1] = 0;
+        m_fill = 0;
+        m_sending = 0;
+        m_flush = false;
+        m_fill_lock = RI_ATOMIC_FLAG_INIT;
+        m_gate.owned = RI_ATOMIC_FLAG_INIT;
+        memset (&m_stats, 0, sizeof (m_stats));
+    }
+
+    return err_code;
+}
+
+rd_status_t ri_comm_batch_append (const uint8_t * const p_data, const size_t length)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if (NULL == p_data)
+    {
+        err_code |= RD_ERROR_NULL;
+    }
+    else if (NULL == m_send)
+    {
+        err_code |= RD_ERROR_INVALID_STATE;
+    }
+    else if ( (0U == length) || (RI_COMM_BATCH_SIZE < length))
+    {
+        err_code |= RD_ERROR_INVALID_LENGTH;
+    }
+    else
+    {
+        bool written = false;
+        err_code |= batch_write (p_data, length, &written);
+
+        if ( (RD_SUCCESS == err_code) && !written)
+        {
+            // Send filled buffer if transport is free, message then fits into the other one.
+            m_flush = true;
+            const rd_status_t send_status = ri_comm_tx_gate_kick (&m_gate);
+            err_code |= batch_write (p_data, length, &written);
+
+            if ( (RD_SUCCESS == err_code) && !written)
+            {
+                m_stats.dropped++;
+                err_code |= RD_ERROR_NO_MEM;
+            }
+
+            err_code |= send_status;
+        }
+
+        // Start may have been blocked by this append, kick after releasing buffer.
+        err_code |= ri_comm_tx_gate_kick (&m_gate);
+    }
+
+    return err_code;
+}
+
+rd_status_t ri_comm_batch_flush (void)
+{
+    m_flush = true;
+    return ri_comm_tx_gate_kick (&m_gate);
+}
+
+rd_status_t ri_comm_batch_done (void)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if (!ri_comm_tx_gate_is_busy (&m_gate))
+    {
+        err_code |= RD_ERROR_INVALID_STATE;
+    }
+    else
+    {
+        m_length[m_sending] = 0;
+        ri_comm_tx_gate_release (&m_gate);
+        err_code |= ri_comm_tx_gate_kick (&m_gate);
+    }
+
+    return err_code;
+}
+
+bool ri_comm_batch_is_busy (void)
+{
+    return ri_comm_tx_gate_is_busy (&m_gate) || (0U != m_length[m_fill]);
+}
+
+rd_status_t ri_comm_batch_stats_get (ri_comm_batch_stats_t * const p_stats)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if (NULL == p_stats)
+    {
+        err_code |= RD_ERROR_NULL;
+    }
+    else
+    {
+        *p_stats = m_stats;
+    }
+
+    return err_code;
+}
+
+/*@}*/
+#endif
@@ -0,0 +1,138 @@
+#ifndef RUUVI_INTERFACE_COMMUNICATION_BATCH_H
+#define RUUVI_INTERFACE_COMMUNICATION_BATCH_H
+/**
+ * @addtogroup Radio
+ */
+/*@{*/
+/**
+ * @file ruuvi_interface_communication_batch.h
+ * @author Otso Jousimaa <otso@ojousima.net>
+ * @date 2026-10-19
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ *
+ * @brief Pack framed messages into double-buffered transfers.
+ *
+ * Sending each short message, e.g. an encoded scan report, as its own transfer
+ * spends most of the link time on per-transfer overhead. Batch appends messages
+ * as is into one buffer while the other buffer is being sent, so each transfer
+ * carries as many messages as have arrived meanwhile. Messages must carry their
+ * own framing, batch only concatenates them.
+ *
+ * A buffer is sent once it cannot hold another message of
+ * @ref RI_COMM_MESSAGE_MAX_LENGTH bytes or once @ref ri_comm_batch_flush is called,
+ * typically from a timer armed by @ref ri_comm_batch_arm_fp_t to bound latency.
+ * Only one buffer is sent at a time, see @ref ri_comm_tx_gate_t.
+ *
+ * Messages may be appended from thread and interrupt context, transfer done
+ * is signalled from transport interrupt.
+ */
+#include "ruuvi_driver_enabled_modules.h"
+#include "ruuvi_driver_error.h"
+#include "ruuvi_interface_communication.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifndef RI_COMM_BATCH_SIZE
+/** @brief Size of one batch buffer, two are allocated. */
+#   define RI_COMM_BATCH_SIZE (256U)
+#endif
+
+#if (RI_COMM_BATCH_SIZE < RI_COMM_MESSAGE_MAX_LENGTH)
+#   error "RI_COMM_BATCH_SIZE must hold at least one message."
+#endif
+
+/**
+ * @brief Start sending a buffer.
+ *
+ * Buffer stays valid until @ref ri_comm_batch_done is called.
+ *
+ * @param[in] p_data Data to send.
+ * @param[in] length Length of data.
+ * @retval RD_SUCCESS if transfer was started.
+ * @return error code if transfer could not be started, buffer is dropped.
+ */
+typedef rd_status_t (*ri_comm_batch_send_fp_t) (const uint8_t * const p_data,
+        const size_t length);
+
+/**
+ * @brief First message was appended into an empty buffer.
+ *
+ * Arm a single-shot timer which calls @ref ri_comm_batch_flush.
+ */
+typedef void (*ri_comm_batch_arm_fp_t) (void);
+
+/** @brief Batch statistics. */
+typedef struct
+{
+    uint32_t messages; //!< Messages appended.
+    uint32_t batches;  //!< Buffers given to transport.
+    uint32_t bytes;    //!< Bytes given to transport.
+    uint32_t dropped;  //!< Messages rejected due to full buffers.
+    uint32_t failed;   //!< Buffers dropped due to transport error.
+} ri_comm_batch_stats_t;
+
+/**
+ * @brief Set up batching, discarding any buffered data.
+ *
+ * @param[in] send Function which starts a transfer.
+ * @param[in] arm Function which arms flush timer, may be NULL if
+ *                @ref ri_comm_batch_flush is called otherwise.
+ * @retval RD_SUCCESS on success.
+ * @retval RD_ERROR_NULL if send is NULL.
+ */
+rd_status_t ri_comm_batch_init (const ri_comm_batch_send_fp_t send,
+                                const ri_comm_batch_arm_fp_t arm);
+
+/**
+ * @brief Append a framed message.
+ *
+ * @param[in] p_data Message.
+ * @param[in] length Length of message, at most @ref RI_COMM_BATCH_SIZE.
+ * @retval RD_SUCCESS if message was buffered or sent.
+ * @retval RD_ERROR_NULL if p_data is NULL.
+ * @retval RD_ERROR_INVALID_STATE if batching is not initialized.
+ * @retval RD_ERROR_INVALID_LENGTH if length is 0 or larger than a buffer.
+ * @retval RD_ERROR_BUSY if another context is appending, e.g. interrupt preempted
+ *                       thread in the middle of append.
+ * @retval RD_ERROR_NO_MEM if both buffers are full, message is dropped.
+ * @return error code from transport if a full buffer could not be sent.
+ */
+rd_status_t ri_comm_batch_append (const uint8_t * const p_data, const size_t length);
+
+/**
+ * @brief Send partially filled buffer as soon as transport is free.
+ *
+ * Safe to call from interrupt context, e.g. flush timer.
+ *
+ * @return error code from transport if buffer could not be sent.
+ */
+rd_status_t ri_comm_batch_flush (void);
+
+/**
+ * @brief Transfer started by @ref ri_comm_batch_send_fp_t is done.
+ *
+ * Call from transport interrupt, starts next buffer if it is ready.
+ *
+ * @return error code from transport if next buffer could not be sent.
+ */
+rd_status_t ri_comm_batch_done (void);
+
+/**
+ * @brief Check if data is buffered or being sent.
+ *
+ * @return true if a transfer is ongoing or data is waiting.
+ */
+bool ri_comm_batch_is_busy (void);
+
+/**
+ * @brief Get batch statistics.
+ *
+ * @param[out] p_stats Statistics since @ref ri_comm_batch_init.
+ * @retval RD_SUCCESS on success.
+ * @retval RD_ERROR_NULL if p_stats is NULL.
+ */
+rd_status_t ri_comm_batch_stats_get (ri_comm_batch_stats_t * const p_stats);
+
+/*@}*/
+#endif
@@ -28,6 +28,10 @@
 /* @brief number of bytes in a MAC address */
 #define BLE_MAC_ADDRESS_LENGTH 6
 
+#ifndef RI_ADV_ROTATION_SLOTS
+#   define RI_ADV_ROTATION_SLOTS (4U) //!< Number of payloads in advertisement rotation.
+#endif
+
 /** @brief Allowed advertisement types */
 typedef enum
 {
@@ -224,6 +228,92 @@ rd_status_t ri_adv_type_set (ri_adv_type_t type);
  */
 rd_status_t ri_adv_stop (void);
 
+/**
+ * @brief Replace payload of ongoing advertisement without stopping it.
+ *
+ * New payload is encoded into the advertising data buffer which is not on air and
+ * given to the stack while advertising continues, buffers alternate on each update.
+ * Advertising parameters, such as interval and type, are kept. Start advertising
+ * with a message on repeat, e.g. @ref RI_COMM_MSG_REPEAT_FOREVER, and update its
+ * payload with this function.
+ *
+ * @param[in] message Payload of advertisement. repeat_count is ignored.
+ * @retval RD_SUCCESS if payload is sent from next advertising event on.
+ * @retval RD_ERROR_NULL if message is NULL.
+ * @retval RD_ERROR_DATA_SIZE if message is too long.
+ * @retval RD_ERROR_INVALID_STATE if there is no ongoing advertisement,
+ *                                advertisements are queued or rotation is running.
+ * @retval RD_ERROR_INVALID_PARAM if payload requires different advertisement type or PHY.
+ * @return error code from stack on other error.
+ */
+rd_status_t ri_adv_data_update (const ri_comm_message_t * const message);
+
+/**
+ * @brief Set payload of an advertisement rotation slot.
+ *
+ * Rotation sends payloads of enabled slots in turn, for example one slot for
+ * sensor data, one for an extended format and one for an URL. Each slot is encoded
+ * once here with current settings, e.g. interval, type, channels and TX power,
+ * and switching between slots on air only selects next encoded slot.
+ *
+ * Slots can be updated independently while rotation is running, new payload
+ * is written into a buffer which is not on air and takes effect on the next turn
+ * of the slot.
+ *
+ * @param[in] slot Index of slot, less than @ref RI_ADV_ROTATION_SLOTS.
+ * @param[in] message Payload of advertisement. repeat_count is ignored.
+ * @param[in] weight Number of advertising events sent on each turn of slot, 1 ... 255.
+ * @param[in] modulation PHY of slot, see @ref ri_adv_init for PHYs used.
+ * @retval RD_SUCCESS if payload was stored.
+ * @retval RD_ERROR_NULL if message is NULL.
+ * @retval RD_ERROR_INVALID_STATE if advertising is not initialized.
+ * @retval RD_ERROR_INVALID_PARAM if slot or weight is out of range.
+ * @retval RD_ERROR_BUSY if slot is being updated from another context.
+ * @retval RD_ERROR_DATA_SIZE if message is too long.
+ */
+rd_status_t ri_adv_rotation_slot_set (const uint8_t slot,
+                                      const ri_comm_message_t * const message,
+                                      const uint8_t weight,
+                                      const ri_radio_modulation_t modulation);
+
+/**
+ * @brief Remove a slot from advertisement rotation.
+ *
+ * If slot is on air, it finishes its current turn.
+ *
+ * @param[in] slot Index of slot, less than @ref RI_ADV_ROTATION_SLOTS.
+ * @retval RD_SUCCESS if slot was removed or it was not in use.
+ * @retval RD_ERROR_INVALID_PARAM if slot is out of range.
+ * @retval RD_ERROR_BUSY if slot is being updated from another context.
+ */
+rd_status_t ri_adv_rotation_slot_clear (const uint8_t slot);
+
+/**
+ * @brief Start sending advertisement rotation.
+ *
+ * Rotation continues until stopped, next slot is started on end of each turn
+ * without application involvement. Application is not notified of each sent turn.
+ * Messages sent through advertisement channel are queued until rotation is stopped.
+ * Rotation stops when a connection is established, slots are kept.
+ *
+ * @retval RD_SUCCESS if rotation was started.
+ * @retval RD_ERROR_INVALID_STATE if advertising is not initialized, an advertisement
+ *                                is ongoing or no slot is in use.
+ * @return error code from stack on other error.
+ */
+rd_status_t ri_adv_rotation_start (void);
+
+/**
+ * @brief Stop advertisement rotation.
+ *
+ * Slots are kept, queued advertisements are started. If the slot on air had
+ * just ended, its termination event starts them instead, see
+ * @ref ri_comm_rotation_stop.
+ *
+ * @retval RD_SUCCESS if rotation is not running.
+ */
+rd_status_t ri_adv_rotation_stop (void);
+
 /** @brief setup scan window interval and window size.
  *
  *  The scan window interval must be larger or equivalent to window size.
@@ -254,6 +344,33 @@ rd_status_t ri_adv_stop (void);
 rd_status_t ri_adv_scan_start (const uint32_t window_interval_ms,
                                const uint32_t window_size_ms);
 
+/**
+ * @brief Scan one PHY regardless of radio modulation.
+ *
+ * Works as @ref ri_adv_scan_start, but scans given PHY:
+ *  - @ref RI_RADIO_BLE_1MBPS: legacy advertisements and extended advertisements
+ *    with 1 MBit/s primary and secondary PHY.
+ *  - @ref RI_RADIO_BLE_2MBPS: extended advertisements with 1 MBit/s primary,
+ *    secondary advertisements are followed to 2 MBit/s.
+ *  - @ref RI_RADIO_BLE_125KBPS: extended advertisements on Coded PHY.
+ *
+ * Only reports received on given PHY are passed on, 2 MBit/s scan passes only
+ * reports with 2 MBit/s secondary PHY and 1 MBit/s scan passes reports without
+ * 2 MBit/s secondary PHY. PHYs enabled by
+ * @ref ri_adv_rx_ble_phy_enabled_set do not apply. Reports are marked as coded
+ * PHY based on scanned PHY.
+ *
+ * @param[in] window_interval_ms interval of the windows. At most 10s.
+ * @param[in] window_size_ms window size within interval. Smaller or equal to interval.
+ * @param[in] modulation PHY to scan.
+ * @retval RD_SUCCESS on success.
+ * @retval RD_ERROR_NOT_SUPPORTED if radio does not support the PHY.
+ * @return error code from stack on other error.
+ */
+rd_status_t ri_adv_scan_phy_start (const uint32_t window_interval_ms,
+                                   const uint32_t window_size_ms,
+                                   const ri_radio_modulation_t modulation);
+
 /**
  * @brief Stop ongoing scanning.
  *
@@ -8,6 +8,7 @@
 #define RUUVI_INTERFACE_COMMUNICATION_BLE4_GATT_H
 #include "ruuvi_driver_error.h"
 #include "ruuvi_interface_communication.h"
+#include "ruuvi_interface_communication_bulk.h"
 #include "ruuvi_interface_communication_radio.h"
 #include "ruuvi_driver_enabled_modules.h"
 
@@ -32,6 +33,37 @@
 #define RI_GATT_MIN_INTERVAL_LOW_POWER_MS (1950U)
 #define RI_GATT_MAX_INTERVAL_LOW_POWER_MS (1980U)
 
+/** @brief Effective parameters of current connection. */
+typedef struct
+{
+    uint16_t att_mtu;               //!< Effective ATT MTU.
+    uint16_t data_length;           //!< Effective LL data length.
+    ri_radio_modulation_t tx_phy;   //!< PHY used for transmitting.
+    ri_radio_modulation_t rx_phy;   //!< PHY used for receiving.
+    uint32_t conn_interval_us;      //!< Connection interval, microseconds.
+    uint16_t slave_latency;         //!< Connection events peripheral may skip.
+    uint32_t tx_bytes;              //!< NUS bytes queued to stack on this connection.
+    uint32_t rx_bytes;              //!< NUS bytes received on this connection.
+} ri_gatt_link_t;
+
+/**
+ * @brief Called when parameters of connection change.
+ *
+ * Called on connection and on MTU, data length, PHY and connection parameter updates.
+ * Byte counters changing do not trigger the callback.
+ *
+ * @param[in] p_link Current parameters, valid only during the call.
+ */
+typedef void (*ri_gatt_link_cb_t) (const ri_gatt_link_t * const p_link);
+
+/**
+ * @brief Called when bulk transfer ends.
+ *
+ * @param[in] result RD_SUCCESS if all data was queued to stack, error code otherwise.
+ * @param[in] sent Number of bytes queued to stack.
+ */
+typedef ri_comm_bulk_done_fp_t ri_gatt_bulk_done_fp;
+
 /**
  * @brief Initializes GATT stack.
  * Uses default values from sdk_config.h, these can be overridden in nrf5_sdk15_application_config.h
@@ -105,4 +137,67 @@ rd_status_t ri_gatt_dis_init (const ri_comm_dis_init_t * const dis);
 rd_status_t ri_gatt_params_request (const ri_gatt_params_t params,
                                     const uint16_t delay_ms);
 
-#endif
\ No newline at end of file
+/**
+ * @brief Send data larger than @ref ri_comm_message_t over Nordic UART Service.
+ *
+ * Data is sent in notifications sized to negotiated ATT MTU and LL data length,
+ * see @ref ri_comm_bulk_fragment_size. Notifications are queued until stack
+ * TX queue is full and the rest is sent as queue drains. Regular NUS send returns
+ * RD_ERROR_BUSY while bulk transfer is ongoing.
+ *
+ * @param[in] p_segments Buffers to send back-to-back. Array and buffers must stay valid
+ *                       until on_done is called.
+ * @param[in] segment_count Number of buffers.
+ * @param[in] on_done Called when transfer ends, may be NULL. Can be called in interrupt
+ *                    context or before this function returns.
+ * @retval RD_SUCCESS Transfer was started.
+ * @retval RD_ERROR_NULL if p_segments is NULL or has a non-empty buffer with NULL data.
+ * @retval RD_ERROR_INVALID_LENGTH if there is no data to send.
+ * @retval RD_ERROR_INVALID_STATE if there is no connection.
+ * @retval RD_ERROR_BUSY if a bulk transfer is already ongoing.
+ */
+rd_status_t ri_gatt_nus_bulk_send (const ri_comm_segment_t * const p_segments,
+                                   const size_t segment_count,
+                                   const ri_gatt_bulk_done_fp on_done);
+
+/**
+ * @brief Stop ongoing bulk transfer.
+ *
+ * Notifications already queued to stack are still sent. on_done is called with
+ * RD_ERROR_INVALID_STATE, as on disconnection. If abort preempts a TX_RDY event
+ * sending the transfer, on_done is called once the event handler resumes.
+ *
+ * @retval RD_SUCCESS Transfer was stopped.
+ * @retval RD_ERROR_INVALID_STATE if there is no ongoing bulk transfer.
+ */
+rd_status_t ri_gatt_nus_bulk_abort (void);
+
+/**
+ * @brief Check if bulk transfer is ongoing.
+ *
+ * @return true if bulk transfer is ongoing.
+ */
+bool ri_gatt_nus_bulk_is_active (void);
+
+/**
+ * @brief Get effective parameters of current connection.
+ *
+ * Use e.g. with @ref ri_comm_bulk_fragment_size to size data to the link.
+ *
+ * @param[out] p_link Parameters of current connection.
+ * @retval RD_SUCCESS on success.
+ * @retval RD_ERROR_NULL if p_link is NULL.
+ * @retval RD_ERROR_INVALID_STATE if there is no connection.
+ */
+rd_status_t ri_gatt_link_get (ri_gatt_link_t * const p_link);
+
+/**
+ * @brief Set handler for connection parameter changes.
+ *
+ * Handler is called in interrupt context and cleared on @ref ri_gatt_uninit.
+ *
+ * @param[in] cb Handler, NULL to clear.
+ */
+void ri_gatt_link_cb_set (const ri_gatt_link_cb_t cb);
+
+#endif
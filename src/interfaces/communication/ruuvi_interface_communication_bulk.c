@@ -0,0 +1,316 @@
+/**
+ * @addtogroup Radio
+ */
+/*@{*/
+/**
+ * @file ruuvi_interface_communication_bulk.c
+ * @author Otso Jousimaa <otso@ojousima.net>
+ * @date 2026-10-18
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ */
+#include "ruuvi_interface_communication_bulk.h"
+#if RI_COMM_ENABLED
+#include <string.h>
+
+/** @brief Skip empty buffers so that current buffer has data unless transfer is done. */
+static void bulk_skip_empty (ri_comm_bulk_t * const p_bulk)
+{
+    while ( (p_bulk->segment < p_bulk->segment_count)
+            && (p_bulk->offset >= p_bulk->p_segments[p_bulk->segment].length))
+    {
+        p_bulk->segment++;
+        p_bulk->offset = 0;
+    }
+}
+
+rd_status_t ri_comm_bulk_init (ri_comm_bulk_t * const p_bulk,
+                               const ri_comm_segment_t * const p_segments,
+                               const size_t segment_count)
+{
+    rd_status_t err_code = RD_SUCCESS;
+    size_t total = 0;
+
+    if ( (NULL == p_bulk) || (NULL == p_segments))
+    {
+        err_code |= RD_ERROR_NULL;
+    }
+    else
+    {
+        for (size_t ii = 0; ii < segment_count; ii++)
+        {
+            if ( (0U != p_segments[ii].length) && (NULL == p_segments[ii].p_data))
+            {
+                err_code |= RD_ERROR_NULL;
+            }
+
+            total += p_segments[ii].length;
+        }
+
+        if ( (RD_SUCCESS == err_code) && (0U == total))
+        {
+            err_code |= RD_ERROR_INVALID_LENGTH;
+        }
+
+        if (RD_SUCCESS == err_code)
+        {
+            p_bulk->p_segments = p_segments;
+            p_bulk->segment_count = segment_count;
+            p_bulk->segment = 0;
+            p_bulk->offset = 0;
+            p_bulk->remaining = total;
+            bulk_skip_empty (p_bulk);
+        }
+    }
+
+    return err_code;
+}
+
+size_t ri_comm_bulk_peek (const ri_comm_bulk_t * const p_bulk,
+                          uint8_t * const p_chunk, const size_t max_length)
+{
+    size_t copied = 0;
+
+    if ( (NULL != p_bulk) && (NULL != p_chunk))
+    {
+        size_t segment = p_bulk->segment;
+        size_t offset = p_bulk->offset;
+
+        while ( (copied < max_length) && (segment < p_bulk->segment_count))
+        {
+            const ri_comm_segment_t * const p_segment = &p_bulk->p_segments[segment];
+            size_t length = p_segment->length - offset;
+
+            if (length > (max_length - copied))
+            {
+                length = max_length - copied;
+            }
+
+            if (0U != length)
+            {
+                memcpy (&p_chunk[copied], &p_segment->p_data[offset], length);
+            }
+
+            copied += length;
+            segment++;
+            offset = 0;
+        }
+    }
+
+    return copied;
+}
+
+void ri_comm_bulk_consume (ri_comm_bulk_t * const p_bulk, const size_t length)
+{
+    if (NULL != p_bulk)
+    {
+        size_t left = (length > p_bulk->remaining) ? p_bulk->remaining : length;
+        p_bulk->remaining -= left;
+
+        while (0U != left)
+        {
+            const size_t available = p_bulk->p_segments[p_bulk->segment].length
+                                     - p_bulk->offset;
+            const size_t step = (left < available) ? left : available;
+            p_bulk->offset += step;
+            left -= step;
+            bulk_skip_empty (p_bulk);
+        }
+    }
+}
+
+size_t ri_comm_bulk_remaining (const ri_comm_bulk_t * const p_bulk)
+{
+    return (NULL == p_bulk) ? 0U : p_bulk->remaining;
+}
+
+uint16_t ri_comm_bulk_fragment_size (const uint16_t att_mtu,
+                                     const uint16_t data_length)
+{
+    const uint32_t overhead = RI_COMM_BULK_L2CAP_HEADER_LENGTH
+                              + RI_COMM_BULK_ATT_HEADER_LENGTH;
+    const uint32_t minimum = RI_COMM_BULK_ATT_MTU_DEFAULT - RI_COMM_BULK_ATT_HEADER_LENGTH;
+    uint32_t payload = minimum;
+
+    if (att_mtu > RI_COMM_BULK_ATT_MTU_DEFAULT)
+    {
+        payload = (uint32_t) att_mtu - RI_COMM_BULK_ATT_HEADER_LENGTH;
+    }
+
+    if (data_length >= RI_COMM_BULK_DATA_LENGTH_DEFAULT)
+    {
+        // Fill whole LL packets, last packet of notification would otherwise be short.
+        const uint32_t packets = (payload + overhead) / data_length;
+        const uint32_t filled = (packets * data_length) - overhead;
+
+        if ( (0U != packets) && (filled >= minimum))
+        {
+            payload = filled;
+        }
+    }
+
+    return (uint16_t) payload;
+}
+
+/**
+ * @brief Offer chunks of ongoing transfer, called only by owner of pump.
+ *
+ * @param[out] p_result Result of transfer if it ended.
+ * @return true if transfer ended.
+ */
+static bool pump_owned (ri_comm_bulk_pump_t * const p_pump, const size_t max_length,
+                        rd_status_t * const p_result)
+{
+    rd_status_t status = RD_SUCCESS;
+    bool done = false;
+    const size_t limit = (max_length < p_pump->chunk_size) ? max_length : p_pump->chunk_size;
+
+    if (p_pump->active)
+    {
+        size_t length = 1U;
+
+        // Abort may arrive from interrupt while a chunk is being sent.
+        while ( (RD_SUCCESS == status) && (0U < length) && !p_pump->abort
+                && (0U < ri_comm_bulk_remaining (&p_pump->bulk)))
+        {
+            length = ri_comm_bulk_peek (&p_pump->bulk, p_pump->p_chunk, limit);
+
+            if (0U < length)
+            {
+                status = p_pump->send (p_pump->p_chunk, &length);
+
+                if (RD_SUCCESS == status)
+                {
+                    ri_comm_bulk_consume (&p_pump->bulk, length);
+                    p_pump->sent += length;
+                }
+            }
+        }
+
+        if (p_pump->abort)
+        {
+            status = RD_ERROR_INVALID_STATE;
+            done = true;
+        }
+        else if (RD_ERROR_RESOURCES == status)
+        {
+            // TX queue full, continue on next pump.
+        }
+        else if ( (RD_SUCCESS != status) || (0U == ri_comm_bulk_remaining (&p_pump->bulk)))
+        {
+            done = true;
+        }
+        else
+        {
+            // Zero-length pump of abort, request was served by another context.
+        }
+    }
+
+    if (done)
+    {
+        p_pump->active = false;
+        p_pump->abort = false;
+        *p_result = status;
+    }
+
+    return done;
+}
+
+rd_status_t ri_comm_bulk_pump_start (ri_comm_bulk_pump_t * const p_pump,
+                                     const ri_comm_segment_t * const p_segments,
+                                     const size_t segment_count,
+                                     const ri_comm_bulk_done_fp_t on_done)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if ( (NULL == p_pump) || (NULL == p_pump->send) || (NULL == p_pump->p_chunk))
+    {
+        err_code |= RD_ERROR_NULL;
+    }
+    else if (!ri_atomic_flag (&p_pump->owned, true))
+    {
+        err_code |= RD_ERROR_BUSY;
+    }
+    else
+    {
+        if (p_pump->active)
+        {
+            err_code |= RD_ERROR_BUSY;
+        }
+        else
+        {
+            err_code |= ri_comm_bulk_init (&p_pump->bulk, p_segments, segment_count);
+
+            if (RD_SUCCESS == err_code)
+            {
+                p_pump->sent = 0;
+                p_pump->on_done = on_done;
+                p_pump->abort = false;
+                p_pump->active = true;
+            }
+        }
+
+        (void) ri_atomic_flag (&p_pump->owned, false);
+    }
+
+    return err_code;
+}
+
+void ri_comm_bulk_pump (ri_comm_bulk_pump_t * const p_pump, const size_t max_length)
+{
+    if (NULL != p_pump)
+    {
+        p_pump->again = true;
+
+        // Request made while another context owned the pump is served by the owner.
+        while (p_pump->again && ri_atomic_flag (&p_pump->owned, true))
+        {
+            ri_comm_bulk_done_fp_t on_done = NULL;
+            rd_status_t result = RD_SUCCESS;
+            p_pump->again = false;
+
+            if (pump_owned (p_pump, max_length, &result))
+            {
+                on_done = p_pump->on_done;
+                p_pump->on_done = NULL;
+            }
+
+            const size_t sent = p_pump->sent;
+            (void) ri_atomic_flag (&p_pump->owned, false);
+
+            // Called without ownership, callback may start next transfer.
+            if (NULL != on_done)
+            {
+                on_done (result, sent);
+            }
+        }
+    }
+}
+
+rd_status_t ri_comm_bulk_pump_abort (ri_comm_bulk_pump_t * const p_pump)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if (NULL == p_pump)
+    {
+        err_code |= RD_ERROR_NULL;
+    }
+    else if (!p_pump->active)
+    {
+        err_code |= RD_ERROR_INVALID_STATE;
+    }
+    else
+    {
+        p_pump->abort = true;
+        ri_comm_bulk_pump (p_pump, 0U);
+    }
+
+    return err_code;
+}
+
+bool ri_comm_bulk_pump_is_active (const ri_comm_bulk_pump_t * const p_pump)
+{
+    return (NULL != p_pump) && p_pump->active;
+}
+
+/*@}*/
+#endif
@@ -0,0 +1,210 @@
+#ifndef RUUVI_INTERFACE_COMMUNICATION_BULK_H
+#define RUUVI_INTERFACE_COMMUNICATION_BULK_H
+/**
+ * @addtogroup Radio
+ */
+/*@{*/
+/**
+ * @file ruuvi_interface_communication_bulk.h
+ * @author Otso Jousimaa <otso@ojousima.net>
+ * @date 2026-10-18
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ *
+ * @brief Fragment scatter/gather buffers into link-sized chunks.
+ *
+ * @ref ri_comm_message_t holds at most @ref RI_COMM_MESSAGE_MAX_LENGTH bytes,
+ * less than a GATT notification can carry after MTU exchange. Bulk transfer takes
+ * a list of buffers of any length and cuts them into chunks sized to the link,
+ * a chunk may span several buffers.
+ *
+ * A chunk is first copied with @ref ri_comm_bulk_peek and consumed with
+ * @ref ri_comm_bulk_consume only after the stack has accepted it, so a chunk
+ * rejected due to full TX queue is sent again as is.
+ *
+ * @ref ri_comm_bulk_pump_t sends a transfer from both thread and interrupt
+ * context: whoever calls @ref ri_comm_bulk_pump while another context is sending
+ * leaves the work to that context, which pumps again before returning.
+ */
+#include "ruuvi_driver_enabled_modules.h"
+#include "ruuvi_driver_error.h"
+#include "ruuvi_interface_atomic.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/** @brief ATT notification header: opcode and handle. */
+#define RI_COMM_BULK_ATT_HEADER_LENGTH   (3U)
+/** @brief L2CAP header in front of ATT PDU. */
+#define RI_COMM_BULK_L2CAP_HEADER_LENGTH (4U)
+/** @brief Default ATT MTU, before exchange. */
+#define RI_COMM_BULK_ATT_MTU_DEFAULT     (23U)
+/** @brief Default LL data length, before Data Length Extension. */
+#define RI_COMM_BULK_DATA_LENGTH_DEFAULT (27U)
+
+/** @brief One buffer of a transfer. */
+typedef struct
+{
+    const uint8_t * p_data; //!< Data, must stay valid until transfer is done.
+    size_t length;          //!< Length of data.
+} ri_comm_segment_t;
+
+/** @brief Position in a transfer. Set up with @ref ri_comm_bulk_init. */
+typedef struct
+{
+    const ri_comm_segment_t * p_segments; //!< Buffers of transfer.
+    size_t segment_count;                 //!< Number of buffers.
+    size_t segment;                       //!< Current buffer.
+    size_t offset;                        //!< Position in current buffer.
+    size_t remaining;                     //!< Bytes not yet consumed.
+} ri_comm_bulk_t;
+
+/**
+ * @brief Offer one chunk to the stack.
+ *
+ * @param[in] p_chunk Chunk to send.
+ * @param[in,out] p_length Length of chunk, bytes accepted by stack on success.
+ * @retval RD_SUCCESS if stack accepted the chunk.
+ * @retval RD_ERROR_RESOURCES if TX queue is full, chunk is offered again on next pump.
+ * @return other error ends transfer.
+ */
+typedef rd_status_t (*ri_comm_bulk_send_fp_t) (const uint8_t * const p_chunk,
+        size_t * const p_length);
+
+/**
+ * @brief Called when transfer ends.
+ *
+ * @param[in] result RD_SUCCESS if all data was accepted, error code otherwise.
+ * @param[in] sent Number of bytes accepted by stack.
+ */
+typedef void (*ri_comm_bulk_done_fp_t) (const rd_status_t result, const size_t sent);
+
+/**
+ * @brief Transfer shared between thread and interrupt context.
+ *
+ * Set up send, p_chunk and chunk_size statically, rest is private to implementation.
+ */
+typedef struct
+{
+    ri_comm_bulk_t bulk;             //!< Position of transfer.
+    ri_comm_bulk_send_fp_t send;     //!< Offer chunk to stack.
+    uint8_t * p_chunk;               //!< Buffer for chunk being offered.
+    size_t chunk_size;               //!< Size of p_chunk.
+    ri_comm_bulk_done_fp_t on_done;  //!< Called when transfer ends.
+    size_t sent;                     //!< Bytes accepted by stack.
+    ri_atomic_t owned;               //!< Set while a context runs the pump.
+    volatile bool again;             //!< Pump was requested while owned.
+    volatile bool abort;             //!< Abort was requested.
+    volatile bool active;            //!< Transfer is ongoing.
+} ri_comm_bulk_pump_t;
+
+/**
+ * @brief Start a transfer.
+ *
+ * @param[out] p_bulk Transfer to initialize.
+ * @param[in] p_segments Buffers, array must stay valid until transfer is done.
+ *                       Empty buffers are skipped.
+ * @param[in] segment_count Number of buffers.
+ * @retval RD_SUCCESS on success.
+ * @retval RD_ERROR_NULL if a pointer is NULL, or a non-empty buffer has NULL data.
+ * @retval RD_ERROR_INVALID_LENGTH if there are no bytes to send.
+ */
+rd_status_t ri_comm_bulk_init (ri_comm_bulk_t * const p_bulk,
+                               const ri_comm_segment_t * const p_segments,
+                               const size_t segment_count);
+
+/**
+ * @brief Copy next chunk of transfer without consuming it.
+ *
+ * @param[in] p_bulk Transfer.
+ * @param[out] p_chunk Buffer for chunk.
+ * @param[in] max_length Size of p_chunk, chunk is at most this long.
+ * @return Length of chunk, 0 if transfer is done or a pointer is NULL.
+ */
+size_t ri_comm_bulk_peek (const ri_comm_bulk_t * const p_bulk,
+                          uint8_t * const p_chunk, const size_t max_length);
+
+/**
+ * @brief Mark bytes of transfer sent.
+ *
+ * @param[in,out] p_bulk Transfer.
+ * @param[in] length Bytes sent, at most @ref ri_comm_bulk_remaining.
+ */
+void ri_comm_bulk_consume (ri_comm_bulk_t * const p_bulk, const size_t length);
+
+/**
+ * @brief Get number of bytes not yet sent.
+ *
+ * @param[in] p_bulk Transfer.
+ * @return Bytes remaining, 0 if p_bulk is NULL.
+ */
+size_t ri_comm_bulk_remaining (const ri_comm_bulk_t * const p_bulk);
+
+/**
+ * @brief Notification payload sized to link.
+ *
+ * Payload is limited by ATT MTU and reduced so that notification fills
+ * whole LL packets of given data length, e.g. 244 bytes with MTU 247 and data
+ * length 251, 236 bytes with MTU 247 and default data length 27.
+ *
+ * @param[in] att_mtu Effective ATT MTU.
+ * @param[in] data_length Effective LL data length.
+ * @return Payload length, at least payload of default MTU.
+ */
+uint16_t ri_comm_bulk_fragment_size (const uint16_t att_mtu,
+                                     const uint16_t data_length);
+
+/**
+ * @brief Set up a transfer on a pump.
+ *
+ * Data is not sent until @ref ri_comm_bulk_pump is called.
+ *
+ * @param[in,out] p_pump Pump to use.
+ * @param[in] p_segments Buffers, see @ref ri_comm_bulk_init.
+ * @param[in] segment_count Number of buffers.
+ * @param[in] on_done Called once when transfer ends, may be NULL.
+ * @retval RD_SUCCESS on success.
+ * @retval RD_ERROR_NULL if a pointer is NULL, see also @ref ri_comm_bulk_init.
+ * @retval RD_ERROR_INVALID_LENGTH if there are no bytes to send.
+ * @retval RD_ERROR_BUSY if a transfer is ongoing or pump is running in another context.
+ */
+rd_status_t ri_comm_bulk_pump_start (ri_comm_bulk_pump_t * const p_pump,
+                                     const ri_comm_segment_t * const p_segments,
+                                     const size_t segment_count,
+                                     const ri_comm_bulk_done_fp_t on_done);
+
+/**
+ * @brief Offer chunks until TX queue is full or transfer ends.
+ *
+ * Safe to call from any context, e.g. after start and on TX queue space
+ * becoming available. If another context is running the pump, returns immediately
+ * and that context pumps again before returning. on_done is called by the context
+ * which ends the transfer.
+ *
+ * @param[in,out] p_pump Pump to run.
+ * @param[in] max_length Longest chunk to offer, limited to chunk_size of pump.
+ */
+void ri_comm_bulk_pump (ri_comm_bulk_pump_t * const p_pump, const size_t max_length);
+
+/**
+ * @brief End ongoing transfer.
+ *
+ * on_done is called with RD_ERROR_INVALID_STATE before this function returns,
+ * or by the preempted context running the pump once it resumes.
+ *
+ * @param[in,out] p_pump Pump to stop.
+ * @retval RD_SUCCESS if abort was requested.
+ * @retval RD_ERROR_NULL if p_pump is NULL.
+ * @retval RD_ERROR_INVALID_STATE if there is no ongoing transfer.
+ */
+rd_status_t ri_comm_bulk_pump_abort (ri_comm_bulk_pump_t * const p_pump);
+
+/**
+ * @brief Check if transfer is ongoing.
+ *
+ * @param[in] p_pump Pump to check.
+ * @return true if transfer is ongoing, false if p_pump is NULL.
+ */
+bool ri_comm_bulk_pump_is_active (const ri_comm_bulk_pump_t * const p_pump);
+
+/*@}*/
+#endif
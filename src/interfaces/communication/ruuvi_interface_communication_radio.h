@@ -141,6 +141,13 @@ rd_status_t ri_radio_address_set (uint64_t const address);
  */
 void ri_radio_activity_callback_set (const ri_radio_activity_interrupt_fp_t handler);
 
+/**
+ * @brief Get radio activity interrupt handler.
+ *
+ * @return Handler set with @ref ri_radio_activity_callback_set, NULL if none is set.
+ */
+ri_radio_activity_interrupt_fp_t ri_radio_activity_callback_get (void);
+
 /**
  * @brief Check if radio is initialized
  *
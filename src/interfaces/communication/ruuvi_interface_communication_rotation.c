@@ -0,0 +1,147 @@
+/**
+ * @addtogroup Radio
+ */
+/*@{*/
+/**
+ * @file ruuvi_interface_communication_rotation.c
+ * @author Otso Jousimaa <otso@ojousima.net>
+ * @date 2026-10-19
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ */
+#include "ruuvi_interface_communication_rotation.h"
+#if RI_COMM_ENABLED
+
+static bool rotation_is_valid (const ri_comm_rotation_t * const p_rotation)
+{
+    return (NULL != p_rotation) && (NULL != p_rotation->p_gate)
+           && (NULL != p_rotation->next) && (NULL != p_rotation->halt);
+}
+
+/** @brief Slot is off air and no new slot is started, free transmitter. */
+static void rotation_end (ri_comm_rotation_t * const p_rotation)
+{
+    p_rotation->running = false;
+    p_rotation->stopping = false;
+    ri_comm_tx_gate_release (p_rotation->p_gate);
+    (void) ri_comm_tx_gate_kick (p_rotation->p_gate);
+}
+
+/** @brief Slot ended while stopping, second of stop and termination ends rotation. */
+static void rotation_slot_ended (ri_comm_rotation_t * const p_rotation)
+{
+    if (!ri_atomic_flag (&p_rotation->slot_ended, true))
+    {
+        (void) ri_atomic_flag (&p_rotation->slot_ended, false);
+        rotation_end (p_rotation);
+    }
+}
+
+rd_status_t ri_comm_rotation_start (ri_comm_rotation_t * const p_rotation)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if (!rotation_is_valid (p_rotation))
+    {
+        err_code |= RD_ERROR_NULL;
+    }
+    // Queued messages wait while rotation owns the transmitter.
+    else if (!ri_comm_tx_gate_acquire (p_rotation->p_gate))
+    {
+        err_code |= RD_ERROR_INVALID_STATE;
+    }
+    else
+    {
+        p_rotation->slot_ended = RI_ATOMIC_FLAG_INIT;
+        p_rotation->stopping = false;
+        p_rotation->running = true;
+        err_code |= p_rotation->next (true);
+
+        if (RD_SUCCESS != err_code)
+        {
+            rotation_end (p_rotation);
+        }
+    }
+
+    return err_code;
+}
+
+rd_status_t ri_comm_rotation_stop (ri_comm_rotation_t * const p_rotation)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if (NULL == p_rotation)
+    {
+        err_code |= RD_ERROR_NULL;
+    }
+    else if (p_rotation->running)
+    {
+        p_rotation->stopping = true;
+
+        // Rotation may have ended in interrupt before it saw the request.
+        if (!p_rotation->running)
+        {
+            p_rotation->stopping = false;
+        }
+        // Still owned by rotation, transmitter can only have a slot on air.
+        else if (p_rotation->halt())
+        {
+            rotation_end (p_rotation);
+        }
+        else
+        {
+            rotation_slot_ended (p_rotation);
+        }
+    }
+    else
+    {
+        // Not running.
+    }
+
+    return err_code;
+}
+
+rd_status_t ri_comm_rotation_terminated (ri_comm_rotation_t * const p_rotation)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if (!rotation_is_valid (p_rotation))
+    {
+        err_code |= RD_ERROR_NULL;
+    }
+    else if (!p_rotation->running)
+    {
+        err_code |= RD_ERROR_NOT_FOUND;
+    }
+    else if (p_rotation->stopping)
+    {
+        rotation_slot_ended (p_rotation);
+    }
+    else
+    {
+        err_code |= p_rotation->next (false);
+
+        if (RD_SUCCESS != err_code)
+        {
+            rotation_end (p_rotation);
+        }
+    }
+
+    return err_code;
+}
+
+void ri_comm_rotation_abort (ri_comm_rotation_t * const p_rotation)
+{
+    if (NULL != p_rotation)
+    {
+        p_rotation->running = false;
+        p_rotation->stopping = false;
+    }
+}
+
+bool ri_comm_rotation_is_running (const ri_comm_rotation_t * const p_rotation)
+{
+    return (NULL != p_rotation) && p_rotation->running;
+}
+
+/*@}*/
+#endif
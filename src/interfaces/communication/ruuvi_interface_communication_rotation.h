@@ -0,0 +1,110 @@
+#ifndef RUUVI_INTERFACE_COMMUNICATION_ROTATION_H
+#define RUUVI_INTERFACE_COMMUNICATION_ROTATION_H
+/**
+ * @addtogroup Radio
+ */
+/*@{*/
+/**
+ * @file ruuvi_interface_communication_rotation.h
+ * @author Otso Jousimaa <otso@ojousima.net>
+ * @date 2026-10-19
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ *
+ * @brief Keep a transmitter for a rotation of resident messages.
+ *
+ * Rotation owns the @ref ri_comm_tx_gate_t of the transmitter from start to stop,
+ * queued messages wait meanwhile. Each slot of rotation ends in interrupt, which
+ * starts the next slot.
+ *
+ * Stop runs in thread context and must take the slot on air off the transmitter
+ * without touching a queued message which interrupt may have started. Stop first
+ * forbids new slots and then halts the transmitter while rotation still owns the
+ * gate. If the slot had already ended, both the stop and the termination interrupt
+ * report the end of slot, and whichever comes second frees the gate.
+ */
+#include "ruuvi_driver_enabled_modules.h"
+#include "ruuvi_driver_error.h"
+#include "ruuvi_interface_atomic.h"
+#include "ruuvi_interface_communication_tx_gate.h"
+#include <stdbool.h>
+
+/**
+ * @brief Select next slot of rotation and start it.
+ *
+ * @param[in] first true on start of rotation, false after a slot ended.
+ * @retval RD_SUCCESS if a slot is being sent.
+ * @return error code if no slot was started, rotation ends.
+ */
+typedef rd_status_t (*ri_comm_rotation_next_fp_t) (const bool first);
+
+/**
+ * @brief Stop the transmitter.
+ *
+ * @return true if a slot was stopped, false if nothing was being sent.
+ */
+typedef bool (*ri_comm_rotation_halt_fp_t) (void);
+
+/** @brief Rotation on a transmitter. Set up gate and functions statically. */
+typedef struct
+{
+    ri_comm_tx_gate_t * p_gate;       //!< Gate of transmitter.
+    ri_comm_rotation_next_fp_t next;  //!< Start next slot.
+    ri_comm_rotation_halt_fp_t halt;  //!< Stop transmitter.
+    volatile bool running;            //!< Rotation owns transmitter.
+    volatile bool stopping;           //!< Stop was requested, no new slots are started.
+    ri_atomic_t slot_ended;           //!< Set by first of stop and termination to see end of slot.
+} ri_comm_rotation_t;
+
+/**
+ * @brief Take transmitter and start first slot.
+ *
+ * @param[in,out] p_rotation Rotation to start.
+ * @retval RD_SUCCESS if rotation was started.
+ * @retval RD_ERROR_NULL if p_rotation or its gate or functions are NULL.
+ * @retval RD_ERROR_INVALID_STATE if transmitter is in use.
+ * @return error code of first slot, transmitter was freed and queue kicked.
+ */
+rd_status_t ri_comm_rotation_start (ri_comm_rotation_t * const p_rotation);
+
+/**
+ * @brief Stop rotation, call in thread context.
+ *
+ * Transmitter is freed and queue kicked here, or in termination interrupt
+ * of the slot if it ended while stopping.
+ *
+ * @param[in,out] p_rotation Rotation to stop.
+ * @retval RD_SUCCESS if rotation is not running anymore.
+ * @retval RD_ERROR_NULL if p_rotation is NULL.
+ */
+rd_status_t ri_comm_rotation_stop (ri_comm_rotation_t * const p_rotation);
+
+/**
+ * @brief Handle end of transmission in interrupt.
+ *
+ * @param[in,out] p_rotation Rotation of transmitter.
+ * @retval RD_SUCCESS if transmission was a slot and rotation continues or was stopped.
+ * @retval RD_ERROR_NOT_FOUND if rotation is not running, transmission was a queued message.
+ * @retval RD_ERROR_NULL if p_rotation is NULL.
+ * @return error code of next slot, rotation ended and transmitter was freed.
+ */
+rd_status_t ri_comm_rotation_terminated (ri_comm_rotation_t * const p_rotation);
+
+/**
+ * @brief Forget rotation which the transmitter dropped, e.g. on connection.
+ *
+ * Gate is not touched, caller frees the transmitter.
+ *
+ * @param[in,out] p_rotation Rotation to forget.
+ */
+void ri_comm_rotation_abort (ri_comm_rotation_t * const p_rotation);
+
+/**
+ * @brief Check if rotation owns the transmitter.
+ *
+ * @param[in] p_rotation Rotation to check.
+ * @return true if rotation is running, false if p_rotation is NULL.
+ */
+bool ri_comm_rotation_is_running (const ri_comm_rotation_t * const p_rotation);
+
+/*@}*/
+#endif
@@ -0,0 +1,325 @@
+/**
+ * @addtogroup Radio
+ */
+/*@{*/
+/**
+ * @file ruuvi_interface_communication_rx_frame.c
+ * @author Otso Jousimaa <otso@ojousima.net>
+ * @date 2026-10-19
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ *
+ * Only receive interrupt picks a free buffer for a new frame and writes into it.
+ * Frame is ended by receive interrupt in delimiter mode and by idle timer in idle
+ * mode, which marks the buffer held before letting go of it. Idle timer may be
+ * preempted by receive interrupt, bytes fed before that belong to the ending frame.
+ */
+#include "ruuvi_interface_communication_rx_frame.h"
+#if RI_COMM_ENABLED
+#include <string.h>
+
+#define FRAME_BUFFERS (2U) //!< One buffer is filled while application holds other.
+#define FILL_NONE     (FRAME_BUFFERS) //!< No frame being received.
+#define CRC16_POLY    (0x1021U)
+#define CRC16_INIT    (0xFFFFU)
+
+static uint8_t m_buffer[FRAME_BUFFERS][RI_COMM_RX_FRAME_SIZE];
+static volatile size_t m_length[FRAME_BUFFERS];
+static volatile bool m_oversize[FRAME_BUFFERS]; //!< Bytes of frame were dropped.
+static volatile bool m_held[FRAME_BUFFERS];     //!< Frame is checked or held by application.
+static volatile uint8_t m_fill;                 //!< Buffer being filled or FILL_NONE.
+static volatile bool m_overrun;                 //!< Frame being received has no buffer.
+static volatile uint32_t m_rx_count;            //!< Feeds, compared by idle timer.
+static uint32_t m_idle_count;                   //!< Feeds at previous idle timeout.
+static ri_comm_rx_frame_init_t m_config;
+static ri_comm_rx_frame_stats_t m_stats;
+
+uint16_t ri_comm_rx_frame_crc16 (const uint8_t * const p_data, const size_t length)
+{
+    uint16_t crc = CRC16_INIT;
+
+    if (NULL != p_data)
+    {
+        for (size_t ii = 0; ii < length; ii++)
+        {
+            crc ^= (uint16_t) (p_data[ii] << 8U);
+
+            for (uint8_t bit = 0; bit < 8U; bit++)
+            {
+                crc = (crc & 0x8000U) ? (uint16_t) ( (crc << 1U) ^ CRC16_POLY)
+                      : (uint16_t) (crc << 1U);
+            }
+        }
+    }
+
+    return crc;
+}
+
+static void frame_discard (const uint8_t index)
+{
+    m_length[index] = 0;
+    m_oversize[index] = false;
+}
+
+/** @brief Check and hand over frame of a buffer which is no longer filled. */
+static void frame_complete (const uint8_t index)
+{
+    size_t length = m_length[index];
+
+    if (m_oversize[index])
+    {
+        m_stats.oversize++;
+        frame_discard (index);
+    }
+    else if (m_config.crc_enabled)
+    {
+        if (RI_COMM_RX_FRAME_CRC_LENGTH >= length)
+        {
+            m_stats.crc_errors++;
+            frame_discard (index);
+        }
+        else
+        {
+            length -= RI_COMM_RX_FRAME_CRC_LENGTH;
+            const uint16_t crc = (uint16_t) (m_buffer[index][length]
+                                             | (m_buffer[index][length + 1U] << 8U));
+
+            if (crc != ri_comm_rx_frame_crc16 (m_buffer[index], length))
+            {
+                m_stats.crc_errors++;
+                frame_discard (index);
+            }
+        }
+    }
+    else
+    {
+        // Frame is valid as is.
+    }
+
+    if (0U != m_length[index])
+    {
+        m_held[index] = true;
+        m_stats.frames++;
+        m_config.on_frame (m_buffer[index], length);
+    }
+}
+
+static bool frame_pending (void)
+{
+    const uint8_t fill = m_fill;
+    return m_overrun || ( (FILL_NONE != fill) && (0U != m_length[fill]));
+}
+
+static uint8_t frame_buffer_free (void)
+{
+    uint8_t index = FILL_NONE;
+
+    for (uint8_t ii = 0; (ii < FRAME_BUFFERS) && (FILL_NONE == index); ii++)
+    {
+        if (!m_held[ii])
+        {
+            index = ii;
+        }
+    }
+
+    return index;
+}
+
+/** @brief End frame being received, called by the context which ends frames. */
+static void frame_end (void)
+{
+    const uint8_t fill = m_fill;
+
+    if (m_overrun)
+    {
+        m_stats.overruns++;
+        m_overrun = false;
+    }
+    else if ( (FILL_NONE == fill) || (0U == m_length[fill]))
+    {
+        // Nothing received, e.g. consecutive delimiters.
+    }
+    else
+    {
+        // Receive interrupt picks a free buffer for next byte.
+        m_held[fill] = true;
+        m_fill = FILL_NONE;
+        frame_complete (fill);
+    }
+}
+
+rd_status_t ri_comm_rx_frame_init (const ri_comm_rx_frame_init_t * const p_config)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if ( (NULL == p_config) || (NULL == p_config->on_frame))
+    {
+        err_code |= RD_ERROR_NULL;
+    }
+    else if ( (RI_COMM_RX_FRAME_DELIMITER != p_config->mode)
+              && (RI_COMM_RX_FRAME_IDLE != p_config->mode))
+    {
+        err_code |= RD_ERROR_INVALID_PARAM;
+    }
+    else
+    {
+        m_config = *p_config;
+
+        for (uint8_t ii = 0; ii < FRAME_BUFFERS; ii++)
+        {
+            frame_discard (ii);
+            m_held[ii] = false;
+        }
+
+        m_fill = FILL_NONE;
+        m_overrun = false;
+        m_rx_count = 0;
+        m_idle_count = 0;
+        memset (&m_stats, 0, sizeof (m_stats));
+    }
+
+    return err_code;
+}
+
+bool ri_comm_rx_frame_feed (const uint8_t * const p_data, const size_t length)
+{
+    bool started = false;
+
+    if ( (NULL != p_data) && (0U != length) && (NULL != m_config.on_frame))
+    {
+        const bool idle_mode = (RI_COMM_RX_FRAME_IDLE == m_config.mode);
+        started = idle_mode && !frame_pending();
+
+        for (size_t ii = 0; ii < length; ii++)
+        {
+            if ( (FILL_NONE == m_fill) && !m_overrun)
+            {
+                m_fill = frame_buffer_free();
+            }
+
+            const uint8_t fill = m_fill;
+
+            if ( (!idle_mode) && (m_config.delimiter == p_data[ii]))
+            {
+                frame_end();
+            }
+            else if (FILL_NONE == fill)
+            {
+                // Application holds both buffers, drop frame even if one is released.
+                m_overrun = true;
+            }
+            else if (RI_COMM_RX_FRAME_SIZE <= m_length[fill])
+            {
+                m_oversize[fill] = true;
+            }
+            else
+            {
+                m_buffer[fill][m_length[fill]] = p_data[ii];
+                m_length[fill]++;
+            }
+        }
+
+        m_rx_count++;
+    }
+
+    return started;
+}
+
+bool ri_comm_rx_frame_idle (void)
+{
+    bool receiving = false;
+    const uint32_t rx_count = m_rx_count;
+
+    if ( (RI_COMM_RX_FRAME_IDLE != m_config.mode) || !frame_pending())
+    {
+        m_idle_count = rx_count;
+    }
+    else if (rx_count != m_idle_count)
+    {
+        // Bytes received since previous timeout.
+        m_idle_count = rx_count;
+        receiving = true;
+    }
+    else
+    {
+        frame_end();
+    }
+
+    return receiving;
+}
+
+rd_status_t ri_comm_rx_frame_release (const uint8_t * const p_frame)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if (NULL == p_frame)
+    {
+        err_code |= RD_ERROR_NULL;
+    }
+    else
+    {
+        uint8_t index = FRAME_BUFFERS;
+
+        for (uint8_t ii = 0; ii < FRAME_BUFFERS; ii++)
+        {
+            if (p_frame == m_buffer[ii])
+            {
+                index = ii;
+            }
+        }
+
+        if (FRAME_BUFFERS == index)
+        {
+            err_code |= RD_ERROR_INVALID_PARAM;
+        }
+        else if (!m_held[index])
+        {
+            err_code |= RD_ERROR_INVALID_STATE;
+        }
+        else
+        {
+            frame_discard (index);
+            m_held[index] = false;
+        }
+    }
+
+    return err_code;
+}
+
+rd_status_t ri_comm_rx_frame_stats_get (ri_comm_rx_frame_stats_t * const p_stats)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if (NULL == p_stats)
+    {
+        err_code |= RD_ERROR_NULL;
+    }
+    else
+    {
+        *p_stats = m_stats;
+    }
+
+    return err_code;
+}
+
+rd_status_t ri_comm_rx_frame_mode_get (ri_comm_rx_frame_mode_t * const p_mode)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if (NULL == p_mode)
+    {
+        err_code |= RD_ERROR_NULL;
+    }
+    else if (NULL == m_config.on_frame)
+    {
+        err_code |= RD_ERROR_INVALID_STATE;
+    }
+    else
+    {
+        *p_mode = m_config.mode;
+    }
+
+    return err_code;
+}
+
+/*@}*/
+#endif
@@ -0,0 +1,167 @@
+#ifndef RUUVI_INTERFACE_COMMUNICATION_RX_FRAME_H
+#define RUUVI_INTERFACE_COMMUNICATION_RX_FRAME_H
+/**
+ * @addtogroup Radio
+ */
+/*@{*/
+/**
+ * @file ruuvi_interface_communication_rx_frame.h
+ * @author Otso Jousimaa <otso@ojousima.net>
+ * @date 2026-10-19
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ *
+ * @brief Assemble received bytes into frames in two alternating buffers.
+ *
+ * Bytes are fed from receive interrupt into one buffer. Once the frame ends,
+ * the buffer is handed to application by pointer and reception continues in the
+ * other buffer. Application returns the buffer with @ref ri_comm_rx_frame_release,
+ * frame is not copied in between.
+ *
+ * Frame ends either on a delimiter byte or once line has been idle, optionally
+ * it carries a CRC which is checked before frame is handed over.
+ * Delimiter must not appear inside frame, use idle line for binary frames.
+ */
+#include "ruuvi_driver_enabled_modules.h"
+#include "ruuvi_driver_error.h"
+#include "ruuvi_interface_communication.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifndef RI_COMM_RX_FRAME_SIZE
+/** @brief Size of one frame buffer including CRC, two are allocated. */
+#   define RI_COMM_RX_FRAME_SIZE (RI_COMM_MESSAGE_MAX_LENGTH)
+#endif
+
+/** @brief Length of CRC at end of frame. */
+#define RI_COMM_RX_FRAME_CRC_LENGTH (2U)
+
+#if (RI_COMM_RX_FRAME_SIZE <= RI_COMM_RX_FRAME_CRC_LENGTH)
+#   error "RI_COMM_RX_FRAME_SIZE must hold a CRC and payload."
+#endif
+
+/** @brief How end of frame is detected. */
+typedef enum
+{
+    RI_COMM_RX_FRAME_DELIMITER, //!< Frame ends on delimiter byte, which is not part of frame.
+    RI_COMM_RX_FRAME_IDLE       //!< Frame ends once line is idle, see @ref ri_comm_rx_frame_idle.
+} ri_comm_rx_frame_mode_t;
+
+/**
+ * @brief Frame received.
+ *
+ * Called from interrupt context. Frame stays valid until it is given to
+ * @ref ri_comm_rx_frame_release, which may be called from the callback.
+ * While application holds a frame, next one is received into the other
+ * buffer. If both are held, frames are dropped.
+ *
+ * @param[in] p_frame Frame, without delimiter and CRC.
+ * @param[in] length Length of frame.
+ */
+typedef void (*ri_comm_rx_frame_fp_t) (const uint8_t * const p_frame,
+                                       const size_t length);
+
+/** @brief Frame reception configuration. */
+typedef struct
+{
+    ri_comm_rx_frame_mode_t mode; //!< End of frame detection.
+    uint8_t delimiter;            //!< Last byte of frame in delimiter mode.
+    /**
+     * @brief Frame ends in CRC of preceding bytes.
+     *
+     * CRC-16/CCITT-FALSE, see @ref ri_comm_rx_frame_crc16, least significant
+     * byte first. Frames with invalid CRC are dropped.
+     */
+    bool crc_enabled;
+    ri_comm_rx_frame_fp_t on_frame; //!< Called with each valid frame.
+} ri_comm_rx_frame_init_t;
+
+/** @brief Frame reception statistics. */
+typedef struct
+{
+    uint32_t frames;     //!< Frames handed to application.
+    uint32_t crc_errors; //!< Frames dropped due to invalid CRC.
+    uint32_t oversize;   //!< Frames dropped due to not fitting into buffer.
+    uint32_t overruns;   //!< Frames dropped because application held both buffers.
+} ri_comm_rx_frame_stats_t;
+
+/**
+ * @brief Set up frame reception, discarding any partial frame.
+ *
+ * Frames held by application must not be released after this.
+ *
+ * @param[in] p_config Configuration.
+ * @retval RD_SUCCESS on success.
+ * @retval RD_ERROR_NULL if p_config or its callback is NULL.
+ * @retval RD_ERROR_INVALID_PARAM if mode is unknown.
+ */
+rd_status_t ri_comm_rx_frame_init (const ri_comm_rx_frame_init_t * const p_config);
+
+/**
+ * @brief Feed received bytes.
+ *
+ * Call from receive interrupt only, bytes of one line must not be fed from
+ * several contexts. Ends frames in delimiter mode.
+ *
+ * @param[in] p_data Received bytes.
+ * @param[in] length Number of received bytes.
+ * @retval true if a frame was started in idle mode, arm idle timer.
+ * @retval false otherwise.
+ */
+bool ri_comm_rx_frame_feed (const uint8_t * const p_data, const size_t length);
+
+/**
+ * @brief Idle timer expired.
+ *
+ * Call periodically from a timer of lower priority than receive interrupt while
+ * a frame is being received. Frame ends if no bytes were fed since previous call,
+ * i.e. 1 to 2 timer periods after its last byte.
+ *
+ * @retval true if frame is still being received, arm idle timer again.
+ * @retval false if there is no frame being received.
+ */
+bool ri_comm_rx_frame_idle (void);
+
+/**
+ * @brief Return frame buffer for reception.
+ *
+ * @param[in] p_frame Frame given to @ref ri_comm_rx_frame_fp_t.
+ * @retval RD_SUCCESS on success.
+ * @retval RD_ERROR_NULL if p_frame is NULL.
+ * @retval RD_ERROR_INVALID_PARAM if p_frame is not a frame buffer.
+ * @retval RD_ERROR_INVALID_STATE if frame was already released.
+ */
+rd_status_t ri_comm_rx_frame_release (const uint8_t * const p_frame);
+
+/**
+ * @brief Get frame reception statistics.
+ *
+ * @param[out] p_stats Statistics since @ref ri_comm_rx_frame_init.
+ * @retval RD_SUCCESS on success.
+ * @retval RD_ERROR_NULL if p_stats is NULL.
+ */
+rd_status_t ri_comm_rx_frame_stats_get (ri_comm_rx_frame_stats_t * const p_stats);
+
+/**
+ * @brief Get end of frame detection of initialized frame reception.
+ *
+ * @param[out] p_mode Mode given to @ref ri_comm_rx_frame_init.
+ * @retval RD_SUCCESS on success.
+ * @retval RD_ERROR_NULL if p_mode is NULL.
+ * @retval RD_ERROR_INVALID_STATE if frame reception is not initialized.
+ */
+rd_status_t ri_comm_rx_frame_mode_get (ri_comm_rx_frame_mode_t * const p_mode);
+
+/**
+ * @brief Calculate CRC-16/CCITT-FALSE.
+ *
+ * Polynomial 0x1021, initial value 0xFFFF, no reflection.
+ *
+ * @param[in] p_data Data.
+ * @param[in] length Length of data.
+ * @return CRC of data, 0xFFFF if p_data is NULL.
+ */
+uint16_t ri_comm_rx_frame_crc16 (const uint8_t * const p_data, const size_t length);
+
+/*@}*/
+#endif
@@ -0,0 +1,210 @@
+/**
+ * @addtogroup Radio
+ */
+/*@{*/
+/**
+ * @file ruuvi_interface_communication_scan_schedule.c
+ * @author Otso Jousimaa <otso@ojousima.net>
+ * @date 2026-10-19
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ *
+ * Windows are selected with smooth weighted round robin: every turn each PHY
+ * gains its weight in credit, PHY with most credit is scanned and pays the sum
+ * of weights. Sum of credits stays 0, so weights may change between turns.
+ */
+#include "ruuvi_interface_communication_scan_schedule.h"
+#if RI_COMM_ENABLED
+#include <string.h>
+
+#define PHY_NONE        (RI_COMM_SCAN_SCHEDULE_PHYS) //!< No window selected.
+#define YIELD_SCALE     (256U * 1000U) //!< Reports per ms to reports per second, 1/256 units.
+#define YIELD_AVERAGING (4U)           //!< New window weighs 1/4 in average.
+
+static const ri_radio_modulation_t m_phys[RI_COMM_SCAN_SCHEDULE_PHYS] =
+{
+    RI_RADIO_BLE_1MBPS,
+    RI_RADIO_BLE_2MBPS,
+    RI_RADIO_BLE_125KBPS
+};
+
+/** @brief Set weights in use from yields once every enabled PHY has been scanned. */
+static void schedule_adapt (ri_comm_scan_schedule_t * const p_schedule)
+{
+    uint64_t score[RI_COMM_SCAN_SCHEDULE_PHYS] = {0};
+    uint64_t best = 0;
+    bool sampled = true;
+
+    for (uint8_t ii = 0; ii < RI_COMM_SCAN_SCHEDULE_PHYS; ii++)
+    {
+        if (0U != p_schedule->weight[ii])
+        {
+            sampled = sampled && (0U != p_schedule->stats[ii].windows);
+            score[ii] = (uint64_t) p_schedule->weight[ii] * p_schedule->yield[ii];
+            best = (score[ii] > best) ? score[ii] : best;
+        }
+    }
+
+    for (uint8_t ii = 0; ii < RI_COMM_SCAN_SCHEDULE_PHYS; ii++)
+    {
+        const uint8_t weight = p_schedule->weight[ii];
+
+        if ( (!sampled) || (0U == best) || (0U == weight))
+        {
+            // Nothing to compare yet, keep configured weights.
+            p_schedule->share[ii] = weight;
+        }
+        else
+        {
+            const uint8_t floor = (weight < RI_COMM_SCAN_SCHEDULE_MIN_SHARE) ?
+                                  weight : RI_COMM_SCAN_SCHEDULE_MIN_SHARE;
+            const uint8_t share = (uint8_t) ( (RI_COMM_SCAN_SCHEDULE_MAX_SHARE * score[ii]) / best);
+            p_schedule->share[ii] = (share < floor) ? floor : share;
+        }
+    }
+}
+
+rd_status_t ri_comm_scan_schedule_init (ri_comm_scan_schedule_t * const p_schedule,
+                                        const ri_comm_scan_schedule_init_t * const p_init)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if ( (NULL == p_schedule) || (NULL == p_init))
+    {
+        err_code |= RD_ERROR_NULL;
+    }
+    else if ( (0U == p_init->weight_1m) && (0U == p_init->weight_2m)
+              && (0U == p_init->weight_coded))
+    {
+        err_code |= RD_ERROR_INVALID_PARAM;
+    }
+    else
+    {
+        memset (p_schedule, 0, sizeof (ri_comm_scan_schedule_t));
+        p_schedule->weight[0] = p_init->weight_1m;
+        p_schedule->weight[1] = p_init->weight_2m;
+        p_schedule->weight[2] = p_init->weight_coded;
+        memcpy (p_schedule->share, p_schedule->weight, sizeof (p_schedule->share));
+        p_schedule->adaptive = p_init->adaptive;
+        p_schedule->current = PHY_NONE;
+    }
+
+    return err_code;
+}
+
+rd_status_t ri_comm_scan_schedule_next (ri_comm_scan_schedule_t * const p_schedule,
+                                        ri_radio_modulation_t * const p_modulation)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if ( (NULL == p_schedule) || (NULL == p_modulation))
+    {
+        err_code |= RD_ERROR_NULL;
+    }
+    else
+    {
+        int16_t total = 0;
+        uint8_t next = PHY_NONE;
+
+        for (uint8_t ii = 0; ii < RI_COMM_SCAN_SCHEDULE_PHYS; ii++)
+        {
+            if (0U != p_schedule->share[ii])
+            {
+                p_schedule->credit[ii] += p_schedule->share[ii];
+                total += p_schedule->share[ii];
+
+                if ( (PHY_NONE == next) || (p_schedule->credit[ii] > p_schedule->credit[next]))
+                {
+                    next = ii;
+                }
+            }
+        }
+
+        p_schedule->credit[next] -= total;
+        p_schedule->current = next;
+        *p_modulation = m_phys[next];
+    }
+
+    return err_code;
+}
+
+rd_status_t ri_comm_scan_schedule_window_done (ri_comm_scan_schedule_t * const p_schedule,
+        const uint32_t reports, const uint32_t scan_ms)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if (NULL == p_schedule)
+    {
+        err_code |= RD_ERROR_NULL;
+    }
+    else if (0U == scan_ms)
+    {
+        err_code |= RD_ERROR_INVALID_PARAM;
+    }
+    else if (PHY_NONE <= p_schedule->current)
+    {
+        err_code |= RD_ERROR_INVALID_STATE;
+    }
+    else
+    {
+        const uint8_t phy = p_schedule->current;
+        ri_comm_scan_schedule_stats_t * const p_stats = &p_schedule->stats[phy];
+        const uint64_t yield = ( (uint64_t) reports * YIELD_SCALE) / scan_ms;
+
+        if (0U == p_stats->windows)
+        {
+            p_schedule->yield[phy] = (uint32_t) yield;
+        }
+        else
+        {
+            p_schedule->yield[phy] = (uint32_t) ( ( (YIELD_AVERAGING - 1U) *
+                                                    (uint64_t) p_schedule->yield[phy] + yield) / YIELD_AVERAGING);
+        }
+
+        p_stats->reports += reports;
+        p_stats->scan_ms += scan_ms;
+        p_stats->windows++;
+        p_schedule->current = PHY_NONE;
+
+        if (p_schedule->adaptive)
+        {
+            schedule_adapt (p_schedule);
+        }
+    }
+
+    return err_code;
+}
+
+rd_status_t ri_comm_scan_schedule_stats_get (const ri_comm_scan_schedule_t * const
+        p_schedule, const ri_radio_modulation_t modulation,
+        ri_comm_scan_schedule_stats_t * const p_stats)
+{
+    rd_status_t err_code = RD_SUCCESS;
+    uint8_t phy = PHY_NONE;
+
+    for (uint8_t ii = 0; ii < RI_COMM_SCAN_SCHEDULE_PHYS; ii++)
+    {
+        if (modulation == m_phys[ii])
+        {
+            phy = ii;
+        }
+    }
+
+    if ( (NULL == p_schedule) || (NULL == p_stats))
+    {
+        err_code |= RD_ERROR_NULL;
+    }
+    else if (PHY_NONE == phy)
+    {
+        err_code |= RD_ERROR_INVALID_PARAM;
+    }
+    else
+    {
+        *p_stats = p_schedule->stats[phy];
+        p_stats->share = p_schedule->share[phy];
+    }
+
+    return err_code;
+}
+
+/*@}*/
+#endif
@@ -0,0 +1,125 @@
+#ifndef RUUVI_INTERFACE_COMMUNICATION_SCAN_SCHEDULE_H
+#define RUUVI_INTERFACE_COMMUNICATION_SCAN_SCHEDULE_H
+/**
+ * @addtogroup Radio
+ */
+/*@{*/
+/**
+ * @file ruuvi_interface_communication_scan_schedule.h
+ * @author Otso Jousimaa <otso@ojousima.net>
+ * @date 2026-10-19
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ *
+ * @brief Share scan time between 1 MBit/s, 2 MBit/s and Coded PHY windows.
+ *
+ * Scanner listens on one primary PHY at a time. A fleet of normal and long range
+ * tags is covered by alternating scan windows of each PHY, in proportion to
+ * their weights. Windows of each PHY are spread over the cycle rather than run
+ * back to back, e.g. weights 2:1:1 give 1M, 2M, Coded, 1M.
+ *
+ * In adaptive mode the weight in use follows reports received per scan time on
+ * each PHY multiplied by the configured weight, so scan time goes where reports
+ * come from. Each enabled PHY keeps at least @ref RI_COMM_SCAN_SCHEDULE_MIN_SHARE
+ * to notice when tags appear on it.
+ */
+#include "ruuvi_driver_enabled_modules.h"
+#include "ruuvi_driver_error.h"
+#include "ruuvi_interface_communication_radio.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/** @brief Number of scanned PHYs: 1 MBit/s, 2 MBit/s and Coded. */
+#define RI_COMM_SCAN_SCHEDULE_PHYS (3U)
+
+/** @brief Largest weight in use in adaptive mode. */
+#define RI_COMM_SCAN_SCHEDULE_MAX_SHARE (255U)
+
+#ifndef RI_COMM_SCAN_SCHEDULE_MIN_SHARE
+/** @brief Smallest weight in use in adaptive mode, unless configured weight is smaller. */
+#   define RI_COMM_SCAN_SCHEDULE_MIN_SHARE (16U)
+#endif
+
+/** @brief Scan schedule configuration. */
+typedef struct
+{
+    uint8_t weight_1m;    //!< Legacy advertisements at 1 MBit/s, 0 to not scan.
+    uint8_t weight_2m;    //!< Extended advertisements with 2 MBit/s secondary, 0 to not scan.
+    uint8_t weight_coded; //!< Long range advertisements at 125 kBit/s, 0 to not scan.
+    bool adaptive;        //!< Follow reports per scan time.
+} ri_comm_scan_schedule_init_t;
+
+/** @brief Scan results of one PHY. */
+typedef struct
+{
+    uint32_t reports; //!< Reports received in windows of this PHY.
+    uint32_t scan_ms; //!< Total length of windows of this PHY.
+    uint32_t windows; //!< Number of windows of this PHY.
+    uint8_t share;    //!< Weight in use.
+} ri_comm_scan_schedule_stats_t;
+
+/** @brief State of scan schedule, set up with @ref ri_comm_scan_schedule_init. */
+typedef struct
+{
+    uint8_t weight[RI_COMM_SCAN_SCHEDULE_PHYS];  //!< Configured weights.
+    uint8_t share[RI_COMM_SCAN_SCHEDULE_PHYS];   //!< Weights in use.
+    int16_t credit[RI_COMM_SCAN_SCHEDULE_PHYS];  //!< Turn of each PHY, highest goes next.
+    uint32_t yield[RI_COMM_SCAN_SCHEDULE_PHYS];  //!< Averaged reports per second, 1/256 units.
+    ri_comm_scan_schedule_stats_t stats[RI_COMM_SCAN_SCHEDULE_PHYS]; //!< Totals.
+    bool adaptive;                               //!< Follow reports per scan time.
+    uint8_t current;                             //!< PHY of ongoing window.
+} ri_comm_scan_schedule_t;
+
+/**
+ * @brief Set up a scan schedule.
+ *
+ * @param[out] p_schedule Schedule to initialize.
+ * @param[in] p_init Configuration.
+ * @retval RD_SUCCESS on success.
+ * @retval RD_ERROR_NULL if a pointer is NULL.
+ * @retval RD_ERROR_INVALID_PARAM if all weights are 0.
+ */
+rd_status_t ri_comm_scan_schedule_init (ri_comm_scan_schedule_t * const p_schedule,
+                                        const ri_comm_scan_schedule_init_t * const p_init);
+
+/**
+ * @brief Select PHY of next scan window.
+ *
+ * @param[in,out] p_schedule Schedule.
+ * @param[out] p_modulation PHY to scan: @ref RI_RADIO_BLE_1MBPS,
+ *                          @ref RI_RADIO_BLE_2MBPS or @ref RI_RADIO_BLE_125KBPS.
+ * @retval RD_SUCCESS on success.
+ * @retval RD_ERROR_NULL if a pointer is NULL.
+ */
+rd_status_t ri_comm_scan_schedule_next (ri_comm_scan_schedule_t * const p_schedule,
+                                        ri_radio_modulation_t * const p_modulation);
+
+/**
+ * @brief Record results of scan window selected by @ref ri_comm_scan_schedule_next.
+ *
+ * @param[in,out] p_schedule Schedule.
+ * @param[in] reports Reports received during window.
+ * @param[in] scan_ms Length of window.
+ * @retval RD_SUCCESS on success.
+ * @retval RD_ERROR_NULL if p_schedule is NULL.
+ * @retval RD_ERROR_INVALID_PARAM if scan_ms is 0.
+ * @retval RD_ERROR_INVALID_STATE if no window was selected.
+ */
+rd_status_t ri_comm_scan_schedule_window_done (ri_comm_scan_schedule_t * const p_schedule,
+        const uint32_t reports, const uint32_t scan_ms);
+
+/**
+ * @brief Get scan results of a PHY.
+ *
+ * @param[in] p_schedule Schedule.
+ * @param[in] modulation PHY.
+ * @param[out] p_stats Results since @ref ri_comm_scan_schedule_init.
+ * @retval RD_SUCCESS on success.
+ * @retval RD_ERROR_NULL if a pointer is NULL.
+ * @retval RD_ERROR_INVALID_PARAM if modulation is not a scanned PHY.
+ */
+rd_status_t ri_comm_scan_schedule_stats_get (const ri_comm_scan_schedule_t * const
+        p_schedule, const ri_radio_modulation_t modulation,
+        ri_comm_scan_schedule_stats_t * const p_stats);
+
+/*@}*/
+#endif
@@ -0,0 +1,79 @@
+/**
+ * @addtogroup Radio
+ */
+/*@{*/
+/**
+ * @file ruuvi_interface_communication_tx_gate.c
+ * @author Otso Jousimaa <otso@ojousima.net>
+ * @date 2026-10-19
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ */
+#include "ruuvi_interface_communication_tx_gate.h"
+#if RI_COMM_ENABLED
+
+rd_status_t ri_comm_tx_gate_kick (ri_comm_tx_gate_t * const p_gate)
+{
+    rd_status_t err_code = RD_SUCCESS;
+    bool check_queue = true;
+
+    if ( (NULL == p_gate) || (NULL == p_gate->pending) || (NULL == p_gate->start))
+    {
+        err_code |= RD_ERROR_NULL;
+        check_queue = false;
+    }
+
+    // Each failed start removes a message, loop ends once queue is empty.
+    while (check_queue)
+    {
+        check_queue = false;
+
+        if (p_gate->pending() && ri_atomic_flag (&p_gate->owned, true))
+        {
+            const rd_status_t start_status = p_gate->start();
+
+            if (RD_ERROR_BUSY == start_status)
+            {
+                // Retrying here would spin over preempted writer, writer kicks again.
+                (void) ri_atomic_flag (&p_gate->owned, false);
+            }
+            else if (RD_SUCCESS != start_status)
+            {
+                (void) ri_atomic_flag (&p_gate->owned, false);
+                // Message may have been queued while gate was owned here.
+                check_queue = true;
+
+                if (RD_ERROR_NOT_FOUND != start_status)
+                {
+                    err_code |= start_status;
+                }
+            }
+            else
+            {
+                // Started, owned until released.
+            }
+        }
+    }
+
+    return err_code;
+}
+
+bool ri_comm_tx_gate_acquire (ri_comm_tx_gate_t * const p_gate)
+{
+    return (NULL != p_gate) && ri_atomic_flag (&p_gate->owned, true);
+}
+
+void ri_comm_tx_gate_release (ri_comm_tx_gate_t * const p_gate)
+{
+    if (NULL != p_gate)
+    {
+        (void) ri_atomic_flag (&p_gate->owned, false);
+    }
+}
+
+bool ri_comm_tx_gate_is_busy (const ri_comm_tx_gate_t * const p_gate)
+{
+    return (NULL != p_gate) && (0U != p_gate->owned);
+}
+
+/*@}*/
+#endif
@@ -0,0 +1,101 @@
+#ifndef RUUVI_INTERFACE_COMMUNICATION_TX_GATE_H
+#define RUUVI_INTERFACE_COMMUNICATION_TX_GATE_H
+/**
+ * @addtogroup Radio
+ */
+/*@{*/
+/**
+ * @file ruuvi_interface_communication_tx_gate.h
+ * @author Otso Jousimaa <otso@ojousima.net>
+ * @date 2026-10-19
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ *
+ * @brief Hand a single transmitter over between thread and interrupt context.
+ *
+ * Messages are queued in thread context and the transmitter is restarted from
+ * interrupt once previous message is done. Gate tracks ownership of the transmitter
+ * in one atomic flag: only the context which sets the flag may start a message, and
+ * the flag is cleared once the message is done.
+ *
+ * Whoever clears the flag checks the queue again with @ref ri_comm_tx_gate_kick.
+ * Message queued while another context owned the transmitter is therefore
+ * picked up either by the queuing context or by the owner on release,
+ * messages are not started twice and not left in queue.
+ */
+#include "ruuvi_driver_enabled_modules.h"
+#include "ruuvi_driver_error.h"
+#include "ruuvi_interface_atomic.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * @brief Check if messages are queued.
+ *
+ * @return true if at least one message is queued.
+ */
+typedef bool (*ri_comm_tx_gate_pending_fp_t) (void);
+
+/**
+ * @brief Remove next message from queue and start sending it.
+ *
+ * Called only by owner of gate. Message must be removed from queue even if
+ * it cannot be started.
+ *
+ * @retval RD_SUCCESS if message is being sent, gate stays owned until
+ *                    @ref ri_comm_tx_gate_release.
+ * @retval RD_ERROR_NOT_FOUND if queue was empty.
+ * @retval RD_ERROR_BUSY if message is being written by a context which this one
+ *                       preempted, writer calls @ref ri_comm_tx_gate_kick when done.
+ * @return error code of failed start, message was dropped.
+ */
+typedef rd_status_t (*ri_comm_tx_gate_start_fp_t) (void);
+
+/** @brief Transmitter shared between contexts. */
+typedef struct
+{
+    ri_atomic_t owned;                     //!< Set while a message is being started or sent.
+    ri_comm_tx_gate_pending_fp_t pending;  //!< Check queue.
+    ri_comm_tx_gate_start_fp_t start;      //!< Start next message.
+} ri_comm_tx_gate_t;
+
+/**
+ * @brief Start next queued message if transmitter is free.
+ *
+ * Safe to call from any context after queuing a message and after releasing gate.
+ * If transmitter is owned by another context, returns immediately and the owner
+ * starts the message on release.
+ *
+ * @param[in] p_gate Gate of transmitter.
+ * @retval RD_SUCCESS if a message was started, transmitter was busy or queue was empty.
+ * @retval RD_ERROR_NULL if p_gate or its functions are NULL.
+ * @return error code of dropped message if start failed.
+ */
+rd_status_t ri_comm_tx_gate_kick (ri_comm_tx_gate_t * const p_gate);
+
+/**
+ * @brief Take transmitter for something else than queued messages.
+ *
+ * @param[in] p_gate Gate of transmitter.
+ * @return true if transmitter was free and is now owned by caller.
+ */
+bool ri_comm_tx_gate_acquire (ri_comm_tx_gate_t * const p_gate);
+
+/**
+ * @brief Mark transmitter free.
+ *
+ * Call @ref ri_comm_tx_gate_kick afterwards to start messages queued meanwhile.
+ *
+ * @param[in] p_gate Gate of transmitter.
+ */
+void ri_comm_tx_gate_release (ri_comm_tx_gate_t * const p_gate);
+
+/**
+ * @brief Check if transmitter is owned.
+ *
+ * @param[in] p_gate Gate of transmitter.
+ * @return true if a message is being started or sent, false if p_gate is NULL.
+ */
+bool ri_comm_tx_gate_is_busy (const ri_comm_tx_gate_t * const p_gate);
+
+/*@}*/
+#endif
@@ -39,6 +39,21 @@ typedef struct
     ri_gpio_id_t tx;     //!< TX pin.
     ri_gpio_id_t rx;     //!< RX pin.
     ri_uart_baudrate_t baud; //!< @ref ri_uart_baudrate_t.
+    /**
+     * @brief Milliseconds a batch may wait for more messages before it is sent.
+     *
+     * Used only if @ref RI_UART_BATCH_ENABLED. At 0 a batch is sent right away if
+     * UART is free and messages accumulate only while previous batch is sent.
+     */
+    uint16_t batch_flush_ms;
+    /**
+     * @brief Milliseconds of idle line which end a received frame.
+     *
+     * Used only if @ref RI_UART_RX_FRAME_ENABLED and frames end on idle line,
+     * see @ref ri_comm_rx_frame_init. Must not be 0 in idle mode. Until frame
+     * reception is set up, received lines are passed as @ref RI_COMM_RECEIVED.
+     */
+    uint16_t rx_idle_ms;
 } ri_uart_init_t;
 
 /**
@@ -60,6 +75,7 @@ rd_status_t ri_uart_init (ri_comm_channel_t * const channel);
  * @param[out] config Interface used for communicating through uart.
  * @retval RD_SUCCESS on success.
  * @retval RD_ERROR_NULL Channel is NULL.
+ * @retval RD_ERROR_INVALID_PARAM if RX frames end on idle line and rx_idle_ms is 0.
  */
 rd_status_t ri_uart_config (const ri_uart_init_t * const config);
 
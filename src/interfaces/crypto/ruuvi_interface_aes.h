@@ -31,6 +31,7 @@
  *  @brief encrypt a block with AES ECB 128 encryption
  *
  * This call takes 16-byte divisible data as input and encrypts it with AES Electronic Codebook.
+ * Cleartext and ciphertext may be the same buffer.
  *
  * @param[in] cleartext Data to encrypt. Must have 16-byte divisible length.
  * @param[out] ciphertext Encryped data output
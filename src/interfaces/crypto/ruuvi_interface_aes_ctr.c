@@ -0,0 +1,412 @@
+#include "ruuvi_driver_enabled_modules.h"
+#if RI_AES_CTR_ENABLED
+/**
+ * @addtogroup Crypto
+ */
+/** @{ */
+/**
+ * @file ruuvi_interface_aes_ctr.c
+ * @author Otso Jousimaa <otso@ojousima.net>
+ * @date 2026-10-18
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ *
+ * Platform independent CTR and CCM modes, block cipher is provided by
+ * @ref ri_aes_ecb_128_encrypt of the platform.
+ *
+ */
+#include "ruuvi_driver_error.h"
+#include "ruuvi_interface_aes.h"
+#include "ruuvi_interface_aes_ctr.h"
+#include <string.h>
+
+#define CCM_FLAGS_L        (1U)    //!< Encoded length field size L - 1, L = 2.
+#define CCM_FLAGS_ADATA    (0x40U) //!< B0 flag of additional data.
+#define CCM_TAG_MIN        (4U)    //!< Shortest CCM tag.
+#define CCM_NONCE_OFFSET   (1U)    //!< Position of nonce in B0 and counter blocks.
+#define CCM_LENGTH_OFFSET  (14U)   //!< Position of length or counter in B0 and counter blocks.
+#define KEYSTREAM_CAPACITY (RI_AES_CTR_KEYSTREAM_BLOCKS * RI_AES_BLOCK_SIZE)
+
+_Static_assert (RI_AES_CTR_KEYSTREAM_BLOCKS > 0U,
+                "RI_AES_CTR_KEYSTREAM_BLOCKS must be at least 1");
+
+/** @brief CBC-MAC state. */
+typedef struct
+{
+    uint8_t x[RI_AES_BLOCK_SIZE]; //!< Chaining value with partial block XORed in.
+    size_t fill;                  //!< Bytes XORed into current block.
+    const uint8_t * key;          //!< Encryption key.
+} cbc_mac_t;
+
+static void counter_increment (uint8_t * const counter)
+{
+    for (size_t ii = RI_AES_BLOCK_SIZE; ii > 0U; ii--)
+    {
+        counter[ii - 1U]++;
+
+        if (0U != counter[ii - 1U])
+        {
+            break;
+        }
+    }
+}
+
+/**
+ * @brief Append up to max_blocks of keystream.
+ *
+ * Counter blocks are written to keystream buffer and encrypted in place with a single call.
+ */
+static rd_status_t keystream_fill (ri_aes_ctr_t * const p_ctx, const size_t max_blocks)
+{
+    rd_status_t err_code = RD_SUCCESS;
+    uint8_t counter[RI_AES_BLOCK_SIZE];
+
+    if ( (0U < p_ctx->offset) && (0U < p_ctx->available))
+    {
+        memmove (p_ctx->keystream, p_ctx->keystream + p_ctx->offset, p_ctx->available);
+    }
+
+    p_ctx->offset = 0;
+    size_t blocks = (KEYSTREAM_CAPACITY - p_ctx->available) / RI_AES_BLOCK_SIZE;
+    blocks = (blocks < max_blocks) ? blocks : max_blocks;
+
+    if (0U < blocks)
+    {
+        uint8_t * const p_block = p_ctx->keystream + p_ctx->available;
+        memcpy (counter, p_ctx->counter, sizeof (counter));
+
+        for (size_t ii = 0; ii < blocks; ii++)
+        {
+            memcpy (p_block + (ii * RI_AES_BLOCK_SIZE), p_ctx->counter, RI_AES_BLOCK_SIZE);
+            counter_increment (p_ctx->counter);
+        }
+
+        err_code |= ri_aes_ecb_128_encrypt (p_block, p_block, p_ctx->key,
+                                            blocks * RI_AES_BLOCK_SIZE);
+
+        if (RD_SUCCESS == err_code)
+        {
+            p_ctx->available += blocks * RI_AES_BLOCK_SIZE;
+        }
+        else
+        {
+            // Counter blocks were not used.
+            memcpy (p_ctx->counter, counter, sizeof (counter));
+        }
+    }
+
+    return err_code;
+}
+
+rd_status_t ri_aes_ctr_init (ri_aes_ctr_t * const p_ctx, const uint8_t * const key,
+                             const uint8_t * const counter)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if ( (NULL == p_ctx) || (NULL == key) || (NULL == counter))
+    {
+        err_code |= RD_ERROR_NULL;
+    }
+    else
+    {
+        memset (p_ctx, 0, sizeof (ri_aes_ctr_t));
+        memcpy (p_ctx->key, key, RI_AES_128_KEY_SIZE);
+        memcpy (p_ctx->counter, counter, RI_AES_BLOCK_SIZE);
+    }
+
+    return err_code;
+}
+
+rd_status_t ri_aes_ctr_precompute (ri_aes_ctr_t * const p_ctx)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if (NULL == p_ctx)
+    {
+        err_code |= RD_ERROR_NULL;
+    }
+    else
+    {
+        err_code |= keystream_fill (p_ctx, RI_AES_CTR_KEYSTREAM_BLOCKS);
+    }
+
+    return err_code;
+}
+
+void ri_aes_ctr_uninit (ri_aes_ctr_t * const p_ctx)
+{
+    if (NULL != p_ctx)
+    {
+        memset (p_ctx, 0, sizeof (ri_aes_ctr_t));
+    }
+}
+
+size_t ri_aes_ctr_available (const ri_aes_ctr_t * const p_ctx)
+{
+    return (NULL == p_ctx) ? 0U : p_ctx->available;
+}
+
+rd_status_t ri_aes_ctr_crypt (ri_aes_ctr_t * const p_ctx, const uint8_t * const input,
+                              uint8_t * const output, const size_t length)
+{
+    rd_status_t err_code = RD_SUCCESS;
+    size_t done = 0;
+
+    if ( (NULL == p_ctx) || (NULL == input) || (NULL == output))
+    {
+        err_code |= RD_ERROR_NULL;
+    }
+
+    while ( (RD_SUCCESS == err_code) && (done < length))
+    {
+        if (0U == p_ctx->available)
+        {
+            // Underrun, generate only the blocks needed.
+            const size_t remaining = length - done;
+            err_code |= keystream_fill (p_ctx, (remaining + RI_AES_BLOCK_SIZE - 1U)
+                                        / RI_AES_BLOCK_SIZE);
+        }
+        else
+        {
+            const size_t remaining = length - done;
+            const size_t chunk = (remaining < p_ctx->available) ? remaining : p_ctx->available;
+            const uint8_t * const p_ks = p_ctx->keystream + p_ctx->offset;
+
+            for (size_t ii = 0; ii < chunk; ii++)
+            {
+                output[done + ii] = input[done + ii] ^ p_ks[ii];
+            }
+
+            p_ctx->offset += chunk;
+            p_ctx->available -= chunk;
+            done += chunk;
+        }
+    }
+
+    return err_code;
+}
+
+static rd_status_t mac_absorb (cbc_mac_t * const p_mac, const uint8_t * const data,
+                               const size_t length)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    for (size_t ii = 0; (ii < length) && (RD_SUCCESS == err_code); ii++)
+    {
+        p_mac->x[p_mac->fill] ^= data[ii];
+        p_mac->fill++;
+
+        if (RI_AES_BLOCK_SIZE == p_mac->fill)
+        {
+            err_code |= ri_aes_ecb_128_encrypt (p_mac->x, p_mac->x, p_mac->key,
+                                                RI_AES_BLOCK_SIZE);
+            p_mac->fill = 0;
+        }
+    }
+
+    return err_code;
+}
+
+/** @brief Zero-pad partial block. */
+static rd_status_t mac_pad (cbc_mac_t * const p_mac)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if (0U < p_mac->fill)
+    {
+        err_code |= ri_aes_ecb_128_encrypt (p_mac->x, p_mac->x, p_mac->key,
+                                            RI_AES_BLOCK_SIZE);
+        p_mac->fill = 0;
+    }
+
+    return err_code;
+}
+
+/**
+ * @brief Compute CBC-MAC of formatted CCM input, SP 800-38C A.2.
+ */
+static rd_status_t ccm_mac (const ri_aes_ccm_t * const p_ctx,
+                            const uint8_t * const aad, const size_t aad_length,
+                            const uint8_t * const data, const size_t length,
+                            const size_t tag_length, uint8_t * const mac)
+{
+    rd_status_t err_code = RD_SUCCESS;
+    uint8_t b0[RI_AES_BLOCK_SIZE];
+    cbc_mac_t state = {0};
+    state.key = p_ctx->ctr.key;
+    b0[0] = (uint8_t) ( ( (0U < aad_length) ? CCM_FLAGS_ADATA : 0U)
+                        | ( ( (tag_length - 2U) / 2U) << 3U)
+                        | CCM_FLAGS_L);
+    memcpy (b0 + CCM_NONCE_OFFSET, p_ctx->nonce, RI_AES_CCM_NONCE_LENGTH);
+    b0[CCM_LENGTH_OFFSET] = (uint8_t) (length >> 8U);
+    b0[CCM_LENGTH_OFFSET + 1U] = (uint8_t) length;
+    err_code |= mac_absorb (&state, b0, sizeof (b0));
+
+    if (0U < aad_length)
+    {
+        const uint8_t aad_encoded[2] = { (uint8_t) (aad_length >> 8U), (uint8_t) aad_length };
+        err_code |= mac_absorb (&state, aad_encoded, sizeof (aad_encoded));
+        err_code |= mac_absorb (&state, aad, aad_length);
+        err_code |= mac_pad (&state);
+    }
+
+    err_code |= mac_absorb (&state, data, length);
+    err_code |= mac_pad (&state);
+    memcpy (mac, state.x, RI_AES_BLOCK_SIZE);
+    return err_code;
+}
+
+static rd_status_t ccm_check (const ri_aes_ccm_t * const p_ctx,
+                              const uint8_t * const aad, const size_t aad_length,
+                              const uint8_t * const input, const uint8_t * const output,
+                              const size_t length,
+                              const uint8_t * const tag, const size_t tag_length)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if ( (NULL == p_ctx) || (NULL == tag)
+            || ( (0U < aad_length) && (NULL == aad))
+            || ( (0U < length) && ( (NULL == input) || (NULL == output))))
+    {
+        err_code |= RD_ERROR_NULL;
+    }
+    else if ( (RI_AES_CCM_MAX_AAD < aad_length)
+              || (RI_AES_CCM_MAX_LENGTH < length)
+              || (CCM_TAG_MIN > tag_length)
+              || (RI_AES_BLOCK_SIZE < tag_length)
+              || (0U != (tag_length % 2U)))
+    {
+        err_code |= RD_ERROR_INVALID_LENGTH;
+    }
+    else if (p_ctx->used)
+    {
+        err_code |= RD_ERROR_INVALID_STATE;
+    }
+    else
+    {
+        // No action needed.
+    }
+
+    return err_code;
+}
+
+rd_status_t ri_aes_ccm_init (ri_aes_ccm_t * const p_ctx, const uint8_t * const key,
+                             const uint8_t * const nonce)
+{
+    rd_status_t err_code = RD_SUCCESS;
+    uint8_t a0[RI_AES_BLOCK_SIZE] = {0};
+
+    if ( (NULL == p_ctx) || (NULL == key) || (NULL == nonce))
+    {
+        err_code |= RD_ERROR_NULL;
+    }
+    else
+    {
+        // Counter block A0, keystream block S0 encrypts tag and S1... payload.
+        a0[0] = CCM_FLAGS_L;
+        memcpy (a0 + CCM_NONCE_OFFSET, nonce, RI_AES_CCM_NONCE_LENGTH);
+        err_code |= ri_aes_ctr_init (&p_ctx->ctr, key, a0);
+        memcpy (p_ctx->nonce, nonce, RI_AES_CCM_NONCE_LENGTH);
+        p_ctx->used = false;
+    }
+
+    return err_code;
+}
+
+rd_status_t ri_aes_ccm_precompute (ri_aes_ccm_t * const p_ctx)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if (NULL == p_ctx)
+    {
+        err_code |= RD_ERROR_NULL;
+    }
+    else if (p_ctx->used)
+    {
+        err_code |= RD_ERROR_INVALID_STATE;
+    }
+    else
+    {
+        err_code |= ri_aes_ctr_precompute (&p_ctx->ctr);
+    }
+
+    return err_code;
+}
+
+rd_status_t ri_aes_ccm_encrypt (ri_aes_ccm_t * const p_ctx,
+                                const uint8_t * const aad, const size_t aad_length,
+                                const uint8_t * const input, uint8_t * const output,
+                                const size_t length,
+                                uint8_t * const tag, const size_t tag_length)
+{
+    uint8_t mac[RI_AES_BLOCK_SIZE];
+    rd_status_t err_code = ccm_check (p_ctx, aad, aad_length, input, output, length,
+                                      tag, tag_length);
+
+    if (RD_SUCCESS == err_code)
+    {
+        p_ctx->used = true;
+        // MAC over cleartext before output may overwrite it.
+        err_code |= ccm_mac (p_ctx, aad, aad_length, input, length, tag_length, mac);
+        err_code |= ri_aes_ctr_crypt (&p_ctx->ctr, mac, mac, sizeof (mac));
+
+        if (0U < length)
+        {
+            err_code |= ri_aes_ctr_crypt (&p_ctx->ctr, input, output, length);
+        }
+
+        memcpy (tag, mac, tag_length);
+        // Nonce is spent, key and keystream are not needed anymore.
+        ri_aes_ctr_uninit (&p_ctx->ctr);
+    }
+
+    return err_code;
+}
+
+rd_status_t ri_aes_ccm_decrypt (ri_aes_ccm_t * const p_ctx,
+                                const uint8_t * const aad, const size_t aad_length,
+                                const uint8_t * const input, uint8_t * const output,
+                                const size_t length,
+                                const uint8_t * const tag, const size_t tag_length)
+{
+    uint8_t s0[RI_AES_BLOCK_SIZE] = {0};
+    uint8_t mac[RI_AES_BLOCK_SIZE];
+    uint8_t diff = 0;
+    rd_status_t err_code = ccm_check (p_ctx, aad, aad_length, input, output, length,
+                                      tag, tag_length);
+
+    if (RD_SUCCESS == err_code)
+    {
+        p_ctx->used = true;
+        err_code |= ri_aes_ctr_crypt (&p_ctx->ctr, s0, s0, sizeof (s0));
+
+        if (0U < length)
+        {
+            err_code |= ri_aes_ctr_crypt (&p_ctx->ctr, input, output, length);
+        }
+
+        err_code |= ccm_mac (p_ctx, aad, aad_length, output, length, tag_length, mac);
+
+        // Compare whole tag regardless of mismatch position.
+        for (size_t ii = 0; ii < tag_length; ii++)
+        {
+            diff |= (uint8_t) ( (mac[ii] ^ s0[ii]) ^ tag[ii]);
+        }
+
+        if (0U != diff)
+        {
+            err_code |= RD_ERROR_INVALID_DATA;
+        }
+
+        if ( (RD_SUCCESS != err_code) && (0U < length))
+        {
+            memset (output, 0, length);
+        }
+
+        ri_aes_ctr_uninit (&p_ctx->ctr);
+    }
+
+    return err_code;
+}
+
+/** @} */
+#endif
@@ -0,0 +1,215 @@
+#ifndef RUUVI_INTERFACE_AES_CTR_H
+#define RUUVI_INTERFACE_AES_CTR_H
+/**
+ * @addtogroup Crypto
+ */
+/** @{ */
+/**
+ * @file ruuvi_interface_aes_ctr.h
+ * @author Otso Jousimaa <otso@ojousima.net>
+ * @date 2026-10-18
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ *
+ * AES-128 CTR stream encryption and CCM authenticated encryption on top of
+ * @ref ri_aes_ecb_128_encrypt.
+ *
+ * Keystream does not depend on data, so blocks can be generated while application
+ * is idle with @ref ri_aes_ctr_precompute. Encryption on the hot path is then
+ * an XOR against precomputed keystream. If there is not enough keystream
+ * precomputed, missing blocks are generated synchronously.
+ *
+ * CCM follows NIST SP 800-38C with 13-byte nonce and 2-byte length field,
+ * i.e. RFC 3610 with L = 2. Keystream of CCM is precomputed the same way,
+ * CBC-MAC depends on data and takes one ECB block per 16 bytes of input.
+ *
+ * Typical usage:
+ *
+ * @code{.c}
+ *  ri_aes_ccm_t ccm;
+ *  uint8_t tag[8];
+ *  err_code |= ri_aes_ccm_init (&ccm, key, nonce);
+ *  // Idle time.
+ *  err_code |= ri_aes_ccm_precompute (&ccm);
+ *  // Hot path.
+ *  err_code |= ri_aes_ccm_encrypt (&ccm, header, sizeof (header),
+ *                                  payload, payload, sizeof (payload),
+ *                                  tag, sizeof (tag));
+ * @endcode
+ */
+
+#include "ruuvi_driver_enabled_modules.h"
+#include "ruuvi_driver_error.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define RI_AES_BLOCK_SIZE       (16U)     //!< Bytes in AES block.
+#define RI_AES_128_KEY_SIZE     (16U)     //!< Bytes in AES-128 key.
+#define RI_AES_CCM_NONCE_LENGTH (13U)     //!< Bytes in CCM nonce.
+#define RI_AES_CCM_MAX_LENGTH   (0xFFFFU) //!< Maximum CCM payload length.
+#define RI_AES_CCM_MAX_AAD      (0xFEFFU) //!< Maximum CCM additional data length.
+
+#ifndef RI_AES_CTR_KEYSTREAM_BLOCKS
+/** @brief Number of keystream blocks precomputed per context. */
+#   define RI_AES_CTR_KEYSTREAM_BLOCKS (4U)
+#endif
+
+/** @brief CTR mode context. Contents are private to implementation. */
+typedef struct
+{
+    uint8_t key[RI_AES_128_KEY_SIZE];     //!< Encryption key.
+    uint8_t counter[RI_AES_BLOCK_SIZE];   //!< Next counter block to encrypt.
+    uint8_t keystream[RI_AES_CTR_KEYSTREAM_BLOCKS * RI_AES_BLOCK_SIZE]; //!< Precomputed keystream.
+    size_t offset;                        //!< First unused byte of keystream.
+    size_t available;                     //!< Unused bytes of keystream.
+} ri_aes_ctr_t;
+
+/** @brief CCM mode context for one message. Contents are private to implementation. */
+typedef struct
+{
+    ri_aes_ctr_t ctr;                          //!< Keystream, starts at counter 0.
+    uint8_t nonce[RI_AES_CCM_NONCE_LENGTH];    //!< Nonce of message.
+    bool used;                                 //!< Message was processed, nonce is spent.
+} ri_aes_ccm_t;
+
+/**
+ * @brief Initialize CTR context.
+ *
+ * Counter block is incremented as a 128-bit big-endian integer,
+ * as in NIST SP 800-38A.
+ *
+ * @param[out] p_ctx Context to initialize.
+ * @param[in] key 16-byte key.
+ * @param[in] counter 16-byte initial counter block.
+ * @retval RD_SUCCESS on success.
+ * @retval RD_ERROR_NULL if any pointer is NULL.
+ */
+rd_status_t ri_aes_ctr_init (ri_aes_ctr_t * const p_ctx, const uint8_t * const key,
+                             const uint8_t * const counter);
+
+/**
+ * @brief Fill keystream of context.
+ *
+ * Call while idle, all missing blocks are generated with one
+ * @ref ri_aes_ecb_128_encrypt call.
+ *
+ * @param[in,out] p_ctx Context to fill.
+ * @retval RD_SUCCESS on success, also if keystream was already full.
+ * @retval RD_ERROR_NULL if p_ctx is NULL.
+ * @return Error code from @ref ri_aes_ecb_128_encrypt.
+ */
+rd_status_t ri_aes_ctr_precompute (ri_aes_ctr_t * const p_ctx);
+
+/**
+ * @brief Clear key, counter and keystream of CTR context.
+ *
+ * Call once the stream is complete. Context must be initialized again before use.
+ *
+ * @param[out] p_ctx Context to clear, NULL is ignored.
+ */
+void ri_aes_ctr_uninit (ri_aes_ctr_t * const p_ctx);
+
+/**
+ * @brief Get number of precomputed keystream bytes.
+ *
+ * @param[in] p_ctx Context to check.
+ * @return Bytes which can be encrypted without calling AES, 0 if p_ctx is NULL.
+ */
+size_t ri_aes_ctr_available (const ri_aes_ctr_t * const p_ctx);
+
+/**
+ * @brief Encrypt or decrypt data.
+ *
+ * Keystream continues from previous call. Missing keystream is generated
+ * synchronously, which adds latency of ECB encryption.
+ *
+ * @param[in,out] p_ctx Context to use.
+ * @param[in] input Data to encrypt or decrypt.
+ * @param[out] output Result, may be same as input.
+ * @param[in] length Bytes to process.
+ * @retval RD_SUCCESS on success.
+ * @retval RD_ERROR_NULL if any pointer is NULL.
+ * @return Error code from @ref ri_aes_ecb_128_encrypt.
+ */
+rd_status_t ri_aes_ctr_crypt (ri_aes_ctr_t * const p_ctx, const uint8_t * const input,
+                              uint8_t * const output, const size_t length);
+
+/**
+ * @brief Initialize CCM context for one message.
+ *
+ * Nonce must never repeat with the same key.
+ *
+ * @param[out] p_ctx Context to initialize.
+ * @param[in] key 16-byte key.
+ * @param[in] nonce 13-byte nonce.
+ * @retval RD_SUCCESS on success.
+ * @retval RD_ERROR_NULL if any pointer is NULL.
+ */
+rd_status_t ri_aes_ccm_init (ri_aes_ccm_t * const p_ctx, const uint8_t * const key,
+                             const uint8_t * const nonce);
+
+/**
+ * @brief Fill keystream of CCM context, see @ref ri_aes_ctr_precompute.
+ *
+ * @param[in,out] p_ctx Context to fill.
+ * @retval RD_SUCCESS on success.
+ * @retval RD_ERROR_NULL if p_ctx is NULL.
+ * @retval RD_ERROR_INVALID_STATE if message was already processed.
+ * @return Error code from @ref ri_aes_ecb_128_encrypt.
+ */
+rd_status_t ri_aes_ccm_precompute (ri_aes_ccm_t * const p_ctx);
+
+/**
+ * @brief Encrypt and authenticate a message.
+ *
+ * Key and keystream are cleared from context once message was processed.
+ *
+ * @param[in,out] p_ctx Context initialized for this message.
+ * @param[in] aad Additional data to authenticate, may be NULL if aad_length is 0.
+ * @param[in] aad_length Bytes of additional data, at most @ref RI_AES_CCM_MAX_AAD.
+ * @param[in] input Cleartext.
+ * @param[out] output Ciphertext, may be same as input.
+ * @param[in] length Bytes of cleartext, at most @ref RI_AES_CCM_MAX_LENGTH.
+ * @param[out] tag Authentication tag.
+ * @param[in] tag_length Bytes of tag, one of 4, 6, 8, 10, 12, 14, 16.
+ * @retval RD_SUCCESS on success.
+ * @retval RD_ERROR_NULL if any required pointer is NULL.
+ * @retval RD_ERROR_INVALID_LENGTH if a length is not supported.
+ * @retval RD_ERROR_INVALID_STATE if nonce of context was already used.
+ * @return Error code from @ref ri_aes_ecb_128_encrypt.
+ */
+rd_status_t ri_aes_ccm_encrypt (ri_aes_ccm_t * const p_ctx,
+                                const uint8_t * const aad, const size_t aad_length,
+                                const uint8_t * const input, uint8_t * const output,
+                                const size_t length,
+                                uint8_t * const tag, const size_t tag_length);
+
+/**
+ * @brief Decrypt and verify a message.
+ *
+ * Output is cleared if tag does not match. Key and keystream are cleared
+ * from context once message was processed.
+ *
+ * @param[in,out] p_ctx Context initialized for this message.
+ * @param[in] aad Additional data to authenticate, may be NULL if aad_length is 0.
+ * @param[in] aad_length Bytes of additional data, at most @ref RI_AES_CCM_MAX_AAD.
+ * @param[in] input Ciphertext.
+ * @param[out] output Cleartext, may be same as input.
+ * @param[in] length Bytes of ciphertext, at most @ref RI_AES_CCM_MAX_LENGTH.
+ * @param[in] tag Authentication tag of message.
+ * @param[in] tag_length Bytes of tag, one of 4, 6, 8, 10, 12, 14, 16.
+ * @retval RD_SUCCESS on success.
+ * @retval RD_ERROR_NULL if any required pointer is NULL.
+ * @retval RD_ERROR_INVALID_LENGTH if a length is not supported.
+ * @retval RD_ERROR_INVALID_STATE if nonce of context was already used.
+ * @retval RD_ERROR_INVALID_DATA if tag does not match.
+ * @return Error code from @ref ri_aes_ecb_128_encrypt.
+ */
+rd_status_t ri_aes_ccm_decrypt (ri_aes_ccm_t * const p_ctx,
+                                const uint8_t * const aad, const size_t aad_length,
+                                const uint8_t * const input, uint8_t * const output,
+                                const size_t length,
+                                const uint8_t * const tag, const size_t tag_length);
+
+/** @} */
+#endif // RUUVI_INTERFACE_AES_CTR_H
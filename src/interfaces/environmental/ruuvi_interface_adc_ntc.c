@@ -71,6 +71,125 @@
 #define ADC_K_TO_C_CONST          273.15f
 #define ADC_NTC_DEFAULT_TEMP_K    (ADC_NTC_DEFAULT_TEMP + ADC_K_TO_C_CONST)
 
+/**
+ * @brief Number of segments in ratio-to-temperature lookup table, power of two.
+ *
+ * Knots are evenly spaced in ratio, knots at ratio 0.0 and 1.0 are singular and
+ * left out. Ratios outside first and last knot are clamped, with default constants
+ * these are above +195 C and below -54 C.
+ * With 128 segments interpolation error is below 0.35 C from -40 C to +125 C
+ * and below 0.05 C from -20 C to +85 C.
+ */
+#define ADC_NTC_LUT_SIZE          (128U)
+#define ADC_NTC_LUT_CENTI         (100.0)  //!< Knots are stored in 0.01 C.
+#define ADC_NTC_LUT_OFFSET_C      (300.0)  //!< Keeps knots positive for rounding.
+
+/*
+ * Lookup table is generated by the compiler from the NTC constants.
+ * Natural logarithm is evaluated as constant expression: argument is scaled by
+ * nearest power of two into [1/sqrt(2), sqrt(2)) and remainder is expanded as
+ * ln(m) = 2 * atanh((m - 1) / (m + 1)), which converges to 1e-9 in five terms.
+ * Supported argument range is 2^-12 ... 2^12, i.e. balance resistor and NTC
+ * calibration resistance within factor of 32.
+ */
+/** @brief Nearest power of two of x, x in 2^-12 ... 2^12. */
+#define ADC_NTC_POW2_NEAREST(x) \
+    ((x) >= 2896.3093757400989 ? 4096.0 : \
+     (x) >= 1448.1546878700494 ? 2048.0 : \
+     (x) >= 724.07734393502471 ? 1024.0 : \
+     (x) >= 362.03867196751236 ? 512.0 : \
+     (x) >= 181.01933598375618 ? 256.0 : \
+     (x) >= 90.509667991878089 ? 128.0 : \
+     (x) >= 45.254833995939045 ? 64.0 : \
+     (x) >= 22.627416997969522 ? 32.0 : \
+     (x) >= 11.313708498984761 ? 16.0 : \
+     (x) >= 5.6568542494923806 ? 8.0 : \
+     (x) >= 2.8284271247461903 ? 4.0 : \
+     (x) >= 1.4142135623730951 ? 2.0 : \
+     (x) >= 0.70710678118654757 ? 1.0 : \
+     (x) >= 0.35355339059327379 ? 0.5 : \
+     (x) >= 0.17677669529663689 ? 0.25 : \
+     (x) >= 0.088388347648318447 ? 0.125 : \
+     (x) >= 0.044194173824159223 ? 0.0625 : \
+     (x) >= 0.022097086912079612 ? 0.03125 : \
+     (x) >= 0.011048543456039806 ? 0.015625 : \
+     (x) >= 0.0055242717280199029 ? 0.0078125 : \
+     (x) >= 0.0027621358640099515 ? 0.00390625 : \
+     (x) >= 0.0013810679320049757 ? 0.001953125 : \
+     (x) >= 0.00069053396600248786 ? 0.0009765625 : \
+     (x) >= 0.00034526698300124393 ? 0.00048828125 : \
+     0.000244140625)
+/** @brief Base-2 logarithm of @ref ADC_NTC_POW2_NEAREST. */
+#define ADC_NTC_LOG2_NEAREST(x) \
+    ((x) >= 2896.3093757400989 ? 12 : \
+     (x) >= 1448.1546878700494 ? 11 : \
+     (x) >= 724.07734393502471 ? 10 : \
+     (x) >= 362.03867196751236 ? 9 : \
+     (x) >= 181.01933598375618 ? 8 : \
+     (x) >= 90.509667991878089 ? 7 : \
+     (x) >= 45.254833995939045 ? 6 : \
+     (x) >= 22.627416997969522 ? 5 : \
+     (x) >= 11.313708498984761 ? 4 : \
+     (x) >= 5.6568542494923806 ? 3 : \
+     (x) >= 2.8284271247461903 ? 2 : \
+     (x) >= 1.4142135623730951 ? 1 : \
+     (x) >= 0.70710678118654757 ? 0 : \
+     (x) >= 0.35355339059327379 ? -1 : \
+     (x) >= 0.17677669529663689 ? -2 : \
+     (x) >= 0.088388347648318447 ? -3 : \
+     (x) >= 0.044194173824159223 ? -4 : \
+     (x) >= 0.022097086912079612 ? -5 : \
+     (x) >= 0.011048543456039806 ? -6 : \
+     (x) >= 0.0055242717280199029 ? -7 : \
+     (x) >= 0.0027621358640099515 ? -8 : \
+     (x) >= 0.0013810679320049757 ? -9 : \
+     (x) >= 0.00069053396600248786 ? -10 : \
+     (x) >= 0.00034526698300124393 ? -11 : \
+     -12)
+#define ADC_NTC_LN2 (0.693147180559945309) //!< Natural logarithm of 2.
+#define ADC_NTC_SQ(z) ((z) * (z))
+/** @brief 2 * atanh(z) for |z| < 0.172. */
+#define ADC_NTC_ATANH2(z) (2.0 * (z) * (1.0 + ADC_NTC_SQ (z) * (1.0 / 3.0 \
+    + ADC_NTC_SQ (z) * (1.0 / 5.0 + ADC_NTC_SQ (z) * (1.0 / 7.0 \
+    + ADC_NTC_SQ (z) * (1.0 / 9.0))))))
+/** @brief Natural logarithm of x as constant expression. */
+#define ADC_NTC_LN(x) ((ADC_NTC_LOG2_NEAREST (x) * ADC_NTC_LN2) \
+    + ADC_NTC_ATANH2 ((((x) / ADC_NTC_POW2_NEAREST (x)) - 1.0) \
+                      / (((x) / ADC_NTC_POW2_NEAREST (x)) + 1.0)))
+/** @brief NTC resistance relative to calibration resistance at knot i. */
+#define ADC_NTC_RT_R0(i) (((double) ADC_NTC_BALANCE * (double) (i)) \
+    / ((double) ADC_NTC_DEFAULT_RES * (double) (ADC_NTC_LUT_SIZE - (i))))
+/** @brief Beta equation at knot i, Celsius. */
+#define ADC_NTC_KNOT_C(i) ((1.0 / ((1.0 / (double) ADC_NTC_DEFAULT_TEMP_K) \
+    + (ADC_NTC_LN (ADC_NTC_RT_R0 (i)) / (double) ADC_NTC_DEFAULT_BETA))) \
+    - (double) ADC_K_TO_C_CONST)
+/**
+ * @brief Knot i rounded to 0.01 C.
+ *
+ * Offset is removed in double, a negative integer result of a constant expression
+ * with conditionals is flagged as overflow by GCC.
+ */
+#define ADC_NTC_KNOT(i) ((int16_t) ((double) (int32_t) (((ADC_NTC_KNOT_C (i) \
+    + ADC_NTC_LUT_OFFSET_C) * ADC_NTC_LUT_CENTI) + 0.5) \
+    - (ADC_NTC_LUT_OFFSET_C * ADC_NTC_LUT_CENTI)))
+#define ADC_NTC_KNOTS_8(i) ADC_NTC_KNOT ((i)), ADC_NTC_KNOT ((i) + 1), \
+    ADC_NTC_KNOT ((i) + 2), ADC_NTC_KNOT ((i) + 3), ADC_NTC_KNOT ((i) + 4), \
+    ADC_NTC_KNOT ((i) + 5), ADC_NTC_KNOT ((i) + 6), ADC_NTC_KNOT ((i) + 7)
+
+/** @brief Temperature at ratio (i + 1) / ADC_NTC_LUT_SIZE, 0.01 C. */
+static const int16_t m_ntc_lut[ADC_NTC_LUT_SIZE - 1U] =
+{
+    ADC_NTC_KNOT (1), ADC_NTC_KNOT (2), ADC_NTC_KNOT (3), ADC_NTC_KNOT (4),
+    ADC_NTC_KNOT (5), ADC_NTC_KNOT (6), ADC_NTC_KNOT (7),
+    ADC_NTC_KNOTS_8 (8),   ADC_NTC_KNOTS_8 (16),  ADC_NTC_KNOTS_8 (24),
+    ADC_NTC_KNOTS_8 (32),  ADC_NTC_KNOTS_8 (40),  ADC_NTC_KNOTS_8 (48),
+    ADC_NTC_KNOTS_8 (56),  ADC_NTC_KNOTS_8 (64),  ADC_NTC_KNOTS_8 (72),
+    ADC_NTC_KNOTS_8 (80),  ADC_NTC_KNOTS_8 (88),  ADC_NTC_KNOTS_8 (96),
+    ADC_NTC_KNOTS_8 (104), ADC_NTC_KNOTS_8 (112), ADC_NTC_KNOTS_8 (120)
+};
+
+_Static_assert (ADC_NTC_LUT_SIZE == 128U, "Update m_ntc_lut initializer with table size");
+
 static ri_adc_pins_config_t adc_ntc_pins_config =
 {
     .p_pin.channel = RI_ADC_GND,
@@ -101,30 +220,35 @@ float m_temperture;                  //!< Last measured temperature
 static bool m_is_init;               //!< Flag, is sensor init.
 static const char m_sensor_name[] = "NTC"; //!< Human-readable name of the sensor.
 
-/**
- * @brief convert measured voltage ratio to temperature
- *
- * @param[in] ratio Measured voltage ratio in NTC divider. 0.0 ... 1.0
- * @return temperature in celcius.
- * @retval RD_FLOAT_INVALID if ratio < 0.0 or ratio > 1.0
- */
-static float ratio_to_temperature (const float * const ratio)
+float ri_adc_ntc_ratio_to_temperature (const float ratio)
 {
     float result = RD_FLOAT_INVALID;
-    float Rt;
-    float Rb = (float)   ADC_NTC_BALANCE;        //!< Fixed divider resistance
-    float beta = (float) ADC_NTC_DEFAULT_BETA;   //!< Beta of NTC
-    float T0 = (float)   ADC_NTC_DEFAULT_TEMP_K; //!< Calibration temp of NTC.
-    float R0 = (float)   RI_ADC_NTC_DEFAULT_RES; //!< Calibration resistance of NTC.
 
-    if ( (NULL != ratio) && (*ratio >= 0.0F) && (*ratio <= 1.0F))
+    if ( (ratio >= 0.0F) && (ratio <= 1.0F))
     {
-        // Calculate NTC resistance.
-        Rt = (Rb * *ratio) / (1.0F - *ratio);
-        // 1/T = 1/T0 + 1/B * ln(R/R0)
-        result = 1.0F / ( (1 / T0) + ( (1 / beta) * log (Rt / R0)));
-        // Convert K->C
-        result -= ADC_K_TO_C_CONST;
+        const float position = ratio * (float) ADC_NTC_LUT_SIZE;
+        uint32_t knot = (uint32_t) position;
+        float fraction = position - (float) knot;
+
+        // Clamp to first and last knot.
+        if (knot < 1U)
+        {
+            knot = 1U;
+            fraction = 0.0F;
+        }
+        else if (knot >= (ADC_NTC_LUT_SIZE - 1U))
+        {
+            knot = ADC_NTC_LUT_SIZE - 2U;
+            fraction = 1.0F;
+        }
+        else
+        {
+            // Interpolate between knot and next knot.
+        }
+
+        const float lower = (float) m_ntc_lut[knot - 1U];
+        const float upper = (float) m_ntc_lut[knot];
+        result = (lower + ( (upper - lower) * fraction)) / (float) ADC_NTC_LUT_CENTI;
     }
 
     return result;
@@ -141,7 +265,7 @@ static rd_status_t get_data (void)
             &ratio))
     {
         //m_temperture = volts_to_temperature (&volts);
-        m_temperture = ratio_to_temperature (&ratio);
+        m_temperture = ri_adc_ntc_ratio_to_temperature (ratio);
     }
     else
     {
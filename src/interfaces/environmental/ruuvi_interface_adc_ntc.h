@@ -58,5 +58,19 @@ rd_status_t ri_adc_ntc_mode_get (uint8_t *);
 /** @brief @ref rd_sensor_data_fp */
 rd_status_t ri_adc_ntc_data_get (rd_sensor_data_t * const
                                  data);
+
+/**
+ * @brief Convert measured voltage ratio of NTC divider to temperature.
+ *
+ * Uses a lookup table generated at compile time from NTC constants,
+ * linearly interpolated. Ratios beyond first and last table point are clamped
+ * to temperature of the table point, approximately +195 C and -54 C with
+ * default constants.
+ *
+ * @param[in] ratio Measured voltage ratio in NTC divider. 0.0 ... 1.0
+ * @return temperature in celcius.
+ * @retval RD_FLOAT_INVALID if ratio < 0.0 or ratio > 1.0
+ */
+float ri_adc_ntc_ratio_to_temperature (const float ratio);
 /*@}*/
 #endif
\ No newline at end of file
@@ -18,297 +18,351 @@
 #include "ruuvi_driver_error.h"
 #include "ruuvi_driver_sensor.h"
 #include "ruuvi_interface_log.h"
-#include <stdio.h>
 #include <string.h>
 
-size_t ri_error_to_string (rd_status_t error,
-                           char * const error_string, const size_t space_remaining)
+/**
+ * @brief Severities muted per module, bit n set mutes severity n.
+ *
+ * Zero-initialized so that every module logs everything compiled in until configured.
+ */
+static uint8_t m_module_mute[RI_LOG_MODULE_COUNT];
+
+static inline bool module_allows (const ri_log_module_t module,
+                                  const ri_log_severity_t severity)
 {
-    if (NULL == error_string)
+    return (module < RI_LOG_MODULE_COUNT)
+           && (0U == (m_module_mute[module] & (1U << severity)));
+}
+
+void ri_log_module (const ri_log_module_t module,
+                    const ri_log_severity_t severity,
+                    const char * const message)
+{
+    if (module_allows (module, severity))
     {
-        RD_ERROR_CHECK (RD_ERROR_NULL, RD_ERROR_NULL);
-        return 0;
+        ri_log (severity, message);
     }
+}
 
-    size_t written = 0;
-    rd_status_t error_bit = 0;
-
-    // Print each error individually
-    do
+void ri_log_module_hex (const ri_log_module_t module,
+                        const ri_log_severity_t severity,
+                        const uint8_t * const bytes,
+                        size_t byte_length)
+{
+    if (module_allows (module, severity))
     {
-        // Print comma + space if needed
-        if (written != 0)
-        {
-            written += snprintf (error_string + written, space_remaining - written, ", ");
-        }
-
-        // If there is some error, print the lowest bit and reset the lowest bit in error code.
-        if (error)
-        {
-            for (uint8_t ii = 0; ii < 32; ii++)
-            {
-                if (error & (1 << ii))
-                {
-                    error_bit = 1 << ii;
-                    error &= 0xFFFFFFFF - (1 << ii);
-                }
-            }
-        }
-
-        switch (error_bit)
-        {
-            case RD_SUCCESS:
-                written += snprintf (error_string + written, space_remaining - written, "%s", "SUCCESS");
-                break;
-
-            case RD_ERROR_INTERNAL:
-                written += snprintf (error_string + written, space_remaining - written, "%s", "INTERNAL");
-                break;
+        ri_log_hex (severity, bytes, byte_length);
+    }
+}
 
-            case RD_ERROR_NOT_FOUND:
-                written += snprintf (error_string + written, space_remaining - written, "%s",
-                                     "NOT_FOUND");
-                break;
+rd_status_t ri_log_module_level_set (const ri_log_module_t module,
+                                     const ri_log_severity_t level)
+{
+    rd_status_t err_code = RD_SUCCESS;
 
-            case RD_ERROR_NO_MEM:
-                written += snprintf (error_string + written, space_remaining - written, "%s", "NO_MEM");
-                break;
+    if ( (module >= RI_LOG_MODULE_COUNT) || (level > RI_LOG_LEVEL_DEBUG))
+    {
+        err_code |= RD_ERROR_INVALID_PARAM;
+    }
+    else
+    {
+        // Mute every severity less severe than level.
+        m_module_mute[module] = (uint8_t) (~ ( (2U << level) - 1U));
+    }
 
-            case RD_ERROR_NOT_SUPPORTED:
-                written += snprintf (error_string + written, space_remaining - written, "%s",
-                                     "NOT_SUPPORTED");
-                break;
+    return err_code;
+}
 
-            case RD_ERROR_INVALID_STATE:
-                written += snprintf (error_string + written, space_remaining - written, "%s",
-                                     "INVALID_STATE");
-                break;
+ri_log_severity_t ri_log_module_level_get (const ri_log_module_t module)
+{
+    ri_log_severity_t level = RI_LOG_LEVEL_NONE;
 
-            case RD_ERROR_INVALID_LENGTH:
-                written += snprintf (error_string + written, space_remaining - written, "%s",
-                                     "INVALID_LENGTH");
-                break;
+    if (module < RI_LOG_MODULE_COUNT)
+    {
+        level = RI_LOG_LEVEL_DEBUG;
 
-            case RD_ERROR_INVALID_FLAGS:
-                written += snprintf (error_string + written, space_remaining - written, "%s",
-                                     "INVALID_FLAGS");
-                break;
+        while ( (RI_LOG_LEVEL_NONE != level) && !module_allows (module, level))
+        {
+            level--;
+        }
+    }
 
-            case RD_ERROR_INVALID_DATA:
-                written += snprintf (error_string + written, space_remaining - written, "%s",
-                                     "INVALID_DATA");
-                break;
+    return level;
+}
 
-            case RD_ERROR_INVALID_PARAM:
-                written += snprintf (error_string + written, space_remaining - written, "%s",
-                                     "INVALID_PARAM");
-                break;
+/** @brief Bounded string builder, output is always null-terminated. */
+typedef struct
+{
+    char * p_str;   //!< Destination buffer.
+    size_t size;    //!< Size of destination buffer, including terminator.
+    size_t length;  //!< Characters written, excluding terminator.
+    bool overflow;  //!< True if some of the output was cut.
+} str_builder_t;
 
-            case RD_ERROR_DATA_SIZE:
-                written += snprintf (error_string + written, space_remaining - written, "%s",
-                                     "DATA_SIZE");
-                break;
+static void sb_init (str_builder_t * const p_sb, char * const p_str, const size_t size)
+{
+    p_sb->p_str = p_str;
+    p_sb->size = size;
+    p_sb->length = 0;
+    p_sb->overflow = (0 == size);
 
-            case RD_ERROR_TIMEOUT:
-                written += snprintf (error_string + written, space_remaining - written, "%s", "TIMEOUT");
-                break;
+    if (0 < size)
+    {
+        p_str[0] = '\0';
+    }
+}
 
-            case RD_ERROR_NULL:
-                written += snprintf (error_string + written, space_remaining - written, "%s", "NULL");
-                break;
+static void sb_append_char (str_builder_t * const p_sb, const char c)
+{
+    if ( (p_sb->length + 1U) < p_sb->size)
+    {
+        p_sb->p_str[p_sb->length++] = c;
+        p_sb->p_str[p_sb->length] = '\0';
+    }
+    else
+    {
+        p_sb->overflow = true;
+    }
+}
 
-            case RD_ERROR_FORBIDDEN:
-                written += snprintf (error_string + written, space_remaining - written, "%s",
-                                     "FORBIDDEN");
-                break;
+static void sb_append (str_builder_t * const p_sb, const char * p_str)
+{
+    while ('\0' != *p_str)
+    {
+        sb_append_char (p_sb, *p_str);
+        p_str++;
+    }
+}
 
-            case RD_ERROR_INVALID_ADDR:
-                written += snprintf (error_string + written, space_remaining - written, "%s",
-                                     "INVALID_ADDR");
-                break;
+static void sb_append_hex_byte (str_builder_t * const p_sb, const uint8_t byte)
+{
+    static const char hex[] = "0123456789ABCDEF";
+    sb_append_char (p_sb, hex[byte >> 4U]);
+    sb_append_char (p_sb, hex[byte & 0x0FU]);
+}
 
-            case RD_ERROR_BUSY:
-                written += snprintf (error_string + written, space_remaining - written, "%s", "BUSY");
-                break;
+static void sb_append_uint (str_builder_t * const p_sb, uint32_t value)
+{
+    char digits[10]; // UINT32_MAX has 10 digits.
+    size_t count = 0;
 
-            case RD_ERROR_RESOURCES:
-                written += snprintf (error_string + written, space_remaining - written, "%s",
-                                     "RESOURCES");
-                break;
+    do
+    {
+        digits[count++] = (char) ('0' + (value % 10U));
+        value /= 10U;
+    } while (0U != value);
 
-            case RD_ERROR_NOT_IMPLEMENTED:
-                written += snprintf (error_string + written, space_remaining - written, "%s",
-                                     "NOT_IMPLEMENTED");
-                break;
+    while (0 < count)
+    {
+        sb_append_char (p_sb, digits[--count]);
+    }
+}
 
-            case RD_ERROR_NOT_INITIALIZED:
-                written += snprintf (error_string + written, space_remaining - written, "%s",
-                                     "NOT_INITIALIZED");
-                break;
+/** @brief Names of error bits, indexed by bit position. NULL for unknown bits. */
+static const char * const m_error_names[32] =
+{
+    [0]  = "INTERNAL",
+    [1]  = "NO_MEM",
+    [2]  = "NOT_FOUND",
+    [3]  = "NOT_SUPPORTED",
+    [4]  = "INVALID_PARAM",
+    [5]  = "INVALID_STATE",
+    [6]  = "INVALID_LENGTH",
+    [7]  = "INVALID_FLAGS",
+    [8]  = "INVALID_DATA",
+    [9]  = "DATA_SIZE",
+    [10] = "TIMEOUT",
+    [11] = "NULL",
+    [12] = "FORBIDDEN",
+    [13] = "INVALID_ADDR",
+    [14] = "BUSY",
+    [15] = "RESOURCES",
+    [16] = "NOT_IMPLEMENTED",
+    [17] = "SELFTEST",
+    [18] = "MORE_AVAILABLE",
+    [19] = "NOT_INITIALIZED",
+    [20] = "NOT ACKNOWLEDGED",
+    [21] = "NOT ENABLED",
+    [22] = "DEPRECATED",
+    [31] = "FATAL"
+};
 
-            case RD_ERROR_SELFTEST:
-                written += snprintf (error_string + written, space_remaining - written, "%s", "SELFTEST");
-                break;
+size_t ri_error_to_string (rd_status_t error,
+                           char * const error_string, const size_t space_remaining)
+{
+    if (NULL == error_string)
+    {
+        RD_ERROR_CHECK (RD_ERROR_NULL, RD_ERROR_NULL);
+        return 0;
+    }
 
-            case RD_ERROR_NOT_ACKNOWLEDGED:
-                written += snprintf (error_string + written, space_remaining - written, "%s",
-                                     "NOT ACKNOWLEDGED");
-                break;
+    str_builder_t sb;
+    sb_init (&sb, error_string, space_remaining);
 
-            case RD_ERROR_NOT_ENABLED:
-                written += snprintf (error_string + written, space_remaining - written, "%s",
-                                     "NOT ENABLED");
-                break;
+    if (RD_SUCCESS == error)
+    {
+        sb_append (&sb, "SUCCESS");
+    }
 
-            case RD_WARNING_DEPRECATED:
-                written += snprintf (error_string + written, space_remaining - written, "%s",
-                                     "DEPRECATED");
-                break;
+    // Print most significant error first.
+    for (int8_t bit = 31; (bit >= 0) && (RD_SUCCESS != error); bit--)
+    {
+        const rd_status_t mask = (1UL << bit);
 
-            case RD_ERROR_FATAL:
-                written += snprintf (error_string + written, space_remaining - written, "%s", "FATAL");
-                break;
+        if (error & mask)
+        {
+            error &= ~mask;
+            const char * const p_name = m_error_names[bit];
+            sb_append (&sb, (NULL != p_name) ? p_name : "UNKNOWN");
 
-            default:
-                written = snprintf (error_string + written, space_remaining - written, "%s", "UNKNOWN");
-                break;
+            if (RD_SUCCESS != error)
+            {
+                sb_append (&sb, ", ");
+            }
         }
-    } while (error);
+    }
 
-    return written;
+    return sb.length;
 }
 
-// Convert configuration value to string.
-static char * configuration_value_to_string (const uint8_t val)
+// Append configuration value as string.
+static void configuration_value_to_string (str_builder_t * const p_sb, const uint8_t val)
 {
-    static char msg[17]; // sizeof "Not implemented", including NULL
-    memset (msg, 0, sizeof (msg));
-
     if (val <= 200 && val > 0)
     {
-        snprintf (msg, sizeof (msg), "%d", val);
+        sb_append_uint (p_sb, val);
     }
     else switch (val)
         {
             case RD_SENSOR_CFG_MIN:
-                snprintf (msg, sizeof (msg), "MIN");
+                sb_append (p_sb, "MIN");
                 break;
 
             case RD_SENSOR_CFG_MAX:
-                snprintf (msg, sizeof (msg), "MAX");
+                sb_append (p_sb, "MAX");
                 break;
 
             case RD_SENSOR_CFG_CONTINUOUS:
-                snprintf (msg, sizeof (msg), "CONTINUOUS");
+                sb_append (p_sb, "CONTINUOUS");
                 break;
 
             case RD_SENSOR_CFG_DEFAULT:
-                snprintf (msg, sizeof (msg), "DEFAULT");
+                sb_append (p_sb, "DEFAULT");
                 break;
 
             case RD_SENSOR_CFG_NO_CHANGE:
-                snprintf (msg, sizeof (msg), "No change");
+                sb_append (p_sb, "No change");
                 break;
 
             case RD_SENSOR_CFG_SINGLE:
-                snprintf (msg, sizeof (msg), "Single");
+                sb_append (p_sb, "Single");
                 break;
 
             case RD_SENSOR_CFG_SLEEP:
-                snprintf (msg, sizeof (msg), "Sleep");
+                sb_append (p_sb, "Sleep");
                 break;
 
             case RD_SENSOR_ERR_NOT_SUPPORTED:
-                snprintf (msg, sizeof (msg), "Not supported");
+                sb_append (p_sb, "Not supported");
                 break;
 
             case RD_SENSOR_ERR_NOT_IMPLEMENTED:
-                snprintf (msg, sizeof (msg), "Not implemented");
+                sb_append (p_sb, "Not implemented");
                 break;
 
             case RD_SENSOR_ERR_INVALID:
-                snprintf (msg, sizeof (msg), "Invalid");
+                sb_append (p_sb, "Invalid");
                 break;
 
             default:
-                snprintf (msg, sizeof (msg), "Unknown");
+                sb_append (p_sb, "Unknown");
                 break;
         }
+}
+
+static void log_configuration_line (const ri_log_severity_t level,
+                                    const char * const p_label,
+                                    const uint8_t val,
+                                    const char * const p_unit)
+{
+    char msg[RD_LOG_BUFFER_SIZE];
+    str_builder_t sb;
+    sb_init (&sb, msg, sizeof (msg));
+    sb_append (&sb, p_label);
+    configuration_value_to_string (&sb, val);
 
-    return msg;
+    if (NULL != p_unit)
+    {
+        sb_append_char (&sb, ' ');
+        sb_append (&sb, p_unit);
+    }
+
+    sb_append (&sb, "\r\n");
+    ri_log (level, msg);
 }
 
 void ri_log_sensor_configuration (const ri_log_severity_t level,
                                   const rd_sensor_configuration_t * const configuration, const char * unit)
 {
-    char msg[RD_LOG_BUFFER_SIZE] = {0};
-    snprintf (msg, RD_LOG_BUFFER_SIZE, "Sample rate: %s Hz\r\n",
-              configuration_value_to_string (configuration->samplerate));
-    ri_log (level, msg);
-    memset (msg, 0, sizeof (msg));
-    snprintf (msg, RD_LOG_BUFFER_SIZE, "Resolution:  %s bits\r\n",
-              configuration_value_to_string (configuration->resolution));
-    ri_log (level, msg);
-    memset (msg, 0, sizeof (msg));
-    snprintf (msg, RD_LOG_BUFFER_SIZE, "Scale:       %s %s\r\n",
-              configuration_value_to_string (configuration->scale), unit);
-    ri_log (level, msg);
-    memset (msg, 0, sizeof (msg));
-    size_t written = snprintf (msg, RD_LOG_BUFFER_SIZE, "DSP:         ");
+    log_configuration_line (level, "Sample rate: ", configuration->samplerate, "Hz");
+    log_configuration_line (level, "Resolution:  ", configuration->resolution, "bits");
+    log_configuration_line (level, "Scale:       ", configuration->scale, unit);
+    char msg[RD_LOG_BUFFER_SIZE];
+    str_builder_t sb;
+    sb_init (&sb, msg, sizeof (msg));
+    sb_append (&sb, "DSP:         ");
 
     switch (configuration->dsp_function)
     {
         case RD_SENSOR_DSP_HIGH_PASS:
-            written += snprintf (msg + written, RD_LOG_BUFFER_SIZE - written, "High pass x ");
+            sb_append (&sb, "High pass x ");
             break;
 
         case RD_SENSOR_DSP_LAST:
-            written += snprintf (msg + written, RD_LOG_BUFFER_SIZE - written, "Last x ");
+            sb_append (&sb, "Last x ");
             break;
 
         case RD_SENSOR_DSP_LOW_PASS:
-            written += snprintf (msg + written, RD_LOG_BUFFER_SIZE - written, "Lowpass x ");
+            sb_append (&sb, "Lowpass x ");
             break;
 
         case RD_SENSOR_DSP_OS:
-            written += snprintf (msg + written, RD_LOG_BUFFER_SIZE - written,
-                                 "Oversampling x ");
+            sb_append (&sb, "Oversampling x ");
             break;
 
         default:
-            written += snprintf (msg + written, RD_LOG_BUFFER_SIZE - written, "Unknown x");
+            sb_append (&sb, "Unknown x");
             break;
     }
 
-    snprintf (msg + written, RD_LOG_BUFFER_SIZE - written, "%s\r\n",
-              configuration_value_to_string (configuration->dsp_parameter));
-    ri_log (level, msg);
-    memset (msg, 0, sizeof (msg));
-    written = snprintf (msg, RD_LOG_BUFFER_SIZE, "Mode:        %s\r\n",
-                        configuration_value_to_string (configuration->mode));
+    configuration_value_to_string (&sb, configuration->dsp_parameter);
+    sb_append (&sb, "\r\n");
     ri_log (level, msg);
+    log_configuration_line (level, "Mode:        ", configuration->mode, NULL);
 }
 
 void ri_log_hex (const ri_log_severity_t severity,
                  const uint8_t * const bytes,
                  size_t byte_length)
 {
-    char msg[RD_LOG_BUFFER_SIZE] =  { 0 };
-    size_t index = 0;
+    char msg[RD_LOG_BUFFER_SIZE];
+    str_builder_t sb;
+    sb_init (&sb, msg, sizeof (msg));
 
-    for (size_t ii = 0; ii < byte_length; ii++)
+    for (size_t ii = 0; (ii < byte_length) && !sb.overflow; ii++)
     {
-        index += snprintf (msg + index, sizeof (msg) - index, "%02X", bytes[ii]);
+        sb_append_hex_byte (&sb, bytes[ii]);
 
         if (ii < (byte_length - 1))
         {
-            index += snprintf (msg + index, sizeof (msg) - index, ":");
+            sb_append_char (&sb, ':');
         }
-
-        if (index >= sizeof (msg)) { return; }
     }
 
-    ri_log (severity, msg);
+    if (!sb.overflow)
+    {
+        ri_log (severity, msg);
+    }
 }
 
 #else
@@ -367,6 +421,32 @@ void ri_log_hex (const ri_log_severity_t severity,
     return;
 }
 
+void ri_log_module (const ri_log_module_t module,
+                    const ri_log_severity_t severity,
+                    const char * const message)
+{
+    return;
+}
+
+void ri_log_module_hex (const ri_log_module_t module,
+                        const ri_log_severity_t severity,
+                        const uint8_t * const bytes,
+                        size_t byte_length)
+{
+    return;
+}
+
+rd_status_t ri_log_module_level_set (const ri_log_module_t module,
+                                     const ri_log_severity_t level)
+{
+    return RD_SUCCESS;
+}
+
+ri_log_severity_t ri_log_module_level_get (const ri_log_module_t module)
+{
+    return RI_LOG_LEVEL_NONE;
+}
+
 /**
  * @brief Write text description of error message into given string pointer and null-terminate it.
  * The string will be cut if it cannot fit into given space.
@@ -374,12 +454,17 @@ void ri_log_hex (const ri_log_severity_t severity,
  * @param error error code to convert to string
  * @param error_string pointer to character array where error should be written
  * @param space_remaining How many bytes there are remaining in the error string.
- * @return number of bytes written (snprintf rvalue).
+ * @return number of characters written, always 0 as logging is disabled.
  */
 size_t ri_error_to_string (rd_status_t error, char * error_string,
                            size_t space_remaining)
 {
-    return space_remaining;
+    if ( (NULL != error_string) && (0 < space_remaining))
+    {
+        error_string[0] = '\0';
+    }
+
+    return 0;
 }
 
 /**
@@ -45,6 +45,73 @@ typedef enum
     RI_LOG_LEVEL_DEBUG       //<! Debug messages
 } ri_log_severity_t;
 
+#ifndef RI_LOG_COMPILE_LEVEL
+/**
+ * @brief Least severe log level compiled into the firmware.
+ *
+ * Log calls made through @ref RI_LOG_MODULE with a less severe level are removed
+ * at compile time, including evaluation of their arguments.
+ */
+#   define RI_LOG_COMPILE_LEVEL RI_LOG_LEVEL_DEBUG
+#endif
+
+/**
+ * Modules which can be filtered individually at runtime.
+ **/
+typedef enum
+{
+    RI_LOG_MODULE_APPLICATION = 0, //!< Application and anything not listed below.
+    RI_LOG_MODULE_SENSOR,          //!< Sensor drivers and sensor task.
+    RI_LOG_MODULE_FLASH,           //!< Flash driver and flash task.
+    RI_LOG_MODULE_ADV,             //!< BLE advertising driver.
+    RI_LOG_MODULE_GATT,            //!< BLE GATT driver and GATT task.
+    RI_LOG_MODULE_UART,            //!< UART driver.
+    RI_LOG_MODULE_COUNT            //!< Number of modules, keep last.
+} ri_log_module_t;
+
+/**
+ * @brief Check if log call is compiled in.
+ *
+ * @param[in] module_level Least severe level compiled in for module, compile-time constant.
+ * @param[in] severity Severity of log call, compile-time constant.
+ */
+#define RI_LOG_IS_COMPILED(module_level, severity) \
+    (((severity) <= (module_level)) && ((severity) <= RI_LOG_COMPILE_LEVEL))
+
+/**
+ * @brief Log a message through module filter.
+ *
+ * Call is eliminated by compiler if severity is not compiled in, otherwise
+ * message is filtered at runtime with @ref ri_log_module.
+ *
+ * @param[in] module @ref ri_log_module_t of caller.
+ * @param[in] module_level Least severe level compiled in for module.
+ * @param[in] severity Severity of message.
+ * @param[in] msg Message string.
+ */
+#define RI_LOG_MODULE(module, module_level, severity, msg) do { \
+    if (RI_LOG_IS_COMPILED ((module_level), (severity))) \
+    { \
+        ri_log_module ((module), (severity), (msg)); \
+    } \
+} while (0)
+
+/**
+ * @brief Log bytes as hex through module filter.
+ *
+ * @param[in] module @ref ri_log_module_t of caller.
+ * @param[in] module_level Least severe level compiled in for module.
+ * @param[in] severity Severity of message.
+ * @param[in] bytes Bytes to log.
+ * @param[in] len Number of bytes to log.
+ */
+#define RI_LOG_MODULE_HEX(module, module_level, severity, bytes, len) do { \
+    if (RI_LOG_IS_COMPILED ((module_level), (severity))) \
+    { \
+        ri_log_module_hex ((module), (severity), (bytes), (len)); \
+    } \
+} while (0)
+
 /**
  * @brief Runs initialization code for the logging backend and sets the severity level.
  *
@@ -87,6 +154,55 @@ void ri_log_hex (const ri_log_severity_t severity,
                  const uint8_t * const bytes,
                  size_t byte_length);
 
+/**
+ * @brief Queue message into log if module allows given severity.
+ *
+ * Prefer @ref RI_LOG_MODULE which removes the call at compile time
+ * if severity is not compiled in.
+ *
+ * @param module module which logs the message.
+ * @param severity severity of the log message.
+ * @param message message string.
+ */
+void ri_log_module (const ri_log_module_t module,
+                    const ri_log_severity_t severity,
+                    const char * const message);
+
+/**
+ * @brief Queue bytes into log as a hex string if module allows given severity.
+ *
+ * @param module module which logs the message.
+ * @param severity severity of the log message.
+ * @param bytes raw bytes to log.
+ * @param byte_length length of bytes to log.
+ */
+void ri_log_module_hex (const ri_log_module_t module,
+                        const ri_log_severity_t severity,
+                        const uint8_t * const bytes,
+                        size_t byte_length);
+
+/**
+ * @brief Set least severe level logged by a module at runtime.
+ *
+ * Global level given to @ref ri_log_init is applied after module level.
+ * All modules log everything compiled in by default.
+ *
+ * @param module module to configure.
+ * @param level least severe log level that will be printed from module.
+ * @retval RD_SUCCESS if level was set.
+ * @retval RD_ERROR_INVALID_PARAM if module or level is unknown.
+ */
+rd_status_t ri_log_module_level_set (const ri_log_module_t module,
+                                     const ri_log_severity_t level);
+
+/**
+ * @brief Get least severe level logged by a module.
+ *
+ * @param module module to query.
+ * @return Level of module, @ref RI_LOG_LEVEL_NONE if module is unknown.
+ */
+ri_log_severity_t ri_log_module_level_get (const ri_log_module_t module);
+
 /**
  * @brief Write text description of error message into given string pointer and null-terminate it.
  * The string will be cut if it cannot fit into given space.
@@ -94,7 +210,8 @@ void ri_log_hex (const ri_log_severity_t severity,
  * @param error error code to convert to string
  * @param error_string pointer to character array where error should be written
  * @param space_remaining How many bytes there are remaining in the error string.
- * @return number of bytes written (snprintf rvalue).
+ * @return number of characters written, excluding null terminator.
+ *         Never more than space_remaining - 1.
  */
 size_t ri_error_to_string (rd_status_t error, char * error_string,
                            size_t space_remaining);
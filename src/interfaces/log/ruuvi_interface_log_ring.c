@@ -0,0 +1,239 @@
+#include "ruuvi_driver_enabled_modules.h"
+#if RI_LOG_RING_ENABLED
+/**
+ * @addtogroup Log
+ */
+/** @{ */
+/**
+ * @file ruuvi_interface_log_ring.c
+ * @author Otso Jousimaa <otso@ojousima.net>
+ * @date 2026-10-18
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ *
+ * RAM ring of latest log messages which survives a soft reset.
+ *
+ */
+#include "ruuvi_driver_error.h"
+#include "ruuvi_interface_atomic.h"
+#include "ruuvi_interface_log.h"
+#include "ruuvi_interface_log_ring.h"
+#include <stdio.h>
+#include <string.h>
+
+#define LOG_RING_MAGIC (0x52554C47U) //!< "RULG", marks valid ring contents.
+
+_Static_assert ( (RI_LOG_RING_LENGTH & (RI_LOG_RING_LENGTH - 1U)) == 0U,
+                 "RI_LOG_RING_LENGTH must be a power of two");
+
+#if defined(__GNUC__) && !defined(CEEDLING)
+#   define LOG_RING_NOINIT __attribute__ ((section (RI_LOG_RING_SECTION)))
+#else
+#   define LOG_RING_NOINIT
+#endif
+
+/** @brief Ring contents, kept over soft reset. */
+typedef struct
+{
+    uint32_t magic;      //!< @ref LOG_RING_MAGIC if contents are valid.
+    uint32_t magic_inv;  //!< Bitwise inverse of magic.
+    uint32_t boot_count; //!< Soft resets survived.
+    uint32_t next_seq;   //!< Sequence number of next message.
+    uint32_t read_seq;   //!< Sequence number of oldest unread message.
+    uint32_t dropped;    //!< Messages dropped due to concurrent write.
+    uint32_t overrun;    //!< Messages overwritten before read.
+    ri_log_ring_entry_t entries[RI_LOG_RING_LENGTH]; //!< Messages.
+} log_ring_t;
+
+static log_ring_t m_ring LOG_RING_NOINIT;
+static ri_atomic_t m_lock = RI_ATOMIC_FLAG_INIT;
+static ri_log_severity_t m_min_severity = RI_LOG_LEVEL_NONE;
+static bool m_is_init = false;
+
+static inline ri_log_ring_entry_t * entry_at (const uint32_t seq)
+{
+    return &m_ring.entries[seq & (RI_LOG_RING_LENGTH - 1U)];
+}
+
+static bool ring_is_valid (void)
+{
+    bool valid = (LOG_RING_MAGIC == m_ring.magic)
+                 && (~LOG_RING_MAGIC == m_ring.magic_inv)
+                 && ( (m_ring.next_seq - m_ring.read_seq) <= RI_LOG_RING_LENGTH);
+
+    // Latest message must be where the counters say.
+    if (valid && (0U < m_ring.next_seq))
+    {
+        valid = ( (m_ring.next_seq - 1U) == entry_at (m_ring.next_seq - 1U)->seq);
+    }
+
+    return valid;
+}
+
+static void ring_store (const ri_log_severity_t severity, const char * const message)
+{
+    if (RI_LOG_RING_LENGTH == (m_ring.next_seq - m_ring.read_seq))
+    {
+        m_ring.read_seq++;
+        m_ring.overrun++;
+    }
+
+    ri_log_ring_entry_t * const p_entry = entry_at (m_ring.next_seq);
+    p_entry->severity = (uint8_t) severity;
+    strncpy (p_entry->text, message, sizeof (p_entry->text) - 1U);
+    p_entry->text[sizeof (p_entry->text) - 1U] = '\0';
+    // Sequence number is written last, it validates the entry on reboot.
+    p_entry->seq = m_ring.next_seq;
+    m_ring.next_seq++;
+}
+
+void ri_log_ring_clear (void)
+{
+    memset (&m_ring, 0, sizeof (m_ring));
+    m_ring.magic = LOG_RING_MAGIC;
+    m_ring.magic_inv = ~LOG_RING_MAGIC;
+}
+
+rd_status_t ri_log_ring_init (const ri_log_severity_t min_severity)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if (min_severity > RI_LOG_LEVEL_DEBUG)
+    {
+        err_code |= RD_ERROR_INVALID_PARAM;
+    }
+    else if (m_is_init)
+    {
+        m_min_severity = min_severity;
+    }
+    else if (ring_is_valid())
+    {
+        char marker[64]; // Truncated by ring if needed.
+        m_ring.boot_count++;
+        snprintf (marker, sizeof (marker), "Reboot %lu, dropped %lu, overrun %lu\r\n",
+                  (unsigned long) m_ring.boot_count,
+                  (unsigned long) m_ring.dropped,
+                  (unsigned long) m_ring.overrun);
+        ring_store (RI_LOG_LEVEL_NONE, marker);
+        m_min_severity = min_severity;
+        m_is_init = true;
+    }
+    else
+    {
+        ri_log_ring_clear();
+        m_min_severity = min_severity;
+        m_is_init = true;
+    }
+
+    return err_code;
+}
+
+void ri_log_ring_uninit (void)
+{
+    m_is_init = false;
+    m_min_severity = RI_LOG_LEVEL_NONE;
+}
+
+void ri_log_ring_write (const ri_log_severity_t severity, const char * const message)
+{
+    if (m_is_init && (NULL != message) && (severity <= m_min_severity))
+    {
+        if (ri_atomic_flag (&m_lock, true))
+        {
+            ring_store (severity, message);
+            ri_atomic_flag (&m_lock, false);
+        }
+        else
+        {
+            m_ring.dropped++;
+        }
+    }
+}
+
+rd_status_t ri_log_ring_peek (ri_log_ring_entry_t * const p_entry)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if (NULL == p_entry)
+    {
+        err_code |= RD_ERROR_NULL;
+    }
+    else if (!m_is_init)
+    {
+        err_code |= RD_ERROR_INVALID_STATE;
+    }
+    else if (!ri_atomic_flag (&m_lock, true))
+    {
+        err_code |= RD_ERROR_BUSY;
+    }
+    else
+    {
+        if (m_ring.read_seq == m_ring.next_seq)
+        {
+            err_code |= RD_ERROR_NOT_FOUND;
+        }
+        else
+        {
+            memcpy (p_entry, entry_at (m_ring.read_seq), sizeof (ri_log_ring_entry_t));
+        }
+
+        ri_atomic_flag (&m_lock, false);
+    }
+
+    return err_code;
+}
+
+rd_status_t ri_log_ring_consume (void)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if (!m_is_init)
+    {
+        err_code |= RD_ERROR_INVALID_STATE;
+    }
+    else if (!ri_atomic_flag (&m_lock, true))
+    {
+        err_code |= RD_ERROR_BUSY;
+    }
+    else
+    {
+        if (m_ring.read_seq == m_ring.next_seq)
+        {
+            err_code |= RD_ERROR_NOT_FOUND;
+        }
+        else
+        {
+            m_ring.read_seq++;
+        }
+
+        ri_atomic_flag (&m_lock, false);
+    }
+
+    return err_code;
+}
+
+rd_status_t ri_log_ring_stats_get (ri_log_ring_stats_t * const p_stats)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if (NULL == p_stats)
+    {
+        err_code |= RD_ERROR_NULL;
+    }
+    else if (!m_is_init)
+    {
+        err_code |= RD_ERROR_INVALID_STATE;
+    }
+    else
+    {
+        p_stats->boot_count = m_ring.boot_count;
+        p_stats->next_seq = m_ring.next_seq;
+        p_stats->unread = m_ring.next_seq - m_ring.read_seq;
+        p_stats->dropped = m_ring.dropped;
+        p_stats->overrun = m_ring.overrun;
+    }
+
+    return err_code;
+}
+
+/** @} */
+#endif
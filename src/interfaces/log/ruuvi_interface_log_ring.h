@@ -0,0 +1,140 @@
+#ifndef RUUVI_INTERFACE_LOG_RING_H
+#define RUUVI_INTERFACE_LOG_RING_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+/**
+ * @addtogroup Log
+ */
+/** @{ */
+/**
+ * @file ruuvi_interface_log_ring.h
+ * @author Otso Jousimaa <otso@ojousima.net>
+ * @date 2026-10-18
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ *
+ * RAM ring of latest log messages which survives a soft reset.
+ *
+ * The ring is placed in a section which is not initialized at boot, so messages
+ * logged before a watchdog or fatal-error reset can be read out after reboot.
+ * Every message gets a running sequence number, messages which could not be stored
+ * and messages overwritten before they were read are counted.
+ *
+ * Log backend stores messages with @ref ri_log_ring_write,
+ * application reads them out with @ref ri_log_ring_peek and @ref ri_log_ring_consume,
+ * usually through @ref rt_log_dump.
+ */
+
+#include "ruuvi_driver_enabled_modules.h"
+#include "ruuvi_driver_error.h"
+#include "ruuvi_interface_log.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifndef RI_LOG_RING_LENGTH
+/** @brief Number of messages held in ring. */
+#   define RI_LOG_RING_LENGTH (16U)
+#endif
+
+#ifndef RI_LOG_RING_ENTRY_SIZE
+/** @brief Maximum length of one stored message, including null terminator. */
+#   define RI_LOG_RING_ENTRY_SIZE (48U)
+#endif
+
+#ifndef RI_LOG_RING_SECTION
+/** @brief Linker section of ring, must not be initialized by startup code. */
+#   define RI_LOG_RING_SECTION ".noinit"
+#endif
+
+/** @brief One message in ring. */
+typedef struct
+{
+    uint32_t seq;                        //!< Running sequence number of message.
+    uint8_t severity;                    //!< @ref ri_log_severity_t of message.
+    char text[RI_LOG_RING_ENTRY_SIZE];   //!< Null-terminated, possibly truncated message.
+} ri_log_ring_entry_t;
+
+/** @brief Accounting of ring. */
+typedef struct
+{
+    uint32_t boot_count; //!< Soft resets survived by ring contents.
+    uint32_t next_seq;   //!< Sequence number of next message.
+    uint32_t unread;     //!< Messages stored and not yet consumed.
+    uint32_t dropped;    //!< Messages lost because ring was busy, e.g. logging from interrupt.
+    uint32_t overrun;    //!< Messages overwritten before they were consumed.
+} ri_log_ring_stats_t;
+
+/**
+ * @brief Initialize ring, keeping contents if they survived a reset.
+ *
+ * If valid contents are found, boot count is incremented and a reboot marker
+ * is written into ring. Otherwise ring is cleared.
+ *
+ * @param[in] min_severity least severe level stored in ring.
+ * @retval RD_SUCCESS on success.
+ * @retval RD_ERROR_INVALID_PARAM if severity is unknown.
+ */
+rd_status_t ri_log_ring_init (const ri_log_severity_t min_severity);
+
+/**
+ * @brief Stop storing messages into ring.
+ *
+ * Contents are kept and recovered by next @ref ri_log_ring_init.
+ */
+void ri_log_ring_uninit (void);
+
+/**
+ * @brief Clear ring contents and counters.
+ */
+void ri_log_ring_clear (void);
+
+/**
+ * @brief Store message in ring.
+ *
+ * Messages longer than @ref RI_LOG_RING_ENTRY_SIZE - 1 are truncated.
+ * Oldest unread message is overwritten if ring is full.
+ * Safe to call from interrupt context, message is dropped and counted if
+ * ring is being written by lower priority context.
+ *
+ * @param[in] severity severity of message.
+ * @param[in] message null-terminated message.
+ */
+void ri_log_ring_write (const ri_log_severity_t severity, const char * const message);
+
+/**
+ * @brief Copy oldest unread message out of ring without consuming it.
+ *
+ * @param[out] p_entry oldest unread message.
+ * @retval RD_SUCCESS if message was copied.
+ * @retval RD_ERROR_NULL if p_entry is NULL.
+ * @retval RD_ERROR_NOT_FOUND if there are no unread messages.
+ * @retval RD_ERROR_BUSY if ring is being written.
+ * @retval RD_ERROR_INVALID_STATE if ring is not initialized.
+ */
+rd_status_t ri_log_ring_peek (ri_log_ring_entry_t * const p_entry);
+
+/**
+ * @brief Consume oldest unread message.
+ *
+ * @retval RD_SUCCESS if message was consumed.
+ * @retval RD_ERROR_NOT_FOUND if there are no unread messages.
+ * @retval RD_ERROR_BUSY if ring is being written.
+ * @retval RD_ERROR_INVALID_STATE if ring is not initialized.
+ */
+rd_status_t ri_log_ring_consume (void);
+
+/**
+ * @brief Get ring accounting.
+ *
+ * @param[out] p_stats Counters of ring.
+ * @retval RD_SUCCESS on success.
+ * @retval RD_ERROR_NULL if p_stats is NULL.
+ * @retval RD_ERROR_INVALID_STATE if ring is not initialized.
+ */
+rd_status_t ri_log_ring_stats_get (ri_log_ring_stats_t * const p_stats);
+
+/** @} */
+#ifdef __cplusplus
+}
+#endif
+#endif
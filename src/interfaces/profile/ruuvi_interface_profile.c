@@ -0,0 +1,109 @@
+#include "ruuvi_driver_enabled_modules.h"
+#if RI_PROFILE_ENABLED
+/**
+ * @addtogroup Profile
+ */
+/** @{ */
+/**
+ * @file ruuvi_interface_profile.c
+ * @author Otso Jousimaa <otso@ojousima.net>
+ * @date 2026-10-18
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ *
+ * Platform-independent bookkeeping of profiling zones.
+ * Tick source is implemented by platform.
+ *
+ */
+#include "ruuvi_driver_error.h"
+#include "ruuvi_interface_atomic.h"
+#include "ruuvi_interface_profile.h"
+#include <stddef.h>
+
+static ri_profile_zone_t * m_p_first = NULL;
+static ri_profile_zone_t * m_p_last = NULL;
+static ri_atomic_t m_lock = RI_ATOMIC_FLAG_INIT;
+
+static void zone_register (ri_profile_zone_t * const p_zone)
+{
+    // Zone is registered on a later call if list is busy.
+    if (ri_atomic_flag (&m_lock, true))
+    {
+        if (!p_zone->registered)
+        {
+            p_zone->p_next = NULL;
+
+            if (NULL == m_p_last)
+            {
+                m_p_first = p_zone;
+            }
+            else
+            {
+                m_p_last->p_next = p_zone;
+            }
+
+            m_p_last = p_zone;
+            p_zone->registered = true;
+        }
+
+        ri_atomic_flag (&m_lock, false);
+    }
+}
+
+void ri_profile_zone_record (ri_profile_zone_t * const p_zone,
+                             const uint32_t start_ticks)
+{
+    const uint32_t duration = ri_profile_ticks_get() - start_ticks;
+
+    if (NULL != p_zone)
+    {
+        if (!p_zone->registered)
+        {
+            zone_register (p_zone);
+        }
+
+        p_zone->calls++;
+        p_zone->total_ticks += duration;
+
+        if (duration < p_zone->min_ticks)
+        {
+            p_zone->min_ticks = duration;
+        }
+
+        if (duration > p_zone->max_ticks)
+        {
+            p_zone->max_ticks = duration;
+        }
+    }
+}
+
+const ri_profile_zone_t * ri_profile_zone_next (const ri_profile_zone_t * const p_zone)
+{
+    return (NULL == p_zone) ? m_p_first : p_zone->p_next;
+}
+
+rd_status_t ri_profile_reset (void)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if (ri_atomic_flag (&m_lock, true))
+    {
+        for (ri_profile_zone_t * p_zone = m_p_first; NULL != p_zone; p_zone = p_zone->p_next)
+        {
+            p_zone->calls = 0;
+            p_zone->total_ticks = 0;
+            p_zone->min_ticks = UINT32_MAX;
+            p_zone->max_ticks = 0;
+        }
+
+        ri_atomic_flag (&m_lock, false);
+    }
+    else
+    {
+        err_code |= RD_ERROR_BUSY;
+    }
+
+    return err_code;
+}
+
+/** @} */
+#endif
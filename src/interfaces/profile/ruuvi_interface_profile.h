@@ -0,0 +1,139 @@
+#ifndef RUUVI_INTERFACE_PROFILE_H
+#define RUUVI_INTERFACE_PROFILE_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+/**
+ * @defgroup Profile Profiling counters
+ * @brief Measure time spent in hot paths.
+ *
+ */
+/** @{ */
+/**
+ * @file ruuvi_interface_profile.h
+ * @author Otso Jousimaa <otso@ojousima.net>
+ * @date 2026-10-18
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ *
+ * Lightweight profiling zones.
+ *
+ * A zone is a statically allocated counter which records number of calls
+ * and minimum, average and maximum duration of a code block. Zones register
+ * themselves on first use, so there is no central table to maintain.
+ * Durations are measured in platform ticks: CPU cycles on nRF5, nanoseconds on POSIX hosts.
+ * CPU cycle counter stops while CPU sleeps, so zones measure active CPU time.
+ *
+ * Profiling is disabled by default, and the macros compile to nothing
+ * unless RI_PROFILE_ENABLED is set.
+ *
+ * Typical usage:
+ *
+ * @code{.c}
+ *  RI_PROFILE_ZONE_DEF (m_zone_fifo, "lis2dh12 fifo");
+ *
+ *  rd_status_t fifo_read (...)
+ *  {
+ *      RI_PROFILE_ENTER (m_zone_fifo);
+ *      // ... Work to measure.
+ *      RI_PROFILE_EXIT (m_zone_fifo);
+ *      return err_code;
+ *  }
+ * @endcode
+ */
+
+#include "ruuvi_driver_enabled_modules.h"
+#include "ruuvi_driver_error.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/** @brief Enable implementation selected by application */
+#if RI_PROFILE_ENABLED
+#  define RUUVI_NRF5_SDK15_PROFILE_ENABLED RUUVI_NRF5_SDK15_ENABLED
+#  define RUUVI_POSIX_PROFILE_ENABLED RUUVI_POSIX_ENABLED
+#endif
+
+/** @brief Statistics of one profiling zone. Use @ref RI_PROFILE_ZONE_DEF to define. */
+typedef struct ri_profile_zone_s
+{
+    const char * const p_name;          //!< Name of zone, shown in report.
+    uint32_t calls;                     //!< Number of completed calls.
+    uint32_t min_ticks;                 //!< Shortest call.
+    uint32_t max_ticks;                 //!< Longest call.
+    uint64_t total_ticks;               //!< Sum of all calls, for average.
+    struct ri_profile_zone_s * p_next;  //!< Next registered zone.
+    bool registered;                    //!< True once zone is in zone list.
+} ri_profile_zone_t;
+
+#if RI_PROFILE_ENABLED
+/** @brief Define a zone named @p zone with report name @p name. */
+#  define RI_PROFILE_ZONE_DEF(zone, name) \
+    static ri_profile_zone_t zone = { .p_name = (name), .min_ticks = UINT32_MAX }
+/** @brief Start measuring @p zone, must be paired with @ref RI_PROFILE_EXIT in same scope. */
+#  define RI_PROFILE_ENTER(zone) \
+    const uint32_t zone ## _start = ri_profile_ticks_get()
+/** @brief Stop measuring @p zone and record duration. */
+#  define RI_PROFILE_EXIT(zone) \
+    ri_profile_zone_record (&(zone), zone ## _start)
+#else
+#  define RI_PROFILE_ZONE_DEF(zone, name) \
+    extern ri_profile_zone_t zone ## _unused //!< Keeps trailing semicolon valid.
+#  define RI_PROFILE_ENTER(zone) do {} while (0)
+#  define RI_PROFILE_EXIT(zone)  do {} while (0)
+#endif
+
+/**
+ * @brief Start tick source of platform.
+ *
+ * @retval RD_SUCCESS on success.
+ * @retval RD_ERROR_NOT_SUPPORTED if platform has no tick source.
+ */
+rd_status_t ri_profile_init (void);
+
+/**
+ * @brief Get current tick count of platform.
+ *
+ * Counter wraps around, durations are calculated modulo 2^32.
+ *
+ * @return Current tick count.
+ */
+uint32_t ri_profile_ticks_get (void);
+
+/**
+ * @brief Get number of ticks per microsecond.
+ *
+ * @return Ticks per microsecond, at least 1.
+ */
+uint32_t ri_profile_ticks_per_us (void);
+
+/**
+ * @brief Record one call of a zone.
+ *
+ * Registers zone on first call. Called by @ref RI_PROFILE_EXIT.
+ *
+ * @param[in,out] p_zone Zone to update.
+ * @param[in] start_ticks Tick count at start of call.
+ */
+void ri_profile_zone_record (ri_profile_zone_t * const p_zone,
+                             const uint32_t start_ticks);
+
+/**
+ * @brief Iterate over registered zones.
+ *
+ * @param[in] p_zone Previous zone, NULL to get first zone.
+ * @return Next registered zone, NULL if there are no more zones.
+ */
+const ri_profile_zone_t * ri_profile_zone_next (const ri_profile_zone_t * const p_zone);
+
+/**
+ * @brief Clear statistics of all registered zones.
+ *
+ * @retval RD_SUCCESS on success.
+ * @retval RD_ERROR_BUSY if a zone is being registered.
+ */
+rd_status_t ri_profile_reset (void);
+
+/** @} */
+#ifdef __cplusplus
+}
+#endif
+#endif
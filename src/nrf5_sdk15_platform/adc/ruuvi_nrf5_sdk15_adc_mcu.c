@@ -45,11 +45,16 @@
  */
 #include "ruuvi_driver_enabled_modules.h"
 #include "ruuvi_interface_adc_mcu.h"
+#include "ruuvi_interface_adc_stream.h"
 #if RUUVI_NRF5_SDK15_ADC_ENABLED
 #include "ruuvi_driver_error.h"
 #include "ruuvi_nrf5_sdk15_error.h"
 
 #include "nrf_drv_saadc.h"
+#if RUUVI_NRF5_SDK15_ADC_STREAM_ENABLED
+#include "nrf_drv_ppi.h"
+#include "nrf_drv_timer.h"
+#endif
 
 #include <string.h>
 
@@ -73,6 +78,10 @@
 #define ADC_BITS_RESOLUTION_14 14
 #define ADC_BITS_RESOLUTION_NUM 4
 
+#define ADC_STREAM_US_PER_CHANNEL 12U      //!< 10 us acquisition + 2 us conversion.
+#define ADC_STREAM_US_PER_S       1000000U
+#define ADC_STREAM_MAX_BLOCK      0x7FFFU  //!< EasyDMA MAXCNT of SAADC.
+
 static float pre_scaling_values[ADC_PRE_SCALING_NUM] =
 {
     ADC_PRE_SCALING_COMPENSATION_1_6,
@@ -94,6 +103,19 @@ static nrf_saadc_channel_config_t * p_channel_configs[NRF_SAADC_CHANNEL_COUNT] =
 static bool m_adc_is_init = false;
 static nrf_drv_saadc_config_t adc_config = NRF_DRV_SAADC_DEFAULT_CONFIG;
 
+static volatile bool m_scan_done = false;
+#if RUUVI_NRF5_SDK15_ADC_STREAM_ENABLED
+static const nrf_drv_timer_t m_stream_timer =
+    NRF_DRV_TIMER_INSTANCE (RUUVI_NRF5_SDK15_ADC_STREAM_TIMER_INSTANCE);
+static nrf_ppi_channel_t m_stream_ppi;
+static bool m_stream_ppi_allocated = false; //!< PPI channel is owned by stream.
+static const ri_adc_stream_limits_t m_stream_limits =
+{
+    .max_scan_us = ADC_STREAM_US_PER_CHANNEL,
+    .max_block = ADC_STREAM_MAX_BLOCK
+};
+#endif
+
 static uint8_t bits_resolution[ADC_BITS_RESOLUTION_NUM] =
 {
     ADC_BITS_RESOLUTION_8, ADC_BITS_RESOLUTION_10,
@@ -276,14 +298,30 @@ static float raw_adc_to_ratio (uint8_t channel_num,
 
 /**
  * @brief Function handling events from 'nrf_drv_saadc.c'.
- * No implementation needed
+ *
+ * Single-shot conversions are blocking and need no handling.
+ * In continuous sampling full block is passed to application and
+ * queued back to ADC for the block after next.
  *
  * @param[in] p_evt SAADC event.
  */
 static void saadc_event_handler (nrf_drv_saadc_evt_t const * p_evt)
 {
-    if (p_evt->type == NRF_DRV_SAADC_EVT_DONE)
+    if ( (p_evt->type == NRF_DRV_SAADC_EVT_DONE) && ri_adc_stream_is_running())
+    {
+        if (ri_adc_stream_block_done (p_evt->data.done.p_buffer, p_evt->data.done.size))
+        {
+            (void) nrf_drv_saadc_buffer_convert (p_evt->data.done.p_buffer,
+                                                 p_evt->data.done.size);
+        }
+    }
+    else if (p_evt->type == NRF_DRV_SAADC_EVT_DONE)
     {
+        m_scan_done = true;
+    }
+    else
+    {
+        // No action needed.
     }
 }
 
@@ -324,6 +362,7 @@ rd_status_t ri_adc_uninit (bool config_default)
 
     if (true == ri_adc_is_init())
     {
+        status |= ri_adc_stream_stop();
         nrf_drv_saadc_uninit();
 
         if (true == config_default)
@@ -381,7 +420,11 @@ rd_status_t ri_adc_configure (uint8_t channel_num,
 {
     rd_status_t status = RD_SUCCESS;
 
-    if (true == ri_adc_is_init())
+    if (ri_adc_stream_is_running())
+    {
+        status = RD_ERROR_INVALID_STATE;
+    }
+    else if (true == ri_adc_is_init())
     {
         if (true == nrf_drv_saadc_is_busy())
         {
@@ -479,7 +522,8 @@ rd_status_t ri_adc_get_raw_data (uint8_t channel_num,
     rd_status_t status = RD_ERROR_INVALID_STATE;
     nrf_saadc_value_t adc_buf;
 
-    if (NRF_SUCCESS == nrf_drv_saadc_sample_convert (channel_num, &adc_buf))
+    if ( (!ri_adc_stream_is_running())
+            && (NRF_SUCCESS == nrf_drv_saadc_sample_convert (channel_num, &adc_buf)))
     {
         (*p_data) = (int16_t) (adc_buf);
         status = RD_SUCCESS;
@@ -489,11 +533,11 @@ rd_status_t ri_adc_get_raw_data (uint8_t channel_num,
 }
 
 /**
- * @brief get raw adc reading.
+ * @brief check that raw adc reading of channel can be converted with given config.
  */
-static rd_status_t nrf5_adc_get_raw (uint8_t channel_num,
-                                     ri_adc_get_data_t * p_config,
-                                     int16_t * const p_data)
+static rd_status_t nrf5_adc_conversion_check (uint8_t channel_num,
+        ri_adc_get_data_t * p_config,
+        const void * const p_data)
 {
     rd_status_t status = RD_SUCCESS;
 
@@ -501,6 +545,10 @@ static rd_status_t nrf5_adc_get_raw (uint8_t channel_num,
     {
         status |= RD_ERROR_NULL;
     }
+    else if (NRF_SAADC_CHANNEL_COUNT <= channel_num)
+    {
+        status |= RD_ERROR_INVALID_PARAM;
+    }
     else
     {
         nrf_saadc_channel_config_t * p_ch_config =
@@ -515,15 +563,86 @@ static rd_status_t nrf5_adc_get_raw (uint8_t channel_num,
         {
             status |= RD_ERROR_INVALID_PARAM;
         }
+    }
+
+    return status;
+}
+
+/**
+ * @brief Count channels included in each scan.
+ */
+static size_t configured_channels_count (void)
+{
+    size_t channels = 0;
+
+    for (uint8_t i = 0; i < NRF_SAADC_CHANNEL_COUNT; i++)
+    {
+        if (NULL != p_channel_configs[i])
+        {
+            channels++;
+        }
+    }
+
+    return channels;
+}
+
+rd_status_t ri_adc_scan_raw (int16_t * const p_data, const size_t num_samples)
+{
+    rd_status_t status = RD_SUCCESS;
+
+    if (NULL == p_data)
+    {
+        status |= RD_ERROR_NULL;
+    }
+    else if (!ri_adc_is_init() || ri_adc_stream_is_running())
+    {
+        status |= RD_ERROR_INVALID_STATE;
+    }
+    else if ( (0U == num_samples) || (configured_channels_count() != num_samples))
+    {
+        status |= RD_ERROR_INVALID_PARAM;
+    }
+    else
+    {
+        m_scan_done = false;
+        // END left by an earlier conversion must not end this scan.
+        nrf_saadc_event_clear (NRF_SAADC_EVENT_END);
+
+        if ( (NRF_SUCCESS == nrf_drv_saadc_buffer_convert (p_data, (uint16_t) num_samples))
+                && (NRF_SUCCESS == nrf_drv_saadc_sample()))
+        {
+            // Scan takes ADC_STREAM_US_PER_CHANNEL per channel. Driver handles END in
+            // SAADC interrupt and is free for next conversion once it reports DONE.
+            while (!m_scan_done)
+            {
+            }
+        }
         else
         {
-            status |= ri_adc_get_raw_data (channel_num, p_data);
+            status |= RD_ERROR_INVALID_STATE;
         }
     }
 
     return status;
 }
 
+/**
+ * @brief get raw adc reading.
+ */
+static rd_status_t nrf5_adc_get_raw (uint8_t channel_num,
+                                     ri_adc_get_data_t * p_config,
+                                     int16_t * const p_data)
+{
+    rd_status_t status = nrf5_adc_conversion_check (channel_num, p_config, p_data);
+
+    if (RD_SUCCESS == status)
+    {
+        status |= ri_adc_get_raw_data (channel_num, p_data);
+    }
+
+    return status;
+}
+
 rd_status_t ri_adc_get_data_absolute (uint8_t channel_num,
                                       ri_adc_get_data_t * p_config,
                                       float * p_data)
@@ -556,6 +675,200 @@ rd_status_t ri_adc_get_data_ratio (uint8_t channel_num,
     return status;
 }
 
+rd_status_t ri_adc_raw_to_absolute (uint8_t channel_num,
+                                    ri_adc_get_data_t * p_config,
+                                    const int16_t raw,
+                                    float * p_data)
+{
+    int16_t data = raw;
+    rd_status_t status = nrf5_adc_conversion_check (channel_num, p_config, p_data);
+
+    if (RD_SUCCESS == status)
+    {
+        (*p_data) = raw_adc_to_volts (channel_num, p_config, &data);
+    }
+
+    return status;
+}
+
+rd_status_t ri_adc_raw_to_ratio (uint8_t channel_num,
+                                 ri_adc_get_data_t * p_config,
+                                 const int16_t raw,
+                                 float * p_data)
+{
+    int16_t data = raw;
+    rd_status_t status = nrf5_adc_conversion_check (channel_num, p_config, p_data);
+
+    if (RD_SUCCESS == status)
+    {
+        (*p_data) = raw_adc_to_ratio (channel_num, p_config, &data);
+    }
+
+    return status;
+}
+
+#if RUUVI_NRF5_SDK15_ADC_STREAM_ENABLED
+
+/**
+ * @brief Timer runs only to trigger sampling through PPI, driver requires a handler.
+ */
+static void stream_timer_handler (nrf_timer_event_t event_type, void * p_context)
+{
+}
+
+/**
+ * @brief Release stream timer and PPI channel, abort ongoing scan.
+ */
+static void stream_hw_release (void)
+{
+    nrf_drv_timer_disable (&m_stream_timer);
+
+    // Channel is not ours if allocation failed, it may belong to another module.
+    if (m_stream_ppi_allocated)
+    {
+        (void) nrf_drv_ppi_channel_disable (m_stream_ppi);
+        (void) nrf_drv_ppi_channel_free (m_stream_ppi);
+        m_stream_ppi_allocated = false;
+    }
+
+    ri_adc_stream_close();
+    nrf_drv_saadc_abort();
+    nrf_drv_timer_uninit (&m_stream_timer);
+}
+
+/**
+ * @brief Connect timer to SAADC sample task and queue both halves of buffer.
+ */
+static rd_status_t stream_hw_start (const ri_adc_stream_config_t * const p_config)
+{
+    nrf_drv_timer_config_t timer_cfg = NRF_DRV_TIMER_DEFAULT_CONFIG;
+    ret_code_t nrf_code = NRF_SUCCESS;
+    timer_cfg.bit_width = NRF_TIMER_BIT_WIDTH_32;
+    nrf_code = nrf_drv_timer_init (&m_stream_timer, &timer_cfg, &stream_timer_handler);
+
+    if (NRF_SUCCESS == nrf_code)
+    {
+        const uint32_t ticks = nrf_drv_timer_us_to_ticks (&m_stream_timer,
+                               ADC_STREAM_US_PER_S / p_config->samplerate_hz);
+        nrf_drv_timer_extended_compare (&m_stream_timer, NRF_TIMER_CC_CHANNEL0, ticks,
+                                        NRF_TIMER_SHORT_COMPARE0_CLEAR_MASK, false);
+        nrf_code = nrf_drv_ppi_init();
+
+        // PPI is shared, it may have been initialized by another module.
+        if (NRF_ERROR_MODULE_ALREADY_INITIALIZED == nrf_code)
+        {
+            nrf_code = NRF_SUCCESS;
+        }
+
+        if (NRF_SUCCESS == nrf_code)
+        {
+            nrf_code = nrf_drv_ppi_channel_alloc (&m_stream_ppi);
+            m_stream_ppi_allocated = (NRF_SUCCESS == nrf_code);
+        }
+
+        if (NRF_SUCCESS == nrf_code)
+        {
+            nrf_code = nrf_drv_ppi_channel_assign (m_stream_ppi,
+                                                   nrf_drv_timer_compare_event_address_get (&m_stream_timer,
+                                                           NRF_TIMER_CC_CHANNEL0),
+                                                   nrf_drv_saadc_sample_task_get());
+        }
+
+        if (NRF_SUCCESS == nrf_code)
+        {
+            nrf_code = nrf_drv_saadc_buffer_convert (p_config->p_buffer,
+                       (uint16_t) p_config->block_samples);
+        }
+
+        if (NRF_SUCCESS == nrf_code)
+        {
+            nrf_code = nrf_drv_saadc_buffer_convert (p_config->p_buffer + p_config->block_samples,
+                       (uint16_t) p_config->block_samples);
+        }
+
+        if (NRF_SUCCESS == nrf_code)
+        {
+            nrf_code = nrf_drv_ppi_channel_enable (m_stream_ppi);
+        }
+
+        if (NRF_SUCCESS == nrf_code)
+        {
+            nrf_drv_timer_enable (&m_stream_timer);
+        }
+        else
+        {
+            stream_hw_release();
+        }
+    }
+
+    return ruuvi_nrf5_sdk15_to_ruuvi_error (nrf_code);
+}
+
+rd_status_t ri_adc_stream_start (const ri_adc_stream_config_t * const p_config)
+{
+    rd_status_t status = RD_SUCCESS;
+    const size_t channels = configured_channels_count();
+
+    if (!ri_adc_is_init())
+    {
+        status |= RD_ERROR_INVALID_STATE;
+    }
+    else if ( (1U < channels) && (NRF_SAADC_OVERSAMPLE_DISABLED != adc_config.oversample))
+    {
+        status |= RD_ERROR_INVALID_PARAM;
+    }
+    else
+    {
+        status |= ri_adc_stream_open (p_config, channels, &m_stream_limits);
+
+        if (RD_SUCCESS == status)
+        {
+            if (true == nrf_drv_saadc_is_busy())
+            {
+                nrf_drv_saadc_abort();
+            }
+
+            status |= stream_hw_start (p_config);
+
+            if (RD_SUCCESS != status)
+            {
+                ri_adc_stream_close();
+            }
+        }
+    }
+
+    return status;
+}
+
+rd_status_t ri_adc_stream_stop (void)
+{
+    if (ri_adc_stream_is_running())
+    {
+        stream_hw_release();
+    }
+
+    return RD_SUCCESS;
+}
+
+#else
+
+rd_status_t ri_adc_stream_start (const ri_adc_stream_config_t * const p_config)
+{
+    return RD_ERROR_NOT_SUPPORTED;
+}
+
+rd_status_t ri_adc_stream_stop (void)
+{
+    return RD_SUCCESS;
+}
+
+bool ri_adc_stream_is_running (void)
+{
+    return false;
+}
+
+#endif
+
 bool ri_adc_mcu_is_valid_ch (const uint8_t ch)
 {
     return ch < NRF_SAADC_CHANNEL_COUNT;
@@ -12,9 +12,13 @@
 #include "ruuvi_driver_error.h"
 #include "ruuvi_nrf5_sdk15_error.h"
 #include "ruuvi_nrf5_sdk15_communication_radio.h"
+#include "ruuvi_interface_atomic.h"
 #include "ruuvi_interface_communication.h"
 #include "ruuvi_interface_communication_radio.h"
+#include "ruuvi_interface_communication_rotation.h"
+#include "ruuvi_interface_communication_tx_gate.h"
 #include "ruuvi_interface_log.h"
+#include "ruuvi_interface_profile.h"
 #include "nordic_common.h"
 #include "nrf_ble_scan.h"
 #include "nrf_nvic.h"
@@ -34,30 +38,16 @@
 #else
 #define LOG_LEVEL RUUVI_NRF5_SDK15_ADV_LOG_LEVEL
 #endif
-static inline void LOG (const char * const msg)
-{
-    ri_log (LOG_LEVEL, msg);
-}
-
-static inline void LOGD (const char * const msg)
-{
-    ri_log (RI_LOG_LEVEL_DEBUG, msg);
-}
-
-static inline void LOGI (const char * const msg)
-{
-    ri_log (RI_LOG_LEVEL_INFO, msg);
-}
-
-static inline void LOGW (const char * const msg)
-{
-    ri_log (RI_LOG_LEVEL_WARNING, msg);
-}
-
-static inline void LOGE (const char * const msg)
-{
-    ri_log (RI_LOG_LEVEL_ERROR, msg);
-}
+#ifndef RUUVI_NRF5_SDK15_ADV_LOG_COMPILE_LEVEL
+#define RUUVI_NRF5_SDK15_ADV_LOG_COMPILE_LEVEL RI_LOG_COMPILE_LEVEL
+#endif
+#define ADV_LOG(severity, msg) RI_LOG_MODULE(RI_LOG_MODULE_ADV, \
+        RUUVI_NRF5_SDK15_ADV_LOG_COMPILE_LEVEL, severity, msg)
+#define LOG(msg)  ADV_LOG(LOG_LEVEL, msg)
+#define LOGD(msg) ADV_LOG(RI_LOG_LEVEL_DEBUG, msg)
+#define LOGI(msg) ADV_LOG(RI_LOG_LEVEL_INFO, msg)
+#define LOGW(msg) ADV_LOG(RI_LOG_LEVEL_WARNING, msg)
+#define LOGE(msg) ADV_LOG(RI_LOG_LEVEL_ERROR, msg)
 
 #define DEFAULT_ADV_INTERVAL_MS      (1010U)
 #define MIN_ADV_INTERVAL_MS          (100U)
@@ -102,17 +92,42 @@ static bool m_is_rx_le_1m_phy_enabled;       //!< Is 1 MBit/s PHY enabled.
 static bool m_is_rx_le_2m_phy_enabled;       //!< Is 2 MBit/s PHY enabled.
 static bool m_is_rx_le_coded_phy_enabled;    //!< Is 125 kBit/s PHY enabled.
 static uint8_t m_max_adv_length = 0;         //!< Maximum length of advertisement.
+static ri_radio_modulation_t m_scan_modulation; //!< PHY being scanned.
+static bool m_scan_phy_only;                    //!< Report only scanned PHY, see ri_adv_scan_phy_start.
 
 /** @brief Advertising handle used to identify an advertising set. */
 static uint8_t m_adv_handle = BLE_GAP_ADV_SET_HANDLE_NOT_SET;
 /** @brief Flag for initialization **/
 static bool m_advertisement_is_init = false;
-/** @brief Flag for advertising in process **/
-static bool m_advertising = false;
+/**
+ * @brief Advertisement given to the stack.
+ *
+ * Stack reads data from these buffers while advertising, payload update
+ * writes into buffer which is not on air and then swaps buffers.
+ */
+static advertisement_t m_live[2];
+static uint8_t m_live_index; //!< Buffer on air.
+
+#define ROTATION_BUFFERS (3U) //!< On air, latest payload and payload being written.
+
+/** @brief Resident payload of advertisement rotation. */
+typedef struct
+{
+    advertisement_t adv[ROTATION_BUFFERS]; //!< Encoded payloads.
+    volatile uint8_t ready;                //!< Buffer with latest payload.
+    volatile bool enabled;                 //!< Slot is part of rotation.
+    ri_atomic_t lock;                      //!< Set while slot is written.
+} rotation_slot_t;
+
+static rotation_slot_t m_rotation[RI_ADV_ROTATION_SLOTS];
+static uint8_t m_rotation_slot;         //!< Slot on air.
+static uint8_t m_rotation_buffer;       //!< Buffer of slot on air.
+
 /** @brief flag for including Ruuvi Sensor data service UUID in the advertisement **/
 static bool m_include_service_uuid = false;
 /** @brief 16-bit Bluetooth Service UUID to advertise, Ruuvi's UUID by default. */
 static uint16_t m_service_uuid = 0xFC98;
+RI_PROFILE_ZONE_DEF (m_zone_send, "adv send");
 
 /**< Universally unique service identifier of Nordic UART Service */
 #if RUUVI_NRF5_SDK15_GATT_ENABLED
@@ -123,57 +138,179 @@ static ble_uuid_t m_adv_uuids[] =
 };
 #endif
 
-static rd_status_t prepare_tx()
+static bool adv_pending (void)
 {
+    return !nrf_queue_is_empty (&m_adv_queue);
+}
+
+/** @brief Pop next advertisement and start it, called by owner of m_tx_gate. */
+static rd_status_t adv_start_next (void)
+{
+    rd_status_t err_code = RD_SUCCESS;
     ret_code_t nrf_code = NRF_SUCCESS;
+    advertisement_t * const p_adv = &m_live[m_live_index];
 
-    // XXX: Use atomic compare-and-swap
-    if (!nrf_queue_is_empty (&m_adv_queue) && !m_advertising)
+    if (NRF_SUCCESS != nrf_queue_pop (&m_adv_queue, p_adv))
+    {
+        // Queue was emptied after it was checked, e.g. by a stop.
+        err_code |= RD_ERROR_NOT_FOUND;
+    }
+    else
     {
-        static advertisement_t adv;
-        nrf_queue_pop (&m_adv_queue, &adv);
         // Pointers have been invalidated in queuing, refresh.
-        adv.data.adv_data.p_data = adv.adv_data;
+        p_adv->data.adv_data.p_data = p_adv->adv_data;
 
-        if (adv.data.scan_rsp_data.len > 0)
+        if (p_adv->data.scan_rsp_data.len > 0)
         {
-            adv.data.scan_rsp_data.p_data = adv.scan_data;
+            p_adv->data.scan_rsp_data.p_data = p_adv->scan_data;
         }
 
         nrf_code |= sd_ble_gap_adv_set_configure (&m_adv_handle,
-                    &adv.data,
-                    &adv.params);
+                    &p_adv->data,
+                    &p_adv->params);
         nrf_code |= sd_ble_gap_tx_power_set (BLE_GAP_TX_POWER_ROLE_ADV,
                                              m_adv_handle,
-                                             adv.tx_pwr);
+                                             p_adv->tx_pwr);
         nrf_code |= sd_ble_gap_adv_start (m_adv_handle,
                                           RUUVI_NRF5_SDK15_BLE4_STACK_CONN_TAG);
+        err_code |= ruuvi_nrf5_sdk15_to_ruuvi_error (nrf_code);
+    }
 
-        if (NRF_SUCCESS == nrf_code)
-        {
-            m_advertising = true;
-        }
-        else
+    return err_code;
+}
+
+/**
+ * @brief Advertising set, owned from start of an advertisement until it is terminated.
+ *
+ * Queue is filled in thread context and advertisements are started from both
+ * thread and BLE observer interrupt, gate ensures that only one context starts
+ * the advertisement.
+ */
+static ri_comm_tx_gate_t m_tx_gate =
+{
+    .owned = RI_ATOMIC_FLAG_INIT,
+    .pending = adv_pending,
+    .start = adv_start_next
+};
+
+static rd_status_t prepare_tx()
+{
+    return ri_comm_tx_gate_kick (&m_tx_gate);
+}
+
+/** @brief notify application of advertising event */
+static void notify_app (const ri_comm_evt_t evt)
+{
+    if ( (NULL != m_channel)  && (NULL != m_channel->on_evt))
+    {
+        m_channel->on_evt (evt, NULL, 0);
+    }
+}
+
+/** @brief terminate advertising set, notify application */
+static void notify_adv_stop (const ri_comm_evt_t evt)
+{
+    ri_comm_tx_gate_release (&m_tx_gate);
+    notify_app (evt);
+}
+
+/**
+ * @brief Give next slot of rotation to the stack.
+ *
+ * Slots are encoded when they are set, only selecting the slot is done here.
+ * A slot which is being written is skipped on this round. If no other slot is
+ * available, buffer which was on air is sent again, it is never written while on air.
+ *
+ * @param[in] first_slot Slot to start search from.
+ * @retval RD_SUCCESS if slot was started.
+ * @retval RD_ERROR_INVALID_STATE if no slot is in use.
+ * @return error code from stack on other error.
+ */
+static rd_status_t rotation_select (const uint8_t first_slot)
+{
+    rd_status_t err_code = RD_SUCCESS;
+    ret_code_t nrf_code = NRF_SUCCESS;
+    uint8_t slot = RI_ADV_ROTATION_SLOTS;
+    uint8_t buffer = ROTATION_BUFFERS;
+
+    for (uint8_t ii = 0; (ii < RI_ADV_ROTATION_SLOTS) && (RI_ADV_ROTATION_SLOTS == slot); ii++)
+    {
+        const uint8_t candidate = (first_slot + ii) % RI_ADV_ROTATION_SLOTS;
+        rotation_slot_t * const p_slot = &m_rotation[candidate];
+
+        if (p_slot->enabled && ri_atomic_flag (&p_slot->lock, true))
         {
-            // Recursion depth is limited to depth of m_adv_queue.
-            prepare_tx();
+            slot = candidate;
+            buffer = p_slot->ready;
+            (void) ri_atomic_flag (&p_slot->lock, false);
         }
     }
 
-    return ruuvi_nrf5_sdk15_to_ruuvi_error (nrf_code);
+    if (RI_ADV_ROTATION_SLOTS != slot)
+    {
+        m_rotation_slot = slot;
+        m_rotation_buffer = buffer;
+    }
+    else if ( (ROTATION_BUFFERS <= m_rotation_buffer)
+              || !m_rotation[m_rotation_slot].enabled)
+    {
+        err_code |= RD_ERROR_INVALID_STATE;
+    }
+    else
+    {
+        // Only slot is being written, repeat the buffer on air.
+    }
+
+    if (RD_SUCCESS == err_code)
+    {
+        advertisement_t * const p_adv = &m_rotation[m_rotation_slot].adv[m_rotation_buffer];
+        nrf_code |= sd_ble_gap_adv_set_configure (&m_adv_handle,
+                    &p_adv->data,
+                    &p_adv->params);
+        nrf_code |= sd_ble_gap_tx_power_set (BLE_GAP_TX_POWER_ROLE_ADV,
+                                             m_adv_handle,
+                                             p_adv->tx_pwr);
+        nrf_code |= sd_ble_gap_adv_start (m_adv_handle,
+                                          RUUVI_NRF5_SDK15_BLE4_STACK_CONN_TAG);
+        err_code |= ruuvi_nrf5_sdk15_to_ruuvi_error (nrf_code);
+    }
+
+    return err_code;
 }
 
-/** @brief terminate advertising set, notify application */
-static void notify_adv_stop (const ri_comm_evt_t evt)
+/** @brief Start first slot of rotation or the slot after one on air. */
+static rd_status_t rotation_next (const bool first)
 {
-    m_advertising = false; // Runs at highest app interrupt level, no need for atomic.
+    uint8_t next_slot = 0;
 
-    if ( (NULL != m_channel)  && (NULL != m_channel->on_evt))
+    if (first)
     {
-        m_channel->on_evt (evt, NULL, 0);
+        m_rotation_slot = 0;
+        m_rotation_buffer = ROTATION_BUFFERS;
     }
+    else
+    {
+        next_slot = (m_rotation_slot + 1U) % RI_ADV_ROTATION_SLOTS;
+    }
+
+    return rotation_select (next_slot);
 }
 
+/** @brief Stop advertising set of rotation. */
+static bool rotation_halt (void)
+{
+    // Fails if turn had just ended, termination event comes or came instead.
+    return (NRF_SUCCESS == sd_ble_gap_adv_stop (m_adv_handle));
+}
+
+/** @brief Advertisement rotation, owns m_tx_gate while running. */
+static ri_comm_rotation_t m_rotation_state =
+{
+    .p_gate = &m_tx_gate,
+    .next = rotation_next,
+    .halt = rotation_halt
+};
+
 // Register a handler for advertisement events.
 static void ble_advertising_on_ble_evt_isr (ble_evt_t const * p_ble_evt, void * p_context)
 {
@@ -181,6 +318,7 @@ static void ble_advertising_on_ble_evt_isr (ble_evt_t const * p_ble_evt, void *
     {
         case BLE_GAP_EVT_CONNECTED:
             nrf_queue_reset (&m_adv_queue);
+            ri_comm_rotation_abort (&m_rotation_state);
 
             if (CONNECTABLE_SCANNABLE == m_type)
             {
@@ -197,14 +335,31 @@ static void ble_advertising_on_ble_evt_isr (ble_evt_t const * p_ble_evt, void *
 
         case BLE_GAP_EVT_DISCONNECTED:
             nrf_queue_reset (&m_adv_queue);
+            ri_comm_rotation_abort (&m_rotation_state);
             notify_adv_stop (RI_COMM_ABORTED);
             break;
 
         // Upon terminated advertising (time-out), start next and notify application TX complete.
         case BLE_GAP_EVT_ADV_SET_TERMINATED:
-            notify_adv_stop (RI_COMM_SENT);
-            prepare_tx();
-            break;
+        {
+            const rd_status_t rotation_status = ri_comm_rotation_terminated (&m_rotation_state);
+
+            if (RD_ERROR_NOT_FOUND == rotation_status)
+            {
+                notify_adv_stop (RI_COMM_SENT);
+                prepare_tx();
+            }
+            else if (RD_SUCCESS != rotation_status)
+            {
+                // Rotation ended and freed the set.
+                notify_app (RI_COMM_ABORTED);
+            }
+            else
+            {
+                // Next slot on air, or rotation was stopped.
+            }
+        }
+        break;
 
         default:
             break;
@@ -235,6 +390,31 @@ static ble_adv_mac_addr_str_t ble_adv_mac_addr_to_str (const uint8_t * const p_m
 NRF_SDH_BLE_OBSERVER (m_ble_observer, APP_BLE_OBSERVER_PRIO,
                       ble_advertising_on_ble_evt_isr, NULL);
 
+/** @brief Check if report was received on the PHY selected by ri_adv_scan_phy_start. */
+static bool scan_phy_matches (ble_gap_evt_adv_report_t const * const p_report)
+{
+    bool matches = false;
+
+    if (RI_RADIO_BLE_2MBPS == m_scan_modulation)
+    {
+        // Legacy and 1 MBit/s secondary reports are heard on 1 MBit/s primary too.
+        matches = (BLE_GAP_PHY_2MBPS == p_report->secondary_phy);
+    }
+    else if (RI_RADIO_BLE_125KBPS == m_scan_modulation)
+    {
+        matches = (BLE_GAP_PHY_CODED == p_report->primary_phy);
+    }
+    else
+    {
+        // Long 1 MBit/s payloads are extended advertisements on 1 MBit/s secondary.
+        matches = (BLE_GAP_PHY_1MBPS == p_report->primary_phy)
+                  && ( (BLE_GAP_PHY_NOT_SET == p_report->secondary_phy)
+                       || (BLE_GAP_PHY_1MBPS == p_report->secondary_phy));
+    }
+
+    return matches;
+}
+
 // Register a handler for scan events.
 static void on_advertisement (scan_evt_t const * p_scan_evt)
 {
@@ -258,10 +438,16 @@ static void on_advertisement (scan_evt_t const * p_scan_evt)
 
             if ( (NULL != m_channel)  && (NULL != m_channel->on_evt))
             {
-                ri_radio_modulation_t modulation = RI_RADIO_BLE_1MBPS;
-                ri_radio_get_modulation (&modulation);
+                const ri_radio_modulation_t modulation = m_scan_modulation;
+
+                // Scan of one PHY selects PHY by itself, global PHY flags do not apply.
+                if (m_scan_phy_only && !scan_phy_matches (p_scan_evt->params.p_not_found))
+                {
+                    break;
+                }
 
-                if ( (RI_RADIO_BLE_1MBPS == modulation) && (!m_is_rx_le_1m_phy_enabled)
+                if ( (!m_scan_phy_only) && (RI_RADIO_BLE_1MBPS == modulation)
+                        && (!m_is_rx_le_1m_phy_enabled)
                         && (BLE_GAP_PHY_1MBPS == p_scan_evt->params.p_not_found->primary_phy)
                         && (BLE_GAP_PHY_NOT_SET == p_scan_evt->params.p_not_found->secondary_phy))
                 {
@@ -493,10 +679,10 @@ static rd_status_t format_msg (const ri_comm_message_t * const p_message,
  *
  */
 static rd_status_t set_phy_type (const ri_comm_message_t * const p_message,
+                                 const ri_radio_modulation_t modulation,
                                  advertisement_t * const p_adv)
 {
     rd_status_t err_code = RD_SUCCESS;
-    ri_radio_modulation_t modulation;
     bool extended_required = false;
     bool sec_phy_required = false;
 
@@ -506,8 +692,6 @@ static rd_status_t set_phy_type (const ri_comm_message_t * const p_message,
     }
     else
     {
-        err_code |= ri_radio_get_modulation (&modulation);
-
         if (p_message->data_length > NONEXTENDED_PAYLOAD_MAX_LEN)
         {
             sec_phy_required = true;
@@ -618,6 +802,38 @@ static rd_status_t set_phy_type (const ri_comm_message_t * const p_message,
     return err_code;
 }
 
+/** @brief Encode message and current settings into advertisement sent on given PHY. */
+static rd_status_t build_adv (const ri_comm_message_t * const message,
+                              const ri_radio_modulation_t modulation,
+                              advertisement_t * const p_adv)
+{
+    rd_status_t err_code = RD_SUCCESS;
+    memset (p_adv, 0, sizeof (advertisement_t));
+    p_adv->data.adv_data.p_data = p_adv->adv_data;
+    p_adv->data.adv_data.len = sizeof (p_adv->adv_data);
+
+    if (m_scannable)
+    {
+        p_adv->data.scan_rsp_data.p_data = p_adv->scan_data;
+        p_adv->data.scan_rsp_data.len = sizeof (p_adv->scan_data);
+    }
+    else
+    {
+        p_adv->data.scan_rsp_data.p_data = NULL;
+        p_adv->data.scan_rsp_data.len = 0;
+    }
+
+    err_code |= format_msg (message, p_adv);
+    err_code |= set_phy_type (message, modulation, p_adv);
+    p_adv->params.max_adv_evts = message->repeat_count;
+    p_adv->params.duration = 0; // Do not timeout, use repeat_count.
+    p_adv->params.filter_policy = BLE_GAP_ADV_FP_ANY;
+    p_adv->params.interval = MSEC_TO_UNITS (m_advertisement_interval_ms, UNIT_0_625_MS);
+    ruuvi_nrf5_sdk15_radio_channels_set (p_adv->params.channel_mask, m_radio_channels);
+    p_adv->tx_pwr = m_tx_power;
+    return err_code;
+}
+
 /**
  *  @brief Asynchronous transfer function. Puts/gets message in driver queue
  *
@@ -640,37 +856,173 @@ static rd_status_t ri_adv_send (ri_comm_message_t * message)
     }
     else
     {
+        RI_PROFILE_ENTER (m_zone_send);
         // Create message
-        advertisement_t adv = {0};
-        adv.data.adv_data.p_data = adv.adv_data;
-        adv.data.adv_data.len = sizeof (adv.adv_data);
+        advertisement_t adv;
+        ri_radio_modulation_t modulation = RI_RADIO_BLE_1MBPS;
+        err_code |= ri_radio_get_modulation (&modulation);
+        err_code |= build_adv (message, modulation, &adv);
+        nrf_code |= nrf_queue_push (&m_adv_queue, &adv);
+        err_code |= prepare_tx();
+        RI_PROFILE_EXIT (m_zone_send);
+    }
 
-        if (m_scannable)
+    return err_code | ruuvi_nrf5_sdk15_to_ruuvi_error (nrf_code);
+}
+
+rd_status_t ri_adv_data_update (const ri_comm_message_t * const message)
+{
+    rd_status_t err_code = RD_SUCCESS;
+    ret_code_t nrf_code = NRF_SUCCESS;
+
+    if (NULL == message)
+    {
+        err_code |= RD_ERROR_NULL;
+    }
+    else if (!ri_comm_tx_gate_is_busy (&m_tx_gate)
+             || ri_comm_rotation_is_running (&m_rotation_state)
+             || !nrf_queue_is_empty (&m_adv_queue))
+    {
+        err_code |= RD_ERROR_INVALID_STATE;
+    }
+    else
+    {
+        const uint8_t next_index = m_live_index ^ 1U;
+        const advertisement_t * const p_live = &m_live[m_live_index];
+        advertisement_t * const p_next = &m_live[next_index];
+        ri_radio_modulation_t modulation = RI_RADIO_BLE_1MBPS;
+        err_code |= ri_radio_get_modulation (&modulation);
+        err_code |= build_adv (message, modulation, p_next);
+
+        // Set parameters cannot change without stopping, payload must fit current set.
+        if ( (RD_SUCCESS == err_code)
+                && ( (p_next->params.properties.type != p_live->params.properties.type)
+                     || (p_next->params.primary_phy != p_live->params.primary_phy)
+                     || (p_next->params.secondary_phy != p_live->params.secondary_phy)))
         {
-            adv.data.scan_rsp_data.p_data = adv.scan_data;
-            adv.data.scan_rsp_data.len = sizeof (adv.scan_data);
+            err_code |= RD_ERROR_INVALID_PARAM;
         }
-        else
+
+        if (RD_SUCCESS == err_code)
         {
-            adv.data.scan_rsp_data.p_data = NULL;
-            adv.data.scan_rsp_data.len = 0;
-        }
+            // Parameters must be NULL while advertising, data buffers must differ from ones on air.
+            nrf_code |= sd_ble_gap_adv_set_configure (&m_adv_handle, &p_next->data, NULL);
 
-        err_code |= format_msg (message, &adv);
-        err_code |= set_phy_type (message, &adv);
-        adv.params.max_adv_evts = message->repeat_count;
-        adv.params.duration = 0; // Do not timeout, use repeat_count.
-        adv.params.filter_policy = BLE_GAP_ADV_FP_ANY;
-        adv.params.interval = MSEC_TO_UNITS (m_advertisement_interval_ms, UNIT_0_625_MS);
-        ruuvi_nrf5_sdk15_radio_channels_set (adv.params.channel_mask, m_radio_channels);
-        adv.tx_pwr = m_tx_power;
-        nrf_code |= nrf_queue_push (&m_adv_queue, &adv);
-        err_code |= prepare_tx();
+            if (NRF_SUCCESS == nrf_code)
+            {
+                p_next->params = p_live->params;
+                p_next->tx_pwr = p_live->tx_pwr;
+                m_live_index = next_index;
+            }
+        }
     }
 
     return err_code | ruuvi_nrf5_sdk15_to_ruuvi_error (nrf_code);
 }
 
+/** @brief Buffer of slot which is neither on air nor holding latest payload. */
+static uint8_t rotation_free_buffer (const uint8_t slot)
+{
+    const rotation_slot_t * const p_slot = &m_rotation[slot];
+    const uint8_t on_air = (ri_comm_rotation_is_running (&m_rotation_state)
+                            && (slot == m_rotation_slot)) ?
+                           m_rotation_buffer : ROTATION_BUFFERS;
+    uint8_t buffer = 0;
+
+    while ( (buffer == p_slot->ready) || (buffer == on_air))
+    {
+        buffer++;
+    }
+
+    return buffer;
+}
+
+rd_status_t ri_adv_rotation_slot_set (const uint8_t slot,
+                                      const ri_comm_message_t * const message,
+                                      const uint8_t weight,
+                                      const ri_radio_modulation_t modulation)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if (NULL == message)
+    {
+        err_code |= RD_ERROR_NULL;
+    }
+    else if (!m_advertisement_is_init)
+    {
+        err_code |= RD_ERROR_INVALID_STATE;
+    }
+    else if ( (RI_ADV_ROTATION_SLOTS <= slot) || (0U == weight))
+    {
+        err_code |= RD_ERROR_INVALID_PARAM;
+    }
+    else if (!ri_atomic_flag (&m_rotation[slot].lock, true))
+    {
+        err_code |= RD_ERROR_BUSY;
+    }
+    else
+    {
+        rotation_slot_t * const p_slot = &m_rotation[slot];
+        const uint8_t buffer = rotation_free_buffer (slot);
+        advertisement_t * const p_adv = &p_slot->adv[buffer];
+        err_code |= build_adv (message, modulation, p_adv);
+        p_adv->params.max_adv_evts = weight;
+
+        if (RD_SUCCESS == err_code)
+        {
+            p_slot->ready = buffer;
+            p_slot->enabled = true;
+        }
+
+        (void) ri_atomic_flag (&p_slot->lock, false);
+    }
+
+    return err_code;
+}
+
+rd_status_t ri_adv_rotation_slot_clear (const uint8_t slot)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if (RI_ADV_ROTATION_SLOTS <= slot)
+    {
+        err_code |= RD_ERROR_INVALID_PARAM;
+    }
+    else if (!ri_atomic_flag (&m_rotation[slot].lock, true))
+    {
+        err_code |= RD_ERROR_BUSY;
+    }
+    else
+    {
+        m_rotation[slot].enabled = false;
+        (void) ri_atomic_flag (&m_rotation[slot].lock, false);
+    }
+
+    return err_code;
+}
+
+rd_status_t ri_adv_rotation_start (void)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if (!m_advertisement_is_init)
+    {
+        err_code |= RD_ERROR_INVALID_STATE;
+    }
+    else
+    {
+        // Queued advertisements wait while rotation owns the advertising set.
+        err_code |= ri_comm_rotation_start (&m_rotation_state);
+    }
+
+    return err_code;
+}
+
+rd_status_t ri_adv_rotation_stop (void)
+{
+    return ri_comm_rotation_stop (&m_rotation_state);
+}
+
 static rd_status_t ri_adv_receive (ri_comm_message_t * message)
 {
     return RD_ERROR_NOT_IMPLEMENTED;
@@ -711,10 +1063,10 @@ rd_status_t ri_adv_uninit (ri_comm_channel_t * const channel)
     rd_status_t err_code = RD_SUCCESS;
 
     // Stop advertising
-    if (true == m_advertising)
+    if (ri_comm_tx_gate_is_busy (&m_tx_gate))
     {
         sd_ble_gap_adv_stop (m_adv_handle);
-        m_advertising = false;
+        ri_comm_tx_gate_release (&m_tx_gate);
     }
 
     m_advertisement_is_init = false;
@@ -724,6 +1076,8 @@ rd_status_t ri_adv_uninit (ri_comm_channel_t * const channel)
     m_tx_power = 0;
     // Flush TX buffer.
     nrf_queue_reset (&m_adv_queue);
+    ri_comm_rotation_abort (&m_rotation_state);
+    memset (m_rotation, 0, sizeof (m_rotation));
     return err_code;
 }
 
@@ -741,18 +1095,41 @@ void ri_adv_rx_set_max_advertisement_data_length (const uint8_t max_adv_length)
     m_max_adv_length = max_adv_length;
 }
 
-rd_status_t ri_adv_scan_start (const uint32_t window_interval_ms,
-                               const uint32_t window_size_ms)
+static rd_status_t scan_start (const uint32_t window_interval_ms,
+                               const uint32_t window_size_ms,
+                               const uint8_t scan_phys, const bool extended)
 {
     ret_code_t status = NRF_SUCCESS;
-    rd_status_t err_code = RD_SUCCESS;
     nrf_ble_scan_init_t scan_init_params = {0};
     ble_gap_scan_params_t scan_params = {0};
-    uint8_t scan_phys = ruuvi_nrf5_sdk15_radio_phy_get();
     scan_params.active = 0; // Do not scan for scan responses
     ruuvi_nrf5_sdk15_radio_channels_set (scan_params.channel_mask, m_radio_channels);
-    scan_params.extended =
-        m_is_rx_le_2m_phy_enabled || m_is_rx_le_coded_phy_enabled;
+    scan_params.extended = extended;
+    NRF_LOG_INFO ("ri_adv_scan_start: NRF modulation: 0x%02x, ext_adv=%d",
+                  scan_phys, scan_params.extended);
+    scan_params.interval = MSEC_TO_UNITS (window_interval_ms, UNIT_0_625_MS);
+    scan_params.report_incomplete_evts = 0;
+    scan_params.scan_phys = scan_phys;
+    scan_params.window =  MSEC_TO_UNITS (window_size_ms, UNIT_0_625_MS);
+    scan_params.timeout = ri_radio_num_channels_get (m_radio_channels) *
+                          MSEC_TO_UNITS (window_interval_ms, UNIT_10_MS);
+    scan_init_params.p_scan_param = &scan_params;
+    status |= nrf_ble_scan_init (&m_scan,           // Scan control structure
+                                 &scan_init_params, // Default params for NULL values.
+                                 on_advertisement); // Callback on data
+    status |= nrf_ble_scan_start (&m_scan);
+    return ruuvi_nrf5_sdk15_to_ruuvi_error (status);
+}
+
+rd_status_t ri_adv_scan_start (const uint32_t window_interval_ms,
+                               const uint32_t window_size_ms)
+{
+    rd_status_t err_code = RD_SUCCESS;
+    uint8_t scan_phys = ruuvi_nrf5_sdk15_radio_phy_get();
+    const bool extended = m_is_rx_le_2m_phy_enabled || m_is_rx_le_coded_phy_enabled;
+    m_scan_modulation = RI_RADIO_BLE_1MBPS;
+    m_scan_phy_only = false;
+    (void) ri_radio_get_modulation (&m_scan_modulation);
 #if defined(RUUVI_NRF5_SDK15_ADV_EXTENDED_ENABLED) && RUUVI_NRF5_SDK15_ADV_EXTENDED_ENABLED
     {
         // 2MBit/s not allowed on primary channel,
@@ -764,25 +1141,32 @@ rd_status_t ri_adv_scan_start (const uint32_t window_interval_ms,
         }
     }
 #endif
-    NRF_LOG_INFO ("ri_adv_scan_start: NRF modulation: 0x%02x, ext_adv=%d",
-                  scan_phys, scan_params.extended);
+    err_code |= scan_start (window_interval_ms, window_size_ms, scan_phys, extended);
+    return err_code;
+}
 
-    if (RD_SUCCESS == err_code)
+rd_status_t ri_adv_scan_phy_start (const uint32_t window_interval_ms,
+                                   const uint32_t window_size_ms,
+                                   const ri_radio_modulation_t modulation)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if (!ri_radio_supports (modulation))
+    {
+        err_code |= RD_ERROR_NOT_SUPPORTED;
+    }
+    else
     {
-        scan_params.interval = MSEC_TO_UNITS (window_interval_ms, UNIT_0_625_MS);
-        scan_params.report_incomplete_evts = 0;
-        scan_params.scan_phys = scan_phys;
-        scan_params.window =  MSEC_TO_UNITS (window_size_ms, UNIT_0_625_MS);
-        scan_params.timeout = ri_radio_num_channels_get (m_radio_channels) *
-                              MSEC_TO_UNITS (window_interval_ms, UNIT_10_MS);
-        scan_init_params.p_scan_param = &scan_params;
-        status |= nrf_ble_scan_init (&m_scan,           // Scan control structure
-                                     &scan_init_params, // Default params for NULL values.
-                                     on_advertisement); // Callback on data
-        status |= nrf_ble_scan_start (&m_scan);
+        // 2 MBit/s is only used on secondary channels, reached from 1 MBit/s primary.
+        const uint8_t scan_phys = (RI_RADIO_BLE_125KBPS == modulation) ?
+                                  BLE_GAP_PHY_CODED : BLE_GAP_PHY_1MBPS;
+        m_scan_modulation = modulation;
+        m_scan_phy_only = true;
+        // Every PHY may carry extended advertisements, scan_phy_matches filters them.
+        err_code |= scan_start (window_interval_ms, window_size_ms, scan_phys, true);
     }
 
-    return ruuvi_nrf5_sdk15_to_ruuvi_error (status) | err_code;
+    return err_code;
 }
 
 rd_status_t ri_adv_scan_stop (void)
@@ -873,11 +1257,13 @@ rd_status_t ri_adv_type_set (ri_adv_type_t type)
 
 rd_status_t ri_adv_stop()
 {
+    // Empty queue first so that termination of ongoing advertisement does not start next one.
+    ri_comm_rotation_abort (&m_rotation_state);
+    nrf_queue_reset (&m_adv_queue);
     // SD returns error if advertisement wasn't ongoing, ignore error.
     (void) ruuvi_nrf5_sdk15_to_ruuvi_error (sd_ble_gap_adv_stop (
             m_adv_handle));
-    m_advertising = false;
-    nrf_queue_reset (&m_adv_queue);
+    ri_comm_tx_gate_release (&m_tx_gate);
     return RD_SUCCESS;
 }
 
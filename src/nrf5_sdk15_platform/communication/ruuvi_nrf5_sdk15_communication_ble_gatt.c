@@ -51,6 +51,8 @@
 #include "ruuvi_nrf5_sdk15_error.h"
 #include "ruuvi_interface_communication.h"
 #include "ruuvi_interface_communication_ble_advertising.h"
+#include "ruuvi_interface_communication_ble_gatt.h"
+#include "ruuvi_interface_communication_bulk.h"
 #include "ruuvi_interface_communication_radio.h"
 #include "ruuvi_interface_flash.h"
 #include "ruuvi_interface_log.h"
@@ -101,10 +103,17 @@
 #ifndef RUUVI_NRF5_SDK15_COMMUNICATION_BLE4_GATT_LOG_LEVEL
 #define RUUVI_NRF5_SDK15_COMMUNICATION_BLE4_GATT_LOG_LEVEL RI_LOG_LEVEL_DEBUG
 #endif
-#define LOG(msg) ri_log(RUUVI_NRF5_SDK15_COMMUNICATION_BLE4_GATT_LOG_LEVEL, msg)
-#define LOGD(msg) ri_log(RI_LOG_LEVEL_DEBUG, msg)
-#define LOGW(msg) ri_log(RI_LOG_LEVEL_WARNING, msg)
-#define LOGHEX(msg, len) ri_log_hex(RUUVI_NRF5_SDK15_COMMUNICATION_BLE4_GATT_LOG_LEVEL, msg, len)
+#ifndef RUUVI_NRF5_SDK15_COMMUNICATION_BLE4_GATT_LOG_COMPILE_LEVEL
+#define RUUVI_NRF5_SDK15_COMMUNICATION_BLE4_GATT_LOG_COMPILE_LEVEL RI_LOG_COMPILE_LEVEL
+#endif
+#define GATT_LOG(severity, msg) RI_LOG_MODULE(RI_LOG_MODULE_GATT, \
+        RUUVI_NRF5_SDK15_COMMUNICATION_BLE4_GATT_LOG_COMPILE_LEVEL, severity, msg)
+#define LOG(msg) GATT_LOG(RUUVI_NRF5_SDK15_COMMUNICATION_BLE4_GATT_LOG_LEVEL, msg)
+#define LOGD(msg) GATT_LOG(RI_LOG_LEVEL_DEBUG, msg)
+#define LOGW(msg) GATT_LOG(RI_LOG_LEVEL_WARNING, msg)
+#define LOGHEX(msg, len) RI_LOG_MODULE_HEX(RI_LOG_MODULE_GATT, \
+        RUUVI_NRF5_SDK15_COMMUNICATION_BLE4_GATT_LOG_COMPILE_LEVEL, \
+        RUUVI_NRF5_SDK15_COMMUNICATION_BLE4_GATT_LOG_LEVEL, msg, len)
 
 APP_TIMER_DEF (
     m_conn_param_retry_timer); //<! Timer for retrying comm param renegotiation.
@@ -122,6 +131,26 @@ static ble_gap_conn_params_t m_gatt_params; //!< Holder for GATT params.
 
 static uint8_t m_gatt_retries;
 
+/** @brief Parameters of current connection. */
+static ri_gatt_link_t m_link =
+{
+    .att_mtu = RI_COMM_BULK_ATT_MTU_DEFAULT,
+    .data_length = RI_COMM_BULK_DATA_LENGTH_DEFAULT,
+    .tx_phy = RI_RADIO_BLE_1MBPS,
+    .rx_phy = RI_RADIO_BLE_1MBPS
+};
+static ri_gatt_link_cb_t m_on_link; //!< Called on changes in link parameters.
+
+static uint8_t m_bulk_chunk[BLE_NUS_MAX_DATA_LEN]; //!< Chunk being sent.
+static rd_status_t bulk_send (const uint8_t * const p_chunk, size_t * const p_length);
+/** @brief Bulk transfer, pumped from application and from TX_RDY. */
+static ri_comm_bulk_pump_t m_bulk =
+{
+    .send = bulk_send,
+    .p_chunk = m_bulk_chunk,
+    .chunk_size = sizeof (m_bulk_chunk)
+};
+
 /** @brief Supported PHYs, start at 1MBPS */
 static ble_gap_phys_t m_phys =
 {
@@ -236,6 +265,84 @@ static ret_code_t conn_params_init (void)
 }
 
 
+/** @brief Reset link parameters to values before any negotiation. */
+static void link_reset (void)
+{
+    memset (&m_link, 0, sizeof (m_link));
+    m_link.att_mtu = RI_COMM_BULK_ATT_MTU_DEFAULT;
+    m_link.data_length = RI_COMM_BULK_DATA_LENGTH_DEFAULT;
+    m_link.tx_phy = RI_RADIO_BLE_1MBPS;
+    m_link.rx_phy = RI_RADIO_BLE_1MBPS;
+}
+
+static void link_conn_params_set (ble_gap_conn_params_t const * const p_params)
+{
+    // Connection interval is in 1.25 ms units, min and max are equal on actual parameters.
+    m_link.conn_interval_us = (uint32_t) p_params->max_conn_interval * 1250U;
+    m_link.slave_latency = p_params->slave_latency;
+}
+
+static ri_radio_modulation_t phy_to_modulation (const uint8_t phy)
+{
+    ri_radio_modulation_t modulation = RI_RADIO_BLE_1MBPS;
+
+    if (BLE_GAP_PHY_2MBPS == phy)
+    {
+        modulation = RI_RADIO_BLE_2MBPS;
+    }
+    else if (BLE_GAP_PHY_CODED == phy)
+    {
+        modulation = RI_RADIO_BLE_125KBPS;
+    }
+    else
+    {
+        // 1 Mbps.
+    }
+
+    return modulation;
+}
+
+static void link_notify (void)
+{
+    if (NULL != m_on_link)
+    {
+        m_on_link (&m_link);
+    }
+}
+
+/**
+ * @brief Offer one bulk chunk to SoftDevice.
+ *
+ * Chunk rejected with NRF_ERROR_RESOURCES is sent again on next BLE_NUS_EVT_TX_RDY.
+ */
+static rd_status_t bulk_send (const uint8_t * const p_chunk, size_t * const p_length)
+{
+    uint16_t length = (uint16_t) *p_length;
+    // NUS API does not use consts.
+    const ret_code_t nrf_code = ble_nus_data_send (&m_nus, (uint8_t *) p_chunk, &length,
+                                m_conn_handle);
+
+    if (NRF_SUCCESS == nrf_code)
+    {
+        *p_length = length;
+        m_link.tx_bytes += length;
+    }
+
+    return ruuvi_nrf5_sdk15_to_ruuvi_error (nrf_code);
+}
+
+/**
+ * @brief Send bulk data until SoftDevice TX queue is full.
+ *
+ * Transfer is done when all data is queued, SoftDevice has a copy of it.
+ * Called from application and SoftDevice event, pump serializes the two.
+ */
+static void bulk_pump (void)
+{
+    ri_comm_bulk_pump (&m_bulk, ri_comm_bulk_fragment_size (m_link.att_mtu,
+                       m_link.data_length));
+}
+
 /**@brief Function for handling the data from the Nordic UART Service.
  *
  * @details This function will process the data received from the Nordic UART BLE Service and send
@@ -246,6 +353,11 @@ static ret_code_t conn_params_init (void)
 /**@snippet [Handling the data received over BLE] */
 static void nus_data_handler (ble_nus_evt_t * p_evt)
 {
+    if (BLE_NUS_EVT_TX_RDY == p_evt->type)
+    {
+        bulk_pump();
+    }
+
     if (NULL == channel || NULL == channel->on_evt)
     {
         return;
@@ -255,6 +367,7 @@ static void nus_data_handler (ble_nus_evt_t * p_evt)
     {
         case BLE_NUS_EVT_RX_DATA:
             LOGD ("NUS RX \r\n");
+            m_link.rx_bytes += p_evt->params.rx_data.length;
             channel->on_evt (RI_COMM_RECEIVED,
                              (void *) p_evt->params.rx_data.p_data, p_evt->params.rx_data.length);
             break;
@@ -297,6 +410,9 @@ static void ble_evt_handler (ble_evt_t const * p_ble_evt, void * p_context)
             m_conn_handle = p_ble_evt->evt.gap_evt.conn_handle;
             err_code = nrf_ble_qwr_conn_handle_assign (&m_qwr, m_conn_handle);
             LOG ("BLE Connected \r\n");
+            link_reset();
+            link_conn_params_set (&p_ble_evt->evt.gap_evt.params.connected.conn_params);
+            link_notify();
             char msg[128];
             sprintf (msg, "PHY: %s.\r\n", phy_str (m_phys));
             RD_ERROR_CHECK (ruuvi_nrf5_sdk15_to_ruuvi_error (err_code),
@@ -322,11 +438,19 @@ static void ble_evt_handler (ble_evt_t const * p_ble_evt, void * p_context)
             evt.type = BLE_NUS_EVT_COMM_STOPPED;
             nus_data_handler (&evt);
             m_conn_handle = BLE_CONN_HANDLE_INVALID;
+            link_reset();
+            (void) ri_comm_bulk_pump_abort (&m_bulk);
             err_code |= app_timer_stop (m_conn_param_retry_timer);
             RD_ERROR_CHECK (ruuvi_nrf5_sdk15_to_ruuvi_error (err_code),
                             RD_SUCCESS);
             break;
 
+        case BLE_GAP_EVT_CONN_PARAM_UPDATE:
+            LOGD ("BLE connection parameters updated \r\n");
+            link_conn_params_set (&p_ble_evt->evt.gap_evt.params.conn_param_update.conn_params);
+            link_notify();
+            break;
+
         case BLE_GAP_EVT_PHY_UPDATE_REQUEST:
             err_code = sd_ble_gap_phy_update (p_ble_evt->evt.gap_evt.conn_handle, &m_phys);
             LOG ("BLE PHY update requested \r\n");
@@ -344,15 +468,26 @@ static void ble_evt_handler (ble_evt_t const * p_ble_evt, void * p_context)
                 break;
             }
 
-            ble_gap_phys_t evt_phys = {0};
-            evt_phys.tx_phys = p_phy_evt->tx_phy;
-            evt_phys.rx_phys = p_phy_evt->rx_phy;
-            char msg[128];
-            snprintf (msg, sizeof (msg), "PHY update %s. PHY set to %s.\r\n",
-                      (p_phy_evt->status == BLE_HCI_STATUS_CODE_SUCCESS) ?
-                      "accepted" : "rejected",
-                      phy_str (evt_phys));
-            LOG (msg);
+            if (p_phy_evt->status == BLE_HCI_STATUS_CODE_SUCCESS)
+            {
+                m_link.tx_phy = phy_to_modulation (p_phy_evt->tx_phy);
+                m_link.rx_phy = phy_to_modulation (p_phy_evt->rx_phy);
+                link_notify();
+            }
+
+            if (RI_LOG_IS_COMPILED (RUUVI_NRF5_SDK15_COMMUNICATION_BLE4_GATT_LOG_COMPILE_LEVEL,
+                                    RUUVI_NRF5_SDK15_COMMUNICATION_BLE4_GATT_LOG_LEVEL))
+            {
+                ble_gap_phys_t evt_phys = {0};
+                evt_phys.tx_phys = p_phy_evt->tx_phy;
+                evt_phys.rx_phys = p_phy_evt->rx_phy;
+                char msg[128];
+                snprintf (msg, sizeof (msg), "PHY update %s. PHY set to %s.\r\n",
+                          (p_phy_evt->status == BLE_HCI_STATUS_CODE_SUCCESS) ?
+                          "accepted" : "rejected",
+                          phy_str (evt_phys));
+                LOG (msg);
+            }
         }
         break;
 
@@ -417,8 +552,20 @@ static void gatt_evt_handler (nrf_ble_gatt_t * p_gatt, nrf_ble_gatt_evt_t const
     if ( (m_conn_handle == p_evt->conn_handle)
             && (p_evt->evt_id == NRF_BLE_GATT_EVT_ATT_MTU_UPDATED))
     {
-        //m_ble_nus_max_data_len = p_evt->params.att_mtu_effective - OPCODE_LENGTH - HANDLE_LENGTH;
-        LOGD ("Changing MTU size is not supported\r\n");
+        m_link.att_mtu = p_evt->params.att_mtu_effective;
+        LOGD ("ATT MTU updated\r\n");
+        link_notify();
+    }
+    else if ( (m_conn_handle == p_evt->conn_handle)
+              && (p_evt->evt_id == NRF_BLE_GATT_EVT_DATA_LENGTH_UPDATED))
+    {
+        m_link.data_length = p_evt->params.data_length;
+        LOGD ("Data length updated\r\n");
+        link_notify();
+    }
+    else
+    {
+        // No action needed.
     }
 }
 
@@ -763,6 +910,7 @@ rd_status_t ri_gatt_uninit (void)
     else
     {
         m_gatt_is_init = false;
+        m_on_link = NULL;
     }
 
     return err_code;
@@ -813,6 +961,10 @@ static rd_status_t ri_gatt_nus_send (ri_comm_message_t * const message)
     {
         err_code |= RD_ERROR_INVALID_STATE;
     }
+    else if (ri_comm_bulk_pump_is_active (&m_bulk))
+    {
+        err_code |= RD_ERROR_BUSY;
+    }
     else if (message->repeat_count > 1)
     {
         err_code |= RD_ERROR_NOT_IMPLEMENTED;
@@ -821,11 +973,78 @@ static rd_status_t ri_gatt_nus_send (ri_comm_message_t * const message)
     {
         uint16_t data_len = message->data_length;
         nrf_code |= ble_nus_data_send (&m_nus, message->data, &data_len, m_conn_handle);
+
+        if (NRF_SUCCESS == nrf_code)
+        {
+            m_link.tx_bytes += data_len;
+        }
     }
 
     return err_code | ruuvi_nrf5_sdk15_to_ruuvi_error (nrf_code);
 }
 
+rd_status_t ri_gatt_nus_bulk_send (const ri_comm_segment_t * const p_segments,
+                                   const size_t segment_count,
+                                   const ri_gatt_bulk_done_fp on_done)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if (NULL == p_segments)
+    {
+        err_code |= RD_ERROR_NULL;
+    }
+    else if (BLE_CONN_HANDLE_INVALID == m_conn_handle)
+    {
+        err_code |= RD_ERROR_INVALID_STATE;
+    }
+    else
+    {
+        err_code |= ri_comm_bulk_pump_start (&m_bulk, p_segments, segment_count, on_done);
+
+        if (RD_SUCCESS == err_code)
+        {
+            bulk_pump();
+        }
+    }
+
+    return err_code;
+}
+
+rd_status_t ri_gatt_nus_bulk_abort (void)
+{
+    return ri_comm_bulk_pump_abort (&m_bulk);
+}
+
+bool ri_gatt_nus_bulk_is_active (void)
+{
+    return ri_comm_bulk_pump_is_active (&m_bulk);
+}
+
+rd_status_t ri_gatt_link_get (ri_gatt_link_t * const p_link)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if (NULL == p_link)
+    {
+        err_code |= RD_ERROR_NULL;
+    }
+    else if (BLE_CONN_HANDLE_INVALID == m_conn_handle)
+    {
+        err_code |= RD_ERROR_INVALID_STATE;
+    }
+    else
+    {
+        memcpy (p_link, &m_link, sizeof (m_link));
+    }
+
+    return err_code;
+}
+
+void ri_gatt_link_cb_set (const ri_gatt_link_cb_t cb)
+{
+    m_on_link = cb;
+}
+
 static rd_status_t ri_gatt_nus_read (ri_comm_message_t * const message)
 {
     return RD_ERROR_NOT_SUPPORTED;
@@ -181,6 +181,11 @@ void ri_radio_activity_callback_set (const ri_radio_activity_interrupt_fp_t hand
     }
 }
 
+ri_radio_activity_interrupt_fp_t ri_radio_activity_callback_get (void)
+{
+    return on_radio_activity_callback;
+}
+
 bool ri_radio_is_init (void)
 {
     return nrf_sdh_is_enabled();
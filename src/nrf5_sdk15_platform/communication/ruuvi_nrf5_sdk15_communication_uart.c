@@ -8,24 +8,62 @@
 #include "ruuvi_nrf5_sdk15_error.h"
 #include "ruuvi_nrf5_sdk15_gpio.h"
 #include "nrf_serial.h"
+#if RI_UART_BATCH_ENABLED
+#include "ruuvi_interface_communication_batch.h"
+#endif
+#if RI_UART_RX_FRAME_ENABLED
+#include "ruuvi_interface_communication_rx_frame.h"
+#endif
+#if RI_UART_BATCH_ENABLED || RI_UART_RX_FRAME_ENABLED
+#include "ruuvi_interface_timer.h"
+#endif
 
 #ifndef RUUVI_NRF5_SDK15_UART_LOG_LEVEL
 #define LOG_LEVEL RI_LOG_LEVEL_INFO
 #else
 #define LOG_LEVEL RUUVI_NRF5_SDK15_UART_LOG_LEVEL
 #endif
-#define LOG(msg)  (ri_log(LOG_LEVEL, msg))
-#define LOGD(msg)  (ri_log(RI_LOG_LEVEL_DEBUG, msg))
+#ifndef RUUVI_NRF5_SDK15_UART_LOG_COMPILE_LEVEL
+#define RUUVI_NRF5_SDK15_UART_LOG_COMPILE_LEVEL RI_LOG_COMPILE_LEVEL
+#endif
+#define LOG(msg)  RI_LOG_MODULE(RI_LOG_MODULE_UART, \
+                                RUUVI_NRF5_SDK15_UART_LOG_COMPILE_LEVEL, LOG_LEVEL, msg)
+#define LOGD(msg) RI_LOG_MODULE(RI_LOG_MODULE_UART, \
+                                RUUVI_NRF5_SDK15_UART_LOG_COMPILE_LEVEL, RI_LOG_LEVEL_DEBUG, msg)
 
 static const ri_comm_channel_t * m_channel; //!< Pointer to application control structure.
 static uint16_t m_rxcnt = 0; //!< Counter of received bytes after last read.
+#if RI_UART_BATCH_ENABLED
+static ri_timer_id_t m_flush_timer;  //!< Bounds latency of partially filled batch.
+static uint16_t m_batch_flush_ms;    //!< Batch flush timeout, 0 to flush on append.
+#else
 static uint16_t m_txcnt = 0; //!< Counter of bytes to send before tx complete.
+#endif
+#if RI_UART_RX_FRAME_ENABLED
+static ri_timer_id_t m_idle_timer;   //!< Ends frame once line is idle.
+static uint16_t m_rx_idle_ms;        //!< Idle timeout, 0 if frames end on delimiter.
+
+static bool uart_rx_frame_feed (void);
+#endif
 
 static void sleep_handler (void)
 {
     ri_yield();
 }
 
+/** @brief Pass received line to application, used if RX frames are not set up. */
+static void uart_rx_line (struct nrf_serial_s const * p_serial)
+{
+    if ( ( ( (char *) (p_serial->p_ctx->p_config->p_buffers->p_rxb)) [0] == '\n')
+            || ++m_rxcnt >= RI_COMM_MESSAGE_MAX_LENGTH)
+    {
+        ri_comm_message_t msg = {0};
+        msg.data_length = RI_COMM_MESSAGE_MAX_LENGTH;
+        m_channel->read (&msg);
+        m_channel->on_evt (RI_COMM_RECEIVED, (void *) &msg.data[0], msg.data_length);
+    }
+}
+
 // Handle UART events
 static void uart_handler (struct nrf_serial_s const * p_serial, nrf_serial_event_t event)
 {
@@ -35,26 +73,32 @@ static void uart_handler (struct nrf_serial_s const * p_serial, nrf_serial_event
         {
             case NRF_SERIAL_EVENT_TX_DONE: ///< Requested TX transfer completed.
                 LOGD ("TX\r\n");
+#if RI_UART_BATCH_ENABLED
+                // Whole batch is one DMA transfer, start next one right away.
+                (void) ri_comm_batch_done();
+                m_channel->on_evt (RI_COMM_SENT, NULL, 0);
+#else
 
                 if (0 == (--m_txcnt))
                 {
                     m_channel->on_evt (RI_COMM_SENT, NULL, 0);
                 }
 
+#endif
                 break;
 
             case NRF_SERIAL_EVENT_RX_DATA: ///< Requested RX transfer completed.
                 LOGD ("RX\r\n");
+#if RI_UART_RX_FRAME_ENABLED
 
-                if ( ( ( (char *) (p_serial->p_ctx->p_config->p_buffers->p_rxb)) [0] == '\n')
-                        || ++m_rxcnt >= RI_COMM_MESSAGE_MAX_LENGTH)
+                if (!uart_rx_frame_feed())
                 {
-                    ri_comm_message_t msg = {0};
-                    msg.data_length = RI_COMM_MESSAGE_MAX_LENGTH;
-                    m_channel->read (&msg);
-                    m_channel->on_evt (RI_COMM_RECEIVED, (void *) &msg.data[0], msg.data_length);
+                    uart_rx_line (p_serial);
                 }
 
+#else
+                uart_rx_line (p_serial);
+#endif
                 break;
 
             case NRF_SERIAL_EVENT_DRV_ERR:   ///< Error reported by UART peripheral.
@@ -76,13 +120,23 @@ static nrf_drv_uart_config_t m_uart0_drv_config;
 
 // FIFOs have a guard byte
 #define GUARD_SIZE (1U)
+#if RI_UART_BATCH_ENABLED
+// TX FIFO holds the batch being sent, batch module buffers the next one.
+#define SERIAL_FIFO_TX_SIZE (RI_COMM_BATCH_SIZE + GUARD_SIZE)
+#else
 #define SERIAL_FIFO_TX_SIZE (RI_COMM_MESSAGE_MAX_LENGTH + GUARD_SIZE)
+#endif
 #define SERIAL_FIFO_RX_SIZE (RI_COMM_MESSAGE_MAX_LENGTH + GUARD_SIZE)
 
 NRF_SERIAL_QUEUES_DEF (serial_queues, SERIAL_FIFO_TX_SIZE, SERIAL_FIFO_RX_SIZE);
 
 
+#if RI_UART_BATCH_ENABLED
+// One DMA transfer per batch instead of one per byte.
+#define SERIAL_BUFF_TX_SIZE (RI_COMM_BATCH_SIZE)
+#else
 #define SERIAL_BUFF_TX_SIZE (1U)
+#endif
 #define SERIAL_BUFF_RX_SIZE (1U)
 
 NRF_SERIAL_BUFFERS_DEF (serial_buffs, SERIAL_BUFF_TX_SIZE, SERIAL_BUFF_RX_SIZE);
@@ -107,6 +161,81 @@ static nrf_uarte_baudrate_t ruuvi_to_nrf_baudrate (const ri_uart_baudrate_t baud
     }
 }
 
+#if RI_UART_BATCH_ENABLED
+static rd_status_t uart_batch_send (const uint8_t * const p_data, const size_t length)
+{
+    rd_status_t err_code = RD_SUCCESS;
+    nrfx_err_t status = NRF_SUCCESS;
+    size_t written = 0;
+    status |= nrf_serial_write (&serial_uart, p_data, length, &written, 0);
+    err_code |= ruuvi_nrf5_sdk15_to_ruuvi_error (status);
+
+    if (written != length)
+    {
+        err_code |= RD_ERROR_NO_MEM;
+    }
+
+    return err_code;
+}
+
+static void uart_batch_arm (void)
+{
+    if (0U == m_batch_flush_ms)
+    {
+        (void) ri_comm_batch_flush();
+    }
+    else
+    {
+        (void) ri_timer_start (m_flush_timer, m_batch_flush_ms, NULL);
+    }
+}
+
+static void uart_batch_timeout (void * const p_context)
+{
+    (void) ri_comm_batch_flush();
+}
+#endif
+
+#if RI_UART_RX_FRAME_ENABLED
+/**
+ * @brief Feed received bytes into frames.
+ *
+ * @retval true if bytes were fed.
+ * @retval false if frames are not set up or idle frames have no timer to end them,
+ *               bytes are left in queue.
+ */
+static bool uart_rx_frame_feed (void)
+{
+    ri_comm_rx_frame_mode_t mode = RI_COMM_RX_FRAME_DELIMITER;
+    bool fed = false;
+
+    if ( (RD_SUCCESS == ri_comm_rx_frame_mode_get (&mode))
+            && ( (RI_COMM_RX_FRAME_IDLE != mode) || (0U != m_rx_idle_ms)))
+    {
+        uint8_t rx[SERIAL_FIFO_RX_SIZE];
+        const size_t length = nrf_queue_utilization_get (&serial_queues_rxq);
+        fed = true;
+
+        if ( (NRF_SUCCESS == nrf_queue_read (&serial_queues_rxq, rx, length))
+                && ri_comm_rx_frame_feed (rx, length)
+                && (0U != m_rx_idle_ms))
+        {
+            (void) ri_timer_start (m_idle_timer, m_rx_idle_ms, NULL);
+        }
+    }
+
+    return fed;
+}
+
+static void uart_rx_idle_timeout (void * const p_context)
+{
+    if (ri_comm_rx_frame_idle())
+    {
+        (void) ri_timer_start (m_idle_timer, m_rx_idle_ms, NULL);
+    }
+}
+#endif
+
 static rd_status_t ri_uart_send_async (ri_comm_message_t * const msg)
 {
     rd_status_t err_code = RD_SUCCESS;
@@ -115,11 +244,19 @@ static rd_status_t ri_uart_send_async (ri_comm_message_t * const msg)
     {
         err_code |= RD_ERROR_NULL;
     }
-
-    if (1 < msg->repeat_count)
+    else if (1 < msg->repeat_count)
     {
         err_code |= RD_ERROR_NOT_SUPPORTED;
     }
+
+#if RI_UART_BATCH_ENABLED
+    else
+    {
+        // Message is already framed, e.g. an encoded scan report.
+        err_code |= ri_comm_batch_append (msg->data, msg->data_length);
+    }
+
+#else
     else if (0 != m_txcnt)
     {
         if (NRF_MTX_LOCKED == serial_uart.p_ctx->write_lock)
@@ -146,6 +283,7 @@ static rd_status_t ri_uart_send_async (ri_comm_message_t * const msg)
         }
     }
 
+#endif
     return err_code;
 }
 
@@ -237,8 +375,54 @@ rd_status_t ri_uart_config (const ri_uart_init_t * const config)
         m_uart0_drv_config.hwfc    = config->hwfc_enabled ? NRF_UARTE_HWFC_ENABLED :
                                      NRF_UARTE_HWFC_DISABLED;
         m_uart0_drv_config.interrupt_priority = APP_IRQ_PRIORITY_HIGH;
-        nrf_status |= nrf_serial_init (&serial_uart, &m_uart0_drv_config, &serial_config);
-        err_code |= ruuvi_nrf5_sdk15_to_ruuvi_error (nrf_status);
+#if RI_UART_BATCH_ENABLED
+        m_batch_flush_ms = config->batch_flush_ms;
+
+        if ( (0U != m_batch_flush_ms) && (NULL == m_flush_timer))
+        {
+            if (!ri_timer_is_init())
+            {
+                err_code |= RD_ERROR_INVALID_STATE;
+            }
+            else
+            {
+                err_code |= ri_timer_create (&m_flush_timer, RI_TIMER_MODE_SINGLE_SHOT,
+                                             &uart_batch_timeout);
+            }
+        }
+
+        err_code |= ri_comm_batch_init (&uart_batch_send, &uart_batch_arm);
+#endif
+#if RI_UART_RX_FRAME_ENABLED
+        ri_comm_rx_frame_mode_t rx_mode = RI_COMM_RX_FRAME_DELIMITER;
+        m_rx_idle_ms = config->rx_idle_ms;
+
+        // Frames in idle mode end only on idle timer.
+        if ( (RD_SUCCESS == ri_comm_rx_frame_mode_get (&rx_mode))
+                && (RI_COMM_RX_FRAME_IDLE == rx_mode) && (0U == m_rx_idle_ms))
+        {
+            err_code |= RD_ERROR_INVALID_PARAM;
+        }
+        else if ( (0U != m_rx_idle_ms) && (NULL == m_idle_timer))
+        {
+            if (!ri_timer_is_init())
+            {
+                err_code |= RD_ERROR_INVALID_STATE;
+            }
+            else
+            {
+                err_code |= ri_timer_create (&m_idle_timer, RI_TIMER_MODE_SINGLE_SHOT,
+                                             &uart_rx_idle_timeout);
+            }
+        }
+
+#endif
+
+        if (RD_SUCCESS == err_code)
+        {
+            nrf_status |= nrf_serial_init (&serial_uart, &m_uart0_drv_config, &serial_config);
+            err_code |= ruuvi_nrf5_sdk15_to_ruuvi_error (nrf_status);
+        }
     }
 
     return err_code;
@@ -17,6 +17,7 @@
 #include "nrf_crypto_aes.h"
 #include "nrf_sdh.h"
 #include "nrf_soc.h"
+#include <string.h>
 
 #define ECB_128_BLOCK_SIZE_BYTES (16U)
 
@@ -39,8 +40,16 @@ static void aes_ecb_128_encrypt_sdapi (const uint8_t * const cleartext,
                 soc_ecb_data.ciphertext,
                 ECB_128_BLOCK_SIZE_BYTES);
     }
+
+    memset (&soc_ecb_data, 0, sizeof (soc_ecb_data));
 }
 
+/**
+ * @brief Encrypt with nRF Crypto API.
+ *
+ * nRF Crypto backends are not documented to support overlapping input and output,
+ * so each block is copied to a local buffer before encryption.
+ */
 static rd_status_t
 aes_ecb_128_encrypt_nrfapi (const uint8_t * const cleartext,
                             uint8_t * const ciphertext,
@@ -48,31 +57,41 @@ aes_ecb_128_encrypt_nrfapi (const uint8_t * const cleartext,
                             const size_t data_length)
 {
     ret_code_t err_code = NRF_SUCCESS;
-    size_t out_data_len;
-    // nRF API does not use consts
-    err_code |= nrf_crypto_aes_crypt (NULL,
-                                      &g_nrf_crypto_aes_ecb_128_info,
-                                      NRF_CRYPTO_ENCRYPT,
-                                      (uint8_t *) key,
-                                      NULL,
-                                      (uint8_t *) cleartext,
-                                      data_length,
-                                      ciphertext,
-                                      &out_data_len);
+    const size_t crypt_rounds = (data_length / ECB_128_BLOCK_SIZE_BYTES);
+    uint8_t block[ECB_128_BLOCK_SIZE_BYTES];
 
-    if (data_length != out_data_len)
+    for (size_t round = 0; (round < crypt_rounds) && (NRF_SUCCESS == err_code); round++)
     {
-        err_code |= RD_ERROR_DATA_SIZE;
+        size_t out_data_len = ECB_128_BLOCK_SIZE_BYTES;
+        memcpy (block,
+                cleartext + (round * ECB_128_BLOCK_SIZE_BYTES),
+                ECB_128_BLOCK_SIZE_BYTES);
+        // nRF API does not use consts
+        err_code |= nrf_crypto_aes_crypt (NULL,
+                                          &g_nrf_crypto_aes_ecb_128_info,
+                                          NRF_CRYPTO_ENCRYPT,
+                                          (uint8_t *) key,
+                                          NULL,
+                                          block,
+                                          ECB_128_BLOCK_SIZE_BYTES,
+                                          ciphertext + (round * ECB_128_BLOCK_SIZE_BYTES),
+                                          &out_data_len);
+
+        if ( (NRF_SUCCESS == err_code) && (ECB_128_BLOCK_SIZE_BYTES != out_data_len))
+        {
+            err_code |= NRF_ERROR_DATA_SIZE;
+        }
     }
 
-    err_code |= ruuvi_nrf5_sdk15_to_ruuvi_error (err_code);
-    return err_code;
+    memset (block, 0, sizeof (block));
+    return ruuvi_nrf5_sdk15_to_ruuvi_error (err_code);
 }
 
 /**
  *  @brief encrypt a block with AES ECB 128 encryption
  *
  * This call takes 16-byte divisible data as input and encrypts it with AES Electronic Codebook.
+ * Cleartext and ciphertext may be the same buffer.
  *
  * @param[in] cleartext Data to encrypt. Must have 16-byte divisible length.
  * @param[out] ciphertext Encryped data output
@@ -108,6 +108,11 @@ extern uint32_t __stop_storage_flash;
  */
 
 #define LOG_LEVEL RI_LOG_LEVEL_DEBUG
+#ifndef RUUVI_NRF5_SDK15_FLASH_LOG_COMPILE_LEVEL
+#define RUUVI_NRF5_SDK15_FLASH_LOG_COMPILE_LEVEL RI_LOG_COMPILE_LEVEL
+#endif
+#define LOG(severity, msg) RI_LOG_MODULE(RI_LOG_MODULE_FLASH, \
+        RUUVI_NRF5_SDK15_FLASH_LOG_COMPILE_LEVEL, severity, msg)
 
 static size_t m_number_of_pages = 0;
 
@@ -185,7 +190,7 @@ static void fds_evt_handler (fds_evt_t const * p_evt)
             if (p_evt->result == FDS_SUCCESS)
             {
                 m_fds_initialized = true;
-                ri_log (LOG_LEVEL, "FDS init\r\n");
+                LOG (LOG_LEVEL, "FDS init\r\n");
             }
 
             break;
@@ -194,7 +199,7 @@ static void fds_evt_handler (fds_evt_t const * p_evt)
         {
             if (p_evt->result == FDS_SUCCESS)
             {
-                ri_log (LOG_LEVEL, "Record written\r\n");
+                LOG (LOG_LEVEL, "Record written\r\n");
                 m_fds_processing = false;
             }
         }
@@ -204,7 +209,7 @@ static void fds_evt_handler (fds_evt_t const * p_evt)
         {
             if (p_evt->result == FDS_SUCCESS)
             {
-                ri_log (LOG_LEVEL, "Record updated\r\n");
+                LOG (LOG_LEVEL, "Record updated\r\n");
                 m_fds_processing = false;
             }
         }
@@ -214,7 +219,7 @@ static void fds_evt_handler (fds_evt_t const * p_evt)
         {
             if (p_evt->result == FDS_SUCCESS)
             {
-                ri_log (LOG_LEVEL, "Record deleted\r\n");
+                LOG (LOG_LEVEL, "Record deleted\r\n");
                 m_fds_processing = false;
             }
         }
@@ -224,7 +229,7 @@ static void fds_evt_handler (fds_evt_t const * p_evt)
         {
             if (p_evt->result == FDS_SUCCESS)
             {
-                ri_log (LOG_LEVEL, "File deleted\r\n");
+                LOG (LOG_LEVEL, "File deleted\r\n");
                 m_fds_processing = false;
             }
         }
@@ -234,7 +239,7 @@ static void fds_evt_handler (fds_evt_t const * p_evt)
         {
             if (p_evt->result == FDS_SUCCESS)
             {
-                ri_log (LOG_LEVEL, "Garbage collected\r\n");
+                LOG (LOG_LEVEL, "Garbage collected\r\n");
                 m_fds_processing = false;
             }
         }
@@ -454,7 +459,7 @@ rd_status_t ri_flash_record_get (const uint32_t page_id,
             else if (record.p_header->length_words * 4 > data_size)
             {
                 err_code |= RD_ERROR_DATA_SIZE;
-                ri_log (RI_LOG_LEVEL_ERROR, "Flash record does not fit in buffer\n");
+                LOG (RI_LOG_LEVEL_ERROR, "Flash record does not fit in buffer\n");
             }
             else
             {
@@ -17,6 +17,7 @@
 #include "ruuvi_interface_log.h"
 #if RUUVI_NRF5_SDK15_LOG_ENABLED
 #include "ruuvi_driver_error.h"
+#include "ruuvi_interface_log_ring.h"
 #include "ruuvi_interface_yield.h"
 #include <stdarg.h>
 
@@ -69,6 +70,11 @@ void ri_log (const ri_log_severity_t severity,
         return;
     }
 
+#   if RI_LOG_RING_ENABLED
+    // Ring has its own level so that it can keep verbose logs for post-mortem.
+    ri_log_ring_write (severity, message);
+#   endif
+
     if (m_log_level >= severity)
     {
         NRF_LOG_INTERNAL_RAW_INFO ("%s", message);
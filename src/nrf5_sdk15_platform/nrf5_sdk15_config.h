@@ -127,6 +127,13 @@
 #   define SAADC_CONFIG_IRQ_PRIORITY 7
 #endif
 
+#if RUUVI_NRF5_SDK15_ADC_STREAM_ENABLED
+#   define PPI_ENABLED 1
+#   define TIMER_ENABLED 1
+#   define TIMER2_ENABLED 1 //!< 0 is used by SD, 1 by timer module, 4 by NFC.
+#   define RUUVI_NRF5_SDK15_ADC_STREAM_TIMER_INSTANCE 2
+#endif
+
 #if RUUVI_NRF5_SDK15_GPIO_PWM_ENABLED
 #define PWM_ENABLED  1
 #define PWM0_ENABLED 1
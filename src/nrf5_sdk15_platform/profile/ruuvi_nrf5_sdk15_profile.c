@@ -0,0 +1,49 @@
+/**
+ * @addtogroup Profile
+ */
+/** @{ */
+/**
+ * @file ruuvi_nrf5_sdk15_profile.c
+ * @author Otso Jousimaa <otso@ojousima.net>
+ * @date 2026-10-18
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ *
+ * Profiling tick source on DWT cycle counter of Cortex-M4.
+ * Counter runs at CPU clock and stops while CPU sleeps.
+ */
+#include "ruuvi_driver_enabled_modules.h"
+#include "ruuvi_interface_profile.h"
+#if RUUVI_NRF5_SDK15_PROFILE_ENABLED
+#include "ruuvi_driver_error.h"
+#include "nrf.h"
+
+#define US_PER_S (1000000U) //!< Microseconds per second.
+
+rd_status_t ri_profile_init (void)
+{
+    rd_status_t err_code = RD_SUCCESS;
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    // Cycle counter is optional in Cortex-M4.
+    if (0U != (DWT->CTRL & DWT_CTRL_NOCYCCNT_Msk))
+    {
+        err_code |= RD_ERROR_NOT_SUPPORTED;
+    }
+
+    return err_code;
+}
+
+uint32_t ri_profile_ticks_get (void)
+{
+    return DWT->CYCCNT;
+}
+
+uint32_t ri_profile_ticks_per_us (void)
+{
+    return SystemCoreClock / US_PER_S;
+}
+
+/** @} */
+#endif
@@ -3,12 +3,14 @@
 #if RUUVI_NRF5_SDK15_SCHEDULER_ENABLED
 
 #include "ruuvi_driver_error.h"
+#include "ruuvi_interface_profile.h"
 #include "ruuvi_nrf5_sdk15_error.h"
 
 #include "sdk_errors.h"
 #include "app_scheduler.h"
 
 static bool m_is_init = false;
+RI_PROFILE_ZONE_DEF (m_zone_execute, "scheduler");
 
 rd_status_t ri_scheduler_init ()
 {
@@ -33,7 +35,9 @@ rd_status_t ri_scheduler_execute (void)
 
     if (m_is_init)
     {
+        RI_PROFILE_ENTER (m_zone_execute);
         app_sched_execute();
+        RI_PROFILE_EXIT (m_zone_execute);
     }
     else
     {
@@ -0,0 +1,50 @@
+/**
+ * @addtogroup Profile
+ */
+/** @{ */
+/**
+ * @file ruuvi_posix_profile.c
+ * @author Otso Jousimaa <otso@ojousima.net>
+ * @date 2026-10-18
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ *
+ * Profiling tick source on monotonic clock of POSIX host, one tick is one nanosecond.
+ * Used when profiling code on host, e.g. in tests and simulations.
+ */
+#define _POSIX_C_SOURCE 199309L //!< clock_gettime
+#include "ruuvi_driver_enabled_modules.h"
+#include "ruuvi_posix_profile.h"
+#if RUUVI_POSIX_PROFILE_ENABLED
+#include "ruuvi_driver_error.h"
+#include <time.h>
+
+#define NS_PER_S (1000000000ULL) //!< Nanoseconds per second.
+
+rd_status_t ri_profile_init (void)
+{
+    rd_status_t err_code = RD_SUCCESS;
+    struct timespec ts;
+
+    if (0 != clock_gettime (CLOCK_MONOTONIC, &ts))
+    {
+        err_code |= RD_ERROR_NOT_SUPPORTED;
+    }
+
+    return err_code;
+}
+
+uint32_t ri_profile_ticks_get (void)
+{
+    struct timespec ts = { 0 };
+    (void) clock_gettime (CLOCK_MONOTONIC, &ts);
+    // Truncated to 32 bits, durations up to ~4 s are calculated correctly.
+    return (uint32_t) ( ( (uint64_t) ts.tv_sec * NS_PER_S) + (uint64_t) ts.tv_nsec);
+}
+
+uint32_t ri_profile_ticks_per_us (void)
+{
+    return RUUVI_POSIX_PROFILE_TICKS_PER_US;
+}
+
+/** @} */
+#endif
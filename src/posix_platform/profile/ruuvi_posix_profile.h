@@ -0,0 +1,22 @@
+#ifndef RUUVI_POSIX_PROFILE_H
+#define RUUVI_POSIX_PROFILE_H
+#include "ruuvi_interface_profile.h"
+/**
+ * @addtogroup Profile
+ * @{
+ */
+/**
+ * @file ruuvi_posix_profile.h
+ * @author Otso Jousimaa <otso@ojousima.net>
+ * @date 2026-10-19
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ *
+ * Profiling tick source on monotonic clock of POSIX host.
+ * Enabled by defining RUUVI_POSIX_ENABLED together with RI_PROFILE_ENABLED.
+ */
+
+/** @brief Ticks per microsecond, one tick is one nanosecond. */
+#define RUUVI_POSIX_PROFILE_TICKS_PER_US (1000U)
+
+/** @} */
+#endif
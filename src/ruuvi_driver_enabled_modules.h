@@ -51,11 +51,42 @@
 #  define RD_LOG_BUFFER_SIZE (128U)
 #endif
 
+#ifndef RI_LOG_RING_ENABLED
+/** @brief Enable log ring which survives soft reset. */
+#  define RI_LOG_RING_ENABLED ENABLE_DEFAULT
+#endif
+
+#if RI_LOG_RING_ENABLED && !(RI_ATOMIC_ENABLED)
+#  error "Log ring requires atomic interface."
+#endif
+
+#ifndef RI_PROFILE_ENABLED
+/**
+ * @brief Enable profiling zones.
+ *
+ * Disabled by default also in tests, as zones add overhead to every hot path.
+ */
+#  define RI_PROFILE_ENABLED 0
+#endif
+
+#if RI_PROFILE_ENABLED && !(RI_ATOMIC_ENABLED)
+#  error "Profiling requires atomic interface."
+#endif
+
 #ifndef RT_ADC_ENABLED
 /** @brief Enable ADC task compilation. */
 #  define RT_ADC_ENABLED ENABLE_DEFAULT
 #endif
 
+#ifndef RI_ADC_STREAM_ENABLED
+/**
+ * @brief Enable continuous ADC sampling.
+ *
+ * Disabled by default as it reserves a hardware timer on nRF5.
+ */
+#  define RI_ADC_STREAM_ENABLED 0
+#endif
+
 #ifndef RI_COMM_ENABLED
 /** @brief Enable communication helper compilation. */
 #  define RI_COMM_ENABLED ENABLE_DEFAULT
@@ -66,6 +97,15 @@
 #  define RI_AES_ENABLED ENABLE_DEFAULT
 #endif
 
+#ifndef RI_AES_CTR_ENABLED
+/** @brief Enable AES CTR and CCM modes compilation. */
+#  define RI_AES_CTR_ENABLED ENABLE_DEFAULT
+#endif
+
+#if RI_AES_CTR_ENABLED && !(RI_AES_ENABLED)
+#  error "AES CTR requires AES interface."
+#endif
+
 #ifndef RI_RADIO_ENABLED
 /** brief enable radio usage */
 #  define RI_RADIO_ENABLED ENABLE_DEFAULT
@@ -87,6 +127,10 @@
 #  error "Advertisement task requires radio interface."
 #endif
 
+#if RT_ADV_ENABLED && !(RI_ATOMIC_ENABLED)
+#  error "Advertisement task requires atomic interface."
+#endif
+
 #ifndef RT_BUTTON_ENABLED
 /** @brief Enable BLE advertising compilation. */
 #  define RT_BUTTON_ENABLED ENABLE_DEFAULT
@@ -161,6 +205,24 @@
 #  endif
 #endif
 
+#ifndef RT_LOG_ENABLED
+/** @brief Enable log dump task compilation. */
+#  define RT_LOG_ENABLED ENABLE_DEFAULT
+#endif
+
+#if RT_LOG_ENABLED && !(RI_LOG_RING_ENABLED && RT_COMMUNICATION_ENABLED)
+#  error "Log task requires log ring and communication task."
+#endif
+
+#ifndef RT_PROFILE_ENABLED
+/** @brief Enable profiling report task compilation. */
+#  define RT_PROFILE_ENABLED (RI_PROFILE_ENABLED && RT_COMMUNICATION_ENABLED)
+#endif
+
+#if RT_PROFILE_ENABLED && !(RI_PROFILE_ENABLED && RT_COMMUNICATION_ENABLED)
+#  error "Profiling task requires profiling and communication task."
+#endif
+
 #ifndef RT_NFC_ENABLED
 #  define RT_NFC_ENABLED ENABLE_DEFAULT
 #endif
@@ -202,6 +264,33 @@
 #   define RI_UART_ENABLED ENABLE_DEFAULT
 #endif
 
+#ifndef RI_UART_BATCH_ENABLED
+/**
+ * @brief Pack UART messages into batched DMA transfers.
+ *
+ * Disabled by default as @ref RI_COMM_SENT is then reported once per batch.
+ */
+#   define RI_UART_BATCH_ENABLED 0
+#endif
+
+#if RI_UART_BATCH_ENABLED && !(RI_COMM_ENABLED && RI_ATOMIC_ENABLED && RI_TIMER_ENABLED)
+#   error "UART batching requires communication, atomic and timer interfaces."
+#endif
+
+#ifndef RI_UART_RX_FRAME_ENABLED
+/**
+ * @brief Assemble received UART bytes into frames.
+ *
+ * Disabled by default as frames then go to @ref ri_comm_rx_frame_fp_t instead of
+ * @ref RI_COMM_RECEIVED.
+ */
+#   define RI_UART_RX_FRAME_ENABLED 0
+#endif
+
+#if RI_UART_RX_FRAME_ENABLED && !(RI_COMM_ENABLED && RI_TIMER_ENABLED)
+#   error "UART frame reception requires communication and timer interfaces."
+#endif
+
 #ifndef RI_YIELD_ENABLED
 #define RI_YIELD_ENABLED ENABLE_DEFAULT
 #endif
@@ -210,11 +299,58 @@
 #define RI_WATCHDOG_ENABLED ENABLE_DEFAULT
 #endif
 
+#ifndef RT_ENERGY_ENABLED
+/** @brief Enable energy ledger task compilation. */
+#  define RT_ENERGY_ENABLED ENABLE_DEFAULT
+#endif
+
+#if RT_ENERGY_ENABLED && !(RI_RTC_ENABLED && RI_YIELD_ENABLED && RI_RADIO_ENABLED)
+#  error "Energy ledger requires RTC, yield and radio interfaces."
+#endif
+
+#ifndef RT_BATTERY_ENABLED
+/** @brief Enable battery voltage tracker task compilation. */
+#  define RT_BATTERY_ENABLED ENABLE_DEFAULT
+#endif
+
+#if RT_BATTERY_ENABLED && !(RT_ADC_ENABLED && RI_RADIO_ENABLED)
+#  error "Battery tracker requires ADC task and radio interface."
+#endif
+
+#ifndef RT_KEYSTREAM_ENABLED
+/** @brief Enable keystream precomputation task compilation. */
+#  define RT_KEYSTREAM_ENABLED ENABLE_DEFAULT
+#endif
+
+#if RT_KEYSTREAM_ENABLED && !(RI_AES_CTR_ENABLED && RI_SCHEDULER_ENABLED)
+#  error "Keystream task requires AES CTR and scheduler interfaces."
+#endif
+
 /** SENSORS **/
 #ifndef RT_SENSOR_ENABLED
 #   define RT_SENSOR_ENABLED ENABLE_DEFAULT
 #endif
 
+#ifndef RT_SENSOR_CACHE_ENABLED
+/** @brief Enable sensor result cache compilation. */
+#   define RT_SENSOR_CACHE_ENABLED ENABLE_DEFAULT
+#endif
+
+#ifndef RT_SENSOR_FUSION_ENABLED
+/** @brief Enable fused virtual sensor compilation. */
+#   define RT_SENSOR_FUSION_ENABLED ENABLE_DEFAULT
+#endif
+
+#ifndef RT_SENSOR_RATE_ENABLED
+/** @brief Enable adaptive sampling rate controller compilation. */
+#   define RT_SENSOR_RATE_ENABLED ENABLE_DEFAULT
+#endif
+
+#ifndef RT_SENSOR_DSP_ENABLED
+/** @brief Enable software sensor DSP compilation. */
+#   define RT_SENSOR_DSP_ENABLED ENABLE_DEFAULT
+#endif
+
 #ifndef RI_BME280_ENABLED
 #   define RI_BME280_ENABLED ENABLE_DEFAULT
 #   ifndef RI_BME280_SPI_ENABLED
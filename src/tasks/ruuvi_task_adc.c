@@ -21,6 +21,8 @@
 #include "ruuvi_driver_sensor.h"
 #include "ruuvi_interface_adc_mcu.h"
 #include "ruuvi_interface_atomic.h"
+#include "ruuvi_interface_profile.h"
+#include "ruuvi_task_energy.h"
 
 #define RD_ADC_USE_DIVIDER      1.00f
 #define RD_ADC_USE_VDD          3.30f
@@ -104,10 +106,13 @@ static ri_adc_get_data_t options =
     .divider = RD_ADC_USE_DIVIDER,
 };
 
+RI_PROFILE_ZONE_DEF (m_zone_data_get, "adc data_get");
+
 static rd_status_t rt_adc_mcu_data_get (rd_sensor_data_t * const
                                         p_data)
 {
     rd_status_t status = RD_ERROR_INVALID_STATE;
+    RI_PROFILE_ENTER (m_zone_data_get);
 
     if (NULL == p_data)
     {
@@ -146,6 +151,7 @@ static rd_status_t rt_adc_mcu_data_get (rd_sensor_data_t * const
         }
     }
 
+    RI_PROFILE_EXIT (m_zone_data_get);
     return RD_SUCCESS;
 }
 
@@ -166,6 +172,9 @@ rd_status_t rt_adc_init (void)
 
         m_next_channel = 0;
         err_code |= ri_adc_init (NULL);
+#if RT_ENERGY_ENABLED
+        rt_energy_state_set (RT_ENERGY_ADC, RT_ENERGY_STATE_ACTIVE);
+#endif
     }
 
     return err_code;
@@ -180,6 +189,9 @@ rd_status_t rt_adc_uninit (void)
     m_ratio = false;
     err_code |= ri_adc_stop (m_channel[m_handle]);
     err_code |= ri_adc_uninit (true);
+#if RT_ENERGY_ENABLED
+    rt_energy_state_set (RT_ENERGY_ADC, RT_ENERGY_STATE_SLEEP);
+#endif
 
     for (size_t ii = 0; ii < RI_ADC_CH_NUM; ii++)
     {
@@ -420,5 +432,139 @@ rd_status_t rt_adc_ratiometric_sample (rd_sensor_configuration_t * const configu
     *sample = rd_sensor_data_parse (&d_adc, d_adc.fields);
     return err_code;
 }
+
+/**
+ * @brief Check scan inputs and invalidate their results.
+ */
+static rd_status_t scan_inputs_check (const rt_adc_scan_input_t * const p_inputs,
+                                      const size_t count)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if (NULL == p_inputs)
+    {
+        err_code |= RD_ERROR_NULL;
+    }
+    else if ( (0U == count) || (RI_ADC_CH_NUM < count))
+    {
+        err_code |= RD_ERROR_INVALID_PARAM;
+    }
+    else
+    {
+        for (size_t ii = 0; ii < count; ii++)
+        {
+            if (NULL == p_inputs[ii].p_result)
+            {
+                err_code |= RD_ERROR_NULL;
+            }
+            else
+            {
+                *p_inputs[ii].p_result = RD_FLOAT_INVALID;
+            }
+
+            if ( (RI_ADC_GND == p_inputs[ii].handle) || (RI_ADC_CH_NUM <= p_inputs[ii].handle))
+            {
+                err_code |= RD_ERROR_INVALID_PARAM;
+            }
+        }
+    }
+
+    return err_code;
+}
+
+/**
+ * @brief Assign and configure channel for handle unless it already has one.
+ */
+static rd_status_t scan_input_configure (const uint8_t handle)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if (RT_ADC_CH_UNUSED == m_channel[handle])
+    {
+        err_code |= channel_assign (handle);
+
+        if (RD_SUCCESS == err_code)
+        {
+            pins_config.p_pin.channel = handle;
+            err_code |= ri_adc_configure (m_channel[handle],
+                                          &pins_config,
+                                          &absolute_config);
+        }
+    }
+
+    return err_code;
+}
+
+/**
+ * @brief Convert raw sample of input to its consumer.
+ *
+ * Channels are assigned in ascending order, so scan result of channel is at
+ * index of channel.
+ */
+static rd_status_t scan_input_convert (const rt_adc_scan_input_t * const p_input,
+                                       const int16_t * const p_raw)
+{
+    rd_status_t err_code = RD_SUCCESS;
+    const uint8_t channel = m_channel[p_input->handle];
+
+    if (ABSOLUTE == p_input->mode)
+    {
+        err_code |= ri_adc_raw_to_absolute (channel, &options, p_raw[channel],
+                                            p_input->p_result);
+    }
+    else
+    {
+        err_code |= ri_adc_raw_to_ratio (channel, &options, p_raw[channel],
+                                         p_input->p_result);
+    }
+
+    return err_code;
+}
+
+rd_status_t rt_adc_scan (const rt_adc_scan_input_t * const p_inputs, const size_t count)
+{
+    rd_status_t err_code = scan_inputs_check (p_inputs, count);
+
+    if (RD_SUCCESS == err_code)
+    {
+        err_code |= rt_adc_init();
+
+        if (RD_SUCCESS == err_code)
+        {
+            int16_t raw[RI_ADC_CH_NUM] = {0};
+
+            for (size_t ii = 0; (ii < count) && (RD_SUCCESS == err_code); ii++)
+            {
+                err_code |= scan_input_configure (p_inputs[ii].handle);
+            }
+
+            if (RD_SUCCESS == err_code)
+            {
+                err_code |= ri_adc_scan_raw (raw, m_next_channel);
+            }
+
+            for (size_t ii = 0; (ii < count) && (RD_SUCCESS == err_code); ii++)
+            {
+                err_code |= scan_input_convert (&p_inputs[ii], raw);
+            }
+
+            // Stop a channel which is in use by scan.
+            m_handle = p_inputs[0].handle;
+            err_code |= rt_adc_uninit();
+        }
+
+        // Uninit clears VDD state, VDD sampled in scan is stored after it.
+        for (size_t ii = 0; (ii < count) && (RD_SUCCESS == err_code); ii++)
+        {
+            if ( (RI_ADC_AINVDD == p_inputs[ii].handle) && (ABSOLUTE == p_inputs[ii].mode))
+            {
+                m_vdd = *p_inputs[ii].p_result;
+                m_vdd_sampled = true;
+            }
+        }
+    }
+
+    return err_code;
+}
 #endif
 /** @}*/
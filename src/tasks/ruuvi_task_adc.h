@@ -62,6 +62,14 @@ typedef enum
     ABSOLUTE        //!< ADC measures absolute voltage in volts
 } rt_adc_mode_t;  //!< ADC against absolute reference or ratio to VDD
 
+/** @brief One input of @ref rt_adc_scan and consumer of its result. */
+typedef struct
+{
+    uint8_t handle;       //!< Handle to ADC, i.e. ADC pin.
+    rt_adc_mode_t mode;   //!< Absolute voltage or ratio to VDD.
+    float * p_result;     //!< Result of input, RD_FLOAT_INVALID if not sampled.
+} rt_adc_scan_input_t;
+
 /**
  * @brief Reserve ADC
  *
@@ -210,5 +218,37 @@ rd_status_t rt_adc_absolute_sample (rd_sensor_configuration_t * const configurat
  */
 rd_status_t rt_adc_ratiometric_sample (rd_sensor_configuration_t * const configuration,
                                        const uint8_t handle, float * const sample);
+
+/**
+ * @brief Sample a group of ADC inputs with one ADC power cycle.
+ *
+ * This function initializes ADC once, configures all inputs, converts them
+ * in one scan, writes each result to its consumer and uninitializes ADC.
+ * Sampling battery, NTC and photodiode separately costs three ADC power cycles
+ * and channel configurations, a scan costs one.
+ * Same handle may be listed twice, e.g. in absolute and ratiometric mode, and it is
+ * sampled once. Absolute sample of RI_ADC_AINVDD updates value of @ref rt_adc_vdd_get.
+ *
+ * @code{.c}
+ *  float battery, ntc, photo;
+ *  const rt_adc_scan_input_t inputs[] =
+ *  {
+ *      { .handle = RI_ADC_AINVDD, .mode = ABSOLUTE,    .p_result = &battery },
+ *      { .handle = RI_ADC_AIN1,   .mode = RATIOMETRIC, .p_result = &ntc },
+ *      { .handle = RI_ADC_AIN2,   .mode = ABSOLUTE,    .p_result = &photo }
+ *  };
+ *  err_code |= rt_adc_scan (inputs, sizeof (inputs) / sizeof (inputs[0]));
+ * @endcode
+ *
+ * @param[in] p_inputs Inputs to sample and consumers of results.
+ * @param[in] count Number of inputs, at most RI_ADC_CH_NUM.
+ * @retval RD_SUCCESS on success.
+ * @retval RD_ERROR_NULL if p_inputs or any result pointer is NULL.
+ * @retval RD_ERROR_INVALID_PARAM if count is 0 or too large, or any handle is invalid.
+ * @retval RD_ERROR_INVALID_STATE if ADC is already in use.
+ * @retval RD_ERROR_RESOURCES if there are more distinct handles than ADC channels.
+ * @retval error code from stack on error.
+ */
+rd_status_t rt_adc_scan (const rt_adc_scan_input_t * const p_inputs, const size_t count);
 /** @} */
 #endif // TASK_ADC_H
\ No newline at end of file
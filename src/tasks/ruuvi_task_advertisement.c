@@ -35,6 +35,12 @@ static size_t safe_strlen (const char * s, size_t maxlen)
 
 static ri_comm_channel_t m_channel;
 static bool m_is_init;
+static ri_comm_scan_schedule_t m_scan_schedule;
+static ri_comm_evt_handler_fp_t m_scan_evt;  //!< Application handler of scheduled scan.
+static volatile bool m_scan_scheduled;       //!< Start next window on timeout.
+static volatile uint32_t m_scan_reports;     //!< Reports in current window.
+static uint16_t m_scan_window_ms;
+static uint8_t m_scan_channels;              //!< Channels scanned in each window.
 
 rd_status_t rt_adv_init (rt_adv_init_t * const adv_init_settings)
 {
@@ -57,6 +63,7 @@ rd_status_t rt_adv_init (rt_adv_init_t * const adv_init_settings)
         err_code |= ri_adv_type_set (NONCONNECTABLE_NONSCANNABLE);
         err_code |= ri_adv_manufacturer_id_set (adv_init_settings->manufacturer_id);
         err_code |= ri_adv_channels_set (adv_init_settings->channels);
+        m_scan_channels = ri_radio_num_channels_get (adv_init_settings->channels);
 
         if (RD_SUCCESS == err_code)
         {
@@ -113,6 +120,94 @@ rd_status_t rt_adv_send_data (ri_comm_message_t * const msg)
     return err_code;
 }
 
+rd_status_t rt_adv_update_data (ri_comm_message_t * const msg)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if (NULL == msg)
+    {
+        err_code |= RD_ERROR_NULL;
+    }
+    else if (!rt_adv_is_init())
+    {
+        err_code |= RD_ERROR_INVALID_STATE;
+    }
+    else if (24 < msg->data_length)
+    {
+        err_code |= RD_ERROR_DATA_SIZE;
+    }
+    else
+    {
+        err_code |= ri_adv_data_update (msg);
+
+        // Nothing on air to update or set must be reconfigured, queue as a new advertisement.
+        if ( (RD_ERROR_INVALID_STATE == err_code) || (RD_ERROR_INVALID_PARAM == err_code))
+        {
+            err_code = m_channel.send (msg);
+        }
+    }
+
+    return err_code;
+}
+
+rd_status_t rt_adv_rotation_set (const uint8_t slot, ri_comm_message_t * const msg,
+                                 const uint8_t weight,
+                                 const ri_radio_modulation_t modulation)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if (NULL == msg)
+    {
+        err_code |= RD_ERROR_NULL;
+    }
+    else if (!rt_adv_is_init())
+    {
+        err_code |= RD_ERROR_INVALID_STATE;
+    }
+    else if (24 < msg->data_length)
+    {
+        err_code |= RD_ERROR_DATA_SIZE;
+    }
+    else
+    {
+        err_code |= ri_adv_rotation_slot_set (slot, msg, weight, modulation);
+    }
+
+    return err_code;
+}
+
+rd_status_t rt_adv_rotation_start (void)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if (!rt_adv_is_init())
+    {
+        err_code |= RD_ERROR_INVALID_STATE;
+    }
+    else
+    {
+        err_code |= ri_adv_rotation_start();
+    }
+
+    return err_code;
+}
+
+rd_status_t rt_adv_rotation_stop (void)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if (!rt_adv_is_init())
+    {
+        err_code |= RD_ERROR_INVALID_STATE;
+    }
+    else
+    {
+        err_code |= ri_adv_rotation_stop();
+    }
+
+    return err_code;
+}
+
 rd_status_t rt_adv_connectability_set (const bool enable, const char * const device_name)
 {
     rd_status_t err_code = RD_SUCCESS;
@@ -157,6 +252,7 @@ rd_status_t rt_adv_scan_start (const ri_comm_evt_handler_fp_t on_evt)
     }
     else
     {
+        m_scan_scheduled = false;
         m_channel.on_evt = on_evt;
         err_code |= ri_adv_scan_start (RT_ADV_SCAN_INTERVAL_MS, RT_ADV_SCAN_WINDOW_MS);
     }
@@ -174,11 +270,104 @@ rd_status_t rt_adv_scan_stop (void)
     }
     else
     {
+        m_scan_scheduled = false;
         err_code |= ri_adv_scan_stop();
     }
 
     return err_code;
 }
 
+static rd_status_t scan_window_start (void)
+{
+    rd_status_t err_code = RD_SUCCESS;
+    ri_radio_modulation_t modulation = RI_RADIO_BLE_1MBPS;
+    err_code |= ri_comm_scan_schedule_next (&m_scan_schedule, &modulation);
+    m_scan_reports = 0;
+
+    if (RD_SUCCESS == err_code)
+    {
+        err_code |= ri_adv_scan_phy_start (m_scan_window_ms, m_scan_window_ms, modulation);
+    }
+
+    return err_code;
+}
+
+static rd_status_t scan_schedule_isr (const ri_comm_evt_t evt, void * p_data,
+                                      size_t data_len)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if ( (RI_COMM_TIMEOUT == evt) && m_scan_scheduled)
+    {
+        // Window is scanned on each channel in turn.
+        (void) ri_comm_scan_schedule_window_done (&m_scan_schedule, m_scan_reports,
+                (uint32_t) m_scan_channels * m_scan_window_ms);
+        err_code |= scan_window_start();
+
+        if (RD_SUCCESS != err_code)
+        {
+            m_scan_scheduled = false;
+            err_code |= m_scan_evt (RI_COMM_TIMEOUT, NULL, 0);
+        }
+    }
+    else
+    {
+        if (RI_COMM_RECEIVED == evt)
+        {
+            m_scan_reports++;
+        }
+
+        err_code |= m_scan_evt (evt, p_data, data_len);
+    }
+
+    return err_code;
+}
+
+rd_status_t rt_adv_scan_schedule_start (const ri_comm_scan_schedule_init_t * const
+                                        p_schedule, const uint16_t window_ms,
+                                        const ri_comm_evt_handler_fp_t on_evt)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if ( (NULL == p_schedule) || (NULL == on_evt))
+    {
+        err_code |= RD_ERROR_NULL;
+    }
+    else if (!rt_adv_is_init())
+    {
+        err_code |= RD_ERROR_INVALID_STATE;
+    }
+    else if (0U == window_ms)
+    {
+        err_code |= RD_ERROR_INVALID_PARAM;
+    }
+    else
+    {
+        err_code |= ri_comm_scan_schedule_init (&m_scan_schedule, p_schedule);
+
+        if (RD_SUCCESS == err_code)
+        {
+            m_scan_evt = on_evt;
+            m_scan_window_ms = window_ms;
+            m_channel.on_evt = scan_schedule_isr;
+            m_scan_scheduled = true;
+            err_code |= scan_window_start();
+
+            if (RD_SUCCESS != err_code)
+            {
+                m_scan_scheduled = false;
+            }
+        }
+    }
+
+    return err_code;
+}
+
+rd_status_t rt_adv_scan_schedule_stats_get (const ri_radio_modulation_t modulation,
+        ri_comm_scan_schedule_stats_t * const p_stats)
+{
+    return ri_comm_scan_schedule_stats_get (&m_scan_schedule, modulation, p_stats);
+}
+
 #endif
 /** @} */
@@ -46,6 +46,7 @@
 
 #include "ruuvi_driver_error.h"
 #include "ruuvi_interface_communication_ble_advertising.h"
+#include "ruuvi_interface_communication_scan_schedule.h"
 
 /** @brief Longer name gets truncated when advertised with UUID. */
 #define SCAN_RSP_NAME_MAX_LEN (11U)
@@ -123,6 +124,60 @@ rd_status_t rt_adv_stop (void);
  */
 rd_status_t rt_adv_send_data (ri_comm_message_t * const msg);
 
+/** @brief Update payload of ongoing advertisement without restarting it.
+ *
+ *  Payload of advertisement on repeat is replaced in place, so advertising continues
+ *  without a gap. If there is no ongoing advertisement to update, for example on first call,
+ *  message is sent with @ref rt_adv_send_data. Send with repeat_count of
+ *  @ref RI_COMM_MSG_REPEAT_FOREVER to keep the advertisement running between updates.
+ *
+ *  @param[in] msg message to be sent as manufacturer specific data payload.
+ *  @retval    RD_SUCCESS if payload was updated or message was queued.
+ *  @retval    RD_ERROR_NULL if msg is NULL.
+ *  @retval    RD_ERROR_INVALID_STATE if advertising isn't initialized.
+ *  @retval    RD_ERROR_DATA_SIZE if payload size is larger than 24 bytes.
+ *  @return    error code from stack on other error.
+ */
+rd_status_t rt_adv_update_data (ri_comm_message_t * const msg);
+
+/** @brief Set payload of an advertisement rotation slot.
+ *
+ *  Rotation sends payloads of several producers in turn, e.g. sensor data in one slot
+ *  and an URL in another, without re-queuing them. Each producer updates its own slot,
+ *  new payload is sent from the next turn of the slot on.
+ *
+ *  @param[in] slot Index of slot, less than @ref RI_ADV_ROTATION_SLOTS.
+ *  @param[in] msg message to be sent as manufacturer specific data payload.
+ *  @param[in] weight Number of advertising events sent on each turn of slot.
+ *  @param[in] modulation PHY of slot.
+ *  @retval    RD_SUCCESS if payload was stored.
+ *  @retval    RD_ERROR_NULL if msg is NULL.
+ *  @retval    RD_ERROR_INVALID_STATE if advertising isn't initialized.
+ *  @retval    RD_ERROR_DATA_SIZE if payload size is larger than 24 bytes.
+ *  @return    error code from @ref ri_adv_rotation_slot_set on other error.
+ */
+rd_status_t rt_adv_rotation_set (const uint8_t slot, ri_comm_message_t * const msg,
+                                 const uint8_t weight,
+                                 const ri_radio_modulation_t modulation);
+
+/** @brief Start sending advertisement rotation.
+ *
+ *  Messages sent with @ref rt_adv_send_data are queued until rotation is stopped.
+ *
+ *  @retval    RD_SUCCESS if rotation was started.
+ *  @retval    RD_ERROR_INVALID_STATE if advertising isn't initialized, an advertisement
+ *                                    is ongoing or no slot is set.
+ *  @return    error code from stack on other error.
+ */
+rd_status_t rt_adv_rotation_start (void);
+
+/** @brief Stop advertisement rotation, slots are kept.
+ *
+ *  @retval    RD_SUCCESS on success.
+ *  @retval    RD_ERROR_INVALID_STATE if advertising isn't initialized.
+ */
+rd_status_t rt_adv_rotation_stop (void);
+
 /** @brief Start advertising BLE GATT connection
  *
  *  This function configures the primary advertisement to be SCANNABLE_CONNECTABLE and
@@ -174,6 +229,45 @@ bool rt_adv_is_init (void);
  */
 rd_status_t rt_adv_scan_start (const ri_comm_evt_handler_fp_t on_evt);
 
+/** @brief Scan 1 MBit/s, 2 MBit/s and Coded PHY in turns.
+ *
+ * Each turn scans one PHY for window_ms on every channel, PHYs are selected by
+ * @ref ri_comm_scan_schedule_next. Reports received during a window are
+ * credited to its PHY, in adaptive mode busier PHYs get more windows.
+ * Next window starts on timeout of previous one, scanning continues until
+ * @ref rt_adv_scan_stop.
+ *
+ * Events are:
+ *   - on_evt(RI_COMM_RECEIVED, scan, sizeof(ri_adv_scan_t));
+ *   - on_evt(RI_COMM_TIMEOUT, NULL, 0) if next window could not be started.
+ *
+ *  @param[in] p_schedule Weights of PHYs.
+ *  @param[in] window_ms Scan window on each channel, at most 10 s.
+ *  @param[in] on_evt Event handler for scan results.
+ *  @retval    RD_SUCCESS Scanning was started.
+ *  @retval    RD_ERROR_NULL if p_schedule or on_evt is NULL.
+ *  @retval    RD_ERROR_INVALID_PARAM if all weights are 0 or window_ms is 0.
+ *  @retval    RD_ERROR_INVALID_STATE Advertising isn't initialized.
+ *  @retval    RD_ERROR_NOT_SUPPORTED if a PHY with weight is not supported by radio.
+ *  @return    error code from stack on other error.
+ *
+ * @warning Event handler is called in interrupt context.
+ */
+rd_status_t rt_adv_scan_schedule_start (const ri_comm_scan_schedule_init_t * const
+                                        p_schedule, const uint16_t window_ms,
+                                        const ri_comm_evt_handler_fp_t on_evt);
+
+/** @brief Get scan results of a PHY in scheduled scan.
+ *
+ *  @param[in] modulation PHY.
+ *  @param[out] p_stats Results since @ref rt_adv_scan_schedule_start.
+ *  @retval    RD_SUCCESS on success.
+ *  @retval    RD_ERROR_NULL if p_stats is NULL.
+ *  @retval    RD_ERROR_INVALID_PARAM if modulation is not a scanned PHY.
+ */
+rd_status_t rt_adv_scan_schedule_stats_get (const ri_radio_modulation_t modulation,
+        ri_comm_scan_schedule_stats_t * const p_stats);
+
 /**
  * @brief Abort scanning.
  *
@@ -0,0 +1,524 @@
+/**
+ * @addtogroup battery_tasks
+ */
+/*@{*/
+/**
+ * @file ruuvi_task_battery.c
+ * @author Otso Jousimaa <otso@ojousima.net>
+ * @date 2026-10-18
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ *
+ * Radio interrupt only counts radio events and queues sampling task, so ADC is
+ * never initialized or sampled in the high priority radio interrupt. Event count
+ * is odd while radio is about to turn on or is on. Sampling task runs in scheduler
+ * and compares the count to the activity it sampled last: resting VDD is sampled
+ * while count is odd, loaded VDD once count is even again.
+ *
+ * Statistics are written only by sampling task and reset, both in main context.
+ * Writer makes sequence number odd for the duration of update, reader retries
+ * until it gets a copy with an even, unchanged sequence number. An interrupt
+ * which preempted the writer cannot wait for it, so reader gives up after
+ * a few tries and statistics may be read from interrupts too.
+ */
+#include "ruuvi_driver_enabled_modules.h"
+#if RT_BATTERY_ENABLED
+#include "ruuvi_driver_error.h"
+#include "ruuvi_driver_sensor.h"
+#include "ruuvi_interface_communication_radio.h"
+#include "ruuvi_interface_scheduler.h"
+#include "ruuvi_task_adc.h"
+#include "ruuvi_task_battery.h"
+#include <string.h>
+
+#define BATTERY_DATA_VOLTAGE (1U) //!< Number of voltage values in ADC data.
+#define STATS_READ_TRIES     (3U) //!< Copies of statistics tried before giving up.
+
+static const char m_sensor_name[] = "BATT";
+static volatile rt_battery_stats_t m_stats;
+static volatile uint32_t m_sequence;
+static volatile uint32_t m_radio_events; //!< Written only by radio interrupt.
+static volatile bool m_task_pending;     //!< Sampling task is queued.
+static volatile bool m_tracking;         //!< Radio activity is sampled.
+static bool m_prepared;                  //!< ADC is reserved and configured for loaded sample.
+static uint32_t m_rest_events;           //!< Radio events when resting VDD was sampled.
+static uint32_t m_done_events;           //!< Radio events when latest activity ended.
+static float m_rest_v;                   //!< VDD before radio activity.
+static bool m_is_init;
+static bool m_own_radio_callback;
+static uint8_t m_dsp;
+static ri_radio_activity_interrupt_fp_t m_radio_chain;
+
+static rd_sensor_configuration_t m_vdd_config =
+{
+    .dsp_function  = RD_SENSOR_DSP_LAST,
+    .dsp_parameter = RD_SENSOR_CFG_DEFAULT,
+    .mode          = RD_SENSOR_CFG_SINGLE,
+    .resolution    = RD_SENSOR_CFG_DEFAULT,
+    .samplerate    = RD_SENSOR_CFG_DEFAULT,
+    .scale         = RD_SENSOR_CFG_DEFAULT
+};
+
+static void stats_clear (void)
+{
+    m_stats.last_v = RD_FLOAT_INVALID;
+    m_stats.min_v = RD_FLOAT_INVALID;
+    m_stats.average_v = RD_FLOAT_INVALID;
+    m_stats.droop_v = RD_FLOAT_INVALID;
+    m_stats.max_droop_v = RD_FLOAT_INVALID;
+    m_stats.timestamp_ms = RD_UINT64_INVALID;
+    m_stats.samples = 0;
+    m_stats.skipped = 0;
+}
+
+/**
+ * @brief Add one radio activity to statistics.
+ */
+static void stats_update (const float rest_v, const float load_v)
+{
+    m_sequence++;
+    const uint32_t samples = m_stats.samples + 1U;
+    const uint32_t weight = (samples < RT_BATTERY_AVERAGE_WINDOW) ?
+                            samples : RT_BATTERY_AVERAGE_WINDOW;
+    const float droop = rest_v - load_v;
+
+    if (1U == samples)
+    {
+        m_stats.min_v = load_v;
+        m_stats.average_v = load_v;
+        m_stats.max_droop_v = droop;
+    }
+    else
+    {
+        m_stats.min_v = (load_v < m_stats.min_v) ? load_v : m_stats.min_v;
+        m_stats.average_v += (load_v - m_stats.average_v) / (float) weight;
+        m_stats.max_droop_v = (droop > m_stats.max_droop_v) ? droop : m_stats.max_droop_v;
+    }
+
+    m_stats.last_v = load_v;
+    m_stats.droop_v = droop;
+    m_stats.samples = samples;
+    m_stats.timestamp_ms = rd_sensor_timestamp_get();
+    m_sequence++;
+}
+
+static void stats_skip (void)
+{
+    m_sequence++;
+    m_stats.skipped++;
+    m_sequence++;
+}
+
+static void adc_release (void)
+{
+    if (m_prepared)
+    {
+        m_prepared = false;
+        (void) rt_adc_uninit();
+    }
+}
+
+/**
+ * @brief Reserve ADC and sample resting VDD before radio turns on.
+ */
+static void sample_rest (const uint32_t events)
+{
+    rd_status_t err_code = rt_adc_vdd_prepare (&m_vdd_config);
+
+    // ADC busy is counted as skipped once radio activity ends.
+    if (RD_SUCCESS == err_code)
+    {
+        rd_sensor_data_t rest;
+        float rest_value = RD_FLOAT_INVALID;
+        memset (&rest, 0, sizeof (rest));
+        rest.data = &rest_value;
+        rest.fields.datas.voltage_v = BATTERY_DATA_VOLTAGE;
+        err_code |= rt_adc_voltage_get (&rest);
+
+        if (RD_SUCCESS == err_code)
+        {
+            m_rest_v = rd_sensor_data_parse (&rest, rest.fields);
+            m_rest_events = events;
+            m_prepared = true;
+        }
+        else
+        {
+            // Activity without resting VDD is counted as skipped once it ends.
+            (void) rt_adc_uninit();
+        }
+    }
+}
+
+/**
+ * @brief Sample loaded VDD after radio turns off and release ADC.
+ */
+static void sample_load (void)
+{
+    float load_v = RD_FLOAT_INVALID;
+    m_prepared = false;
+    rd_status_t err_code = rt_adc_vdd_sample();
+    err_code |= rt_adc_vdd_get (&load_v);
+
+    if (RD_SUCCESS == err_code)
+    {
+        stats_update (m_rest_v, load_v);
+    }
+    else
+    {
+        stats_skip();
+    }
+}
+
+static void sample_task (void * p_event_data, uint16_t event_size)
+{
+    // Clear before reading events, so an event after the read queues task again.
+    m_task_pending = false;
+    const uint32_t events = m_radio_events;
+
+    if (!m_is_init)
+    {
+        // Uninitialized while task was queued.
+    }
+    else if (0U != (events & 1U))
+    {
+        if (!m_prepared)
+        {
+            sample_rest (events);
+        }
+    }
+    else if (events != m_done_events)
+    {
+        // Resting VDD must belong to the activity which just ended.
+        if (m_prepared && ( (m_rest_events + 1U) == events))
+        {
+            sample_load();
+        }
+        else
+        {
+            adc_release();
+            stats_skip();
+        }
+
+        m_done_events = events;
+    }
+    else
+    {
+        // No new radio activity.
+    }
+}
+
+void rt_battery_radio_activity_handler (const ri_radio_activity_evt_t evt)
+{
+    if (m_is_init && m_tracking)
+    {
+        const bool radio_on = (0U != (m_radio_events & 1U));
+
+        if ( (RI_RADIO_BEFORE == evt) != radio_on)
+        {
+            m_radio_events++;
+
+            if (!m_task_pending)
+            {
+                m_task_pending = (RD_SUCCESS == ri_scheduler_event_put (NULL, 0, &sample_task));
+            }
+        }
+        else
+        {
+            // Unpaired event, e.g. tracking started during radio activity.
+        }
+    }
+
+    if (NULL != m_radio_chain)
+    {
+        m_radio_chain (evt);
+    }
+}
+
+rd_status_t rt_battery_init (const bool own_radio_callback)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if (m_is_init || (own_radio_callback && (NULL != ri_radio_activity_callback_get())))
+    {
+        // Interface would ignore tracker callback.
+        err_code |= RD_ERROR_INVALID_STATE;
+    }
+    else
+    {
+        stats_clear();
+        m_prepared = false;
+        m_radio_events = 0;
+        m_rest_events = 0;
+        m_done_events = 0;
+        m_task_pending = false;
+        m_tracking = true;
+        m_dsp = RD_SENSOR_DSP_LAST;
+        m_own_radio_callback = own_radio_callback;
+        m_is_init = true;
+
+        if (own_radio_callback)
+        {
+            ri_radio_activity_callback_set (&rt_battery_radio_activity_handler);
+        }
+    }
+
+    return err_code;
+}
+
+void rt_battery_uninit (void)
+{
+    if (m_is_init && m_own_radio_callback
+            && (&rt_battery_radio_activity_handler == ri_radio_activity_callback_get()))
+    {
+        // Interface keeps existing callback, clear it before restoring chain.
+        ri_radio_activity_callback_set (NULL);
+        ri_radio_activity_callback_set (m_radio_chain);
+    }
+
+    adc_release();
+
+    m_is_init = false;
+    m_own_radio_callback = false;
+    m_tracking = false;
+    m_radio_chain = NULL;
+}
+
+bool rt_battery_is_init (void)
+{
+    return m_is_init;
+}
+
+void rt_battery_reset (void)
+{
+    m_sequence++;
+    stats_clear();
+    m_sequence++;
+}
+
+void rt_battery_radio_activity_chain (const ri_radio_activity_interrupt_fp_t handler)
+{
+    m_radio_chain = handler;
+}
+
+rd_status_t rt_battery_stats_get (rt_battery_stats_t * const p_stats)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if (NULL == p_stats)
+    {
+        err_code |= RD_ERROR_NULL;
+    }
+    else if (!m_is_init)
+    {
+        err_code |= RD_ERROR_INVALID_STATE;
+    }
+    else
+    {
+        bool consistent = false;
+
+        for (uint8_t tries = 0; (tries < STATS_READ_TRIES) && !consistent; tries++)
+        {
+            const uint32_t sequence = m_sequence;
+            *p_stats = m_stats;
+            consistent = (0U == (sequence & 1U)) && (sequence == m_sequence);
+        }
+
+        if (!consistent)
+        {
+            // Caller preempted update.
+            err_code |= RD_ERROR_BUSY;
+        }
+    }
+
+    return err_code;
+}
+
+static rd_status_t battery_mode_get (uint8_t * mode)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if (NULL == mode)
+    {
+        err_code |= RD_ERROR_NULL;
+    }
+    else
+    {
+        *mode = m_tracking ? RD_SENSOR_CFG_CONTINUOUS : RD_SENSOR_CFG_SLEEP;
+    }
+
+    return err_code;
+}
+
+static rd_status_t battery_mode_set (uint8_t * mode)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if (NULL == mode)
+    {
+        err_code |= RD_ERROR_NULL;
+    }
+    else if (RD_SENSOR_CFG_SLEEP == *mode)
+    {
+        m_tracking = false;
+        adc_release();
+    }
+    else if ( (RD_SENSOR_CFG_CONTINUOUS == *mode) || (RD_SENSOR_CFG_DEFAULT == *mode))
+    {
+        m_tracking = true;
+        *mode = RD_SENSOR_CFG_CONTINUOUS;
+    }
+    else if (RD_SENSOR_CFG_SINGLE == *mode)
+    {
+        // Samples follow radio activity, latest sample is always available.
+        err_code |= battery_mode_get (mode);
+    }
+    else
+    {
+        err_code |= RD_ERROR_INVALID_PARAM;
+    }
+
+    return err_code;
+}
+
+static rd_status_t battery_samplerate_set (uint8_t * samplerate)
+{
+    uint8_t mode;
+    rd_status_t err_code = battery_mode_get (&mode);
+    return err_code | validate_default_input_set (samplerate, mode);
+}
+
+static rd_status_t battery_resolution_set (uint8_t * resolution)
+{
+    uint8_t mode;
+    rd_status_t err_code = battery_mode_get (&mode);
+    return err_code | validate_default_input_set (resolution, mode);
+}
+
+static rd_status_t battery_scale_set (uint8_t * scale)
+{
+    uint8_t mode;
+    rd_status_t err_code = battery_mode_get (&mode);
+    return err_code | validate_default_input_set (scale, mode);
+}
+
+static rd_status_t battery_dsp_set (uint8_t * dsp, uint8_t * parameter)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if ( (NULL == dsp) || (NULL == parameter))
+    {
+        err_code |= RD_ERROR_NULL;
+    }
+    else if ( (RD_SENSOR_DSP_LAST == *dsp) || (RD_SENSOR_DSP_LOW_PASS == *dsp))
+    {
+        // Average window is fixed at compile time.
+        m_dsp = *dsp;
+        *parameter = RD_SENSOR_CFG_DEFAULT;
+    }
+    else
+    {
+        err_code |= RD_ERROR_NOT_SUPPORTED;
+    }
+
+    return err_code;
+}
+
+static rd_status_t battery_dsp_get (uint8_t * dsp, uint8_t * parameter)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if ( (NULL == dsp) || (NULL == parameter))
+    {
+        err_code |= RD_ERROR_NULL;
+    }
+    else
+    {
+        *dsp = m_dsp;
+        *parameter = RD_SENSOR_CFG_DEFAULT;
+    }
+
+    return err_code;
+}
+
+static rd_status_t battery_data_get (rd_sensor_data_t * const p_data)
+{
+    rd_status_t err_code = RD_SUCCESS;
+    rt_battery_stats_t stats;
+
+    if (NULL == p_data)
+    {
+        err_code |= RD_ERROR_NULL;
+    }
+    else
+    {
+        err_code |= rt_battery_stats_get (&stats);
+
+        if ( (RD_SUCCESS == err_code) && (0U < stats.samples))
+        {
+            const rd_sensor_data_fields_t voltage = {.datas.voltage_v = BATTERY_DATA_VOLTAGE};
+            const float value = (RD_SENSOR_DSP_LOW_PASS == m_dsp) ?
+                                stats.average_v : stats.last_v;
+            rd_sensor_data_set (p_data, voltage, value);
+            p_data->timestamp_ms = stats.timestamp_ms;
+        }
+    }
+
+    return err_code;
+}
+
+rd_status_t rt_battery_sensor_init (rd_sensor_t * const p_sensor, const rd_bus_t bus,
+                                    const uint8_t handle)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if (NULL == p_sensor)
+    {
+        err_code |= RD_ERROR_NULL;
+    }
+    else if (!m_is_init)
+    {
+        err_code |= RD_ERROR_INVALID_STATE;
+    }
+    else
+    {
+        rd_sensor_initialize (p_sensor);
+        p_sensor->name              = m_sensor_name;
+        p_sensor->init              = rt_battery_sensor_init;
+        p_sensor->uninit            = rt_battery_sensor_uninit;
+        p_sensor->samplerate_set    = battery_samplerate_set;
+        p_sensor->samplerate_get    = validate_default_input_get;
+        p_sensor->resolution_set    = battery_resolution_set;
+        p_sensor->resolution_get    = validate_default_input_get;
+        p_sensor->scale_set         = battery_scale_set;
+        p_sensor->scale_get         = validate_default_input_get;
+        p_sensor->dsp_set           = battery_dsp_set;
+        p_sensor->dsp_get           = battery_dsp_get;
+        p_sensor->mode_set          = battery_mode_set;
+        p_sensor->mode_get          = battery_mode_get;
+        p_sensor->data_get          = battery_data_get;
+        p_sensor->configuration_set = rd_sensor_configuration_set;
+        p_sensor->configuration_get = rd_sensor_configuration_get;
+        p_sensor->provides.datas.voltage_v = BATTERY_DATA_VOLTAGE;
+    }
+
+    return err_code;
+}
+
+rd_status_t rt_battery_sensor_uninit (rd_sensor_t * const p_sensor, const rd_bus_t bus,
+                                      const uint8_t handle)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if (NULL == p_sensor)
+    {
+        err_code |= RD_ERROR_NULL;
+    }
+    else
+    {
+        rd_sensor_uninitialize (p_sensor);
+    }
+
+    return err_code;
+}
+
+/*@}*/
+#endif
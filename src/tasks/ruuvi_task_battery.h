@@ -0,0 +1,180 @@
+#ifndef RUUVI_TASK_BATTERY_H
+#define RUUVI_TASK_BATTERY_H
+/**
+ * @addtogroup peripheral_tasks
+ */
+/*@{*/
+/**
+ * @defgroup battery_tasks Battery tasks
+ * @brief Track battery voltage under radio load.
+ *
+ */
+/*@}*/
+/**
+ * @addtogroup battery_tasks
+ */
+/*@{*/
+/**
+ * @file ruuvi_task_battery.h
+ * @author Otso Jousimaa <otso@ojousima.net>
+ * @date 2026-10-18
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ *
+ * @brief Battery voltage tracker synchronized to radio activity.
+ *
+ * ADC is prepared and resting VDD is sampled when radio is about to turn on,
+ * and loaded VDD is sampled as soon as radio turns off. Sampling piggybacks on
+ * radio wakeups, so battery monitoring costs no extra wakeups and captures
+ * the voltage droop of the radio load. Statistics are kept in fixed memory
+ * and are available as a @ref rd_sensor_t with voltage_v.
+ *
+ * Radio interrupt only queues sampling into scheduler, so scheduler must be
+ * initialized. Loaded VDD is sampled once scheduler runs after radio turns off,
+ * which is right away unless main context is busy. If radio turns off before
+ * resting VDD was sampled, activity is skipped.
+ *
+ * Radio activity callback has a single owner. The tracker either installs its own
+ * handler and forwards events to a chained handler, or another owner such as
+ * the energy ledger forwards events to @ref rt_battery_radio_activity_handler.
+ *
+ * Typical usage:
+ *
+ * @code{.c}
+ *  rd_sensor_t battery;
+ *  rt_battery_stats_t stats;
+ *  // Energy ledger owns radio activity callback, forward to tracker.
+ *  err_code |= rt_energy_init (&profile);
+ *  err_code |= rt_battery_init (false);
+ *  rt_energy_radio_activity_chain (&rt_battery_radio_activity_handler);
+ *  err_code |= rt_battery_sensor_init (&battery, RD_BUS_NONE, 0);
+ *  // ... Later.
+ *  err_code |= rt_battery_stats_get (&stats);
+ * @endcode
+ */
+#include "ruuvi_driver_enabled_modules.h"
+#include "ruuvi_driver_error.h"
+#include "ruuvi_driver_sensor.h"
+#include "ruuvi_interface_communication_radio.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifndef RT_BATTERY_AVERAGE_WINDOW
+/**
+ * @brief Number of samples in running average.
+ *
+ * Average is exact mean until window is full, and then decays with
+ * weight 1 / window per sample.
+ */
+#   define RT_BATTERY_AVERAGE_WINDOW (32U)
+#endif
+
+/** @brief Battery voltage statistics since @ref rt_battery_init or @ref rt_battery_reset. */
+typedef struct
+{
+    float last_v;         //!< VDD right after latest radio activity, i.e. under load.
+    float min_v;          //!< Lowest VDD under load.
+    float average_v;      //!< Running average of VDD under load.
+    float droop_v;        //!< Resting VDD minus loaded VDD of latest radio activity.
+    float max_droop_v;    //!< Largest droop.
+    uint64_t timestamp_ms;//!< Time of latest sample, RD_UINT64_INVALID if none.
+    uint32_t samples;     //!< Number of radio activities sampled.
+    uint32_t skipped;     //!< Number of radio activities skipped as ADC was busy.
+} rt_battery_stats_t;
+
+/**
+ * @brief Start tracking battery voltage.
+ *
+ * @param[in] own_radio_callback True to install tracker as radio activity callback,
+ *                               false if events are forwarded to
+ *                               @ref rt_battery_radio_activity_handler by another owner.
+ * @retval RD_SUCCESS on success.
+ * @retval RD_ERROR_INVALID_STATE if tracker is already initialized, or if
+ *                                own_radio_callback is true and another radio activity
+ *                                callback is installed. Pass the callback to
+ *                                @ref rt_battery_radio_activity_chain and clear it instead.
+ */
+rd_status_t rt_battery_init (const bool own_radio_callback);
+
+/**
+ * @brief Stop tracking battery voltage.
+ *
+ * If tracker callback is still installed, chained handler is installed back.
+ * ADC is released if it was prepared for sampling.
+ */
+void rt_battery_uninit (void);
+
+/**
+ * @brief Check if tracker is initialized.
+ *
+ * @return True if tracker is running.
+ */
+bool rt_battery_is_init (void);
+
+/**
+ * @brief Clear statistics.
+ */
+void rt_battery_reset (void);
+
+/**
+ * @brief Set application radio activity callback called after tracker.
+ *
+ * @param[in] handler Application callback, NULL to remove.
+ */
+void rt_battery_radio_activity_chain (const ri_radio_activity_interrupt_fp_t handler);
+
+/**
+ * @brief Handle radio activity event.
+ *
+ * Installed as radio activity callback by @ref rt_battery_init, or called
+ * by another owner of the callback. Runs in interrupt context, only counts
+ * the event and queues sampling to scheduler.
+ *
+ * @param[in] evt Type of radio event.
+ */
+void rt_battery_radio_activity_handler (const ri_radio_activity_evt_t evt);
+
+/**
+ * @brief Get battery voltage statistics.
+ *
+ * Statistics are updated in scheduler, copy is consistent also in interrupt context.
+ *
+ * @param[out] p_stats Statistics.
+ * @retval RD_SUCCESS on success.
+ * @retval RD_ERROR_NULL if p_stats is NULL.
+ * @retval RD_ERROR_INVALID_STATE if tracker is not initialized.
+ * @retval RD_ERROR_BUSY if called from interrupt which preempted update, try again later.
+ */
+rd_status_t rt_battery_stats_get (rt_battery_stats_t * const p_stats);
+
+/**
+ * @brief @ref rd_sensor_init_fp for battery tracker.
+ *
+ * Sensor provides voltage_v. DSP RD_SENSOR_DSP_LAST returns voltage after latest
+ * radio activity, RD_SENSOR_DSP_LOW_PASS returns running average.
+ * Mode RD_SENSOR_CFG_SLEEP pauses tracking, RD_SENSOR_CFG_CONTINUOUS resumes it.
+ * Sample rate follows radio activity, resolution and scale are fixed.
+ *
+ * @param[out] p_sensor Sensor to initialize.
+ * @param[in] bus Unused, RD_BUS_NONE.
+ * @param[in] handle Unused.
+ * @retval RD_SUCCESS on success.
+ * @retval RD_ERROR_NULL if p_sensor is NULL.
+ * @retval RD_ERROR_INVALID_STATE if tracker is not initialized.
+ */
+rd_status_t rt_battery_sensor_init (rd_sensor_t * const p_sensor, const rd_bus_t bus,
+                                    const uint8_t handle);
+
+/**
+ * @brief @ref rd_sensor_init_fp for battery tracker.
+ *
+ * @param[out] p_sensor Sensor to uninitialize.
+ * @param[in] bus Unused, RD_BUS_NONE.
+ * @param[in] handle Unused.
+ * @retval RD_SUCCESS on success.
+ * @retval RD_ERROR_NULL if p_sensor is NULL.
+ */
+rd_status_t rt_battery_sensor_uninit (rd_sensor_t * const p_sensor, const rd_bus_t bus,
+                                      const uint8_t handle);
+
+/*@}*/
+#endif
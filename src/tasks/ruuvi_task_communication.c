@@ -7,6 +7,7 @@
 #include "ruuvi_task_communication.h"
 
 #include <stdio.h>
+#include <string.h>
 #include <inttypes.h>
 
 #define MAC_BYTES     (6U)  //!< Number of bytes in MAC address
@@ -99,4 +100,39 @@ rd_status_t rt_com_get_id_str (char * const id_str, const size_t id_len)
     return status;
 }
 
+rd_status_t rt_com_send_chunked (const ri_comm_xfer_fp_t send,
+                                 const char * const p_data, const size_t data_len,
+                                 size_t * const p_offset)
+{
+    rd_status_t status = RD_SUCCESS;
+
+    if ( (NULL == send) || (NULL == p_data) || (NULL == p_offset))
+    {
+        status |= RD_ERROR_NULL;
+    }
+
+    while ( (RD_SUCCESS == status) && (*p_offset < data_len))
+    {
+        ri_comm_message_t msg = { 0 };
+        size_t chunk = data_len - *p_offset;
+
+        if (chunk > RI_COMM_MESSAGE_MAX_LENGTH)
+        {
+            chunk = RI_COMM_MESSAGE_MAX_LENGTH;
+        }
+
+        memcpy (msg.data, p_data + *p_offset, chunk);
+        msg.data_length = (uint8_t) chunk;
+        msg.repeat_count = 1;
+        status |= send (&msg);
+
+        if (RD_SUCCESS == status)
+        {
+            *p_offset += chunk;
+        }
+    }
+
+    return status;
+}
+
 #endif
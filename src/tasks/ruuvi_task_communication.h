@@ -52,6 +52,24 @@ rd_status_t rt_com_get_mac_str (char * const mac_str, const size_t mac_len);
  */
 rd_status_t rt_com_get_id_str (char * const id_str, const size_t id_len);
 
+/**
+ * @brief Send data split into as many messages as needed.
+ *
+ * Each message carries at most @ref RI_COMM_MESSAGE_MAX_LENGTH bytes and is sent once.
+ * Sending stops at first error, offset tells where to resume.
+ *
+ * @param[in] send Send function of channel, e.g. @ref rt_gatt_send_asynchronous.
+ * @param[in] p_data Data to send.
+ * @param[in] data_len Length of data.
+ * @param[in,out] p_offset In: bytes already sent. Out: bytes sent after call.
+ * @retval RD_SUCCESS if all data was sent.
+ * @retval RD_ERROR_NULL if any pointer is NULL.
+ * @return Error from send function, e.g. RD_ERROR_NO_MEM if TX queue is full.
+ */
+rd_status_t rt_com_send_chunked (const ri_comm_xfer_fp_t send,
+                                 const char * const p_data, const size_t data_len,
+                                 size_t * const p_offset);
+
 /** @} */
 
 #endif
\ No newline at end of file
@@ -0,0 +1,300 @@
+/**
+ * @addtogroup energy_tasks
+ */
+/*@{*/
+/**
+ * @file ruuvi_task_energy.c
+ * @author Otso Jousimaa <otso@ojousima.net>
+ * @date 2026-10-18
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ *
+ * Each tracked instance has a slot with its current state and time of last change.
+ * Time is added to state totals on every change, so each total is written only from
+ * the context which drives that instance: radio from radio interrupt, others from main.
+ */
+#include "ruuvi_driver_enabled_modules.h"
+#if RT_ENERGY_ENABLED
+#include "ruuvi_driver_error.h"
+#include "ruuvi_driver_sensor.h"
+#include "ruuvi_interface_communication_radio.h"
+#include "ruuvi_interface_rtc.h"
+#include "ruuvi_interface_yield.h"
+#include "ruuvi_task_energy.h"
+#include <string.h>
+
+#define MS_PER_HOUR       (3600000.0F) //!< Milliseconds in hour.
+#define SLOT_CPU          (0U)         //!< Slot of MCU core.
+#define SLOT_RADIO        (1U)         //!< Slot of radio.
+#define SLOT_ADC          (2U)         //!< Slot of ADC.
+#define SLOT_SENSOR_FIRST (3U)         //!< First sensor slot.
+#define SLOT_COUNT        (SLOT_SENSOR_FIRST + RT_ENERGY_SENSOR_SLOTS) //!< Number of slots.
+
+/** @brief State of one tracked instance. */
+typedef struct
+{
+    const void * p_key;  //!< Identifier of sensor, NULL if sensor slot is free.
+    uint8_t subsystem;   //!< @ref rt_energy_subsystem_t of instance.
+    uint8_t state;       //!< @ref rt_energy_state_t of instance.
+    uint64_t since_ms;   //!< Time of last state change.
+} ledger_slot_t;
+
+static ledger_slot_t m_slots[SLOT_COUNT];
+static uint64_t m_state_ms[RT_ENERGY_SUBSYSTEM_COUNT][RT_ENERGY_STATE_COUNT];
+static uint64_t m_start_ms;
+static const rt_energy_profile_t * m_p_profile;
+static ri_yield_state_ind_fp_t m_yield_chain;
+static ri_radio_activity_interrupt_fp_t m_radio_chain;
+
+static void slot_state_set (ledger_slot_t * const p_slot, const uint8_t state)
+{
+    const uint64_t now = ri_rtc_millis();
+    m_state_ms[p_slot->subsystem][p_slot->state] += now - p_slot->since_ms;
+    p_slot->since_ms = now;
+    p_slot->state = state;
+}
+
+static void on_yield (const bool active)
+{
+    if (rt_energy_is_init())
+    {
+        slot_state_set (&m_slots[SLOT_CPU],
+                        active ? RT_ENERGY_STATE_ACTIVE : RT_ENERGY_STATE_SLEEP);
+    }
+
+    if (NULL != m_yield_chain)
+    {
+        m_yield_chain (active);
+    }
+}
+
+static void on_radio (const ri_radio_activity_evt_t evt)
+{
+    if (rt_energy_is_init())
+    {
+        slot_state_set (&m_slots[SLOT_RADIO],
+                        (RI_RADIO_BEFORE == evt) ? RT_ENERGY_STATE_ACTIVE : RT_ENERGY_STATE_SLEEP);
+    }
+
+    if (NULL != m_radio_chain)
+    {
+        m_radio_chain (evt);
+    }
+}
+
+static void slots_init (const uint64_t now)
+{
+    memset (m_slots, 0, sizeof (m_slots));
+    m_slots[SLOT_CPU].subsystem = RT_ENERGY_CPU;
+    m_slots[SLOT_CPU].state = RT_ENERGY_STATE_ACTIVE;
+    m_slots[SLOT_RADIO].subsystem = RT_ENERGY_RADIO;
+    m_slots[SLOT_ADC].subsystem = RT_ENERGY_ADC;
+
+    for (size_t ii = 0; ii < SLOT_COUNT; ii++)
+    {
+        m_slots[ii].since_ms = now;
+    }
+
+    for (size_t ii = SLOT_SENSOR_FIRST; ii < SLOT_COUNT; ii++)
+    {
+        m_slots[ii].subsystem = RT_ENERGY_SENSORS;
+    }
+}
+
+rd_status_t rt_energy_init (const rt_energy_profile_t * const p_profile)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if (NULL == p_profile)
+    {
+        err_code |= RD_ERROR_NULL;
+    }
+    else if (rt_energy_is_init() || (NULL != ri_radio_activity_callback_get()))
+    {
+        // Interface would ignore ledger callback.
+        err_code |= RD_ERROR_INVALID_STATE;
+    }
+    else
+    {
+        const uint64_t now = ri_rtc_millis();
+        memset (m_state_ms, 0, sizeof (m_state_ms));
+        slots_init (now);
+        m_start_ms = now;
+        m_p_profile = p_profile;
+        ri_yield_indication_set (&on_yield);
+        ri_radio_activity_callback_set (&on_radio);
+    }
+
+    return err_code;
+}
+
+void rt_energy_uninit (void)
+{
+    if (rt_energy_is_init())
+    {
+        ri_yield_indication_set (m_yield_chain);
+
+        if (&on_radio == ri_radio_activity_callback_get())
+        {
+            // Interface keeps existing callback, clear it before restoring chain.
+            ri_radio_activity_callback_set (NULL);
+            ri_radio_activity_callback_set (m_radio_chain);
+        }
+    }
+
+    m_p_profile = NULL;
+    m_yield_chain = NULL;
+    m_radio_chain = NULL;
+}
+
+bool rt_energy_is_init (void)
+{
+    return (NULL != m_p_profile);
+}
+
+void rt_energy_reset (void)
+{
+    const uint64_t now = ri_rtc_millis();
+    memset (m_state_ms, 0, sizeof (m_state_ms));
+
+    for (size_t ii = 0; ii < SLOT_COUNT; ii++)
+    {
+        m_slots[ii].since_ms = now;
+    }
+
+    m_start_ms = now;
+}
+
+void rt_energy_yield_indication_chain (const ri_yield_state_ind_fp_t indication)
+{
+    m_yield_chain = indication;
+}
+
+void rt_energy_radio_activity_chain (const ri_radio_activity_interrupt_fp_t handler)
+{
+    m_radio_chain = handler;
+}
+
+rd_status_t rt_energy_state_set (const rt_energy_subsystem_t subsystem,
+                                 const rt_energy_state_t state)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if (!rt_energy_is_init())
+    {
+        err_code |= RD_ERROR_INVALID_STATE;
+    }
+    else if ( (RT_ENERGY_STATE_COUNT <= state)
+              || (RT_ENERGY_SENSORS == subsystem)
+              || (RT_ENERGY_SUBSYSTEM_COUNT <= subsystem))
+    {
+        err_code |= RD_ERROR_INVALID_PARAM;
+    }
+    else
+    {
+        for (size_t ii = 0; ii < SLOT_SENSOR_FIRST; ii++)
+        {
+            if (subsystem == m_slots[ii].subsystem)
+            {
+                slot_state_set (&m_slots[ii], state);
+            }
+        }
+    }
+
+    return err_code;
+}
+
+void rt_energy_sensor_mode_set (const void * const p_sensor, const uint8_t mode)
+{
+    ledger_slot_t * p_slot = NULL;
+    ledger_slot_t * p_free = NULL;
+
+    if (rt_energy_is_init() && (NULL != p_sensor))
+    {
+        for (size_t ii = SLOT_SENSOR_FIRST; (ii < SLOT_COUNT) && (NULL == p_slot); ii++)
+        {
+            if (p_sensor == m_slots[ii].p_key)
+            {
+                p_slot = &m_slots[ii];
+            }
+            else if ( (NULL == m_slots[ii].p_key) && (NULL == p_free))
+            {
+                p_free = &m_slots[ii];
+            }
+            else
+            {
+                // Slot of another sensor.
+            }
+        }
+
+        if ( (NULL == p_slot) && (NULL != p_free))
+        {
+            p_slot = p_free;
+            p_slot->p_key = p_sensor;
+            p_slot->state = RT_ENERGY_STATE_SLEEP;
+            p_slot->since_ms = ri_rtc_millis();
+        }
+
+        if (NULL != p_slot)
+        {
+            slot_state_set (p_slot, (RD_SENSOR_CFG_CONTINUOUS == mode) ?
+                            RT_ENERGY_STATE_ACTIVE : RT_ENERGY_STATE_SLEEP);
+        }
+    }
+}
+
+rd_status_t rt_energy_report_get (rt_energy_report_t * const p_report)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if (NULL == p_report)
+    {
+        err_code |= RD_ERROR_NULL;
+    }
+    else if (!rt_energy_is_init())
+    {
+        err_code |= RD_ERROR_INVALID_STATE;
+    }
+    else
+    {
+        const uint64_t now = ri_rtc_millis();
+        memset (p_report, 0, sizeof (rt_energy_report_t));
+        memcpy (p_report->state_ms, m_state_ms, sizeof (m_state_ms));
+
+        // Add time since last change of each instance.
+        for (size_t ii = 0; ii < SLOT_COUNT; ii++)
+        {
+            const ledger_slot_t * const p_slot = &m_slots[ii];
+
+            if ( ( (ii < SLOT_SENSOR_FIRST) || (NULL != p_slot->p_key))
+                    && (now > p_slot->since_ms))
+            {
+                p_report->state_ms[p_slot->subsystem][p_slot->state] += now - p_slot->since_ms;
+            }
+        }
+
+        for (size_t sub = 0; sub < RT_ENERGY_SUBSYSTEM_COUNT; sub++)
+        {
+            for (size_t state = 0; state < RT_ENERGY_STATE_COUNT; state++)
+            {
+                p_report->subsystem_uah[sub] += ( (float) p_report->state_ms[sub][state])
+                                                * m_p_profile->current_ua[sub][state]
+                                                / MS_PER_HOUR;
+            }
+
+            p_report->total_uah += p_report->subsystem_uah[sub];
+        }
+
+        p_report->elapsed_ms = now - m_start_ms;
+
+        if (0U < p_report->elapsed_ms)
+        {
+            p_report->uah_per_hour = p_report->total_uah * MS_PER_HOUR
+                                     / (float) p_report->elapsed_ms;
+        }
+    }
+
+    return err_code;
+}
+
+/*@}*/
+#endif
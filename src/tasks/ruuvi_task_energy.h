@@ -0,0 +1,185 @@
+#ifndef RUUVI_TASK_ENERGY_H
+#define RUUVI_TASK_ENERGY_H
+/**
+ * @addtogroup peripheral_tasks
+ */
+/*@{*/
+/**
+ * @defgroup energy_tasks Energy tasks
+ * @brief Estimate energy consumption per subsystem.
+ *
+ */
+/*@}*/
+/**
+ * @addtogroup energy_tasks
+ */
+/*@{*/
+/**
+ * @file ruuvi_task_energy.h
+ * @author Otso Jousimaa <otso@ojousima.net>
+ * @date 2026-10-18
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ *
+ * @brief Energy ledger which integrates time spent in each state per subsystem.
+ *
+ * CPU state is tracked through yield indication, radio through radio activity
+ * callback, sensors through @ref rt_sensor_configure and ADC through
+ * @ref rt_adc_init and @ref rt_adc_uninit. Time is taken from @ref ri_rtc_millis,
+ * so host simulation only needs to provide a clock. Accounting has RTC resolution,
+ * short radio events are rounded but average out over many events.
+ *
+ * Typical usage:
+ *
+ * @code{.c}
+ *  static const rt_energy_profile_t profile =
+ *  {
+ *      .current_ua =
+ *      {
+ *          [RT_ENERGY_CPU]     = { [RT_ENERGY_STATE_SLEEP] = 2.0F, [RT_ENERGY_STATE_ACTIVE] = 3300.0F },
+ *          [RT_ENERGY_RADIO]   = { [RT_ENERGY_STATE_SLEEP] = 0.0F, [RT_ENERGY_STATE_ACTIVE] = 5300.0F },
+ *          [RT_ENERGY_SENSORS] = { [RT_ENERGY_STATE_SLEEP] = 0.5F, [RT_ENERGY_STATE_ACTIVE] = 4.0F },
+ *          [RT_ENERGY_ADC]     = { [RT_ENERGY_STATE_SLEEP] = 0.0F, [RT_ENERGY_STATE_ACTIVE] = 700.0F }
+ *      }
+ *  };
+ *  rt_energy_report_t report;
+ *  err_code |= rt_energy_init (&profile);
+ *  // LED task uses yield indication too, let ledger forward the indication.
+ *  rt_energy_yield_indication_chain (&rt_led_activity_indicate);
+ *  // ... Later.
+ *  err_code |= rt_energy_report_get (&report);
+ * @endcode
+ */
+#include "ruuvi_driver_enabled_modules.h"
+#include "ruuvi_driver_error.h"
+#include "ruuvi_interface_communication_radio.h"
+#include "ruuvi_interface_yield.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifndef RT_ENERGY_SENSOR_SLOTS
+/** @brief Number of sensors tracked separately. */
+#   define RT_ENERGY_SENSOR_SLOTS (4U)
+#endif
+
+/** @brief Subsystems accounted in ledger. */
+typedef enum
+{
+    RT_ENERGY_CPU = 0,        //!< MCU core.
+    RT_ENERGY_RADIO,          //!< Radio TX and RX.
+    RT_ENERGY_SENSORS,        //!< Sum of all sensors, current is per sensor.
+    RT_ENERGY_ADC,            //!< MCU ADC.
+    RT_ENERGY_SUBSYSTEM_COUNT //!< Number of subsystems.
+} rt_energy_subsystem_t;
+
+/** @brief States of subsystems. */
+typedef enum
+{
+    RT_ENERGY_STATE_SLEEP = 0, //!< CPU sleeping, radio off, sensor sleeping, ADC off.
+    RT_ENERGY_STATE_ACTIVE,    //!< CPU running, radio on, sensor continuous, ADC on.
+    RT_ENERGY_STATE_COUNT      //!< Number of states.
+} rt_energy_state_t;
+
+/** @brief Current consumption of subsystems in each state. */
+typedef struct
+{
+    float current_ua[RT_ENERGY_SUBSYSTEM_COUNT][RT_ENERGY_STATE_COUNT]; //!< Microamperes.
+} rt_energy_profile_t;
+
+/** @brief Estimated consumption since @ref rt_energy_init or @ref rt_energy_reset. */
+typedef struct
+{
+    uint64_t elapsed_ms;  //!< Time accounted.
+    uint64_t state_ms[RT_ENERGY_SUBSYSTEM_COUNT][RT_ENERGY_STATE_COUNT]; //!< Time in state, summed over sensors.
+    float subsystem_uah[RT_ENERGY_SUBSYSTEM_COUNT]; //!< Charge used per subsystem.
+    float total_uah;      //!< Charge used by all subsystems.
+    float uah_per_hour;   //!< Average consumption, equal to average current in uA.
+} rt_energy_report_t;
+
+/**
+ * @brief Start ledger.
+ *
+ * Installs ledger as yield indication and radio activity callback.
+ * CPU is assumed active, radio, sensors and ADC are assumed sleeping.
+ *
+ * @param[in] p_profile Current consumption of subsystems, must remain valid.
+ * @retval RD_SUCCESS on success.
+ * @retval RD_ERROR_NULL if p_profile is NULL.
+ * @retval RD_ERROR_INVALID_STATE if ledger is already initialized or another radio
+ *                                activity callback is installed. Pass the callback to
+ *                                @ref rt_energy_radio_activity_chain and clear it instead.
+ */
+rd_status_t rt_energy_init (const rt_energy_profile_t * const p_profile);
+
+/**
+ * @brief Stop ledger and remove its callbacks.
+ *
+ * Chained callbacks are installed back to their interfaces. Radio activity
+ * callback is left as is if it has been replaced after init.
+ */
+void rt_energy_uninit (void);
+
+/**
+ * @brief Check if ledger is initialized.
+ *
+ * @return True if ledger is running.
+ */
+bool rt_energy_is_init (void);
+
+/**
+ * @brief Clear accumulated time, keep current states.
+ */
+void rt_energy_reset (void);
+
+/**
+ * @brief Set application yield indication called after ledger has been updated.
+ *
+ * @param[in] indication Application indication, NULL to remove.
+ */
+void rt_energy_yield_indication_chain (const ri_yield_state_ind_fp_t indication);
+
+/**
+ * @brief Set application radio activity callback called after ledger has been updated.
+ *
+ * @param[in] handler Application callback, NULL to remove.
+ */
+void rt_energy_radio_activity_chain (const ri_radio_activity_interrupt_fp_t handler);
+
+/**
+ * @brief Record new state of a single-instance subsystem.
+ *
+ * Used by hooks, can be used by application to account subsystems driven manually,
+ * e.g. in host simulation.
+ *
+ * @param[in] subsystem RT_ENERGY_CPU, RT_ENERGY_RADIO or RT_ENERGY_ADC.
+ * @param[in] state New state.
+ * @retval RD_SUCCESS on success.
+ * @retval RD_ERROR_INVALID_PARAM if subsystem is sensors or state is unknown.
+ * @retval RD_ERROR_INVALID_STATE if ledger is not initialized.
+ */
+rd_status_t rt_energy_state_set (const rt_energy_subsystem_t subsystem,
+                                 const rt_energy_state_t state);
+
+/**
+ * @brief Record new mode of a sensor.
+ *
+ * Continuous mode is accounted as active. Single mode is accounted as sleep,
+ * as sensor returns to sleep after measurement.
+ * Sensors beyond @ref RT_ENERGY_SENSOR_SLOTS are not accounted.
+ *
+ * @param[in] p_sensor Any pointer identifying sensor, e.g. its @ref rt_sensor_ctx_t.
+ * @param[in] mode RD_SENSOR_CFG_SLEEP, RD_SENSOR_CFG_SINGLE or RD_SENSOR_CFG_CONTINUOUS.
+ */
+void rt_energy_sensor_mode_set (const void * const p_sensor, const uint8_t mode);
+
+/**
+ * @brief Get estimated consumption.
+ *
+ * @param[out] p_report Accumulated time and charge.
+ * @retval RD_SUCCESS on success.
+ * @retval RD_ERROR_NULL if p_report is NULL.
+ * @retval RD_ERROR_INVALID_STATE if ledger is not initialized.
+ */
+rd_status_t rt_energy_report_get (rt_energy_report_t * const p_report);
+
+/*@}*/
+#endif
@@ -26,6 +26,7 @@
 #include "ruuvi_interface_flash.h"
 #include "ruuvi_interface_log.h"
 #include "ruuvi_interface_power.h"
+#include "ruuvi_interface_profile.h"
 #include "ruuvi_interface_yield.h"
 #include "ruuvi_task_flash.h"
 
@@ -38,6 +39,10 @@
 #define TASK_FLASH_LOG_LEVEL RI_LOG_LEVEL_INFO
 #endif
 
+#ifndef TASK_FLASH_LOG_COMPILE_LEVEL
+#define TASK_FLASH_LOG_COMPILE_LEVEL RI_LOG_COMPILE_LEVEL
+#endif
+
 #ifndef RT_FLASH_ERROR_FILE
 #  define RT_FLASH_ERROR_FILE 0xBFFE
 #endif
@@ -46,10 +51,14 @@
 #  define RT_FLASH_ERROR_RECORD 0xBFFE
 #endif
 
-#define LOG(msg) ri_log(TASK_FLASH_LOG_LEVEL, msg)
-#define LOGD(msg) ri_log(RI_LOG_DEBUG, msg)
-#define LOGW(msg) ri_log(RI_LOG_WARNING, msg)
-#define LOGHEX(msg, len) ri_log_hex(TASK_FLASH_LOG_LEVEL, msg, len)
+#define LOG(msg) RI_LOG_MODULE(RI_LOG_MODULE_FLASH, TASK_FLASH_LOG_COMPILE_LEVEL, \
+                               TASK_FLASH_LOG_LEVEL, msg)
+#define LOGD(msg) RI_LOG_MODULE(RI_LOG_MODULE_FLASH, TASK_FLASH_LOG_COMPILE_LEVEL, \
+                                RI_LOG_LEVEL_DEBUG, msg)
+#define LOGW(msg) RI_LOG_MODULE(RI_LOG_MODULE_FLASH, TASK_FLASH_LOG_COMPILE_LEVEL, \
+                                RI_LOG_LEVEL_WARNING, msg)
+#define LOGHEX(msg, len) RI_LOG_MODULE_HEX(RI_LOG_MODULE_FLASH, \
+        TASK_FLASH_LOG_COMPILE_LEVEL, TASK_FLASH_LOG_LEVEL, msg, len)
 
 typedef struct
 {
@@ -58,6 +67,8 @@ typedef struct
     int line;
 } rt_flash_error_cause_t;
 
+RI_PROFILE_ZONE_DEF (m_zone_store, "flash store");
+
 #if 0
 static void on_error (const rd_status_t err,
                       const bool fatal,
@@ -144,6 +155,7 @@ rd_status_t rt_flash_store (const uint16_t page_id, const uint16_t record_id,
                             const void * const message, const size_t message_length)
 {
     rd_status_t status = RD_SUCCESS;
+    RI_PROFILE_ENTER (m_zone_store);
     status = ri_flash_record_set (page_id, record_id, message_length, message);
 
     if (RD_ERROR_NO_MEM == status)
@@ -158,6 +170,7 @@ rd_status_t rt_flash_store (const uint16_t page_id, const uint16_t record_id,
         status = ri_flash_record_set (page_id, record_id, message_length, message);
     }
 
+    RI_PROFILE_EXIT (m_zone_store);
     return status;
 }
 
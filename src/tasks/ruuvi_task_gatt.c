@@ -27,15 +27,21 @@
 #define TASK_GATT_LOG_LEVEL RI_LOG_LEVEL_INFO
 #endif
 
-static inline void LOGD (const char * const msg)
-{
-    ri_log (RI_LOG_LEVEL_DEBUG, msg);
-}
+#ifndef TASK_GATT_LOG_COMPILE_LEVEL
+#define TASK_GATT_LOG_COMPILE_LEVEL RI_LOG_COMPILE_LEVEL
+#endif
 
-static inline void LOGDHEX (const uint8_t * const msg, const size_t len)
-{
-    ri_log_hex (RI_LOG_LEVEL_DEBUG, msg, len);
-}
+/**
+ * @brief Compiler barrier between writing a queue slot and publishing it.
+ *
+ * Queue is shared with interrupts on the same core, so compiler ordering is enough.
+ */
+#define TX_QUEUE_BARRIER() __asm__ volatile ("" ::: "memory")
+
+#define LOGD(msg) RI_LOG_MODULE(RI_LOG_MODULE_GATT, TASK_GATT_LOG_COMPILE_LEVEL, \
+                                RI_LOG_LEVEL_DEBUG, msg)
+#define LOGDHEX(msg, len) RI_LOG_MODULE_HEX(RI_LOG_MODULE_GATT, \
+        TASK_GATT_LOG_COMPILE_LEVEL, RI_LOG_LEVEL_DEBUG, msg, len)
 
 static ri_comm_channel_t m_channel;   //!< API for sending data.
 static bool m_is_init;
@@ -49,6 +55,32 @@ static ri_comm_cb_t m_on_connected;    //!< Callback for connection established
 static ri_comm_cb_t m_on_disconnected; //!< Callback for connection lost
 static ri_comm_cb_t m_on_received;     //!< Callback for data received
 static ri_comm_cb_t m_on_sent;         //!< Callback for data sent
+static rt_gatt_tx_backpressure_cb_t m_on_backpressure; //!< Callback for TX queue watermarks
+static ri_gatt_bulk_done_fp m_on_bulk_done; //!< Callback of ongoing bulk transfer
+
+static ri_comm_message_t m_tx_queue[RT_GATT_TX_QUEUE_LENGTH]; //!< Messages waiting for softdevice
+static volatile uint32_t m_tx_head;  //!< Messages taken from queue, written only by drain.
+static volatile uint32_t m_tx_tail;  //!< Messages put to queue, written only by producer.
+static ri_atomic_t m_tx_lock;        //!< Held while queue is drained.
+static volatile bool m_tx_pending;   //!< Drain requested while lock was held.
+static volatile bool m_tx_flush;     //!< Drop queued messages on next drain.
+static bool m_tx_throttled;          //!< Producer has been asked to throttle.
+static bool m_tx_stalled;            //!< Softdevice TX queue is full.
+static uint64_t m_tx_stall_start;    //!< Time of stall start.
+static rt_gatt_tx_stats_t m_tx_stats;
+
+static bool m_autotune_enabled;
+static rt_gatt_autotune_config_t m_autotune;
+static rt_gatt_autotune_stats_t m_autotune_stats;
+static volatile uint32_t m_rx_count;   //!< Received messages, written only in ISR.
+static uint32_t m_rx_seen;             //!< Received messages evaluated by auto-tuning.
+static uint32_t m_tx_seen;             //!< Queued messages evaluated by auto-tuning.
+static bool m_profile_active;          //!< Connected, time is accounted to profile.
+static uint64_t m_profile_start_ms;    //!< Start of unaccounted time in profile.
+static uint64_t m_last_activity_ms;    //!< Last time traffic was seen.
+static uint64_t m_last_switch_ms;      //!< Last parameter update request.
+static bool m_has_switched;            //!< Parameters were updated on this connection.
+static uint64_t m_connected_ms;        //!< Time of NUS connection.
 
 // https://github.com/arm-embedded/gcc-arm-none-eabi.debian/blob/master/src/libiberty/strnlen.c
 // Not included when compiled with std=c99.
@@ -68,6 +100,8 @@ void rt_gatt_mock_state_reset()
     m_on_disconnected = NULL;
     m_on_received = NULL;
     m_on_sent = NULL;
+    m_on_backpressure = NULL;
+    m_on_bulk_done = NULL;
     m_is_init = false;
     m_nus_is_init = false;
     m_dfu_is_init = false;
@@ -75,9 +109,148 @@ void rt_gatt_mock_state_reset()
     m_nus_is_connected = false;
     memset (&m_channel, 0, sizeof (ri_comm_channel_t));
     memset (m_name, 0, sizeof (m_name));
+    m_tx_head = 0;
+    m_tx_tail = 0;
+    m_tx_lock = 0;
+    m_tx_pending = false;
+    m_tx_flush = false;
+    m_tx_throttled = false;
+    m_tx_stalled = false;
+    memset (&m_tx_stats, 0, sizeof (m_tx_stats));
+    m_autotune_enabled = false;
+    memset (&m_autotune, 0, sizeof (m_autotune));
+    memset (&m_autotune_stats, 0, sizeof (m_autotune_stats));
+    m_rx_count = 0;
+    m_rx_seen = 0;
+    m_tx_seen = 0;
+    m_profile_active = false;
+    m_has_switched = false;
 }
 #endif
 
+/** @brief Add time since last accounting to current profile. */
+static void profile_account (const uint64_t now)
+{
+    if (m_autotune_enabled && m_profile_active)
+    {
+        m_autotune_stats.time_ms[m_autotune_stats.profile] += now - m_profile_start_ms;
+        m_profile_start_ms = now;
+    }
+}
+
+static inline uint32_t tx_depth (void)
+{
+    return m_tx_tail - m_tx_head;
+}
+
+static void tx_backpressure_update (void)
+{
+    const uint32_t depth = tx_depth();
+
+    if ( (!m_tx_throttled) && (RT_GATT_TX_HIGH_WATER <= depth))
+    {
+        m_tx_throttled = true;
+        (NULL != m_on_backpressure) ? m_on_backpressure (true) : false;
+    }
+    else if (m_tx_throttled && (RT_GATT_TX_LOW_WATER >= depth))
+    {
+        m_tx_throttled = false;
+        (NULL != m_on_backpressure) ? m_on_backpressure (false) : false;
+    }
+    else
+    {
+        // No change.
+    }
+}
+
+static void tx_stall_end (void)
+{
+    if (m_tx_stalled)
+    {
+        m_tx_stats.stall_ms += ri_rtc_millis() - m_tx_stall_start;
+        m_tx_stalled = false;
+    }
+}
+
+/**
+ * @brief Send queued messages until softdevice TX queue is full.
+ *
+ * Must be called with m_tx_lock held.
+ *
+ * @return Error codes of messages rejected by stack, other than full TX queue.
+ */
+static rd_status_t tx_queue_send (void)
+{
+    rd_status_t err_code = RD_SUCCESS;
+    bool stack_full = false;
+
+    if (m_tx_flush)
+    {
+        m_tx_flush = false;
+        m_tx_stats.dropped += tx_depth();
+        m_tx_head = m_tx_tail;
+        tx_stall_end();
+    }
+
+    while ( (0U < tx_depth()) && (!stack_full))
+    {
+        ri_comm_message_t * const p_msg = &m_tx_queue[m_tx_head % RT_GATT_TX_QUEUE_LENGTH];
+        const rd_status_t send_status = m_channel.send (p_msg);
+
+        if (RD_SUCCESS == send_status)
+        {
+            LOGD (">>>;");
+            LOGDHEX (p_msg->data, p_msg->data_length);
+            LOGD (";\r\n");
+            tx_stall_end();
+            m_tx_head++;
+        }
+        // Softdevice buffers are full or bulk transfer is ongoing, retry on next TX event.
+        else if ( (RD_ERROR_RESOURCES == send_status) || (RD_ERROR_BUSY == send_status))
+        {
+            if (!m_tx_stalled)
+            {
+                m_tx_stalled = true;
+                m_tx_stall_start = ri_rtc_millis();
+                m_tx_stats.stalls++;
+            }
+
+            stack_full = true;
+        }
+        // Message cannot be sent, drop it so that it doesn't block the queue.
+        else
+        {
+            err_code |= send_status;
+            m_tx_stats.dropped++;
+            m_tx_head++;
+        }
+    }
+
+    tx_backpressure_update();
+    return err_code;
+}
+
+/**
+ * @brief Drain TX queue from thread or interrupt context.
+ *
+ * If the queue is being drained by interrupted context, request is left
+ * pending and the lock holder drains the queue again before returning.
+ */
+static rd_status_t tx_drain (void)
+{
+    rd_status_t err_code = RD_SUCCESS;
+    m_tx_pending = true;
+
+    while (m_tx_pending && ri_atomic_flag (&m_tx_lock, true))
+    {
+        m_tx_pending = false;
+        err_code |= tx_queue_send();
+        (void) ri_atomic_flag (&m_tx_lock, false);
+    }
+
+    return err_code;
+}
+
 /**
  * @brief Event handler for NUS events
  *
@@ -107,19 +280,32 @@ rd_status_t rt_gatt_on_nus_isr (ri_comm_evt_t evt,
         // Note: This gets called only after the NUS notifications have been registered.
         case RI_COMM_CONNECTED:
             m_nus_is_connected = true;
+            // Connection starts with preferred parameters.
+            m_autotune_stats.profile = RI_GATT_STANDARD;
+            m_connected_ms = ri_rtc_millis();
+            m_profile_start_ms = m_connected_ms;
+            m_last_activity_ms = m_connected_ms;
+            m_profile_active = true;
+            m_has_switched = false;
             (NULL != m_on_connected) ? m_on_connected (p_data, data_len) : false;
             break;
 
         case RI_COMM_DISCONNECTED:
             m_nus_is_connected = false;
+            profile_account (ri_rtc_millis());
+            m_profile_active = false;
+            m_tx_flush = true;
+            (void) tx_drain();
             (NULL != m_on_disconnected) ? m_on_disconnected (p_data, data_len) : false;
             break;
 
         case RI_COMM_SENT:
+            (void) tx_drain();
             (NULL != m_on_sent) ? m_on_sent (p_data, data_len) : false;
             break;
 
         case RI_COMM_RECEIVED:
+            m_rx_count++;
             LOGD ("<<<;");
             LOGDHEX (p_data, data_len);
             LOGD (";\r\n");
@@ -210,6 +396,7 @@ rd_status_t rt_gatt_init (const char * const name)
             err_code |= ri_gatt_init();
             memcpy (m_name, name, name_length);
             m_name[name_length] = '\0';
+            memset (&m_tx_stats, 0, sizeof (m_tx_stats));
         }
         else
         {
@@ -245,6 +432,8 @@ rd_status_t rt_gatt_uninit (void)
         rt_gatt_set_on_sent_isr (NULL);
         rt_gatt_set_on_connected_isr (NULL);
         rt_gatt_set_on_disconn_isr (NULL);
+        rt_gatt_set_on_tx_backpressure_isr (NULL);
+        rt_gatt_autotune_stop();
         err_code |= ri_radio_uninit();
         err_code |= ri_gatt_uninit();
         memset (&m_channel, 0, sizeof (m_channel));
@@ -253,6 +442,9 @@ rd_status_t rt_gatt_uninit (void)
         m_dis_is_init = false;
         m_nus_is_init = false;
         m_dfu_is_init = false;
+        m_tx_head = m_tx_tail;
+        m_tx_throttled = false;
+        m_tx_stalled = false;
     }
 
     return err_code;
@@ -319,26 +511,68 @@ rd_status_t rt_gatt_send_asynchronous (ri_comm_message_t
     {
         err_code |= RD_ERROR_INVALID_STATE;
     }
+    else if (RT_GATT_TX_QUEUE_LENGTH <= tx_depth())
+    {
+        err_code |= RD_ERROR_NO_MEM;
+    }
     else
     {
-        // Try to put data to SD
-        err_code |= m_channel.send (p_msg);
-
-        // If success, return. Else put data to ringbuffer
-        if (RD_SUCCESS == err_code)
-        {
-            LOGD (">>>;");
-            LOGDHEX (p_msg->data, p_msg->data_length);
-            LOGD (";\r\n");
-        }
-        else if (RD_ERROR_RESOURCES == err_code)
+        // Queue keeps order of messages, drain sends it to SD as far as SD has room.
+        m_tx_queue[m_tx_tail % RT_GATT_TX_QUEUE_LENGTH] = *p_msg;
+        // Drain in interrupt must not see new tail before the message.
+        TX_QUEUE_BARRIER();
+        m_tx_tail++;
+        m_tx_stats.queued++;
+
+        if (tx_depth() > m_tx_stats.depth_max)
         {
-            err_code = RD_ERROR_NO_MEM;
+            m_tx_stats.depth_max = (uint16_t) tx_depth();
         }
+
+        err_code |= tx_drain();
         // If the error code is something else than buffer full, return error.
-        else
+        RD_ERROR_CHECK (err_code, ~RD_ERROR_FATAL);
+    }
+
+    return err_code;
+}
+
+/** @brief Resume queue held back by bulk transfer, then report to application. */
+static void bulk_done (const rd_status_t result, const size_t sent)
+{
+    const ri_gatt_bulk_done_fp on_done = m_on_bulk_done;
+    m_on_bulk_done = NULL;
+    // Queue was stalled with RD_ERROR_BUSY, no TX event may follow the last chunk.
+    (void) tx_drain();
+
+    if (NULL != on_done)
+    {
+        on_done (result, sent);
+    }
+}
+
+rd_status_t rt_gatt_bulk_send (const ri_comm_segment_t * const p_segments,
+                               const size_t segment_count,
+                               const ri_gatt_bulk_done_fp on_done)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if (!rt_gatt_nus_is_connected())
+    {
+        err_code |= RD_ERROR_INVALID_STATE;
+    }
+    else if (ri_gatt_nus_bulk_is_active())
+    {
+        err_code |= RD_ERROR_BUSY;
+    }
+    else
+    {
+        m_on_bulk_done = on_done;
+        err_code |= ri_gatt_nus_bulk_send (p_segments, segment_count, &bulk_done);
+
+        if (RD_SUCCESS != err_code)
         {
-            RD_ERROR_CHECK (err_code, ~RD_ERROR_FATAL);
+            m_on_bulk_done = NULL;
         }
     }
 
@@ -366,6 +600,220 @@ void rt_gatt_set_on_sent_isr (const ri_comm_cb_t cb)
     m_on_sent = cb;
 }
 
+void rt_gatt_set_on_tx_backpressure_isr (const rt_gatt_tx_backpressure_cb_t cb)
+{
+    m_on_backpressure = cb;
+}
+
+rd_status_t rt_gatt_tx_stats_get (rt_gatt_tx_stats_t * const p_stats)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if (NULL == p_stats)
+    {
+        err_code |= RD_ERROR_NULL;
+    }
+    else
+    {
+        *p_stats = m_tx_stats;
+        p_stats->depth = (uint16_t) tx_depth();
+
+        if (m_tx_stalled)
+        {
+            p_stats->stall_ms += ri_rtc_millis() - m_tx_stall_start;
+        }
+    }
+
+    return err_code;
+}
+
+rd_status_t rt_gatt_autotune_start (const rt_gatt_autotune_config_t * const p_config)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if (NULL == p_config)
+    {
+        err_code |= RD_ERROR_NULL;
+    }
+    else if (p_config->low_power_idle_ms < p_config->standard_idle_ms)
+    {
+        err_code |= RD_ERROR_INVALID_PARAM;
+    }
+    else if (!rt_gatt_is_init())
+    {
+        err_code |= RD_ERROR_INVALID_STATE;
+    }
+    else
+    {
+        const uint64_t now = ri_rtc_millis();
+        const ri_gatt_params_t profile = m_profile_active ?
+                                         m_autotune_stats.profile : RI_GATT_STANDARD;
+        m_autotune = *p_config;
+        memset (&m_autotune_stats, 0, sizeof (m_autotune_stats));
+        m_autotune_stats.profile = profile;
+        m_profile_start_ms = now;
+        m_last_activity_ms = now;
+        m_rx_seen = m_rx_count;
+        m_tx_seen = m_tx_stats.queued;
+        m_autotune_enabled = true;
+    }
+
+    return err_code;
+}
+
+void rt_gatt_autotune_stop (void)
+{
+    if (m_autotune_enabled)
+    {
+        profile_account (ri_rtc_millis());
+        m_autotune_enabled = false;
+    }
+}
+
+/** @brief Select profile for current traffic. */
+static ri_gatt_params_t autotune_target (const uint64_t now, const uint32_t rx, const uint32_t tx)
+{
+    const ri_gatt_params_t current = m_autotune_stats.profile;
+    ri_gatt_params_t target = current;
+    const bool tx_busy = (0U != m_autotune.turbo_tx_depth)
+                         && (m_autotune.turbo_tx_depth <= tx_depth());
+    const bool rx_busy = (0U != m_autotune.turbo_rx_messages)
+                         && (m_autotune.turbo_rx_messages <= rx);
+
+    if ( (0U != rx) || (0U != tx) || (0U != tx_depth()))
+    {
+        m_last_activity_ms = now;
+    }
+
+    const uint64_t idle_ms = now - m_last_activity_ms;
+
+    if (tx_busy || rx_busy)
+    {
+        target = RI_GATT_TURBO;
+    }
+    else if (idle_ms >= m_autotune.low_power_idle_ms)
+    {
+        target = RI_GATT_LOW_POWER;
+    }
+    else if (idle_ms >= m_autotune.standard_idle_ms)
+    {
+        target = RI_GATT_STANDARD;
+    }
+    // Traffic on low power link, speed up to standard.
+    else if (RI_GATT_LOW_POWER == current)
+    {
+        target = RI_GATT_STANDARD;
+    }
+    else
+    {
+        // Recent traffic, keep current profile.
+    }
+
+    return target;
+}
+
+rd_status_t rt_gatt_autotune_process (void)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if (m_autotune_enabled && rt_gatt_nus_is_connected())
+    {
+        const uint64_t now = ri_rtc_millis();
+        const uint32_t rx_count = m_rx_count;
+        const uint32_t tx_count = m_tx_stats.queued;
+        const ri_gatt_params_t target = autotune_target (now, rx_count - m_rx_seen,
+                                        tx_count - m_tx_seen);
+        m_rx_seen = rx_count;
+        m_tx_seen = tx_count;
+
+        if (target == m_autotune_stats.profile)
+        {
+            // No change needed.
+        }
+        // Rate limit updates, softdevice renegotiation takes several connection events.
+        else if (m_has_switched
+                 && ( (now - m_last_switch_ms) < m_autotune.min_switch_interval_ms))
+        {
+            m_autotune_stats.deferred++;
+        }
+        else
+        {
+            err_code |= ri_gatt_params_request (target, 0);
+
+            if (RD_SUCCESS == err_code)
+            {
+                profile_account (now);
+                m_autotune_stats.profile = target;
+                m_autotune_stats.switches++;
+                m_last_switch_ms = now;
+                m_has_switched = true;
+            }
+        }
+    }
+
+    return err_code;
+}
+
+rd_status_t rt_gatt_autotune_stats_get (rt_gatt_autotune_stats_t * const p_stats)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if (NULL == p_stats)
+    {
+        err_code |= RD_ERROR_NULL;
+    }
+    else
+    {
+        *p_stats = m_autotune_stats;
+
+        if (m_autotune_enabled && m_profile_active)
+        {
+            p_stats->time_ms[p_stats->profile] += ri_rtc_millis() - m_profile_start_ms;
+        }
+    }
+
+    return err_code;
+}
+
+void rt_gatt_set_on_link_isr (const ri_gatt_link_cb_t cb)
+{
+    ri_gatt_link_cb_set (cb);
+}
+
+static uint32_t bytes_per_second (const uint32_t bytes, const uint64_t elapsed_ms)
+{
+    return (0U == elapsed_ms) ? 0U : (uint32_t) ( ( (uint64_t) bytes * 1000U) / elapsed_ms);
+}
+
+rd_status_t rt_gatt_throughput_get (rt_gatt_throughput_t * const p_throughput)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if (NULL == p_throughput)
+    {
+        err_code |= RD_ERROR_NULL;
+    }
+    else if (!rt_gatt_nus_is_connected())
+    {
+        err_code |= RD_ERROR_INVALID_STATE;
+    }
+    else
+    {
+        err_code |= ri_gatt_link_get (&p_throughput->link);
+
+        if (RD_SUCCESS == err_code)
+        {
+            p_throughput->connected_ms = ri_rtc_millis() - m_connected_ms;
+            p_throughput->tx_bytes_per_second = bytes_per_second (p_throughput->link.tx_bytes,
+                                                p_throughput->connected_ms);
+            p_throughput->rx_bytes_per_second = bytes_per_second (p_throughput->link.rx_bytes,
+                                                p_throughput->connected_ms);
+        }
+    }
+
+    return err_code;
+}
+
 bool rt_gatt_is_nus_enabled (void)
 {
     return m_nus_is_init;
@@ -434,6 +882,46 @@ void rt_gatt_set_on_sent_isr (const ri_comm_cb_t cb)
     // No implementation needed
 }
 
+void rt_gatt_set_on_tx_backpressure_isr (const rt_gatt_tx_backpressure_cb_t cb)
+{
+    // No implementation needed
+}
+
+rd_status_t rt_gatt_tx_stats_get (rt_gatt_tx_stats_t * const p_stats)
+{
+    return RD_ERROR_NOT_ENABLED;
+}
+
+rd_status_t rt_gatt_autotune_start (const rt_gatt_autotune_config_t * const p_config)
+{
+    return RD_ERROR_NOT_ENABLED;
+}
+
+void rt_gatt_autotune_stop (void)
+{
+    // No implementation needed
+}
+
+rd_status_t rt_gatt_autotune_process (void)
+{
+    return RD_ERROR_NOT_ENABLED;
+}
+
+rd_status_t rt_gatt_autotune_stats_get (rt_gatt_autotune_stats_t * const p_stats)
+{
+    return RD_ERROR_NOT_ENABLED;
+}
+
+void rt_gatt_set_on_link_isr (const ri_gatt_link_cb_t cb)
+{
+    // No implementation needed
+}
+
+rd_status_t rt_gatt_throughput_get (rt_gatt_throughput_t * const p_throughput)
+{
+    return RD_ERROR_NOT_ENABLED;
+}
+
 bool rt_gatt_is_nus_enabled (void)
 {
     return false;
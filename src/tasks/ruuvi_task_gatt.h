@@ -18,6 +18,83 @@
 #include "ruuvi_interface_communication.h"
 #include "ruuvi_interface_communication_ble_gatt.h"
 
+#ifndef RT_GATT_TX_QUEUE_LENGTH
+/** @brief Number of messages buffered while softdevice TX queue is full. */
+#   define RT_GATT_TX_QUEUE_LENGTH (8U)
+#endif
+
+#ifndef RT_GATT_TX_HIGH_WATER
+/** @brief Queue depth at which producers are asked to throttle. */
+#   define RT_GATT_TX_HIGH_WATER ((RT_GATT_TX_QUEUE_LENGTH * 3U) / 4U)
+#endif
+
+#ifndef RT_GATT_TX_LOW_WATER
+/** @brief Queue depth at which producers are allowed to resume. */
+#   define RT_GATT_TX_LOW_WATER (RT_GATT_TX_QUEUE_LENGTH / 4U)
+#endif
+
+#if (RT_GATT_TX_HIGH_WATER > RT_GATT_TX_QUEUE_LENGTH) || (RT_GATT_TX_LOW_WATER >= RT_GATT_TX_HIGH_WATER)
+#   error "GATT TX watermarks must satisfy LOW < HIGH <= QUEUE_LENGTH."
+#endif
+
+/**
+ * @brief Backpressure callback of TX queue.
+ *
+ * Called in interrupt or thread context, whichever changed the queue depth.
+ *
+ * @param[in] throttle true when queue depth reaches @ref RT_GATT_TX_HIGH_WATER,
+ *                     false when it drains to @ref RT_GATT_TX_LOW_WATER or queue is flushed.
+ */
+typedef void (*rt_gatt_tx_backpressure_cb_t) (const bool throttle);
+
+/** @brief Statistics of TX queue. */
+typedef struct
+{
+    uint16_t depth;     //!< Messages in queue now.
+    uint16_t depth_max; //!< Highest depth seen.
+    uint32_t queued;    //!< Messages accepted to queue.
+    uint32_t dropped;   //!< Messages rejected by stack or flushed on disconnection.
+    uint32_t stalls;    //!< Times softdevice TX queue was found full.
+    uint64_t stall_ms;  //!< Total time queue waited on softdevice, including ongoing stall.
+} rt_gatt_tx_stats_t;
+
+/** @brief Number of connection parameter profiles, see @ref ri_gatt_params_t. */
+#define RT_GATT_PROFILES (RI_GATT_LOW_POWER + 1U)
+
+/**
+ * @brief Connection parameter auto-tuning policy.
+ *
+ * Link is busy if TX queue depth or number of received messages since last
+ * @ref rt_gatt_autotune_process reaches threshold. Busy link is switched to
+ * RI_GATT_TURBO. Idle link drifts to RI_GATT_STANDARD and then to RI_GATT_LOW_POWER.
+ */
+typedef struct
+{
+    uint16_t turbo_tx_depth;         //!< TX queue depth which makes link busy, 0 to ignore TX.
+    uint16_t turbo_rx_messages;      //!< Received messages which make link busy, 0 to ignore RX.
+    uint32_t standard_idle_ms;       //!< Idle time before leaving turbo.
+    uint32_t low_power_idle_ms;      //!< Idle time before entering low power.
+    uint32_t min_switch_interval_ms; //!< Minimum time between parameter update requests.
+} rt_gatt_autotune_config_t;
+
+/** @brief Statistics of connection parameter auto-tuning. */
+typedef struct
+{
+    uint64_t time_ms[RT_GATT_PROFILES]; //!< Connected time in each profile, indexed by ri_gatt_params_t.
+    uint32_t switches;                  //!< Parameter updates requested.
+    uint32_t deferred;                  //!< Updates postponed by rate limit.
+    ri_gatt_params_t profile;           //!< Current profile.
+} rt_gatt_autotune_stats_t;
+
+/** @brief Throughput of current NUS connection. */
+typedef struct
+{
+    ri_gatt_link_t link;          //!< Effective link parameters and byte counters.
+    uint64_t connected_ms;        //!< Time since NUS was connected.
+    uint32_t tx_bytes_per_second; //!< Average TX rate since connection.
+    uint32_t rx_bytes_per_second; //!< Average RX rate since connection.
+} rt_gatt_throughput_t;
+
 #ifdef CEEDLING
 // Assist function for unit tests.
 void rt_gatt_mock_state_reset();
@@ -32,17 +109,55 @@ rd_status_t rt_gatt_on_nus_isr (ri_comm_evt_t evt,
  * @brief Send given message via NUS
  *
  * This function queues a message to be sent and returns immediately.
- * There is no guarantee on when the data is actually sent, and
- * there is no acknowledgement or callback after the data has been sent.
+ * Message is copied to TX queue of @ref RT_GATT_TX_QUEUE_LENGTH messages
+ * and queue is drained to softdevice as previous messages are sent.
+ * There is no guarantee on when the data is actually sent, use
+ * @ref rt_gatt_set_on_tx_backpressure_isr to pace the producer.
  *
  * @retval RD_SUCCESS if data was placed in send buffer
  * @retval RD_ERROR_INVALID_STATE if NUS is not connected
  * @retval RD_ERROR_NO_MEM if tx buffer is full
- * @retval error code from stack on other error
+ * @retval error code from stack on other error, message which caused the error is dropped.
  *
  */
 rd_status_t rt_gatt_send_asynchronous (ri_comm_message_t * const msg);
 
+/**
+ * @brief Send data larger than a message via NUS.
+ *
+ * See @ref ri_gatt_nus_bulk_send. Messages of @ref rt_gatt_send_asynchronous are
+ * held in TX queue while transfer is ongoing and queue is drained when it ends.
+ * Use this instead of calling @ref ri_gatt_nus_bulk_send directly.
+ *
+ * @param[in] p_segments Buffers to send back-to-back, must stay valid until on_done.
+ * @param[in] segment_count Number of buffers.
+ * @param[in] on_done Called when transfer ends, may be NULL. Can be called in interrupt
+ *                    context or before this function returns.
+ * @retval RD_SUCCESS Transfer was started.
+ * @retval RD_ERROR_INVALID_STATE if NUS is not connected.
+ * @retval RD_ERROR_BUSY if a bulk transfer is already ongoing.
+ * @return error code from @ref ri_gatt_nus_bulk_send.
+ */
+rd_status_t rt_gatt_bulk_send (const ri_comm_segment_t * const p_segments,
+                               const size_t segment_count,
+                               const ri_gatt_bulk_done_fp on_done);
+
+/**
+ * @brief Setup TX queue backpressure handler.
+ *
+ * @param[in] cb Callback for queue crossing watermarks, NULL to disable.
+ */
+void rt_gatt_set_on_tx_backpressure_isr (const rt_gatt_tx_backpressure_cb_t cb);
+
+/**
+ * @brief Get statistics of TX queue.
+ *
+ * @param[out] p_stats Statistics since GATT initialization.
+ * @retval RD_SUCCESS on success.
+ * @retval RD_ERROR_NULL if p_stats is NULL.
+ */
+rd_status_t rt_gatt_tx_stats_get (rt_gatt_tx_stats_t * const p_stats);
+
 /**
  * @brief Initialize Device Firmware Update service
  *
@@ -217,5 +332,68 @@ void rt_gatt_set_on_received_isr (const ri_comm_cb_t cb);
  */
 void rt_gatt_set_on_sent_isr (const ri_comm_cb_t cb);
 
+/**
+ * @brief Start automatic connection parameter tuning.
+ *
+ * Traffic is tracked by GATT task, profile is changed only in
+ * @ref rt_gatt_autotune_process. Application should not call
+ * @ref ri_gatt_params_request while auto-tuning is running.
+ *
+ * @param[in] p_config Policy, copied.
+ * @retval RD_SUCCESS on success.
+ * @retval RD_ERROR_NULL if p_config is NULL.
+ * @retval RD_ERROR_INVALID_PARAM if low_power_idle_ms is less than standard_idle_ms.
+ * @retval RD_ERROR_INVALID_STATE if GATT is not initialized.
+ */
+rd_status_t rt_gatt_autotune_start (const rt_gatt_autotune_config_t * const p_config);
+
+/**
+ * @brief Stop automatic connection parameter tuning.
+ *
+ * Current connection parameters are left as is.
+ */
+void rt_gatt_autotune_stop (void);
+
+/**
+ * @brief Evaluate traffic and request new connection parameters if needed.
+ *
+ * Call periodically in thread context, e.g. from scheduler once per second.
+ * Has no effect unless auto-tuning is started and NUS is connected.
+ *
+ * @retval RD_SUCCESS on success, including when no update was needed.
+ * @return Error code from @ref ri_gatt_params_request, profile is not changed.
+ */
+rd_status_t rt_gatt_autotune_process (void);
+
+/**
+ * @brief Get statistics of connection parameter auto-tuning.
+ *
+ * @param[out] p_stats Statistics since auto-tuning was started, including ongoing profile.
+ * @retval RD_SUCCESS on success.
+ * @retval RD_ERROR_NULL if p_stats is NULL.
+ */
+rd_status_t rt_gatt_autotune_stats_get (rt_gatt_autotune_stats_t * const p_stats);
+
+/**
+ * @brief Setup link parameter change handler.
+ *
+ * Called in interrupt context on connection and when ATT MTU, LL data length,
+ * PHY or connection interval change. Cleared on @ref rt_gatt_uninit.
+ *
+ * @param[in] cb Callback, NULL to disable.
+ */
+void rt_gatt_set_on_link_isr (const ri_gatt_link_cb_t cb);
+
+/**
+ * @brief Get link parameters and achieved throughput of current NUS connection.
+ *
+ * @param[out] p_throughput Link parameters and average byte rates since connection.
+ * @retval RD_SUCCESS on success.
+ * @retval RD_ERROR_NULL if p_throughput is NULL.
+ * @retval RD_ERROR_INVALID_STATE if NUS is not connected.
+ * @return Error code from @ref ri_gatt_link_get on other error.
+ */
+rd_status_t rt_gatt_throughput_get (rt_gatt_throughput_t * const p_throughput);
+
 #endif
 /*@}*/
\ No newline at end of file
@@ -0,0 +1,227 @@
+/**
+ * @addtogroup keystream_tasks
+ */
+/*@{*/
+/**
+ * @file ruuvi_task_keystream.c
+ * @author Otso Jousimaa <otso@ojousima.net>
+ * @date 2026-10-18
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ *
+ * At most one refill is queued in scheduler at a time, it refills every open stream.
+ */
+#include "ruuvi_driver_enabled_modules.h"
+#if RT_KEYSTREAM_ENABLED
+#include "ruuvi_driver_error.h"
+#include "ruuvi_interface_aes_ctr.h"
+#include "ruuvi_interface_scheduler.h"
+#include "ruuvi_task_keystream.h"
+#include <string.h>
+
+/** @brief One stream of pool. */
+typedef struct
+{
+    ri_aes_ctr_t ctr;            //!< Key, counter and precomputed keystream.
+    rt_keystream_stats_t stats;  //!< Statistics since opening.
+    bool open;                   //!< Stream is in use.
+} keystream_slot_t;
+
+static keystream_slot_t m_slots[RT_KEYSTREAM_STREAMS];
+static bool m_refill_pending;
+static bool m_is_init;
+
+static keystream_slot_t * slot_get (const uint8_t stream)
+{
+    keystream_slot_t * p_slot = NULL;
+
+    if (m_is_init && (RT_KEYSTREAM_STREAMS > stream) && m_slots[stream].open)
+    {
+        p_slot = &m_slots[stream];
+    }
+
+    return p_slot;
+}
+
+static void refill_handler (void * p_event_data, uint16_t event_size)
+{
+    m_refill_pending = false;
+
+    // Pool may have been uninitialized while refill was queued.
+    if (m_is_init)
+    {
+        rd_status_t err_code = rt_keystream_refill();
+        // Streams fall back to synchronous encryption, no need to reset.
+        RD_ERROR_CHECK (err_code, ~RD_ERROR_FATAL);
+    }
+}
+
+static void refill_schedule (void)
+{
+    if (!m_refill_pending)
+    {
+        // If queue is full, next crypt retries and streams fall back to synchronous encryption.
+        m_refill_pending = (RD_SUCCESS == ri_scheduler_event_put (NULL, 0, &refill_handler));
+    }
+}
+
+rd_status_t rt_keystream_init (void)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if (m_is_init)
+    {
+        err_code |= RD_ERROR_INVALID_STATE;
+    }
+    else
+    {
+        memset (m_slots, 0, sizeof (m_slots));
+        m_refill_pending = false;
+        m_is_init = true;
+    }
+
+    return err_code;
+}
+
+void rt_keystream_uninit (void)
+{
+    memset (m_slots, 0, sizeof (m_slots));
+    m_is_init = false;
+}
+
+bool rt_keystream_is_init (void)
+{
+    return m_is_init;
+}
+
+rd_status_t rt_keystream_open (const uint8_t * const key, const uint8_t * const counter,
+                               uint8_t * const p_stream)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if ( (NULL == key) || (NULL == counter) || (NULL == p_stream))
+    {
+        err_code |= RD_ERROR_NULL;
+    }
+    else if (!m_is_init)
+    {
+        err_code |= RD_ERROR_INVALID_STATE;
+    }
+    else
+    {
+        err_code |= RD_ERROR_NO_MEM;
+
+        for (uint8_t ii = 0; (ii < RT_KEYSTREAM_STREAMS) && (RD_SUCCESS != err_code); ii++)
+        {
+            if (!m_slots[ii].open)
+            {
+                memset (&m_slots[ii], 0, sizeof (keystream_slot_t));
+                err_code = ri_aes_ctr_init (&m_slots[ii].ctr, key, counter);
+                m_slots[ii].open = true;
+                *p_stream = ii;
+                refill_schedule();
+            }
+        }
+    }
+
+    return err_code;
+}
+
+rd_status_t rt_keystream_close (const uint8_t stream)
+{
+    rd_status_t err_code = RD_SUCCESS;
+    keystream_slot_t * const p_slot = slot_get (stream);
+
+    if (NULL == p_slot)
+    {
+        err_code |= RD_ERROR_INVALID_PARAM;
+    }
+    else
+    {
+        memset (p_slot, 0, sizeof (keystream_slot_t));
+    }
+
+    return err_code;
+}
+
+rd_status_t rt_keystream_crypt (const uint8_t stream, const uint8_t * const input,
+                                uint8_t * const output, const size_t length)
+{
+    rd_status_t err_code = RD_SUCCESS;
+    keystream_slot_t * const p_slot = slot_get (stream);
+
+    if ( (NULL == input) || (NULL == output))
+    {
+        err_code |= RD_ERROR_NULL;
+    }
+    else if (NULL == p_slot)
+    {
+        err_code |= RD_ERROR_INVALID_PARAM;
+    }
+    else
+    {
+        if (length > ri_aes_ctr_available (&p_slot->ctr))
+        {
+            p_slot->stats.underruns++;
+        }
+        else
+        {
+            p_slot->stats.hits++;
+        }
+
+        err_code |= ri_aes_ctr_crypt (&p_slot->ctr, input, output, length);
+        p_slot->stats.bytes += (uint32_t) length;
+        refill_schedule();
+    }
+
+    return err_code;
+}
+
+rd_status_t rt_keystream_refill (void)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if (!m_is_init)
+    {
+        err_code |= RD_ERROR_INVALID_STATE;
+    }
+    else
+    {
+        for (size_t ii = 0; ii < RT_KEYSTREAM_STREAMS; ii++)
+        {
+            if (m_slots[ii].open
+                    && ( (RI_AES_CTR_KEYSTREAM_BLOCKS * RI_AES_BLOCK_SIZE)
+                         > ri_aes_ctr_available (&m_slots[ii].ctr)))
+            {
+                err_code |= ri_aes_ctr_precompute (&m_slots[ii].ctr);
+                m_slots[ii].stats.refills++;
+            }
+        }
+    }
+
+    return err_code;
+}
+
+rd_status_t rt_keystream_stats_get (const uint8_t stream,
+                                    rt_keystream_stats_t * const p_stats)
+{
+    rd_status_t err_code = RD_SUCCESS;
+    const keystream_slot_t * const p_slot = slot_get (stream);
+
+    if (NULL == p_stats)
+    {
+        err_code |= RD_ERROR_NULL;
+    }
+    else if (NULL == p_slot)
+    {
+        err_code |= RD_ERROR_INVALID_PARAM;
+    }
+    else
+    {
+        *p_stats = p_slot->stats;
+    }
+
+    return err_code;
+}
+
+/*@}*/
+#endif
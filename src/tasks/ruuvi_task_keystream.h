@@ -0,0 +1,152 @@
+#ifndef RUUVI_TASK_KEYSTREAM_H
+#define RUUVI_TASK_KEYSTREAM_H
+/**
+ * @addtogroup peripheral_tasks
+ */
+/*@{*/
+/**
+ * @defgroup keystream_tasks Keystream tasks
+ * @brief Precompute AES keystream in idle time.
+ *
+ */
+/*@}*/
+/**
+ * @addtogroup keystream_tasks
+ */
+/*@{*/
+/**
+ * @file ruuvi_task_keystream.h
+ * @author Otso Jousimaa <otso@ojousima.net>
+ * @date 2026-10-18
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ *
+ * @brief Pool of AES-CTR streams which are refilled from scheduler.
+ *
+ * Each stream has a key and counter sequence of its own and keeps
+ * RI_AES_CTR_KEYSTREAM_BLOCKS of keystream ready. Consuming keystream
+ * schedules a refill, which runs on next @ref ri_scheduler_execute, i.e. when
+ * application is otherwise idle. Encrypting a frame right before sending it
+ * is then an XOR with constant latency. If a frame is longer than precomputed
+ * keystream, missing blocks are encrypted synchronously and the underrun is counted.
+ *
+ * All functions must be called from main context.
+ *
+ * Typical usage:
+ *
+ * @code{.c}
+ *  uint8_t stream;
+ *  err_code |= rt_keystream_init();
+ *  err_code |= rt_keystream_open (key, initial_counter, &stream);
+ *  // ... Data ready to send.
+ *  err_code |= rt_keystream_crypt (stream, payload, payload, sizeof (payload));
+ *  err_code |= rt_adv_send_data (&msg);
+ * @endcode
+ */
+#include "ruuvi_driver_enabled_modules.h"
+#include "ruuvi_driver_error.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifndef RT_KEYSTREAM_STREAMS
+/** @brief Number of simultaneously open streams. */
+#   define RT_KEYSTREAM_STREAMS (2U)
+#endif
+
+/** @brief Statistics of a stream since it was opened. */
+typedef struct
+{
+    uint32_t bytes;      //!< Bytes encrypted or decrypted.
+    uint32_t hits;       //!< Calls served entirely from precomputed keystream.
+    uint32_t underruns;  //!< Calls which had to encrypt keystream synchronously.
+    uint32_t refills;    //!< Refills run from scheduler.
+} rt_keystream_stats_t;
+
+/**
+ * @brief Initialize keystream pool.
+ *
+ * Scheduler must be initialized before refills can run.
+ *
+ * @retval RD_SUCCESS on success.
+ * @retval RD_ERROR_INVALID_STATE if pool is already initialized.
+ */
+rd_status_t rt_keystream_init (void);
+
+/**
+ * @brief Close all streams and wipe keys and keystream.
+ */
+void rt_keystream_uninit (void);
+
+/**
+ * @brief Check if keystream pool is initialized.
+ *
+ * @return True if pool is initialized.
+ */
+bool rt_keystream_is_init (void);
+
+/**
+ * @brief Open a stream and schedule its first refill.
+ *
+ * @param[in] key 16-byte AES key.
+ * @param[in] counter 16-byte initial counter block.
+ * @param[out] p_stream Handle of opened stream.
+ * @retval RD_SUCCESS on success.
+ * @retval RD_ERROR_NULL if any pointer is NULL.
+ * @retval RD_ERROR_INVALID_STATE if pool is not initialized.
+ * @retval RD_ERROR_NO_MEM if all streams are open.
+ */
+rd_status_t rt_keystream_open (const uint8_t * const key, const uint8_t * const counter,
+                               uint8_t * const p_stream);
+
+/**
+ * @brief Close a stream and wipe its key and keystream.
+ *
+ * @param[in] stream Handle of stream.
+ * @retval RD_SUCCESS on success.
+ * @retval RD_ERROR_INVALID_PARAM if stream is not open.
+ */
+rd_status_t rt_keystream_close (const uint8_t stream);
+
+/**
+ * @brief Encrypt or decrypt data with next bytes of stream.
+ *
+ * Missing keystream is generated synchronously, so call succeeds also on underrun.
+ *
+ * @param[in] stream Handle of stream.
+ * @param[in] input Data to encrypt or decrypt.
+ * @param[out] output Result, may be same as input.
+ * @param[in] length Bytes to process.
+ * @retval RD_SUCCESS on success.
+ * @retval RD_ERROR_NULL if input or output is NULL.
+ * @retval RD_ERROR_INVALID_PARAM if stream is not open.
+ * @return Error code from @ref ri_aes_ecb_128_encrypt on underrun.
+ */
+rd_status_t rt_keystream_crypt (const uint8_t stream, const uint8_t * const input,
+                                uint8_t * const output, const size_t length);
+
+/**
+ * @brief Refill all open streams now.
+ *
+ * Called from scheduler after keystream is consumed, can be called by application
+ * e.g. right after opening streams to have keystream ready before first frame.
+ *
+ * @retval RD_SUCCESS on success.
+ * @retval RD_ERROR_INVALID_STATE if pool is not initialized.
+ * @return Error code from @ref ri_aes_ecb_128_encrypt.
+ */
+rd_status_t rt_keystream_refill (void);
+
+/**
+ * @brief Get statistics of stream.
+ *
+ * @param[in] stream Handle of stream.
+ * @param[out] p_stats Statistics.
+ * @retval RD_SUCCESS on success.
+ * @retval RD_ERROR_NULL if p_stats is NULL.
+ * @retval RD_ERROR_INVALID_PARAM if stream is not open.
+ */
+rd_status_t rt_keystream_stats_get (const uint8_t stream,
+                                    rt_keystream_stats_t * const p_stats);
+
+/*@}*/
+#endif
@@ -0,0 +1,93 @@
+/**
+ * @addtogroup log_tasks
+ */
+/*@{*/
+/**
+ * @file ruuvi_task_log.c
+ * @author Otso Jousimaa <otso@ojousima.net>
+ * @date 2026-10-18
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ */
+#include "ruuvi_driver_enabled_modules.h"
+#if RT_LOG_ENABLED
+#include "ruuvi_driver_error.h"
+#include "ruuvi_interface_communication.h"
+#include "ruuvi_interface_log.h"
+#include "ruuvi_interface_log_ring.h"
+#include "ruuvi_task_communication.h"
+#include "ruuvi_task_log.h"
+#include <stdio.h>
+
+/** @brief Room for sequence number and severity in front of message. */
+#define DUMP_PREFIX_MAX_LEN (16U)
+
+static bool m_dump_resume;     //!< True if a message was partially sent.
+static uint32_t m_dump_seq;    //!< Sequence number of partially sent message.
+static size_t m_dump_offset;   //!< Bytes of partially sent message already sent.
+
+static char severity_char (const uint8_t severity)
+{
+    static const char severities[] = "-EWID";
+    return (severity < (sizeof (severities) - 1U)) ? severities[severity] : '?';
+}
+
+rd_status_t rt_log_dump (const ri_comm_xfer_fp_t send)
+{
+    rd_status_t err_code = RD_SUCCESS;
+    ri_log_ring_entry_t entry;
+
+    if (NULL == send)
+    {
+        err_code |= RD_ERROR_NULL;
+    }
+
+    while (RD_SUCCESS == err_code)
+    {
+        err_code |= ri_log_ring_peek (&entry);
+
+        if (RD_SUCCESS == err_code)
+        {
+            char line[DUMP_PREFIX_MAX_LEN + RI_LOG_RING_ENTRY_SIZE];
+            const int written = snprintf (line, sizeof (line), "%lu %c: %s",
+                                          (unsigned long) entry.seq,
+                                          severity_char (entry.severity), entry.text);
+            const size_t line_len = (written > 0) ? (size_t) written : 0U;
+            size_t offset = 0;
+
+            if (m_dump_resume && (m_dump_seq == entry.seq))
+            {
+                offset = m_dump_offset;
+            }
+
+            m_dump_resume = false;
+
+            err_code |= rt_com_send_chunked (send, line, line_len, &offset);
+
+            if (RD_SUCCESS == err_code)
+            {
+                err_code |= ri_log_ring_consume();
+            }
+            else
+            {
+                m_dump_resume = true;
+                m_dump_seq = entry.seq;
+                m_dump_offset = offset;
+            }
+        }
+        else if (RD_ERROR_NOT_FOUND == err_code)
+        {
+            // All messages sent.
+            err_code = RD_SUCCESS;
+            break;
+        }
+        else
+        {
+            // Return error from ring.
+        }
+    }
+
+    return err_code;
+}
+
+/*@}*/
+#endif
@@ -0,0 +1,63 @@
+#ifndef RUUVI_TASK_LOG_H
+#define RUUVI_TASK_LOG_H
+/**
+ * @addtogroup peripheral_tasks
+ */
+/*@{*/
+/**
+ * @defgroup log_tasks Log tasks
+ * @brief Post-mortem log readout.
+ *
+ */
+/*@}*/
+/**
+ * @addtogroup log_tasks
+ */
+/*@{*/
+/**
+ * @file ruuvi_task_log.h
+ * @author Otso Jousimaa <otso@ojousima.net>
+ * @date 2026-10-18
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ *
+ * @brief Dump log ring over any communication channel.
+ *
+ * Messages stored in log ring before a reset are kept over reset, and can be
+ * read out over UART or NUS after reboot.
+ *
+ * Typical usage:
+ *
+ * @code{.c}
+ *  rd_status_t err_code = RD_SUCCESS;
+ *  err_code = ri_log_ring_init (RI_LOG_LEVEL_DEBUG);
+ *  // ... Later, e.g. when NUS is connected.
+ *  err_code = rt_log_dump (&rt_gatt_send_asynchronous);
+ *  if (RD_ERROR_NO_MEM == err_code)
+ *  {
+ *      // Retry on next RI_COMM_SENT event.
+ *  }
+ * @endcode
+ */
+#include "ruuvi_driver_error.h"
+#include "ruuvi_interface_communication.h"
+#include "ruuvi_interface_log_ring.h"
+
+/**
+ * @brief Send unread messages of log ring through given send function.
+ *
+ * Each message is formatted as "<seq> <severity>: <text>" and split into as many
+ * @ref ri_comm_message_t as needed. Messages are consumed from ring once all
+ * of their parts have been sent. If sending fails, dump can be resumed by calling
+ * this function again, parts already sent are not repeated.
+ *
+ * @param[in] send Send function of channel, e.g. @ref rt_gatt_send_asynchronous.
+ * @retval RD_SUCCESS if all unread messages were sent.
+ * @retval RD_ERROR_NULL if send is NULL.
+ * @retval RD_ERROR_INVALID_STATE if log ring is not initialized.
+ * @return Error from send function if sending failed, e.g. RD_ERROR_NO_MEM when
+ *         TX queue is full.
+ */
+rd_status_t rt_log_dump (const ri_comm_xfer_fp_t send);
+
+/*@}*/
+#endif
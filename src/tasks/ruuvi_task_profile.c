@@ -0,0 +1,150 @@
+/**
+ * @addtogroup profile_tasks
+ */
+/*@{*/
+/**
+ * @file ruuvi_task_profile.c
+ * @author Otso Jousimaa <otso@ojousima.net>
+ * @date 2026-10-18
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ */
+#include "ruuvi_driver_enabled_modules.h"
+#if RT_PROFILE_ENABLED
+#include "ruuvi_driver_error.h"
+#include "ruuvi_interface_communication.h"
+#include "ruuvi_interface_profile.h"
+#include "ruuvi_task_communication.h"
+#include "ruuvi_task_profile.h"
+#include <stdio.h>
+
+#define REPORT_LINE_MAX_LEN (96U) //!< Longest line of report, longer names are truncated.
+#define TENTHS              (10U) //!< Durations are reported in 0.1 us.
+
+static const char m_header[] = "zone: calls min/avg/max us\r\n";
+
+static char m_line[REPORT_LINE_MAX_LEN]; //!< Line being sent, kept until fully sent.
+static size_t m_line_len;      //!< Length of line being sent.
+static bool m_line_pending;    //!< True if line is partially sent.
+static size_t m_report_line;   //!< Index of line being sent, 0 is header.
+static size_t m_report_offset; //!< Bytes of line already sent.
+
+static const ri_profile_zone_t * zone_at (const size_t index)
+{
+    const ri_profile_zone_t * p_zone = ri_profile_zone_next (NULL);
+
+    for (size_t ii = 0; (ii < index) && (NULL != p_zone); ii++)
+    {
+        p_zone = ri_profile_zone_next (p_zone);
+    }
+
+    return p_zone;
+}
+
+static uint32_t ticks_to_tenths_us (const uint64_t ticks)
+{
+    uint32_t ticks_per_us = ri_profile_ticks_per_us();
+
+    if (0U == ticks_per_us)
+    {
+        ticks_per_us = 1U;
+    }
+
+    return (uint32_t) ( (ticks * TENTHS) / ticks_per_us);
+}
+
+static size_t format_zone (char * const line, const size_t line_size,
+                           const ri_profile_zone_t * const p_zone)
+{
+    int written;
+
+    if (0U == p_zone->calls)
+    {
+        written = snprintf (line, line_size, "%s: 0 -/-/-\r\n", p_zone->p_name);
+    }
+    else
+    {
+        const uint32_t min = ticks_to_tenths_us (p_zone->min_ticks);
+        const uint32_t avg = ticks_to_tenths_us (p_zone->total_ticks / p_zone->calls);
+        const uint32_t max = ticks_to_tenths_us (p_zone->max_ticks);
+        written = snprintf (line, line_size,
+                            "%s: %lu %lu.%lu/%lu.%lu/%lu.%lu\r\n",
+                            p_zone->p_name, (unsigned long) p_zone->calls,
+                            (unsigned long) (min / TENTHS), (unsigned long) (min % TENTHS),
+                            (unsigned long) (avg / TENTHS), (unsigned long) (avg % TENTHS),
+                            (unsigned long) (max / TENTHS), (unsigned long) (max % TENTHS));
+    }
+
+    if (written < 0)
+    {
+        written = 0;
+    }
+    else if ( (size_t) written >= line_size)
+    {
+        written = (int) (line_size - 1U);
+    }
+    else
+    {
+        // Whole line fit.
+    }
+
+    return (size_t) written;
+}
+
+rd_status_t rt_profile_report (const ri_comm_xfer_fp_t send)
+{
+    rd_status_t err_code = RD_SUCCESS;
+    bool done = false;
+
+    if (NULL == send)
+    {
+        err_code |= RD_ERROR_NULL;
+    }
+
+    while ( (RD_SUCCESS == err_code) && !done)
+    {
+        if (!m_line_pending)
+        {
+            if (0U == m_report_line)
+            {
+                m_line_len = (size_t) snprintf (m_line, sizeof (m_line), "%s", m_header);
+            }
+            else
+            {
+                const ri_profile_zone_t * const p_zone = zone_at (m_report_line - 1U);
+
+                if (NULL == p_zone)
+                {
+                    done = true;
+                }
+                else
+                {
+                    m_line_len = format_zone (m_line, sizeof (m_line), p_zone);
+                }
+            }
+
+            m_line_pending = !done;
+            m_report_offset = 0;
+        }
+
+        if (m_line_pending)
+        {
+            err_code |= rt_com_send_chunked (send, m_line, m_line_len, &m_report_offset);
+
+            if (RD_SUCCESS == err_code)
+            {
+                m_line_pending = false;
+                m_report_line++;
+            }
+        }
+    }
+
+    if (done)
+    {
+        m_report_line = 0;
+    }
+
+    return err_code;
+}
+
+/*@}*/
+#endif
@@ -0,0 +1,60 @@
+#ifndef RUUVI_TASK_PROFILE_H
+#define RUUVI_TASK_PROFILE_H
+/**
+ * @addtogroup peripheral_tasks
+ */
+/*@{*/
+/**
+ * @defgroup profile_tasks Profiling tasks
+ * @brief Report profiling zones.
+ *
+ */
+/*@}*/
+/**
+ * @addtogroup profile_tasks
+ */
+/*@{*/
+/**
+ * @file ruuvi_task_profile.h
+ * @author Otso Jousimaa <otso@ojousima.net>
+ * @date 2026-10-18
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ *
+ * @brief Send table of profiling zones over any communication channel.
+ *
+ * Typical usage:
+ *
+ * @code{.c}
+ *  rd_status_t err_code = RD_SUCCESS;
+ *  err_code = ri_profile_init();
+ *  // ... Later, e.g. when report is requested over NUS.
+ *  err_code = rt_profile_report (&rt_gatt_send_asynchronous);
+ *  if (RD_ERROR_NO_MEM == err_code)
+ *  {
+ *      // Retry on next RI_COMM_SENT event.
+ *  }
+ * @endcode
+ */
+#include "ruuvi_driver_error.h"
+#include "ruuvi_interface_communication.h"
+#include "ruuvi_interface_profile.h"
+
+/**
+ * @brief Send statistics of all registered zones through given send function.
+ *
+ * Report starts with a header line, followed by one line per zone:
+ * "<name>: <calls> <min>/<avg>/<max>", durations in microseconds with one decimal.
+ * Lines are split into as many @ref ri_comm_message_t as needed.
+ * If sending fails, report can be resumed by calling this function again,
+ * parts already sent are not repeated.
+ *
+ * @param[in] send Send function of channel, e.g. @ref rt_gatt_send_asynchronous.
+ * @retval RD_SUCCESS if whole report was sent.
+ * @retval RD_ERROR_NULL if send is NULL.
+ * @return Error from send function if sending failed, e.g. RD_ERROR_NO_MEM when
+ *         TX queue is full.
+ */
+rd_status_t rt_profile_report (const ri_comm_xfer_fp_t send);
+
+/*@}*/
+#endif
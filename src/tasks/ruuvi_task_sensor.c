@@ -3,6 +3,7 @@
 #include "ruuvi_driver_error.h"
 #include "ruuvi_driver_sensor.h"
 #include "ruuvi_interface_log.h"
+#include "ruuvi_task_energy.h"
 #include "ruuvi_task_flash.h"
 #include "ruuvi_task_sensor.h"
 
@@ -12,20 +13,16 @@
 #define TASK_SENSOR_LOG_LEVEL RI_LOG_LEVEL_DEBUG
 #endif
 
-static inline void LOG (const char * const msg)
-{
-    ri_log (TASK_SENSOR_LOG_LEVEL, msg);
-}
+#ifndef TASK_SENSOR_LOG_COMPILE_LEVEL
+#define TASK_SENSOR_LOG_COMPILE_LEVEL RI_LOG_COMPILE_LEVEL
+#endif
 
-static inline void LOGD (const char * const msg)
-{
-    ri_log (RI_LOG_LEVEL_DEBUG, msg);
-}
-
-static inline void LOGHEX (const uint8_t * const msg, const size_t len)
-{
-    ri_log_hex (TASK_SENSOR_LOG_LEVEL, msg, len);
-}
+#define LOG(msg) RI_LOG_MODULE(RI_LOG_MODULE_SENSOR, TASK_SENSOR_LOG_COMPILE_LEVEL, \
+                               TASK_SENSOR_LOG_LEVEL, msg)
+#define LOGD(msg) RI_LOG_MODULE(RI_LOG_MODULE_SENSOR, TASK_SENSOR_LOG_COMPILE_LEVEL, \
+                                RI_LOG_LEVEL_DEBUG, msg)
+#define LOGHEX(msg, len) RI_LOG_MODULE_HEX(RI_LOG_MODULE_SENSOR, \
+        TASK_SENSOR_LOG_COMPILE_LEVEL, TASK_SENSOR_LOG_LEVEL, msg, len)
 
 /** @brief Initialize sensor CTX
  *
@@ -149,13 +146,66 @@ rd_status_t rt_sensor_configure (rt_sensor_ctx_t * const ctx)
         LOG ("\r\nAttempting to configure ");
         LOG (ctx->sensor.name);
         LOG (" with:\r\n");
-        ri_log_sensor_configuration (TASK_SENSOR_LOG_LEVEL,
-                                     & (ctx->configuration), "");
+
+        if (RI_LOG_IS_COMPILED (TASK_SENSOR_LOG_COMPILE_LEVEL, TASK_SENSOR_LOG_LEVEL))
+        {
+            ri_log_sensor_configuration (TASK_SENSOR_LOG_LEVEL,
+                                         & (ctx->configuration), "");
+        }
+
         err_code |= ctx->sensor.configuration_set (& (ctx->sensor),
                     & (ctx->configuration));
+#if RT_ENERGY_ENABLED
+
+        if (RD_SUCCESS == err_code)
+        {
+            rt_energy_sensor_mode_set (ctx, ctx->configuration.mode);
+        }
+
+#endif
         LOG ("Actual configuration:\r\n");
-        ri_log_sensor_configuration (TASK_SENSOR_LOG_LEVEL,
-                                     & (ctx->configuration), "");
+
+        if (RI_LOG_IS_COMPILED (TASK_SENSOR_LOG_COMPILE_LEVEL, TASK_SENSOR_LOG_LEVEL))
+        {
+            ri_log_sensor_configuration (TASK_SENSOR_LOG_LEVEL,
+                                         & (ctx->configuration), "");
+        }
+    }
+
+    return err_code;
+}
+
+rd_status_t rt_sensor_data_get (rt_sensor_ctx_t * const ctx,
+                                rd_sensor_data_t * const p_data)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if ( (NULL == ctx) || (NULL == p_data))
+    {
+        err_code |= RD_ERROR_NULL;
+    }
+    else if (!rd_sensor_is_init (& (ctx->sensor)))
+    {
+        err_code |= RD_ERROR_INVALID_STATE;
+    }
+    else
+    {
+        const rd_sensor_data_fields_t valid_before = p_data->valid;
+        err_code |= ctx->sensor.data_get (p_data);
+#if RT_SENSOR_DSP_ENABLED
+
+        if ( (RD_SUCCESS == err_code) && (NULL != ctx->p_dsp))
+        {
+            const rd_sensor_data_fields_t read =
+            {
+                .bitfield = p_data->valid.bitfield & ~valid_before.bitfield
+            };
+            err_code |= rt_sensor_dsp_process (ctx->p_dsp, p_data, read);
+        }
+
+#else
+        (void) valid_before;
+#endif
     }
 
     return err_code;
@@ -17,6 +17,7 @@
 #include "ruuvi_driver_sensor.h"
 #include "ruuvi_interface_gpio.h"
 #include "ruuvi_interface_i2c.h"
+#include "ruuvi_task_sensor_dsp.h"
 
 typedef struct
 {
@@ -32,6 +33,7 @@ typedef struct
     ri_gpio_id_t fifo_pin;                    //!< FIFO full interrupt.
     ri_gpio_id_t level_pin;                   //!< Level interrupt.
     ri_i2c_frequency_t i2c_max_speed; //!< Maximum I2C speed supported
+    rt_sensor_dsp_t * p_dsp;                  //!< Software DSP of data, NULL if not used.
 } rt_sensor_ctx_t;
 
 /** @brief Initialize sensor CTX
@@ -83,6 +85,23 @@ rd_status_t rt_sensor_load (rt_sensor_ctx_t * const sensor);
  */
 rd_status_t rt_sensor_configure (rt_sensor_ctx_t * const sensor);
 
+/**
+ * @brief Read data of a sensor and run it through software DSP of sensor.
+ *
+ * Fields which become valid in this call are filtered with ctx->p_dsp,
+ * if set. Fields still accumulating oversampled value are left invalid.
+ *
+ * @param[in] ctx Sensor to read.
+ * @param[in,out] p_data Data to populate, as in @ref rd_sensor_data_fp.
+ *
+ * @retval RD_SUCCESS on success.
+ * @retval RD_ERROR_NULL if any pointer is NULL.
+ * @retval RD_ERROR_INVALID_STATE if sensor is not initialized.
+ * @return error code from sensor on other error.
+ */
+rd_status_t rt_sensor_data_get (rt_sensor_ctx_t * const ctx,
+                                rd_sensor_data_t * const p_data);
+
 /**
  * @brief Search for requested sensor backend in given list of sensors.
  *
@@ -0,0 +1,133 @@
+/**
+ * @addtogroup sensor_tasks
+ */
+/*@{*/
+/**
+ * @file ruuvi_task_sensor_cache.c
+ * @author Otso Jousimaa <otso@ojousima.net>
+ * @date 2026-10-18
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ *
+ * Cached sample is stored as values of rd_sensor_data_t with fields the sensor provides.
+ */
+#include "ruuvi_driver_enabled_modules.h"
+#if RT_SENSOR_CACHE_ENABLED
+#include "ruuvi_driver_error.h"
+#include "ruuvi_driver_sensor.h"
+#include "ruuvi_task_sensor_cache.h"
+#include <string.h>
+
+static bool cache_is_fresh (const rt_sensor_cache_t * const p_cache, const uint64_t now)
+{
+    return (0U != p_cache->valid.bitfield)
+           && (RD_SENSOR_INVALID_TIMSTAMP != now)
+           && (now >= p_cache->sampled_ms)
+           && ( (now - p_cache->sampled_ms) <= p_cache->max_age_ms);
+}
+
+static rd_status_t cache_refresh (rt_sensor_cache_t * const p_cache, const uint64_t now)
+{
+    rd_status_t err_code = RD_SUCCESS;
+    rd_sensor_data_t sample = {0};
+    sample.fields = p_cache->p_sensor->provides;
+    sample.data = p_cache->values;
+
+    for (size_t ii = 0; ii < RT_SENSOR_CACHE_VALUES; ii++)
+    {
+        p_cache->values[ii] = RD_FLOAT_INVALID;
+    }
+
+    err_code |= p_cache->p_sensor->data_get (&sample);
+
+    if (RD_SUCCESS == err_code)
+    {
+        p_cache->valid = sample.valid;
+        // Drivers timestamp their samples, fall back to time of read.
+        p_cache->sampled_ms = ( (0U == sample.timestamp_ms)
+                                || (RD_SENSOR_INVALID_TIMSTAMP == sample.timestamp_ms)) ?
+                              now : sample.timestamp_ms;
+    }
+    else
+    {
+        p_cache->valid.bitfield = 0;
+    }
+
+    return err_code;
+}
+
+rd_status_t rt_sensor_cache_init (rt_sensor_cache_t * const p_cache,
+                                  const rd_sensor_t * const p_sensor,
+                                  const uint32_t max_age_ms)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if ( (NULL == p_cache) || (NULL == p_sensor))
+    {
+        err_code |= RD_ERROR_NULL;
+    }
+    else if (RT_SENSOR_CACHE_VALUES < (uint32_t) __builtin_popcount (
+                 p_sensor->provides.bitfield))
+    {
+        err_code |= RD_ERROR_NO_MEM;
+    }
+    else
+    {
+        memset (p_cache, 0, sizeof (rt_sensor_cache_t));
+        p_cache->p_sensor = p_sensor;
+        p_cache->max_age_ms = max_age_ms;
+    }
+
+    return err_code;
+}
+
+rd_status_t rt_sensor_cache_data_get (rt_sensor_cache_t * const p_cache,
+                                      rd_sensor_data_t * const p_data)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if ( (NULL == p_cache) || (NULL == p_data))
+    {
+        err_code |= RD_ERROR_NULL;
+    }
+    else if ( (NULL == p_cache->p_sensor) || (NULL == p_cache->p_sensor->data_get))
+    {
+        err_code |= RD_ERROR_INVALID_STATE;
+    }
+    else
+    {
+        const uint64_t now = rd_sensor_timestamp_get();
+
+        if (cache_is_fresh (p_cache, now))
+        {
+            p_cache->hits++;
+        }
+        else
+        {
+            p_cache->misses++;
+            err_code |= cache_refresh (p_cache, now);
+        }
+
+        if (RD_SUCCESS == err_code)
+        {
+            rd_sensor_data_t cached = {0};
+            cached.timestamp_ms = p_cache->sampled_ms;
+            cached.fields = p_cache->p_sensor->provides;
+            cached.valid = p_cache->valid;
+            cached.data = p_cache->values;
+            rd_sensor_data_populate (p_data, &cached, p_data->fields);
+        }
+    }
+
+    return err_code;
+}
+
+void rt_sensor_cache_invalidate (rt_sensor_cache_t * const p_cache)
+{
+    if (NULL != p_cache)
+    {
+        p_cache->valid.bitfield = 0;
+    }
+}
+
+/*@}*/
+#endif
@@ -0,0 +1,93 @@
+#ifndef RUUVI_TASK_SENSOR_CACHE_H
+#define RUUVI_TASK_SENSOR_CACHE_H
+/**
+ * @addtogroup sensor_tasks
+ */
+/*@{*/
+/**
+ * @file ruuvi_task_sensor_cache.h
+ * @author Otso Jousimaa <otso@ojousima.net>
+ * @date 2026-10-18
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ *
+ * @brief Cache latest sample of a sensor.
+ *
+ * Drivers which refresh data in data_get, such as ADC-based sensors with
+ * autorefresh, run a new conversion on every call. When several consumers read the
+ * same sensor in quick succession, a cache returns the latest sample while it is
+ * younger than configured maximum age and calls sensor only when sample is stale.
+ *
+ * Cache holds all fields sensor provides, so consumers requesting different
+ * fields share the same sample. Age is measured with @ref rd_sensor_timestamp_get.
+ *
+ * Typical usage:
+ *
+ * @code{.c}
+ *  static rt_sensor_cache_t ntc_cache;
+ *  err_code |= rt_sensor_cache_init (&ntc_cache, &ntc_sensor, 1000U);
+ *  // Advertisement encoder, GATT log and NFC each call:
+ *  err_code |= rt_sensor_cache_data_get (&ntc_cache, &data);
+ * @endcode
+ */
+#include "ruuvi_driver_enabled_modules.h"
+#include "ruuvi_driver_error.h"
+#include "ruuvi_driver_sensor.h"
+#include <stdint.h>
+
+#ifndef RT_SENSOR_CACHE_VALUES
+/** @brief Maximum number of fields of a cached sensor. */
+#   define RT_SENSOR_CACHE_VALUES (6U)
+#endif
+
+/** @brief Cache of one sensor. Set up with @ref rt_sensor_cache_init. */
+typedef struct
+{
+    const rd_sensor_t * p_sensor;          //!< Cached sensor.
+    uint32_t max_age_ms;                   //!< Oldest sample returned from cache.
+    uint64_t sampled_ms;                   //!< Timestamp of cached sample.
+    rd_sensor_data_fields_t valid;         //!< Valid fields of cached sample, 0 if empty.
+    float values[RT_SENSOR_CACHE_VALUES];  //!< Cached values, in order of sensor fields.
+    uint32_t hits;                         //!< Calls served from cache.
+    uint32_t misses;                       //!< Calls which read sensor.
+} rt_sensor_cache_t;
+
+/**
+ * @brief Set up cache for a sensor.
+ *
+ * @param[out] p_cache Cache to initialize.
+ * @param[in] p_sensor Initialized sensor to cache, must remain valid while cache is used.
+ * @param[in] max_age_ms Maximum age of sample returned from cache. 0 serves
+ *                       only calls within same millisecond.
+ * @retval RD_SUCCESS on success.
+ * @retval RD_ERROR_NULL if any pointer is NULL.
+ * @retval RD_ERROR_NO_MEM if sensor provides more than @ref RT_SENSOR_CACHE_VALUES fields.
+ */
+rd_status_t rt_sensor_cache_init (rt_sensor_cache_t * const p_cache,
+                                  const rd_sensor_t * const p_sensor,
+                                  const uint32_t max_age_ms);
+
+/**
+ * @brief Get data of sensor, from cache if fresh enough.
+ *
+ * Behaves like @ref rd_sensor_data_fp of cached sensor: requested fields which are
+ * not yet valid in p_data are filled and marked valid.
+ *
+ * @param[in,out] p_cache Cache of sensor.
+ * @param[in,out] p_data Data to populate.
+ * @retval RD_SUCCESS on success.
+ * @retval RD_ERROR_NULL if any pointer is NULL.
+ * @retval RD_ERROR_INVALID_STATE if cache has no sensor.
+ * @return Error code from sensor data_get on cache miss.
+ */
+rd_status_t rt_sensor_cache_data_get (rt_sensor_cache_t * const p_cache,
+                                      rd_sensor_data_t * const p_data);
+
+/**
+ * @brief Drop cached sample, e.g. after sensor was reconfigured.
+ *
+ * @param[in,out] p_cache Cache to invalidate.
+ */
+void rt_sensor_cache_invalidate (rt_sensor_cache_t * const p_cache);
+
+/*@}*/
+#endif
@@ -0,0 +1,305 @@
+/**
+ * @addtogroup sensor_tasks
+ */
+/*@{*/
+/**
+ * @file ruuvi_task_sensor_dsp.c
+ * @author Otso Jousimaa <otso@ojousima.net>
+ * @date 2026-10-18
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ *
+ * Values are quantized to int32 steps of resolution, IIR state has 8 fractional bits.
+ */
+#include "ruuvi_driver_enabled_modules.h"
+#if RT_SENSOR_DSP_ENABLED
+#include "ruuvi_driver_error.h"
+#include "ruuvi_driver_sensor.h"
+#include "ruuvi_task_sensor_dsp.h"
+#include <string.h>
+
+#define IIR_FRACTION_BITS (8U)
+#define IIR_ONE           (1L << IIR_FRACTION_BITS)
+#define QUANTIZED_MAX     ((1L << 22U) - 1L)
+
+#define DSP_FUNCTIONS (RD_SENSOR_DSP_LOW_PASS | RD_SENSOR_DSP_HIGH_PASS \
+                       | RD_SENSOR_DSP_OS | RT_SENSOR_DSP_MEDIAN)
+
+static int32_t quantize (const float value, const float resolution)
+{
+    const float steps = value / resolution;
+    int32_t quantized = 0;
+
+    if (steps >= (float) QUANTIZED_MAX)
+    {
+        quantized = (int32_t) QUANTIZED_MAX;
+    }
+    else if (steps <= (float) - QUANTIZED_MAX)
+    {
+        quantized = (int32_t) - QUANTIZED_MAX;
+    }
+    else
+    {
+        quantized = (int32_t) (steps + ( (steps < 0.0F) ? -0.5F : 0.5F));
+    }
+
+    return quantized;
+}
+
+/** @brief Division rounded to nearest, halves away from zero. */
+static int32_t divide_rounded (const int64_t dividend, const int64_t divisor)
+{
+    const int64_t half = divisor / 2;
+    return (int32_t) ( (dividend < 0) ? ( (dividend - half) / divisor) :
+                       ( (dividend + half) / divisor));
+}
+
+static rd_status_t config_check (const rt_sensor_dsp_config_t * const p_config)
+{
+    rd_status_t err_code = RD_SUCCESS;
+    const uint8_t function = p_config->dsp_function;
+    const uint8_t iir = RD_SENSOR_DSP_LOW_PASS | RD_SENSOR_DSP_HIGH_PASS;
+
+    if (0U != (function & ~DSP_FUNCTIONS))
+    {
+        err_code |= RD_ERROR_NOT_SUPPORTED;
+    }
+    else if ( (1 != __builtin_popcount (p_config->field.bitfield))
+              || ! (p_config->resolution > 0.0F)
+              || (iir == (function & iir)))
+    {
+        err_code |= RD_ERROR_INVALID_PARAM;
+    }
+    else if ( (0U != (function & iir))
+              && ( (0U == p_config->iir_shift)
+                   || (RT_SENSOR_DSP_IIR_SHIFT_MAX < p_config->iir_shift)))
+    {
+        err_code |= RD_ERROR_INVALID_PARAM;
+    }
+    else if ( (0U != (function & RD_SENSOR_DSP_OS)) && (2U > p_config->os_samples))
+    {
+        err_code |= RD_ERROR_INVALID_PARAM;
+    }
+    else if ( (0U != (function & RT_SENSOR_DSP_MEDIAN))
+              && ( (3U > p_config->median_window)
+                   || (RT_SENSOR_DSP_MEDIAN_MAX < p_config->median_window)
+                   || (0U == (p_config->median_window & 1U))))
+    {
+        err_code |= RD_ERROR_INVALID_PARAM;
+    }
+    else
+    {
+        // Configuration is valid.
+    }
+
+    return err_code;
+}
+
+/**
+ * @brief Replace oldest sample of median window with new one.
+ *
+ * Sorted copy is updated by one removal and one insertion, at most
+ * RT_SENSOR_DSP_MEDIAN_MAX moves each.
+ */
+static int32_t median_filter (rt_sensor_dsp_stage_t * const p_stage, const int32_t value)
+{
+    const uint8_t window = p_stage->config.median_window;
+    uint8_t count = p_stage->median_count;
+
+    if (window == count)
+    {
+        const int32_t oldest = p_stage->median_ring[p_stage->median_head];
+        uint8_t index = 0;
+
+        while (p_stage->median_sorted[index] != oldest)
+        {
+            index++;
+        }
+
+        for (; (index + 1U) < count; index++)
+        {
+            p_stage->median_sorted[index] = p_stage->median_sorted[index + 1U];
+        }
+
+        count--;
+    }
+
+    uint8_t position = count;
+
+    while ( (position > 0U) && (p_stage->median_sorted[position - 1U] > value))
+    {
+        p_stage->median_sorted[position] = p_stage->median_sorted[position - 1U];
+        position--;
+    }
+
+    p_stage->median_sorted[position] = value;
+    count++;
+    p_stage->median_ring[p_stage->median_head] = value;
+    p_stage->median_head = (uint8_t) ( (p_stage->median_head + 1U) % window);
+    p_stage->median_count = count;
+    return p_stage->median_sorted[ (count - 1U) / 2U];
+}
+
+/** @return true if an oversampled value is ready in p_value. */
+static bool os_filter (rt_sensor_dsp_stage_t * const p_stage, int32_t * const p_value)
+{
+    bool ready = false;
+    p_stage->os_sum += *p_value;
+    p_stage->os_count++;
+
+    if (p_stage->os_count >= p_stage->config.os_samples)
+    {
+        *p_value = divide_rounded (p_stage->os_sum, p_stage->os_count);
+        p_stage->os_sum = 0;
+        p_stage->os_count = 0;
+        ready = true;
+    }
+
+    return ready;
+}
+
+/** @return Low pass output in IIR fixed point. */
+static int32_t iir_filter (rt_sensor_dsp_stage_t * const p_stage, const int32_t value)
+{
+    const int32_t input = value * (int32_t) IIR_ONE;
+
+    if (!p_stage->iir_primed)
+    {
+        p_stage->iir_state = input;
+        p_stage->iir_primed = true;
+    }
+    else
+    {
+        // Full scale step does not fit int32, new state is between old state and input.
+        const int64_t delta = (int64_t) input - (int64_t) p_stage->iir_state;
+        // Division instead of shift, right shift of negative values is implementation-defined.
+        p_stage->iir_state += (int32_t) (delta / (int64_t) (1UL << p_stage->config.iir_shift));
+    }
+
+    return p_stage->iir_state;
+}
+
+static void stage_process (rt_sensor_dsp_stage_t * const p_stage,
+                           rd_sensor_data_t * const p_data)
+{
+    const rt_sensor_dsp_config_t * const p_config = & (p_stage->config);
+    const float resolution = p_config->resolution;
+    int32_t value = quantize (rd_sensor_data_parse (p_data, p_config->field), resolution);
+    int32_t output = value * (int32_t) IIR_ONE;
+    bool ready = true;
+
+    if (0U != (p_config->dsp_function & RT_SENSOR_DSP_MEDIAN))
+    {
+        value = median_filter (p_stage, value);
+        output = value * (int32_t) IIR_ONE;
+    }
+
+    if (0U != (p_config->dsp_function & RD_SENSOR_DSP_OS))
+    {
+        ready = os_filter (p_stage, &value);
+        output = value * (int32_t) IIR_ONE;
+    }
+
+    if (ready && (0U != (p_config->dsp_function & RD_SENSOR_DSP_LOW_PASS)))
+    {
+        output = iir_filter (p_stage, value);
+    }
+    else if (ready && (0U != (p_config->dsp_function & RD_SENSOR_DSP_HIGH_PASS)))
+    {
+        const int64_t low = iir_filter (p_stage, value);
+        output = (int32_t) ( ( (int64_t) value * IIR_ONE) - low);
+    }
+    else
+    {
+        // No IIR, or waiting for oversampled value.
+    }
+
+    if (ready)
+    {
+        rd_sensor_data_set (p_data, p_config->field,
+                            ( (float) output / (float) IIR_ONE) * resolution);
+    }
+    else
+    {
+        rd_sensor_data_set (p_data, p_config->field, RD_FLOAT_INVALID);
+        p_data->valid.bitfield &= ~ (p_config->field.bitfield);
+    }
+}
+
+rd_status_t rt_sensor_dsp_init (rt_sensor_dsp_t * const p_dsp,
+                                const rt_sensor_dsp_config_t * const p_config,
+                                const size_t count)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if ( (NULL == p_dsp) || (NULL == p_config))
+    {
+        err_code |= RD_ERROR_NULL;
+    }
+    else if (RT_SENSOR_DSP_FIELDS < count)
+    {
+        err_code |= RD_ERROR_NO_MEM;
+    }
+    else
+    {
+        for (size_t ii = 0; (ii < count) && (RD_SUCCESS == err_code); ii++)
+        {
+            err_code |= config_check (&p_config[ii]);
+        }
+
+        if (RD_SUCCESS == err_code)
+        {
+            memset (p_dsp, 0, sizeof (rt_sensor_dsp_t));
+
+            for (size_t ii = 0; ii < count; ii++)
+            {
+                p_dsp->stages[ii].config = p_config[ii];
+            }
+
+            p_dsp->stage_count = count;
+        }
+    }
+
+    return err_code;
+}
+
+rd_status_t rt_sensor_dsp_process (rt_sensor_dsp_t * const p_dsp,
+                                   rd_sensor_data_t * const p_data,
+                                   const rd_sensor_data_fields_t fields)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if ( (NULL == p_dsp) || (NULL == p_data))
+    {
+        err_code |= RD_ERROR_NULL;
+    }
+    else
+    {
+        const uint32_t filtered = fields.bitfield & p_data->valid.bitfield;
+
+        for (size_t ii = 0; ii < p_dsp->stage_count; ii++)
+        {
+            if (0U != (filtered & p_dsp->stages[ii].config.field.bitfield))
+            {
+                stage_process (&p_dsp->stages[ii], p_data);
+            }
+        }
+    }
+
+    return err_code;
+}
+
+void rt_sensor_dsp_reset (rt_sensor_dsp_t * const p_dsp)
+{
+    if (NULL != p_dsp)
+    {
+        for (size_t ii = 0; ii < p_dsp->stage_count; ii++)
+        {
+            const rt_sensor_dsp_config_t config = p_dsp->stages[ii].config;
+            memset (&p_dsp->stages[ii], 0, sizeof (rt_sensor_dsp_stage_t));
+            p_dsp->stages[ii].config = config;
+        }
+    }
+}
+
+/*@}*/
+#endif
@@ -0,0 +1,143 @@
+#ifndef RUUVI_TASK_SENSOR_DSP_H
+#define RUUVI_TASK_SENSOR_DSP_H
+/**
+ * @addtogroup sensor_tasks
+ */
+/*@{*/
+/**
+ * @file ruuvi_task_sensor_dsp.h
+ * @author Otso Jousimaa <otso@ojousima.net>
+ * @date 2026-10-18
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ *
+ * @brief Software signal processing of sensor data.
+ *
+ * Sensors support DSP functions only where the chip implements them, e.g. IIR on BME280
+ * and high pass on LIS2DH12. This stage runs the same functions in software on any
+ * field, between data_get and consumer of data.
+ *
+ * Each field is filtered separately, in order:
+ * 1. @ref RT_SENSOR_DSP_MEDIAN removes spikes with a median over last samples.
+ * 2. @ref RD_SENSOR_DSP_OS averages samples, one output per given number of inputs.
+ *    Field is marked invalid on other samples.
+ * 3. @ref RD_SENSOR_DSP_LOW_PASS or @ref RD_SENSOR_DSP_HIGH_PASS, first order IIR with
+ *    coefficient 2^-shift.
+ *
+ * Values are processed in fixed point, quantized to configured resolution.
+ * Values are limited to +- 2^22 resolution steps. Cost per sample is constant,
+ * median is bounded by @ref RT_SENSOR_DSP_MEDIAN_MAX.
+ *
+ * Typical usage:
+ *
+ * @code{.c}
+ *  static rt_sensor_dsp_t env_dsp;
+ *  const rt_sensor_dsp_config_t config[] =
+ *  {
+ *      {
+ *          .field = RD_SENSOR_TEMP_FIELD,
+ *          .dsp_function = RD_SENSOR_DSP_LOW_PASS | RT_SENSOR_DSP_MEDIAN,
+ *          .iir_shift = 3U,
+ *          .median_window = 5U,
+ *          .resolution = 0.01F
+ *      }
+ *  };
+ *  err_code |= rt_sensor_dsp_init (&env_dsp, config, 1U);
+ *  shtcx_ctx.p_dsp = &env_dsp;
+ *  err_code |= rt_sensor_data_get (&shtcx_ctx, &data);
+ * @endcode
+ */
+#include "ruuvi_driver_enabled_modules.h"
+#include "ruuvi_driver_error.h"
+#include "ruuvi_driver_sensor.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifndef RT_SENSOR_DSP_FIELDS
+/** @brief Maximum number of filtered fields in one pipeline. */
+#   define RT_SENSOR_DSP_FIELDS (4U)
+#endif
+
+#ifndef RT_SENSOR_DSP_MEDIAN_MAX
+/** @brief Largest median window, odd. */
+#   define RT_SENSOR_DSP_MEDIAN_MAX (7U)
+#endif
+
+/** @brief Median filter, software only. Parameter: median_window. */
+#define RT_SENSOR_DSP_MEDIAN      (1U << 4U)
+/** @brief Largest IIR shift. */
+#define RT_SENSOR_DSP_IIR_SHIFT_MAX (15U)
+
+/** @brief Filtering of one field. */
+typedef struct
+{
+    rd_sensor_data_fields_t field; //!< Filtered field, exactly one.
+    uint8_t dsp_function;          //!< RD_SENSOR_DSP_* and RT_SENSOR_DSP_MEDIAN flags.
+    uint8_t iir_shift;             //!< Low or high pass coefficient 2^-shift, 1 ... 15.
+    uint8_t os_samples;            //!< Samples per oversampled output, at least 2.
+    uint8_t median_window;         //!< Odd median window, 3 ... RT_SENSOR_DSP_MEDIAN_MAX.
+    float resolution;              //!< Fixed point step, in units of field.
+} rt_sensor_dsp_config_t;
+
+/** @brief State of one field. */
+typedef struct
+{
+    rt_sensor_dsp_config_t config;                    //!< Configuration.
+    int32_t median_ring[RT_SENSOR_DSP_MEDIAN_MAX];    //!< Samples in arrival order.
+    int32_t median_sorted[RT_SENSOR_DSP_MEDIAN_MAX];  //!< Samples in ascending order.
+    uint8_t median_count;                             //!< Samples in median window.
+    uint8_t median_head;                              //!< Oldest sample of ring.
+    int64_t os_sum;                                   //!< Sum of oversampled values.
+    uint8_t os_count;                                 //!< Samples in os_sum.
+    int32_t iir_state;                                //!< Low pass output, Q8 fixed point.
+    bool iir_primed;                                  //!< iir_state has been set.
+} rt_sensor_dsp_stage_t;
+
+/** @brief DSP pipeline. Set up with @ref rt_sensor_dsp_init. */
+typedef struct
+{
+    rt_sensor_dsp_stage_t stages[RT_SENSOR_DSP_FIELDS]; //!< Per-field state.
+    size_t stage_count;                                //!< Number of filtered fields.
+} rt_sensor_dsp_t;
+
+/**
+ * @brief Set up DSP pipeline.
+ *
+ * @param[out] p_dsp Pipeline to initialize.
+ * @param[in] p_config Filtering of fields, copied.
+ * @param[in] count Number of elements in p_config.
+ * @retval RD_SUCCESS on success.
+ * @retval RD_ERROR_NULL if any pointer is NULL.
+ * @retval RD_ERROR_NO_MEM if count is larger than @ref RT_SENSOR_DSP_FIELDS.
+ * @retval RD_ERROR_INVALID_PARAM if a configuration is not one field, sets both low and
+ *                                high pass or has parameter out of range.
+ * @retval RD_ERROR_NOT_SUPPORTED if a configuration has unknown DSP function.
+ */
+rd_status_t rt_sensor_dsp_init (rt_sensor_dsp_t * const p_dsp,
+                                const rt_sensor_dsp_config_t * const p_config,
+                                const size_t count);
+
+/**
+ * @brief Filter valid fields of data in place.
+ *
+ * Fields which are not configured or not valid pass through unchanged.
+ *
+ * @param[in,out] p_dsp Pipeline.
+ * @param[in,out] p_data Data to filter.
+ * @param[in] fields Fields to filter, e.g. fields which were just read.
+ * @retval RD_SUCCESS on success.
+ * @retval RD_ERROR_NULL if any pointer is NULL.
+ */
+rd_status_t rt_sensor_dsp_process (rt_sensor_dsp_t * const p_dsp,
+                                   rd_sensor_data_t * const p_data,
+                                   const rd_sensor_data_fields_t fields);
+
+/**
+ * @brief Clear filter state, e.g. after sensor was reconfigured.
+ *
+ * @param[in,out] p_dsp Pipeline to reset.
+ */
+void rt_sensor_dsp_reset (rt_sensor_dsp_t * const p_dsp);
+
+/*@}*/
+#endif
@@ -0,0 +1,334 @@
+/**
+ * @addtogroup sensor_tasks
+ */
+/*@{*/
+/**
+ * @file ruuvi_task_sensor_fusion.c
+ * @author Otso Jousimaa <otso@ojousima.net>
+ * @date 2026-10-18
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ *
+ * Setters are run on every backend and report the value of highest-priority backend,
+ * getters report the value of highest-priority backend.
+ */
+#include "ruuvi_driver_enabled_modules.h"
+#if RT_SENSOR_FUSION_ENABLED
+#include "ruuvi_driver_error.h"
+#include "ruuvi_driver_sensor.h"
+#include "ruuvi_task_sensor_fusion.h"
+#include <string.h>
+
+/** @brief Setup function of backend. */
+typedef enum
+{
+    SETUP_SAMPLERATE,
+    SETUP_RESOLUTION,
+    SETUP_SCALE,
+    SETUP_MODE
+} fusion_setup_t;
+
+static const char m_sensor_name[] = "FUSION";
+static rd_sensor_t * m_backends[RT_SENSOR_FUSION_BACKENDS];
+static size_t m_backend_count;
+static bool m_is_init;
+
+static rd_sensor_setup_fp setup_fp_get (const rd_sensor_t * const p_backend,
+                                        const fusion_setup_t setup, const bool set)
+{
+    rd_sensor_setup_fp fp = NULL;
+
+    if (SETUP_SAMPLERATE == setup)
+    {
+        fp = set ? p_backend->samplerate_set : p_backend->samplerate_get;
+    }
+    else if (SETUP_RESOLUTION == setup)
+    {
+        fp = set ? p_backend->resolution_set : p_backend->resolution_get;
+    }
+    else if (SETUP_SCALE == setup)
+    {
+        fp = set ? p_backend->scale_set : p_backend->scale_get;
+    }
+    else
+    {
+        fp = set ? p_backend->mode_set : p_backend->mode_get;
+    }
+
+    return fp;
+}
+
+static rd_status_t setup_set_all (const fusion_setup_t setup, uint8_t * const parameter)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if (NULL == parameter)
+    {
+        err_code |= RD_ERROR_NULL;
+    }
+    else
+    {
+        const uint8_t requested = *parameter;
+
+        // Iterate backwards so that highest-priority backend writes the reported value last.
+        for (size_t ii = m_backend_count; ii > 0U; ii--)
+        {
+            *parameter = requested;
+            err_code |= setup_fp_get (m_backends[ii - 1U], setup, true) (parameter);
+        }
+    }
+
+    return err_code;
+}
+
+static rd_status_t setup_get_first (const fusion_setup_t setup, uint8_t * const parameter)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if (NULL == parameter)
+    {
+        err_code |= RD_ERROR_NULL;
+    }
+    else
+    {
+        err_code |= setup_fp_get (m_backends[0], setup, false) (parameter);
+    }
+
+    return err_code;
+}
+
+static rd_status_t fusion_samplerate_set (uint8_t * samplerate)
+{
+    return setup_set_all (SETUP_SAMPLERATE, samplerate);
+}
+
+static rd_status_t fusion_samplerate_get (uint8_t * samplerate)
+{
+    return setup_get_first (SETUP_SAMPLERATE, samplerate);
+}
+
+static rd_status_t fusion_resolution_set (uint8_t * resolution)
+{
+    return setup_set_all (SETUP_RESOLUTION, resolution);
+}
+
+static rd_status_t fusion_resolution_get (uint8_t * resolution)
+{
+    return setup_get_first (SETUP_RESOLUTION, resolution);
+}
+
+static rd_status_t fusion_scale_set (uint8_t * scale)
+{
+    return setup_set_all (SETUP_SCALE, scale);
+}
+
+static rd_status_t fusion_scale_get (uint8_t * scale)
+{
+    return setup_get_first (SETUP_SCALE, scale);
+}
+
+static rd_status_t fusion_mode_set (uint8_t * mode)
+{
+    return setup_set_all (SETUP_MODE, mode);
+}
+
+static rd_status_t fusion_mode_get (uint8_t * mode)
+{
+    return setup_get_first (SETUP_MODE, mode);
+}
+
+static rd_status_t fusion_dsp_set (uint8_t * dsp, uint8_t * parameter)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if ( (NULL == dsp) || (NULL == parameter))
+    {
+        err_code |= RD_ERROR_NULL;
+    }
+    else
+    {
+        const uint8_t requested_dsp = *dsp;
+        const uint8_t requested_parameter = *parameter;
+
+        for (size_t ii = m_backend_count; ii > 0U; ii--)
+        {
+            *dsp = requested_dsp;
+            *parameter = requested_parameter;
+            err_code |= m_backends[ii - 1U]->dsp_set (dsp, parameter);
+        }
+    }
+
+    return err_code;
+}
+
+static rd_status_t fusion_dsp_get (uint8_t * dsp, uint8_t * parameter)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if ( (NULL == dsp) || (NULL == parameter))
+    {
+        err_code |= RD_ERROR_NULL;
+    }
+    else
+    {
+        err_code |= m_backends[0]->dsp_get (dsp, parameter);
+    }
+
+    return err_code;
+}
+
+/**
+ * @brief Read every backend which can still fill a requested field.
+ *
+ * A failing backend does not stop reading others, a lower-priority backend
+ * may provide the same field.
+ */
+static rd_status_t fusion_data_get (rd_sensor_data_t * const p_data)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if (NULL == p_data)
+    {
+        err_code |= RD_ERROR_NULL;
+    }
+    else
+    {
+        for (size_t ii = 0; ii < m_backend_count; ii++)
+        {
+            const rd_sensor_t * const p_backend = m_backends[ii];
+            const uint32_t missing = p_data->fields.bitfield & ~p_data->valid.bitfield;
+
+            if (0U != (missing & p_backend->provides.bitfield))
+            {
+                float values[RT_SENSOR_FUSION_VALUES];
+                rd_sensor_data_t sample = {0};
+                sample.fields = p_backend->provides;
+                sample.data = values;
+
+                for (size_t jj = 0; jj < RT_SENSOR_FUSION_VALUES; jj++)
+                {
+                    values[jj] = RD_FLOAT_INVALID;
+                }
+
+                err_code |= p_backend->data_get (&sample);
+                rd_sensor_data_populate (p_data, &sample, p_data->fields);
+            }
+        }
+    }
+
+    return err_code;
+}
+
+rd_status_t rt_sensor_fusion_backends_set (rd_sensor_t * const * const backends,
+        const size_t count)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if (NULL == backends)
+    {
+        err_code |= RD_ERROR_NULL;
+    }
+    else if ( (0U == count) || (RT_SENSOR_FUSION_BACKENDS < count))
+    {
+        err_code |= RD_ERROR_INVALID_PARAM;
+    }
+    else if (m_is_init)
+    {
+        err_code |= RD_ERROR_INVALID_STATE;
+    }
+    else
+    {
+        for (size_t ii = 0; (ii < count) && (RD_SUCCESS == err_code); ii++)
+        {
+            if (NULL == backends[ii])
+            {
+                err_code |= RD_ERROR_NULL;
+            }
+            else if (!rd_sensor_is_init (backends[ii]))
+            {
+                err_code |= RD_ERROR_INVALID_STATE;
+            }
+            else if (RT_SENSOR_FUSION_VALUES < (uint32_t) __builtin_popcount (
+                         backends[ii]->provides.bitfield))
+            {
+                err_code |= RD_ERROR_NO_MEM;
+            }
+            else
+            {
+                // Backend is valid.
+            }
+        }
+
+        if (RD_SUCCESS == err_code)
+        {
+            memcpy (m_backends, backends, count * sizeof (rd_sensor_t *));
+            m_backend_count = count;
+        }
+    }
+
+    return err_code;
+}
+
+rd_status_t rt_sensor_fusion_init (rd_sensor_t * const p_sensor, const rd_bus_t bus,
+                                   const uint8_t handle)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if (NULL == p_sensor)
+    {
+        err_code |= RD_ERROR_NULL;
+    }
+    else if (m_is_init || (0U == m_backend_count))
+    {
+        err_code |= RD_ERROR_INVALID_STATE;
+    }
+    else
+    {
+        rd_sensor_initialize (p_sensor);
+        p_sensor->name              = m_sensor_name;
+        p_sensor->init              = rt_sensor_fusion_init;
+        p_sensor->uninit            = rt_sensor_fusion_uninit;
+        p_sensor->samplerate_set    = fusion_samplerate_set;
+        p_sensor->samplerate_get    = fusion_samplerate_get;
+        p_sensor->resolution_set    = fusion_resolution_set;
+        p_sensor->resolution_get    = fusion_resolution_get;
+        p_sensor->scale_set         = fusion_scale_set;
+        p_sensor->scale_get         = fusion_scale_get;
+        p_sensor->dsp_set           = fusion_dsp_set;
+        p_sensor->dsp_get           = fusion_dsp_get;
+        p_sensor->mode_set          = fusion_mode_set;
+        p_sensor->mode_get          = fusion_mode_get;
+        p_sensor->data_get          = fusion_data_get;
+        p_sensor->configuration_set = rd_sensor_configuration_set;
+        p_sensor->configuration_get = rd_sensor_configuration_get;
+
+        for (size_t ii = 0; ii < m_backend_count; ii++)
+        {
+            p_sensor->provides.bitfield |= m_backends[ii]->provides.bitfield;
+        }
+
+        m_is_init = true;
+    }
+
+    return err_code;
+}
+
+rd_status_t rt_sensor_fusion_uninit (rd_sensor_t * const p_sensor, const rd_bus_t bus,
+                                     const uint8_t handle)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if (NULL == p_sensor)
+    {
+        err_code |= RD_ERROR_NULL;
+    }
+    else
+    {
+        rd_sensor_uninitialize (p_sensor);
+        m_is_init = false;
+    }
+
+    return err_code;
+}
+
+/*@}*/
+#endif
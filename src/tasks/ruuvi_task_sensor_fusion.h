@@ -0,0 +1,102 @@
+#ifndef RUUVI_TASK_SENSOR_FUSION_H
+#define RUUVI_TASK_SENSOR_FUSION_H
+/**
+ * @addtogroup sensor_tasks
+ */
+/*@{*/
+/**
+ * @file ruuvi_task_sensor_fusion.h
+ * @author Otso Jousimaa <otso@ojousima.net>
+ * @date 2026-10-18
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ *
+ * @brief Virtual sensor which combines fields of several physical sensors.
+ *
+ * Backends are given in priority order. Each field of virtual sensor is taken
+ * from the first backend which provides it and has valid data, so a lower-priority
+ * backend fills in if a higher-priority one fails. All backends are read in one
+ * data_get and merged with @ref rd_sensor_data_populate, application sees one
+ * sensor with one timestamp.
+ *
+ * Configuration calls are applied to every backend. Conversions run concurrently
+ * when backends are in continuous mode, as each sensor converts on its own and
+ * data_get only reads latest results. Single-shot mode triggers backends one
+ * after another.
+ *
+ * rd_sensor_t interface has no context pointer, there is a single virtual sensor.
+ *
+ * Typical usage:
+ *
+ * @code{.c}
+ *  // Humidity from SHTCX, temperature from TMP117, pressure from DPS310.
+ *  static rd_sensor_t * const backends[] =
+ *  {
+ *      &tmp117.sensor, &shtcx.sensor, &dps310.sensor
+ *  };
+ *  rd_sensor_t environmental;
+ *  err_code |= rt_sensor_fusion_backends_set (backends, 3);
+ *  err_code |= rt_sensor_fusion_init (&environmental, RD_BUS_NONE, 0);
+ *  err_code |= environmental.data_get (&data);
+ * @endcode
+ */
+#include "ruuvi_driver_enabled_modules.h"
+#include "ruuvi_driver_error.h"
+#include "ruuvi_driver_sensor.h"
+#include <stddef.h>
+
+#ifndef RT_SENSOR_FUSION_BACKENDS
+/** @brief Maximum number of backends of virtual sensor. */
+#   define RT_SENSOR_FUSION_BACKENDS (4U)
+#endif
+
+#ifndef RT_SENSOR_FUSION_VALUES
+/** @brief Maximum number of fields of one backend. */
+#   define RT_SENSOR_FUSION_VALUES (6U)
+#endif
+
+/**
+ * @brief Set backends of virtual sensor.
+ *
+ * @param[in] backends Initialized sensors in priority order, highest first.
+ *                     Sensors must remain valid while virtual sensor is used.
+ * @param[in] count Number of backends.
+ * @retval RD_SUCCESS on success.
+ * @retval RD_ERROR_NULL if backends or any backend is NULL.
+ * @retval RD_ERROR_INVALID_PARAM if count is 0 or larger than @ref RT_SENSOR_FUSION_BACKENDS.
+ * @retval RD_ERROR_INVALID_STATE if virtual sensor is initialized or a backend is not.
+ * @retval RD_ERROR_NO_MEM if a backend provides more than @ref RT_SENSOR_FUSION_VALUES fields.
+ */
+rd_status_t rt_sensor_fusion_backends_set (rd_sensor_t * const * const backends,
+        const size_t count);
+
+/**
+ * @brief @ref rd_sensor_init_fp for virtual sensor.
+ *
+ * Virtual sensor provides union of fields of its backends.
+ *
+ * @param[out] p_sensor Sensor to initialize.
+ * @param[in] bus Unused, RD_BUS_NONE.
+ * @param[in] handle Unused.
+ * @retval RD_SUCCESS on success.
+ * @retval RD_ERROR_NULL if p_sensor is NULL.
+ * @retval RD_ERROR_INVALID_STATE if no backends are set or virtual sensor is initialized.
+ */
+rd_status_t rt_sensor_fusion_init (rd_sensor_t * const p_sensor, const rd_bus_t bus,
+                                   const uint8_t handle);
+
+/**
+ * @brief @ref rd_sensor_init_fp for virtual sensor.
+ *
+ * Backends are not uninitialized.
+ *
+ * @param[out] p_sensor Sensor to uninitialize.
+ * @param[in] bus Unused, RD_BUS_NONE.
+ * @param[in] handle Unused.
+ * @retval RD_SUCCESS on success.
+ * @retval RD_ERROR_NULL if p_sensor is NULL.
+ */
+rd_status_t rt_sensor_fusion_uninit (rd_sensor_t * const p_sensor, const rd_bus_t bus,
+                                     const uint8_t handle);
+
+/*@}*/
+#endif
@@ -0,0 +1,261 @@
+/**
+ * @addtogroup sensor_tasks
+ */
+/*@{*/
+/**
+ * @file ruuvi_task_sensor_rate.c
+ * @author Otso Jousimaa <otso@ojousima.net>
+ * @date 2026-10-18
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ *
+ * Rate of change of each field is normalized with its threshold, largest
+ * normalized rate decides if signal is active, calm or in between.
+ */
+#include "ruuvi_driver_enabled_modules.h"
+#if RT_SENSOR_RATE_ENABLED
+#include "ruuvi_driver_error.h"
+#include "ruuvi_driver_sensor.h"
+#include "ruuvi_task_sensor_rate.h"
+#include <math.h>
+#include <string.h>
+
+#define MS_PER_S (1000.0F)
+
+static inline bool value_is_valid (const float value)
+{
+    return !isnan (value);
+}
+
+static inline float absolute (const float value)
+{
+    return (value < 0.0F) ? -value : value;
+}
+
+static inline bool timestamp_is_valid (const uint64_t timestamp)
+{
+    return (0U != timestamp) && (RD_SENSOR_INVALID_TIMSTAMP != timestamp);
+}
+
+static rd_status_t rate_apply (const rt_sensor_rate_t * const p_rate)
+{
+    rd_status_t err_code = RD_SUCCESS;
+    uint8_t mode = RD_SENSOR_CFG_SLEEP;
+    // Drivers accept new sample rate only while sleeping.
+    err_code |= p_rate->p_sensor->mode_set (&mode);
+
+    if (RT_SENSOR_RATE_CONTINUOUS_LIMIT_MS > p_rate->interval_ms)
+    {
+        uint8_t samplerate = (uint8_t) (RT_SENSOR_RATE_CONTINUOUS_LIMIT_MS /
+                                        p_rate->interval_ms);
+        err_code |= p_rate->p_sensor->samplerate_set (&samplerate);
+        mode = RD_SENSOR_CFG_CONTINUOUS;
+        err_code |= p_rate->p_sensor->mode_set (&mode);
+    }
+
+    return err_code;
+}
+
+/**
+ * @brief Store followed values of sample for next rate of change.
+ *
+ * @return Largest rate of change relative to threshold, negative if no field
+ *         has two consecutive valid values.
+ */
+static float rate_activity (rt_sensor_rate_t * const p_rate,
+                            const rd_sensor_data_t * const p_data, const float elapsed_s)
+{
+    float activity = -1.0F;
+    uint32_t remaining = p_rate->config.fields.bitfield;
+    size_t index = 0;
+
+    while (0U != remaining)
+    {
+        const rd_sensor_data_fields_t field =
+        {
+            .bitfield = remaining & (~remaining + 1U)
+        };
+        float value = RD_FLOAT_INVALID;
+
+        if (0U != (p_data->valid.bitfield & field.bitfield))
+        {
+            value = rd_sensor_data_parse (p_data, field);
+        }
+
+        if ( (0.0F < elapsed_s) && value_is_valid (value)
+                && value_is_valid (p_rate->previous[index]))
+        {
+            const float change = absolute (value - p_rate->previous[index]) / elapsed_s;
+            const float relative = change / p_rate->config.thresholds[index];
+
+            if (relative > activity)
+            {
+                activity = relative;
+            }
+        }
+
+        p_rate->previous[index] = value;
+        remaining &= (remaining - 1U);
+        index++;
+    }
+
+    return activity;
+}
+
+static uint32_t rate_next_interval (rt_sensor_rate_t * const p_rate, const float activity)
+{
+    uint32_t interval = p_rate->interval_ms;
+
+    if (activity > 1.0F)
+    {
+        p_rate->calm_samples = 0;
+        interval = p_rate->config.min_interval_ms;
+    }
+    else if (activity < p_rate->config.hysteresis)
+    {
+        p_rate->calm_samples++;
+
+        if (p_rate->calm_samples >= p_rate->config.settle_samples)
+        {
+            p_rate->calm_samples = 0;
+            interval = (interval > (p_rate->config.max_interval_ms / 2U)) ?
+                       p_rate->config.max_interval_ms : (interval * 2U);
+        }
+    }
+    else
+    {
+        p_rate->calm_samples = 0;
+    }
+
+    return interval;
+}
+
+rd_status_t rt_sensor_rate_init (rt_sensor_rate_t * const p_rate,
+                                 const rd_sensor_t * const p_sensor,
+                                 const rt_sensor_rate_config_t * const p_config)
+{
+    rd_status_t err_code = RD_SUCCESS;
+    const size_t field_count = (NULL == p_config) ? 0U :
+                               (size_t) __builtin_popcount (p_config->fields.bitfield);
+
+    if ( (NULL == p_rate) || (NULL == p_sensor) || (NULL == p_config))
+    {
+        err_code |= RD_ERROR_NULL;
+    }
+    else if ( (RT_SENSOR_RATE_MIN_INTERVAL_MS > p_config->min_interval_ms)
+              || (p_config->min_interval_ms > p_config->max_interval_ms)
+              || ! (p_config->hysteresis >= 0.0F) || (p_config->hysteresis > 1.0F))
+    {
+        err_code |= RD_ERROR_INVALID_PARAM;
+    }
+    else if (RT_SENSOR_RATE_FIELDS < field_count)
+    {
+        err_code |= RD_ERROR_NO_MEM;
+    }
+    else if ( (0U == field_count)
+              || (p_config->fields.bitfield != (p_config->fields.bitfield
+                      & p_sensor->provides.bitfield)))
+    {
+        err_code |= RD_ERROR_NOT_SUPPORTED;
+    }
+    else
+    {
+        for (size_t ii = 0; ii < field_count; ii++)
+        {
+            if (! (p_config->thresholds[ii] > 0.0F))
+            {
+                err_code |= RD_ERROR_INVALID_PARAM;
+            }
+        }
+
+        if (RD_SUCCESS == err_code)
+        {
+            memset (p_rate, 0, sizeof (rt_sensor_rate_t));
+            p_rate->p_sensor = p_sensor;
+            p_rate->config = *p_config;
+            p_rate->interval_ms = p_config->max_interval_ms;
+
+            for (size_t ii = 0; ii < RT_SENSOR_RATE_FIELDS; ii++)
+            {
+                p_rate->previous[ii] = RD_FLOAT_INVALID;
+            }
+
+            err_code |= rate_apply (p_rate);
+        }
+    }
+
+    return err_code;
+}
+
+rd_status_t rt_sensor_rate_update (rt_sensor_rate_t * const p_rate,
+                                   const rd_sensor_data_t * const p_data)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if ( (NULL == p_rate) || (NULL == p_data) || (NULL == p_rate->p_sensor))
+    {
+        err_code |= RD_ERROR_NULL;
+    }
+    else
+    {
+        const uint64_t now = p_data->timestamp_ms;
+        float elapsed_s = 0.0F;
+
+        if (timestamp_is_valid (now) && timestamp_is_valid (p_rate->previous_ms)
+                && (now > p_rate->previous_ms))
+        {
+            elapsed_s = (float) (now - p_rate->previous_ms) / MS_PER_S;
+        }
+
+        const float activity = rate_activity (p_rate, p_data, elapsed_s);
+        p_rate->previous_ms = timestamp_is_valid (now) ? now : 0U;
+
+        if (activity >= 0.0F)
+        {
+            const uint32_t interval = rate_next_interval (p_rate, activity);
+
+            if (interval != p_rate->interval_ms)
+            {
+                p_rate->interval_ms = interval;
+                err_code |= rate_apply (p_rate);
+            }
+        }
+    }
+
+    return err_code;
+}
+
+rd_status_t rt_sensor_rate_sample (rt_sensor_rate_t * const p_rate,
+                                   rd_sensor_data_t * const p_data)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if ( (NULL == p_rate) || (NULL == p_data) || (NULL == p_rate->p_sensor))
+    {
+        err_code |= RD_ERROR_NULL;
+    }
+    else
+    {
+        if (RT_SENSOR_RATE_CONTINUOUS_LIMIT_MS <= p_rate->interval_ms)
+        {
+            uint8_t mode = RD_SENSOR_CFG_SINGLE;
+            err_code |= p_rate->p_sensor->mode_set (&mode);
+        }
+
+        err_code |= p_rate->p_sensor->data_get (p_data);
+
+        if (RD_SUCCESS == err_code)
+        {
+            err_code |= rt_sensor_rate_update (p_rate, p_data);
+        }
+    }
+
+    return err_code;
+}
+
+uint32_t rt_sensor_rate_interval_get (const rt_sensor_rate_t * const p_rate)
+{
+    return (NULL == p_rate) ? 0U : p_rate->interval_ms;
+}
+
+/*@}*/
+#endif
@@ -0,0 +1,143 @@
+#ifndef RUUVI_TASK_SENSOR_RATE_H
+#define RUUVI_TASK_SENSOR_RATE_H
+/**
+ * @addtogroup sensor_tasks
+ */
+/*@{*/
+/**
+ * @file ruuvi_task_sensor_rate.h
+ * @author Otso Jousimaa <otso@ojousima.net>
+ * @date 2026-10-18
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ *
+ * @brief Adapt sampling interval of a sensor to rate of change of its data.
+ *
+ * Controller follows rate of change of configured fields between consecutive
+ * samples. Each field has a threshold in units per second, for example 0.1 C/s for
+ * temperature or 2 g/s for acceleration.
+ *
+ * - If any field changes faster than its threshold, interval drops to minimum at once.
+ * - If every field changes slower than hysteresis * threshold for settle_samples
+ *   consecutive samples, interval is doubled up to maximum.
+ * - Otherwise interval is kept.
+ *
+ * Intervals shorter than 1 s run sensor in continuous mode at matching sample rate,
+ * longer intervals put sensor to sleep and application takes single samples
+ * with @ref rt_sensor_rate_sample every @ref rt_sensor_rate_interval_get milliseconds.
+ *
+ * @ref rt_sensor_rate_update accepts any sample, so controller can be driven
+ * with recorded traces.
+ *
+ * Typical usage:
+ *
+ * @code{.c}
+ *  static rt_sensor_rate_t env_rate;
+ *  const rt_sensor_rate_config_t env_config =
+ *  {
+ *      .min_interval_ms = 1000U,
+ *      .max_interval_ms = 64000U,
+ *      .settle_samples = 3U,
+ *      .hysteresis = 0.5F,
+ *      .fields = { .bitfield = RD_SENSOR_TEMP_FIELD.bitfield | RD_SENSOR_HUMI_FIELD.bitfield },
+ *      .thresholds = { 1.0F, 0.05F } // In order of fields bits: humidity, temperature.
+ *  };
+ *  err_code |= rt_sensor_rate_init (&env_rate, &bme280, &env_config);
+ *  // In timer callback, rescheduled every rt_sensor_rate_interval_get (&env_rate) ms:
+ *  err_code |= rt_sensor_rate_sample (&env_rate, &data);
+ * @endcode
+ */
+#include "ruuvi_driver_enabled_modules.h"
+#include "ruuvi_driver_error.h"
+#include "ruuvi_driver_sensor.h"
+#include <stdint.h>
+
+#ifndef RT_SENSOR_RATE_FIELDS
+/** @brief Maximum number of fields followed by one controller. */
+#   define RT_SENSOR_RATE_FIELDS (4U)
+#endif
+
+/** @brief Shortest interval in continuous mode, 200 Hz. */
+#define RT_SENSOR_RATE_MIN_INTERVAL_MS (5U)
+/** @brief Intervals below this run sensor in continuous mode. */
+#define RT_SENSOR_RATE_CONTINUOUS_LIMIT_MS (1000U)
+
+/** @brief Configuration of controller. */
+typedef struct
+{
+    uint32_t min_interval_ms;              //!< Interval when signal changes.
+    uint32_t max_interval_ms;              //!< Interval when signal is stable.
+    uint8_t settle_samples;                //!< Calm samples before interval is doubled.
+    float hysteresis;                      //!< Fraction of threshold considered calm, 0 ... 1.
+    rd_sensor_data_fields_t fields;        //!< Fields to follow.
+    float thresholds[RT_SENSOR_RATE_FIELDS]; //!< Change per second, in order of field bits.
+} rt_sensor_rate_config_t;
+
+/** @brief State of controller. Set up with @ref rt_sensor_rate_init. */
+typedef struct
+{
+    const rd_sensor_t * p_sensor;          //!< Controlled sensor.
+    rt_sensor_rate_config_t config;        //!< Configuration.
+    uint32_t interval_ms;                  //!< Current interval.
+    uint8_t calm_samples;                  //!< Consecutive calm samples.
+    uint64_t previous_ms;                  //!< Timestamp of previous sample, 0 if none.
+    float previous[RT_SENSOR_RATE_FIELDS]; //!< Previous values, in order of field bits.
+} rt_sensor_rate_t;
+
+/**
+ * @brief Set up controller and apply maximum interval to sensor.
+ *
+ * @param[out] p_rate Controller to initialize.
+ * @param[in] p_sensor Initialized sensor, must remain valid while controller is used.
+ * @param[in] p_config Configuration, copied.
+ * @retval RD_SUCCESS on success.
+ * @retval RD_ERROR_NULL if any pointer is NULL.
+ * @retval RD_ERROR_INVALID_PARAM if intervals are out of order or shorter than
+ *                                @ref RT_SENSOR_RATE_MIN_INTERVAL_MS, hysteresis is
+ *                                not within 0 ... 1 or a threshold is not positive.
+ * @retval RD_ERROR_NO_MEM if more than @ref RT_SENSOR_RATE_FIELDS fields are followed.
+ * @retval RD_ERROR_NOT_SUPPORTED if sensor does not provide followed fields.
+ * @return Error code from sensor if configuration fails.
+ */
+rd_status_t rt_sensor_rate_init (rt_sensor_rate_t * const p_rate,
+                                 const rd_sensor_t * const p_sensor,
+                                 const rt_sensor_rate_config_t * const p_config);
+
+/**
+ * @brief Feed a sample to controller and reconfigure sensor if interval changes.
+ *
+ * Samples without valid timestamp or older than previous sample only
+ * restart rate of change calculation.
+ *
+ * @param[in,out] p_rate Controller.
+ * @param[in] p_data Sample of sensor.
+ * @retval RD_SUCCESS on success.
+ * @retval RD_ERROR_NULL if any pointer is NULL.
+ * @return Error code from sensor if configuration fails.
+ */
+rd_status_t rt_sensor_rate_update (rt_sensor_rate_t * const p_rate,
+                                   const rd_sensor_data_t * const p_data);
+
+/**
+ * @brief Read sensor and feed result to controller.
+ *
+ * Triggers a single measurement if sensor is not in continuous mode.
+ *
+ * @param[in,out] p_rate Controller.
+ * @param[in,out] p_data Data to populate, as in @ref rd_sensor_data_fp.
+ * @retval RD_SUCCESS on success.
+ * @retval RD_ERROR_NULL if any pointer is NULL.
+ * @return Error code from sensor.
+ */
+rd_status_t rt_sensor_rate_sample (rt_sensor_rate_t * const p_rate,
+                                   rd_sensor_data_t * const p_data);
+
+/**
+ * @brief Get current sampling interval.
+ *
+ * @param[in] p_rate Controller.
+ * @return Interval in milliseconds, 0 if p_rate is NULL.
+ */
+uint32_t rt_sensor_rate_interval_get (const rt_sensor_rate_t * const p_rate);
+
+/*@}*/
+#endif
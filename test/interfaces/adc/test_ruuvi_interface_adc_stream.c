@@ -0,0 +1,168 @@
+#include "unity.h"
+
+#include "ruuvi_driver_enabled_modules.h"
+#include "ruuvi_driver_error.h"
+#include "ruuvi_interface_adc_stream.h"
+
+#include <string.h>
+
+#define CHANNELS      (2U)
+#define BLOCK_SAMPLES (4U)
+
+static const ri_adc_stream_limits_t m_limits =
+{
+    .max_scan_us = 12U,
+    .max_block = 8U
+};
+
+static int16_t m_buffer[2U * BLOCK_SAMPLES];
+static const int16_t * m_block;
+static size_t m_block_samples;
+static uint32_t m_blocks;
+static bool m_stop_in_callback;
+
+static void on_block (const int16_t * const p_samples, const size_t num_samples)
+{
+    m_block = p_samples;
+    m_block_samples = num_samples;
+    m_blocks++;
+
+    if (m_stop_in_callback)
+    {
+        ri_adc_stream_close();
+    }
+}
+
+static ri_adc_stream_config_t m_config;
+
+void setUp (void)
+{
+    m_block = NULL;
+    m_block_samples = 0;
+    m_blocks = 0;
+    m_stop_in_callback = false;
+    m_config.samplerate_hz = 100U;
+    m_config.p_buffer = m_buffer;
+    m_config.block_samples = BLOCK_SAMPLES;
+    m_config.callback = &on_block;
+}
+
+void tearDown (void)
+{
+    ri_adc_stream_close();
+}
+
+void test_ri_adc_stream_open_ok (void)
+{
+    TEST_ASSERT_FALSE (ri_adc_stream_is_running());
+    TEST_ASSERT (RD_SUCCESS == ri_adc_stream_open (&m_config, CHANNELS, &m_limits));
+    TEST_ASSERT (ri_adc_stream_is_running());
+    ri_adc_stream_close();
+    TEST_ASSERT_FALSE (ri_adc_stream_is_running());
+}
+
+void test_ri_adc_stream_open_null (void)
+{
+    TEST_ASSERT (RD_ERROR_NULL == ri_adc_stream_open (NULL, CHANNELS, &m_limits));
+    TEST_ASSERT (RD_ERROR_NULL == ri_adc_stream_open (&m_config, CHANNELS, NULL));
+    m_config.callback = NULL;
+    TEST_ASSERT (RD_ERROR_NULL == ri_adc_stream_open (&m_config, CHANNELS, &m_limits));
+    m_config.callback = &on_block;
+    m_config.p_buffer = NULL;
+    TEST_ASSERT (RD_ERROR_NULL == ri_adc_stream_open (&m_config, CHANNELS, &m_limits));
+    TEST_ASSERT_FALSE (ri_adc_stream_is_running());
+}
+
+void test_ri_adc_stream_open_invalid_state (void)
+{
+    TEST_ASSERT (RD_ERROR_INVALID_STATE == ri_adc_stream_open (&m_config, 0U, &m_limits));
+    TEST_ASSERT (RD_SUCCESS == ri_adc_stream_open (&m_config, CHANNELS, &m_limits));
+    TEST_ASSERT (RD_ERROR_INVALID_STATE == ri_adc_stream_open (&m_config, CHANNELS,
+                 &m_limits));
+}
+
+void test_ri_adc_stream_open_invalid_param (void)
+{
+    m_config.samplerate_hz = 0U;
+    TEST_ASSERT (RD_ERROR_INVALID_PARAM == ri_adc_stream_open (&m_config, CHANNELS,
+                 &m_limits));
+    // 2 channels take 24 us, 41666 scans per second at most.
+    m_config.samplerate_hz = 41667U;
+    TEST_ASSERT (RD_ERROR_INVALID_PARAM == ri_adc_stream_open (&m_config, CHANNELS,
+                 &m_limits));
+    m_config.samplerate_hz = 41666U;
+    m_config.block_samples = 3U;
+    TEST_ASSERT (RD_ERROR_INVALID_PARAM == ri_adc_stream_open (&m_config, CHANNELS,
+                 &m_limits));
+    m_config.block_samples = 10U;
+    TEST_ASSERT (RD_ERROR_INVALID_PARAM == ri_adc_stream_open (&m_config, CHANNELS,
+                 &m_limits));
+    m_config.block_samples = 0U;
+    TEST_ASSERT (RD_ERROR_INVALID_PARAM == ri_adc_stream_open (&m_config, CHANNELS,
+                 &m_limits));
+    TEST_ASSERT_FALSE (ri_adc_stream_is_running());
+    m_config.block_samples = BLOCK_SAMPLES;
+    TEST_ASSERT (RD_SUCCESS == ri_adc_stream_open (&m_config, CHANNELS, &m_limits));
+}
+
+void test_ri_adc_stream_blocks_alternate (void)
+{
+    ri_adc_stream_stats_t stats = { 0 };
+    TEST_ASSERT (RD_SUCCESS == ri_adc_stream_open (&m_config, CHANNELS, &m_limits));
+
+    for (uint8_t ii = 0; ii < 4U; ii++)
+    {
+        int16_t * const p_half = &m_buffer[ (ii % 2U) * BLOCK_SAMPLES];
+        TEST_ASSERT (ri_adc_stream_block_done (p_half, BLOCK_SAMPLES));
+        TEST_ASSERT (p_half == m_block);
+        TEST_ASSERT_EQUAL (BLOCK_SAMPLES, m_block_samples);
+    }
+
+    TEST_ASSERT (RD_SUCCESS == ri_adc_stream_stats_get (&stats));
+    TEST_ASSERT_EQUAL (4U, stats.blocks);
+    TEST_ASSERT_EQUAL (0U, stats.out_of_order);
+}
+
+void test_ri_adc_stream_block_out_of_order (void)
+{
+    int16_t other[BLOCK_SAMPLES];
+    ri_adc_stream_stats_t stats = { 0 };
+    TEST_ASSERT (RD_SUCCESS == ri_adc_stream_open (&m_config, CHANNELS, &m_limits));
+    // Second half before first, foreign buffer and partial block are not queued again.
+    TEST_ASSERT_FALSE (ri_adc_stream_block_done (&m_buffer[BLOCK_SAMPLES], BLOCK_SAMPLES));
+    TEST_ASSERT_FALSE (ri_adc_stream_block_done (other, BLOCK_SAMPLES));
+    TEST_ASSERT_FALSE (ri_adc_stream_block_done (m_buffer, BLOCK_SAMPLES - 1U));
+    TEST_ASSERT_EQUAL (0U, m_blocks);
+    TEST_ASSERT (ri_adc_stream_block_done (m_buffer, BLOCK_SAMPLES));
+    TEST_ASSERT (RD_SUCCESS == ri_adc_stream_stats_get (&stats));
+    TEST_ASSERT_EQUAL (1U, stats.blocks);
+    TEST_ASSERT_EQUAL (3U, stats.out_of_order);
+    TEST_ASSERT (RD_ERROR_NULL == ri_adc_stream_stats_get (NULL));
+}
+
+void test_ri_adc_stream_block_after_close (void)
+{
+    TEST_ASSERT (RD_SUCCESS == ri_adc_stream_open (&m_config, CHANNELS, &m_limits));
+    ri_adc_stream_close();
+    TEST_ASSERT_FALSE (ri_adc_stream_block_done (m_buffer, BLOCK_SAMPLES));
+    TEST_ASSERT_EQUAL (0U, m_blocks);
+}
+
+void test_ri_adc_stream_stop_in_callback (void)
+{
+    m_stop_in_callback = true;
+    TEST_ASSERT (RD_SUCCESS == ri_adc_stream_open (&m_config, CHANNELS, &m_limits));
+    TEST_ASSERT_FALSE (ri_adc_stream_block_done (m_buffer, BLOCK_SAMPLES));
+    TEST_ASSERT_EQUAL (1U, m_blocks);
+    TEST_ASSERT_FALSE (ri_adc_stream_block_done (&m_buffer[BLOCK_SAMPLES], BLOCK_SAMPLES));
+    TEST_ASSERT_EQUAL (1U, m_blocks);
+}
+
+void test_ri_adc_stream_reopen_restarts_at_first_half (void)
+{
+    TEST_ASSERT (RD_SUCCESS == ri_adc_stream_open (&m_config, CHANNELS, &m_limits));
+    TEST_ASSERT (ri_adc_stream_block_done (m_buffer, BLOCK_SAMPLES));
+    ri_adc_stream_close();
+    TEST_ASSERT (RD_SUCCESS == ri_adc_stream_open (&m_config, CHANNELS, &m_limits));
+    TEST_ASSERT (ri_adc_stream_block_done (m_buffer, BLOCK_SAMPLES));
+}
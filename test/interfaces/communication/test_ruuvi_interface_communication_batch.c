@@ -0,0 +1,364 @@
+#include "unity.h"
+
+#include "ruuvi_driver_enabled_modules.h"
+#include "ruuvi_driver_error.h"
+#include "ruuvi_interface_communication_batch.h"
+#include "ruuvi_interface_communication_tx_gate.h"
+#include "mock_ruuvi_interface_atomic.h"
+
+#include <string.h>
+
+#define FRAME_STX         (0x02U)
+#define FRAME_ETX         (0x03U)
+#define FRAME_OVERHEAD    (5U) //!< STX, id, length, ETX.
+#define STRESS_ROUNDS     (20000U)
+#define STRESS_MESSAGES   (STRESS_ROUNDS * 2U)
+
+static uint8_t m_sent[RI_COMM_BATCH_SIZE];
+static size_t m_sent_length;
+static uint32_t m_send_calls;
+static uint32_t m_arm_calls;
+static bool m_in_flight;
+static uint32_t m_double_sends;
+static rd_status_t m_send_status;
+static bool m_preempt;
+static bool m_in_isr;
+static uint32_t m_seed;
+static uint16_t m_next_id;
+static uint8_t m_accepted[STRESS_MESSAGES];
+static uint8_t m_received[STRESS_MESSAGES];
+static uint32_t m_frame_errors;
+static uint16_t m_last_thread_id;
+static uint16_t m_last_isr_id;
+
+static uint32_t rand_next (void)
+{
+    m_seed = (m_seed * 1103515245U) + 12345U;
+    return (m_seed >> 16U) & 0x7FFFU;
+}
+
+static void simulated_isr (void);
+
+/** @brief Interrupt may preempt caller here. */
+static void preemption_point (void)
+{
+    if (m_preempt && !m_in_isr && (0U == (rand_next() % 3U)))
+    {
+        m_in_isr = true;
+        simulated_isr();
+        m_in_isr = false;
+    }
+}
+
+static bool atomic_flag_fake (ri_atomic_t * const flag, const bool set,
+                              int cmock_num_calls)
+{
+    bool success = false;
+    preemption_point();
+
+    if (*flag != set)
+    {
+        *flag = set;
+        success = true;
+    }
+
+    preemption_point();
+    return success;
+}
+
+/** @brief Parse frames of a batch, a batch must hold only whole frames. */
+static void parse_batch (const uint8_t * const p_data, const size_t length)
+{
+    size_t pos = 0;
+
+    while (pos < length)
+    {
+        const size_t frame_length = FRAME_OVERHEAD + p_data[pos + 3U];
+        const uint16_t id = (uint16_t) (p_data[pos + 1U] | (p_data[pos + 2U] << 8U));
+
+        if ( (FRAME_STX != p_data[pos]) || ( (pos + frame_length) > length)
+                || (FRAME_ETX != p_data[pos + frame_length - 1U]) || (STRESS_MESSAGES <= id))
+        {
+            m_frame_errors++;
+            break;
+        }
+
+        m_received[id]++;
+        pos += frame_length;
+    }
+}
+
+static rd_status_t send_batch (const uint8_t * const p_data, const size_t length)
+{
+    if (m_in_flight)
+    {
+        m_double_sends++;
+    }
+
+    m_send_calls++;
+
+    if (RD_SUCCESS == m_send_status)
+    {
+        memcpy (m_sent, p_data, length);
+        m_sent_length = length;
+        parse_batch (p_data, length);
+        m_in_flight = true;
+        preemption_point();
+    }
+
+    return m_send_status;
+}
+
+static void arm_flush (void)
+{
+    m_arm_calls++;
+}
+
+static void tx_done (void)
+{
+    if (m_in_flight)
+    {
+        m_in_flight = false;
+        (void) ri_comm_batch_done();
+    }
+}
+
+/** @brief Build frame with given id and payload length. */
+static size_t frame (uint8_t * const p_frame, const uint16_t id, const uint8_t payload)
+{
+    p_frame[0] = FRAME_STX;
+    p_frame[1] = (uint8_t) (id & 0xFFU);
+    p_frame[2] = (uint8_t) (id >> 8U);
+    p_frame[3] = payload;
+    memset (&p_frame[4], 0xA5, payload);
+    p_frame[4U + payload] = FRAME_ETX;
+    return FRAME_OVERHEAD + payload;
+}
+
+/** @brief Append a frame with next id, return true if it was accepted. */
+static bool append_next (uint16_t * const p_id)
+{
+    uint8_t data[RI_COMM_MESSAGE_MAX_LENGTH];
+    const uint8_t payload = (uint8_t) (rand_next() % (RI_COMM_MESSAGE_MAX_LENGTH -
+                                       FRAME_OVERHEAD + 1U));
+    const uint16_t id = m_next_id++;
+    const size_t length = frame (data, id, payload);
+    const rd_status_t err_code = ri_comm_batch_append (data, length);
+    TEST_ASSERT ( (RD_SUCCESS == err_code) || (RD_ERROR_NO_MEM == err_code)
+                  || (RD_ERROR_BUSY == err_code));
+
+    if (RD_SUCCESS == err_code)
+    {
+        m_accepted[id]++;
+    }
+
+    *p_id = id;
+    return (RD_SUCCESS == err_code);
+}
+
+/** @brief Transfer done, flush timer or scan report from interrupt. */
+static void simulated_isr (void)
+{
+    const uint32_t event = rand_next() % 3U;
+    uint16_t id = 0;
+
+    if (0U == event)
+    {
+        tx_done();
+    }
+    else if (1U == event)
+    {
+        (void) ri_comm_batch_flush();
+    }
+    else if (append_next (&id))
+    {
+        TEST_ASSERT ( (0U == m_last_isr_id) || (id > m_last_isr_id));
+        m_last_isr_id = id;
+    }
+    else
+    {
+        // Message rejected, counted as not accepted.
+    }
+}
+
+void setUp (void)
+{
+    ri_atomic_flag_StubWithCallback (&atomic_flag_fake);
+    TEST_ASSERT (RD_SUCCESS == ri_comm_batch_init (send_batch, arm_flush));
+    memset (m_sent, 0, sizeof (m_sent));
+    memset (m_accepted, 0, sizeof (m_accepted));
+    memset (m_received, 0, sizeof (m_received));
+    m_sent_length = 0;
+    m_send_calls = 0;
+    m_arm_calls = 0;
+    m_in_flight = false;
+    m_double_sends = 0;
+    m_send_status = RD_SUCCESS;
+    m_preempt = false;
+    m_in_isr = false;
+    m_next_id = 0;
+    m_frame_errors = 0;
+    m_last_thread_id = 0;
+    m_last_isr_id = 0;
+}
+
+void tearDown (void)
+{
+}
+
+void test_ri_comm_batch_init_null (void)
+{
+    TEST_ASSERT (RD_ERROR_NULL == ri_comm_batch_init (NULL, arm_flush));
+}
+
+void test_ri_comm_batch_append_errors (void)
+{
+    uint8_t data[RI_COMM_BATCH_SIZE + 1U] = { 0 };
+    ri_comm_batch_stats_t stats = { 0 };
+    TEST_ASSERT (RD_ERROR_NULL == ri_comm_batch_append (NULL, 1U));
+    TEST_ASSERT (RD_ERROR_INVALID_LENGTH == ri_comm_batch_append (data, 0U));
+    TEST_ASSERT (RD_ERROR_INVALID_LENGTH == ri_comm_batch_append (data,
+                 RI_COMM_BATCH_SIZE + 1U));
+    TEST_ASSERT (RD_ERROR_NULL == ri_comm_batch_stats_get (NULL));
+    TEST_ASSERT (RD_SUCCESS == ri_comm_batch_stats_get (&stats));
+    TEST_ASSERT_EQUAL (0U, stats.messages);
+    TEST_ASSERT (RD_ERROR_INVALID_STATE == ri_comm_batch_done());
+}
+
+void test_ri_comm_batch_flush_sends_partial (void)
+{
+    uint8_t first[8];
+    uint8_t second[8];
+    const size_t first_length = frame (first, 1U, 2U);
+    const size_t second_length = frame (second, 2U, 3U);
+    TEST_ASSERT (RD_SUCCESS == ri_comm_batch_append (first, first_length));
+    TEST_ASSERT (RD_SUCCESS == ri_comm_batch_append (second, second_length));
+    // Waiting for more messages or flush timer.
+    TEST_ASSERT_EQUAL (0U, m_send_calls);
+    TEST_ASSERT_EQUAL (1U, m_arm_calls);
+    TEST_ASSERT (ri_comm_batch_is_busy());
+    TEST_ASSERT (RD_SUCCESS == ri_comm_batch_flush());
+    TEST_ASSERT_EQUAL (1U, m_send_calls);
+    TEST_ASSERT_EQUAL (first_length + second_length, m_sent_length);
+    TEST_ASSERT_EQUAL_MEMORY (first, m_sent, first_length);
+    TEST_ASSERT_EQUAL_MEMORY (second, &m_sent[first_length], second_length);
+    tx_done();
+    TEST_ASSERT_FALSE (ri_comm_batch_is_busy());
+    // Nothing buffered, flush does not send.
+    TEST_ASSERT (RD_SUCCESS == ri_comm_batch_flush());
+    TEST_ASSERT_EQUAL (1U, m_send_calls);
+}
+
+void test_ri_comm_batch_full_buffer_sent_and_double_buffered (void)
+{
+    uint8_t data[RI_COMM_MESSAGE_MAX_LENGTH];
+    const size_t length = frame (data, 0U, RI_COMM_MESSAGE_MAX_LENGTH - FRAME_OVERHEAD);
+    const uint32_t per_batch = RI_COMM_BATCH_SIZE / RI_COMM_MESSAGE_MAX_LENGTH;
+    ri_comm_batch_stats_t stats = { 0 };
+
+    for (uint32_t ii = 0; ii < per_batch; ii++)
+    {
+        TEST_ASSERT (RD_SUCCESS == ri_comm_batch_append (data, length));
+    }
+
+    // First buffer went out as one transfer once it could not hold another message.
+    TEST_ASSERT_EQUAL (1U, m_send_calls);
+    TEST_ASSERT_EQUAL (per_batch * length, m_sent_length);
+
+    // Second buffer fills while first is sent.
+    for (uint32_t ii = 0; ii < per_batch; ii++)
+    {
+        TEST_ASSERT (RD_SUCCESS == ri_comm_batch_append (data, length));
+    }
+
+    TEST_ASSERT (RD_ERROR_NO_MEM == ri_comm_batch_append (data, length));
+    TEST_ASSERT_EQUAL (1U, m_send_calls);
+    tx_done();
+    TEST_ASSERT_EQUAL (2U, m_send_calls);
+    TEST_ASSERT (RD_SUCCESS == ri_comm_batch_append (data, length));
+    TEST_ASSERT (RD_SUCCESS == ri_comm_batch_stats_get (&stats));
+    TEST_ASSERT_EQUAL (2U * per_batch + 1U, stats.messages);
+    TEST_ASSERT_EQUAL (2U, stats.batches);
+    TEST_ASSERT_EQUAL (1U, stats.dropped);
+}
+
+void test_ri_comm_batch_flush_while_sending_waits (void)
+{
+    uint8_t data[8];
+    const size_t length = frame (data, 0U, 3U);
+    TEST_ASSERT (RD_SUCCESS == ri_comm_batch_append (data, length));
+    TEST_ASSERT (RD_SUCCESS == ri_comm_batch_flush());
+    TEST_ASSERT (RD_SUCCESS == ri_comm_batch_append (data, length));
+    TEST_ASSERT (RD_SUCCESS == ri_comm_batch_flush());
+    TEST_ASSERT_EQUAL (1U, m_send_calls);
+    tx_done();
+    TEST_ASSERT_EQUAL (2U, m_send_calls);
+    TEST_ASSERT_EQUAL (length, m_sent_length);
+}
+
+void test_ri_comm_batch_send_error_drops_buffer (void)
+{
+    uint8_t data[8];
+    const size_t length = frame (data, 0U, 3U);
+    ri_comm_batch_stats_t stats = { 0 };
+    m_send_status = RD_ERROR_INTERNAL;
+    TEST_ASSERT (RD_SUCCESS == ri_comm_batch_append (data, length));
+    TEST_ASSERT (RD_ERROR_INTERNAL == ri_comm_batch_flush());
+    TEST_ASSERT_FALSE (ri_comm_batch_is_busy());
+    m_send_status = RD_SUCCESS;
+    TEST_ASSERT (RD_SUCCESS == ri_comm_batch_append (data, length));
+    TEST_ASSERT (RD_SUCCESS == ri_comm_batch_flush());
+    TEST_ASSERT_EQUAL (length, m_sent_length);
+    TEST_ASSERT (RD_SUCCESS == ri_comm_batch_stats_get (&stats));
+    TEST_ASSERT_EQUAL (1U, stats.failed);
+    TEST_ASSERT_EQUAL (1U, stats.batches);
+}
+
+void test_ri_comm_batch_stress_interleaved (void)
+{
+    uint32_t accepted = 0;
+    uint32_t received = 0;
+    m_seed = 12345U;
+    m_preempt = true;
+
+    for (uint32_t round = 0; round < STRESS_ROUNDS; round++)
+    {
+        uint16_t id = 0;
+
+        if (0U == (rand_next() % 2U))
+        {
+            if (append_next (&id))
+            {
+                TEST_ASSERT ( (0U == m_last_thread_id) || (id > m_last_thread_id));
+                m_last_thread_id = id;
+            }
+        }
+        else
+        {
+            m_in_isr = true;
+            simulated_isr();
+            m_in_isr = false;
+        }
+    }
+
+    m_preempt = false;
+
+    while (ri_comm_batch_is_busy())
+    {
+        (void) ri_comm_batch_flush();
+        tx_done();
+    }
+
+    for (uint32_t ii = 0; ii < m_next_id; ii++)
+    {
+        TEST_ASSERT_EQUAL (m_accepted[ii], m_received[ii]);
+        accepted += m_accepted[ii];
+        received += m_received[ii];
+    }
+
+    TEST_ASSERT_EQUAL (0U, m_double_sends);
+    TEST_ASSERT_EQUAL (0U, m_frame_errors);
+    TEST_ASSERT_EQUAL (accepted, received);
+    // Several messages per transfer.
+    TEST_ASSERT (m_send_calls < (accepted / 2U));
+}
@@ -0,0 +1,343 @@
+#include "unity.h"
+
+#include "ruuvi_driver_error.h"
+#include "ruuvi_interface_communication_bulk.h"
+#include "mock_ruuvi_interface_atomic.h"
+
+#include <string.h>
+
+static const uint8_t m_first[] = { 0, 1, 2, 3, 4 };
+static const uint8_t m_second[] = { 5, 6, 7 };
+static const uint8_t m_third[] = { 8, 9, 10, 11, 12, 13 };
+static ri_comm_bulk_t m_bulk;
+
+static uint8_t m_chunk[4];
+static uint8_t m_received[32];
+static size_t m_received_length;
+static size_t m_queue_space;   //!< Chunks stack accepts before queue is full.
+static rd_status_t m_send_error;
+static void (*m_preempt) (void); //!< Interrupt which fires inside send.
+static size_t m_done_calls;
+static rd_status_t m_done_result;
+static size_t m_done_sent;
+
+static rd_status_t fake_send (const uint8_t * const p_chunk, size_t * const p_length);
+
+static ri_comm_bulk_pump_t m_pump =
+{
+    .send = fake_send,
+    .p_chunk = m_chunk,
+    .chunk_size = sizeof (m_chunk)
+};
+
+static bool atomic_flag_fake (ri_atomic_t * const flag, const bool set, int cmock_num_calls)
+{
+    const ri_atomic_t expected = set ? 0U : 1U;
+    bool swapped = false;
+
+    if (expected == *flag)
+    {
+        *flag = set ? 1U : 0U;
+        swapped = true;
+    }
+
+    return swapped;
+}
+
+static rd_status_t fake_send (const uint8_t * const p_chunk, size_t * const p_length)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if (NULL != m_preempt)
+    {
+        void (* const preempt) (void) = m_preempt;
+        m_preempt = NULL;
+        preempt();
+    }
+
+    if (RD_SUCCESS != m_send_error)
+    {
+        err_code |= m_send_error;
+    }
+    else if (0U == m_queue_space)
+    {
+        err_code |= RD_ERROR_RESOURCES;
+    }
+    else
+    {
+        m_queue_space--;
+        memcpy (&m_received[m_received_length], p_chunk, *p_length);
+        m_received_length += *p_length;
+    }
+
+    return err_code;
+}
+
+static void on_done (const rd_status_t result, const size_t sent)
+{
+    m_done_calls++;
+    m_done_result = result;
+    m_done_sent = sent;
+}
+
+static void tx_ready_isr (void)
+{
+    m_queue_space = 100U;
+    ri_comm_bulk_pump (&m_pump, sizeof (m_chunk));
+}
+
+static void abort_isr (void)
+{
+    TEST_ASSERT (RD_SUCCESS == ri_comm_bulk_pump_abort (&m_pump));
+}
+
+void setUp (void)
+{
+    memset (&m_bulk, 0, sizeof (m_bulk));
+    ri_atomic_flag_StubWithCallback (&atomic_flag_fake);
+    m_pump.owned = 0;
+    m_pump.active = false;
+    m_pump.again = false;
+    m_pump.abort = false;
+    memset (m_received, 0, sizeof (m_received));
+    m_received_length = 0;
+    m_queue_space = 100U;
+    m_send_error = RD_SUCCESS;
+    m_preempt = NULL;
+    m_done_calls = 0;
+    m_done_result = RD_SUCCESS;
+    m_done_sent = 0;
+}
+
+void tearDown (void)
+{
+}
+
+void test_ri_comm_bulk_init_null (void)
+{
+    const ri_comm_segment_t segments[] = { { NULL, 3U } };
+    TEST_ASSERT (RD_ERROR_NULL == ri_comm_bulk_init (NULL, segments, 1U));
+    TEST_ASSERT (RD_ERROR_NULL == ri_comm_bulk_init (&m_bulk, NULL, 1U));
+    TEST_ASSERT (RD_ERROR_NULL == ri_comm_bulk_init (&m_bulk, segments, 1U));
+}
+
+void test_ri_comm_bulk_init_empty (void)
+{
+    const ri_comm_segment_t segments[] = { { NULL, 0U }, { m_first, 0U } };
+    TEST_ASSERT (RD_ERROR_INVALID_LENGTH == ri_comm_bulk_init (&m_bulk, segments, 2U));
+    TEST_ASSERT (RD_ERROR_INVALID_LENGTH == ri_comm_bulk_init (&m_bulk, segments, 0U));
+}
+
+void test_ri_comm_bulk_chunks_span_segments (void)
+{
+    const ri_comm_segment_t segments[] =
+    {
+        { m_first, sizeof (m_first) },
+        { NULL, 0U },
+        { m_second, sizeof (m_second) },
+        { m_third, sizeof (m_third) }
+    };
+    uint8_t chunk[6] = { 0 };
+    uint8_t received[14] = { 0 };
+    size_t total = 0;
+    TEST_ASSERT (RD_SUCCESS == ri_comm_bulk_init (&m_bulk, segments, 4U));
+    TEST_ASSERT (14U == ri_comm_bulk_remaining (&m_bulk));
+
+    while (0U < ri_comm_bulk_remaining (&m_bulk))
+    {
+        const size_t length = ri_comm_bulk_peek (&m_bulk, chunk, sizeof (chunk));
+        TEST_ASSERT (0U < length);
+        memcpy (&received[total], chunk, length);
+        total += length;
+        ri_comm_bulk_consume (&m_bulk, length);
+    }
+
+    TEST_ASSERT (14U == total);
+
+    for (uint8_t ii = 0; ii < total; ii++)
+    {
+        TEST_ASSERT (ii == received[ii]);
+    }
+
+    TEST_ASSERT (0U == ri_comm_bulk_peek (&m_bulk, chunk, sizeof (chunk)));
+}
+
+void test_ri_comm_bulk_peek_does_not_consume (void)
+{
+    const ri_comm_segment_t segments[] =
+    {
+        { m_first, sizeof (m_first) },
+        { m_second, sizeof (m_second) }
+    };
+    uint8_t chunk[4] = { 0 };
+    TEST_ASSERT (RD_SUCCESS == ri_comm_bulk_init (&m_bulk, segments, 2U));
+    ri_comm_bulk_consume (&m_bulk, 3U);
+    // Chunk rejected by stack is sent again as is.
+    TEST_ASSERT (4U == ri_comm_bulk_peek (&m_bulk, chunk, sizeof (chunk)));
+    TEST_ASSERT (3U == chunk[0]);
+    TEST_ASSERT (6U == chunk[3]);
+    TEST_ASSERT (4U == ri_comm_bulk_peek (&m_bulk, chunk, sizeof (chunk)));
+    TEST_ASSERT (3U == chunk[0]);
+    TEST_ASSERT (5U == ri_comm_bulk_remaining (&m_bulk));
+    ri_comm_bulk_consume (&m_bulk, 4U);
+    TEST_ASSERT (1U == ri_comm_bulk_peek (&m_bulk, chunk, sizeof (chunk)));
+    TEST_ASSERT (7U == chunk[0]);
+}
+
+void test_ri_comm_bulk_consume_over_remaining (void)
+{
+    const ri_comm_segment_t segments[] = { { m_first, sizeof (m_first) } };
+    TEST_ASSERT (RD_SUCCESS == ri_comm_bulk_init (&m_bulk, segments, 1U));
+    ri_comm_bulk_consume (&m_bulk, 100U);
+    TEST_ASSERT (0U == ri_comm_bulk_remaining (&m_bulk));
+    TEST_ASSERT (0U == ri_comm_bulk_remaining (NULL));
+    ri_comm_bulk_consume (NULL, 1U);
+}
+
+void test_ri_comm_bulk_fragment_size (void)
+{
+    // Default link, 20-byte notifications.
+    TEST_ASSERT (20U == ri_comm_bulk_fragment_size (23U, 27U));
+    TEST_ASSERT (20U == ri_comm_bulk_fragment_size (0U, 0U));
+    // Large MTU and DLE, notification fills one LL packet.
+    TEST_ASSERT (244U == ri_comm_bulk_fragment_size (247U, 251U));
+    // Large MTU without DLE, notification fills 9 LL packets.
+    TEST_ASSERT (236U == ri_comm_bulk_fragment_size (247U, 27U));
+    // Payload does not fill one LL packet, limited by MTU.
+    TEST_ASSERT (97U == ri_comm_bulk_fragment_size (100U, 251U));
+}
+
+void test_ri_comm_bulk_pump_sends_all (void)
+{
+    const ri_comm_segment_t segments[] =
+    {
+        { m_first, sizeof (m_first) },
+        { m_second, sizeof (m_second) },
+        { m_third, sizeof (m_third) }
+    };
+    TEST_ASSERT (RD_SUCCESS == ri_comm_bulk_pump_start (&m_pump, segments, 3U, &on_done));
+    TEST_ASSERT (ri_comm_bulk_pump_is_active (&m_pump));
+    ri_comm_bulk_pump (&m_pump, 100U);
+    TEST_ASSERT (!ri_comm_bulk_pump_is_active (&m_pump));
+    TEST_ASSERT (1U == m_done_calls);
+    TEST_ASSERT (RD_SUCCESS == m_done_result);
+    TEST_ASSERT (14U == m_done_sent);
+    TEST_ASSERT (14U == m_received_length);
+
+    for (uint8_t ii = 0; ii < m_received_length; ii++)
+    {
+        TEST_ASSERT (ii == m_received[ii]);
+    }
+}
+
+void test_ri_comm_bulk_pump_queue_full (void)
+{
+    const ri_comm_segment_t segments[] = { { m_third, sizeof (m_third) } };
+    m_queue_space = 1U;
+    TEST_ASSERT (RD_SUCCESS == ri_comm_bulk_pump_start (&m_pump, segments, 1U, &on_done));
+    ri_comm_bulk_pump (&m_pump, 100U);
+    TEST_ASSERT (ri_comm_bulk_pump_is_active (&m_pump));
+    TEST_ASSERT (4U == m_received_length);
+    TEST_ASSERT (RD_ERROR_BUSY == ri_comm_bulk_pump_start (&m_pump, segments, 1U, &on_done));
+    m_queue_space = 1U;
+    ri_comm_bulk_pump (&m_pump, 100U);
+    TEST_ASSERT (1U == m_done_calls);
+    TEST_ASSERT (6U == m_done_sent);
+}
+
+void test_ri_comm_bulk_pump_send_error (void)
+{
+    const ri_comm_segment_t segments[] = { { m_third, sizeof (m_third) } };
+    m_send_error = RD_ERROR_INVALID_STATE;
+    TEST_ASSERT (RD_SUCCESS == ri_comm_bulk_pump_start (&m_pump, segments, 1U, &on_done));
+    ri_comm_bulk_pump (&m_pump, 100U);
+    TEST_ASSERT (!ri_comm_bulk_pump_is_active (&m_pump));
+    TEST_ASSERT (1U == m_done_calls);
+    TEST_ASSERT (RD_ERROR_INVALID_STATE == m_done_result);
+    TEST_ASSERT (0U == m_done_sent);
+}
+
+void test_ri_comm_bulk_pump_reentry_sends_once (void)
+{
+    const ri_comm_segment_t segments[] =
+    {
+        { m_first, sizeof (m_first) },
+        { m_second, sizeof (m_second) },
+        { m_third, sizeof (m_third) }
+    };
+    // Queue fills on first chunk, TX_RDY interrupts next send of thread.
+    m_queue_space = 1U;
+    TEST_ASSERT (RD_SUCCESS == ri_comm_bulk_pump_start (&m_pump, segments, 3U, &on_done));
+    m_preempt = &tx_ready_isr;
+    ri_comm_bulk_pump (&m_pump, 100U);
+    // Thread finished the transfer on behalf of interrupt, each byte sent once in order.
+    TEST_ASSERT (!ri_comm_bulk_pump_is_active (&m_pump));
+    TEST_ASSERT (1U == m_done_calls);
+    TEST_ASSERT (14U == m_done_sent);
+    TEST_ASSERT (14U == m_received_length);
+
+    for (uint8_t ii = 0; ii < m_received_length; ii++)
+    {
+        TEST_ASSERT (ii == m_received[ii]);
+    }
+}
+
+void test_ri_comm_bulk_pump_reentry_after_queue_full (void)
+{
+    const ri_comm_segment_t segments[] = { { m_third, sizeof (m_third) } };
+    // Interrupt fires on the send which finds the queue full, its request must not be lost.
+    m_queue_space = 0U;
+    TEST_ASSERT (RD_SUCCESS == ri_comm_bulk_pump_start (&m_pump, segments, 1U, &on_done));
+    m_preempt = &tx_ready_isr;
+    ri_comm_bulk_pump (&m_pump, 100U);
+    TEST_ASSERT (1U == m_done_calls);
+    TEST_ASSERT (6U == m_received_length);
+}
+
+void test_ri_comm_bulk_pump_abort_preempts_send (void)
+{
+    const ri_comm_segment_t segments[] = { { m_third, sizeof (m_third) } };
+    TEST_ASSERT (RD_SUCCESS == ri_comm_bulk_pump_start (&m_pump, segments, 1U, &on_done));
+    m_preempt = &abort_isr;
+    ri_comm_bulk_pump (&m_pump, 100U);
+    // Chunk being sent completes, then the owner ends the transfer.
+    TEST_ASSERT (!ri_comm_bulk_pump_is_active (&m_pump));
+    TEST_ASSERT (1U == m_done_calls);
+    TEST_ASSERT (RD_ERROR_INVALID_STATE == m_done_result);
+    TEST_ASSERT (4U == m_done_sent);
+    TEST_ASSERT (4U == m_received_length);
+}
+
+void test_ri_comm_bulk_pump_abort (void)
+{
+    const ri_comm_segment_t segments[] = { { m_third, sizeof (m_third) } };
+    TEST_ASSERT (RD_ERROR_INVALID_STATE == ri_comm_bulk_pump_abort (&m_pump));
+    TEST_ASSERT (RD_ERROR_NULL == ri_comm_bulk_pump_abort (NULL));
+    m_queue_space = 0U;
+    TEST_ASSERT (RD_SUCCESS == ri_comm_bulk_pump_start (&m_pump, segments, 1U, &on_done));
+    ri_comm_bulk_pump (&m_pump, 100U);
+    TEST_ASSERT (RD_SUCCESS == ri_comm_bulk_pump_abort (&m_pump));
+    TEST_ASSERT (1U == m_done_calls);
+    TEST_ASSERT (RD_ERROR_INVALID_STATE == m_done_result);
+    TEST_ASSERT (!ri_comm_bulk_pump_is_active (&m_pump));
+    // Next transfer starts clean.
+    m_queue_space = 100U;
+    TEST_ASSERT (RD_SUCCESS == ri_comm_bulk_pump_start (&m_pump, segments, 1U, &on_done));
+    ri_comm_bulk_pump (&m_pump, 100U);
+    TEST_ASSERT (2U == m_done_calls);
+    TEST_ASSERT (RD_SUCCESS == m_done_result);
+}
+
+void test_ri_comm_bulk_pump_start_invalid (void)
+{
+    const ri_comm_segment_t segments[] = { { m_third, sizeof (m_third) } };
+    ri_comm_bulk_pump_t unset = { 0 };
+    TEST_ASSERT (RD_ERROR_NULL == ri_comm_bulk_pump_start (NULL, segments, 1U, &on_done));
+    TEST_ASSERT (RD_ERROR_NULL == ri_comm_bulk_pump_start (&unset, segments, 1U, &on_done));
+    TEST_ASSERT (RD_ERROR_NULL == ri_comm_bulk_pump_start (&m_pump, NULL, 1U, &on_done));
+    TEST_ASSERT (RD_ERROR_INVALID_LENGTH == ri_comm_bulk_pump_start (&m_pump, segments, 0U,
+                 &on_done));
+    TEST_ASSERT (!ri_comm_bulk_pump_is_active (&m_pump));
+    TEST_ASSERT (!ri_comm_bulk_pump_is_active (NULL));
+    ri_comm_bulk_pump (NULL, 100U);
+}
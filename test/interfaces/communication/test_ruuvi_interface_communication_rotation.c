@@ -0,0 +1,278 @@
+#include "unity.h"
+
+#include "ruuvi_driver_enabled_modules.h"
+#include "ruuvi_driver_error.h"
+#include "ruuvi_interface_communication_rotation.h"
+#include "ruuvi_interface_communication_tx_gate.h"
+#include "mock_ruuvi_interface_atomic.h"
+
+#include <string.h>
+
+static bool queue_pending (void);
+static rd_status_t queue_start (void);
+static rd_status_t slot_next (const bool first);
+static bool slot_halt (void);
+
+static ri_comm_tx_gate_t m_gate =
+{
+    .pending = queue_pending,
+    .start = queue_start
+};
+
+static ri_comm_rotation_t m_rotation =
+{
+    .p_gate = &m_gate,
+    .next = slot_next,
+    .halt = slot_halt
+};
+
+static uint32_t m_queued;         //!< Messages in queue.
+static uint32_t m_queue_started;  //!< Queued messages started.
+static bool m_queue_on_air;       //!< Queued message is being sent.
+static bool m_slot_on_air;        //!< Rotation slot is being sent.
+static uint32_t m_slots_started;
+static uint32_t m_first_starts;
+static rd_status_t m_next_error;
+static uint32_t m_halted_queued;  //!< Queued messages stopped by rotation, must stay 0.
+static void (*m_preempt_halt) (void); //!< Interrupt which fires inside halt.
+
+static bool atomic_flag_fake (ri_atomic_t * const flag, const bool set, int cmock_num_calls)
+{
+    const ri_atomic_t expected = set ? 0U : 1U;
+    bool swapped = false;
+
+    if (expected == *flag)
+    {
+        *flag = set ? 1U : 0U;
+        swapped = true;
+    }
+
+    return swapped;
+}
+
+static bool queue_pending (void)
+{
+    return (0U != m_queued);
+}
+
+static rd_status_t queue_start (void)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if (0U == m_queued)
+    {
+        err_code |= RD_ERROR_NOT_FOUND;
+    }
+    else
+    {
+        m_queued--;
+        m_queue_started++;
+        m_queue_on_air = true;
+    }
+
+    return err_code;
+}
+
+static rd_status_t slot_next (const bool first)
+{
+    rd_status_t err_code = m_next_error;
+
+    if (RD_SUCCESS == err_code)
+    {
+        m_first_starts += first ? 1U : 0U;
+        m_slots_started++;
+        m_slot_on_air = true;
+    }
+
+    return err_code;
+}
+
+static bool slot_halt (void)
+{
+    bool stopped = false;
+
+    if (NULL != m_preempt_halt)
+    {
+        void (* const preempt) (void) = m_preempt_halt;
+        m_preempt_halt = NULL;
+        preempt();
+    }
+
+    if (m_queue_on_air)
+    {
+        m_halted_queued++;
+        m_queue_on_air = false;
+        stopped = true;
+    }
+    else if (m_slot_on_air)
+    {
+        m_slot_on_air = false;
+        stopped = true;
+    }
+    else
+    {
+        // Nothing on air.
+    }
+
+    return stopped;
+}
+
+/** @brief Slot turn ends on air, event is not yet handled. */
+static void slot_expires (void)
+{
+    m_slot_on_air = false;
+}
+
+/** @brief Termination event of the transmitter. */
+static void terminated_isr (void)
+{
+    if (RD_ERROR_NOT_FOUND == ri_comm_rotation_terminated (&m_rotation))
+    {
+        m_queue_on_air = false;
+        ri_comm_tx_gate_release (&m_gate);
+        (void) ri_comm_tx_gate_kick (&m_gate);
+    }
+}
+
+/** @brief Slot turn ends and its termination event preempts the caller. */
+static void slot_expires_isr (void)
+{
+    slot_expires();
+    terminated_isr();
+}
+
+void setUp (void)
+{
+    ri_atomic_flag_StubWithCallback (&atomic_flag_fake);
+    m_gate.owned = 0;
+    m_rotation.running = false;
+    m_rotation.stopping = false;
+    m_rotation.slot_ended = 0;
+    m_queued = 0;
+    m_queue_started = 0;
+    m_queue_on_air = false;
+    m_slot_on_air = false;
+    m_slots_started = 0;
+    m_first_starts = 0;
+    m_next_error = RD_SUCCESS;
+    m_halted_queued = 0;
+    m_preempt_halt = NULL;
+}
+
+void tearDown (void)
+{
+}
+
+void test_ri_comm_rotation_start_stop (void)
+{
+    TEST_ASSERT (RD_SUCCESS == ri_comm_rotation_start (&m_rotation));
+    TEST_ASSERT (ri_comm_rotation_is_running (&m_rotation));
+    TEST_ASSERT (ri_comm_tx_gate_is_busy (&m_gate));
+    TEST_ASSERT_EQUAL (1U, m_first_starts);
+    // Queued message waits for rotation.
+    m_queued = 1U;
+    TEST_ASSERT (RD_SUCCESS == ri_comm_tx_gate_kick (&m_gate));
+    TEST_ASSERT_EQUAL (0U, m_queue_started);
+    TEST_ASSERT (RD_SUCCESS == ri_comm_rotation_stop (&m_rotation));
+    TEST_ASSERT_FALSE (ri_comm_rotation_is_running (&m_rotation));
+    TEST_ASSERT_FALSE (m_slot_on_air);
+    TEST_ASSERT_EQUAL (1U, m_queue_started);
+    TEST_ASSERT (ri_comm_tx_gate_is_busy (&m_gate));
+    terminated_isr();
+    TEST_ASSERT_FALSE (ri_comm_tx_gate_is_busy (&m_gate));
+}
+
+void test_ri_comm_rotation_start_busy (void)
+{
+    TEST_ASSERT (ri_comm_tx_gate_acquire (&m_gate));
+    TEST_ASSERT (RD_ERROR_INVALID_STATE == ri_comm_rotation_start (&m_rotation));
+    TEST_ASSERT_FALSE (ri_comm_rotation_is_running (&m_rotation));
+    TEST_ASSERT_EQUAL (0U, m_slots_started);
+}
+
+void test_ri_comm_rotation_start_fails (void)
+{
+    m_queued = 1U;
+    m_next_error = RD_ERROR_INVALID_STATE;
+    TEST_ASSERT (RD_ERROR_INVALID_STATE == ri_comm_rotation_start (&m_rotation));
+    TEST_ASSERT_FALSE (ri_comm_rotation_is_running (&m_rotation));
+    TEST_ASSERT_EQUAL (1U, m_queue_started);
+}
+
+void test_ri_comm_rotation_terminated_starts_next (void)
+{
+    TEST_ASSERT (RD_SUCCESS == ri_comm_rotation_start (&m_rotation));
+    slot_expires();
+    TEST_ASSERT (RD_SUCCESS == ri_comm_rotation_terminated (&m_rotation));
+    TEST_ASSERT_EQUAL (2U, m_slots_started);
+    TEST_ASSERT_EQUAL (1U, m_first_starts);
+    TEST_ASSERT (m_slot_on_air);
+}
+
+void test_ri_comm_rotation_terminated_next_fails (void)
+{
+    TEST_ASSERT (RD_SUCCESS == ri_comm_rotation_start (&m_rotation));
+    m_queued = 1U;
+    m_next_error = RD_ERROR_INTERNAL;
+    slot_expires();
+    TEST_ASSERT (RD_ERROR_INTERNAL == ri_comm_rotation_terminated (&m_rotation));
+    TEST_ASSERT_FALSE (ri_comm_rotation_is_running (&m_rotation));
+    TEST_ASSERT_EQUAL (1U, m_queue_started);
+}
+
+void test_ri_comm_rotation_terminated_not_running (void)
+{
+    TEST_ASSERT (RD_ERROR_NOT_FOUND == ri_comm_rotation_terminated (&m_rotation));
+}
+
+void test_ri_comm_rotation_stop_after_slot_expired (void)
+{
+    TEST_ASSERT (RD_SUCCESS == ri_comm_rotation_start (&m_rotation));
+    m_queued = 1U;
+    // Turn ended on air, event is handled only after stop returns.
+    slot_expires();
+    TEST_ASSERT (RD_SUCCESS == ri_comm_rotation_stop (&m_rotation));
+    TEST_ASSERT_EQUAL (0U, m_queue_started);
+    terminated_isr();
+    TEST_ASSERT_FALSE (ri_comm_rotation_is_running (&m_rotation));
+    TEST_ASSERT_EQUAL (1U, m_slots_started);
+    TEST_ASSERT_EQUAL (1U, m_queue_started);
+    TEST_ASSERT (m_queue_on_air);
+}
+
+void test_ri_comm_rotation_stop_preempted_by_terminate (void)
+{
+    TEST_ASSERT (RD_SUCCESS == ri_comm_rotation_start (&m_rotation));
+    m_queued = 1U;
+    // Turn ends and its event is handled between stop request and halt.
+    m_preempt_halt = &slot_expires_isr;
+    TEST_ASSERT (RD_SUCCESS == ri_comm_rotation_stop (&m_rotation));
+    TEST_ASSERT_FALSE (ri_comm_rotation_is_running (&m_rotation));
+    TEST_ASSERT_EQUAL (1U, m_slots_started);
+    TEST_ASSERT_EQUAL (0U, m_halted_queued);
+    TEST_ASSERT_EQUAL (1U, m_queue_started);
+    TEST_ASSERT (m_queue_on_air);
+    TEST_ASSERT (ri_comm_tx_gate_is_busy (&m_gate));
+}
+
+void test_ri_comm_rotation_abort (void)
+{
+    TEST_ASSERT (RD_SUCCESS == ri_comm_rotation_start (&m_rotation));
+    ri_comm_rotation_abort (&m_rotation);
+    TEST_ASSERT_FALSE (ri_comm_rotation_is_running (&m_rotation));
+    // Caller frees the transmitter.
+    TEST_ASSERT (ri_comm_tx_gate_is_busy (&m_gate));
+    TEST_ASSERT (RD_SUCCESS == ri_comm_rotation_stop (&m_rotation));
+    TEST_ASSERT (ri_comm_tx_gate_is_busy (&m_gate));
+    ri_comm_rotation_abort (NULL);
+}
+
+void test_ri_comm_rotation_null (void)
+{
+    ri_comm_rotation_t unset = { 0 };
+    TEST_ASSERT (RD_ERROR_NULL == ri_comm_rotation_start (NULL));
+    TEST_ASSERT (RD_ERROR_NULL == ri_comm_rotation_start (&unset));
+    TEST_ASSERT (RD_ERROR_NULL == ri_comm_rotation_stop (NULL));
+    TEST_ASSERT (RD_ERROR_NULL == ri_comm_rotation_terminated (NULL));
+    TEST_ASSERT_FALSE (ri_comm_rotation_is_running (NULL));
+}
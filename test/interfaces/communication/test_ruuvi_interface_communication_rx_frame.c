@@ -0,0 +1,236 @@
+#include "unity.h"
+
+#include "ruuvi_driver_enabled_modules.h"
+#include "ruuvi_driver_error.h"
+#include "ruuvi_interface_communication_rx_frame.h"
+
+#include <string.h>
+
+#define DELIMITER (0x0AU)
+
+static const uint8_t * m_frame;
+static size_t m_frame_length;
+static uint8_t m_frame_copy[RI_COMM_RX_FRAME_SIZE];
+static uint32_t m_frames;
+static bool m_auto_release;
+
+static void on_frame (const uint8_t * const p_frame, const size_t length)
+{
+    m_frame = p_frame;
+    m_frame_length = length;
+    memcpy (m_frame_copy, p_frame, length);
+    m_frames++;
+
+    if (m_auto_release)
+    {
+        TEST_ASSERT (RD_SUCCESS == ri_comm_rx_frame_release (p_frame));
+    }
+}
+
+static void init_mode (const ri_comm_rx_frame_mode_t mode, const bool crc)
+{
+    const ri_comm_rx_frame_init_t config =
+    {
+        .mode = mode,
+        .delimiter = DELIMITER,
+        .crc_enabled = crc,
+        .on_frame = on_frame
+    };
+    TEST_ASSERT (RD_SUCCESS == ri_comm_rx_frame_init (&config));
+}
+
+/** @brief Append CRC to payload, return frame length. */
+static size_t crc_frame (uint8_t * const p_frame, const size_t payload)
+{
+    const uint16_t crc = ri_comm_rx_frame_crc16 (p_frame, payload);
+    p_frame[payload] = (uint8_t) (crc & 0xFFU);
+    p_frame[payload + 1U] = (uint8_t) (crc >> 8U);
+    return payload + RI_COMM_RX_FRAME_CRC_LENGTH;
+}
+
+void setUp (void)
+{
+    m_frame = NULL;
+    m_frame_length = 0;
+    m_frames = 0;
+    m_auto_release = false;
+    init_mode (RI_COMM_RX_FRAME_DELIMITER, false);
+}
+
+void tearDown (void)
+{
+}
+
+void test_ri_comm_rx_frame_init_errors (void)
+{
+    ri_comm_rx_frame_init_t config =
+    {
+        .mode = RI_COMM_RX_FRAME_DELIMITER,
+        .on_frame = NULL
+    };
+    TEST_ASSERT (RD_ERROR_NULL == ri_comm_rx_frame_init (NULL));
+    TEST_ASSERT (RD_ERROR_NULL == ri_comm_rx_frame_init (&config));
+    config.on_frame = on_frame;
+    config.mode = (ri_comm_rx_frame_mode_t) (RI_COMM_RX_FRAME_IDLE + 1);
+    TEST_ASSERT (RD_ERROR_INVALID_PARAM == ri_comm_rx_frame_init (&config));
+}
+
+void test_ri_comm_rx_frame_mode_get (void)
+{
+    ri_comm_rx_frame_mode_t mode = RI_COMM_RX_FRAME_IDLE;
+    TEST_ASSERT (RD_SUCCESS == ri_comm_rx_frame_mode_get (&mode));
+    TEST_ASSERT (RI_COMM_RX_FRAME_DELIMITER == mode);
+    init_mode (RI_COMM_RX_FRAME_IDLE, false);
+    TEST_ASSERT (RD_SUCCESS == ri_comm_rx_frame_mode_get (&mode));
+    TEST_ASSERT (RI_COMM_RX_FRAME_IDLE == mode);
+    TEST_ASSERT (RD_ERROR_NULL == ri_comm_rx_frame_mode_get (NULL));
+}
+
+void test_ri_comm_rx_frame_crc16_check_value (void)
+{
+    const uint8_t check[] = "123456789";
+    TEST_ASSERT_EQUAL_HEX16 (0x29B1U, ri_comm_rx_frame_crc16 (check, 9U));
+    TEST_ASSERT_EQUAL_HEX16 (0xFFFFU, ri_comm_rx_frame_crc16 (NULL, 9U));
+}
+
+void test_ri_comm_rx_frame_delimiter_zero_copy (void)
+{
+    const uint8_t rx[] = {'a', 'b', 'c', DELIMITER, DELIMITER, 'd', 'e'};
+    TEST_ASSERT_FALSE (ri_comm_rx_frame_feed (rx, sizeof (rx)));
+    // Consecutive delimiters do not produce empty frames.
+    TEST_ASSERT_EQUAL (1U, m_frames);
+    TEST_ASSERT_EQUAL (3U, m_frame_length);
+    TEST_ASSERT_EQUAL_MEMORY ("abc", m_frame, 3U);
+    // Frame is not copied, buffer stays held until released.
+    const uint8_t * const p_first = m_frame;
+    const uint8_t tail[] = {'f', DELIMITER};
+    (void) ri_comm_rx_frame_feed (tail, sizeof (tail));
+    TEST_ASSERT_EQUAL (2U, m_frames);
+    TEST_ASSERT_EQUAL_MEMORY ("def", m_frame, 3U);
+    TEST_ASSERT (p_first != m_frame);
+    TEST_ASSERT_EQUAL_MEMORY ("abc", p_first, 3U);
+    TEST_ASSERT (RD_SUCCESS == ri_comm_rx_frame_release (p_first));
+    TEST_ASSERT (RD_SUCCESS == ri_comm_rx_frame_release (m_frame));
+}
+
+void test_ri_comm_rx_frame_overrun_while_held (void)
+{
+    const uint8_t rx[] = {'a', DELIMITER, 'b', DELIMITER, 'c', DELIMITER};
+    ri_comm_rx_frame_stats_t stats = { 0 };
+    (void) ri_comm_rx_frame_feed (rx, sizeof (rx));
+    // First frame is held, second is being held while third arrives.
+    TEST_ASSERT_EQUAL (2U, m_frames);
+    TEST_ASSERT (RD_SUCCESS == ri_comm_rx_frame_stats_get (&stats));
+    TEST_ASSERT_EQUAL (1U, stats.overruns);
+    TEST_ASSERT_EQUAL ('b', m_frame_copy[0]);
+    m_auto_release = true;
+    TEST_ASSERT (RD_SUCCESS == ri_comm_rx_frame_release (m_frame));
+    (void) ri_comm_rx_frame_feed (rx, 2U);
+    TEST_ASSERT_EQUAL (3U, m_frames);
+    TEST_ASSERT_EQUAL ('a', m_frame_copy[0]);
+}
+
+void test_ri_comm_rx_frame_release_errors (void)
+{
+    const uint8_t rx[] = {'a', DELIMITER};
+    uint8_t other[1] = { 0 };
+    (void) ri_comm_rx_frame_feed (rx, sizeof (rx));
+    TEST_ASSERT (RD_ERROR_NULL == ri_comm_rx_frame_release (NULL));
+    TEST_ASSERT (RD_ERROR_INVALID_PARAM == ri_comm_rx_frame_release (other));
+    TEST_ASSERT (RD_SUCCESS == ri_comm_rx_frame_release (m_frame));
+    TEST_ASSERT (RD_ERROR_INVALID_STATE == ri_comm_rx_frame_release (m_frame));
+    TEST_ASSERT (RD_ERROR_NULL == ri_comm_rx_frame_stats_get (NULL));
+}
+
+void test_ri_comm_rx_frame_crc (void)
+{
+    uint8_t rx[RI_COMM_RX_FRAME_SIZE + 1U] = {'h', 'e', 'l', 'l', 'o'};
+    size_t length = crc_frame (rx, 5U);
+    ri_comm_rx_frame_stats_t stats = { 0 };
+    rx[length++] = DELIMITER;
+    init_mode (RI_COMM_RX_FRAME_DELIMITER, true);
+    m_auto_release = true;
+    (void) ri_comm_rx_frame_feed (rx, length);
+    TEST_ASSERT_EQUAL (1U, m_frames);
+    TEST_ASSERT_EQUAL (5U, m_frame_length);
+    TEST_ASSERT_EQUAL_MEMORY ("hello", m_frame_copy, 5U);
+    // Corrupted payload.
+    rx[1] = 'a';
+    (void) ri_comm_rx_frame_feed (rx, length);
+    // Only CRC, no payload.
+    const uint8_t short_frame[] = {0x12, 0x34, DELIMITER};
+    (void) ri_comm_rx_frame_feed (short_frame, sizeof (short_frame));
+    TEST_ASSERT_EQUAL (1U, m_frames);
+    TEST_ASSERT (RD_SUCCESS == ri_comm_rx_frame_stats_get (&stats));
+    TEST_ASSERT_EQUAL (2U, stats.crc_errors);
+    TEST_ASSERT_EQUAL (1U, stats.frames);
+}
+
+void test_ri_comm_rx_frame_oversize_dropped (void)
+{
+    uint8_t rx[RI_COMM_RX_FRAME_SIZE + 1U];
+    ri_comm_rx_frame_stats_t stats = { 0 };
+    memset (rx, 'x', sizeof (rx));
+    m_auto_release = true;
+    (void) ri_comm_rx_frame_feed (rx, sizeof (rx));
+    const uint8_t next[] = {DELIMITER, 'o', 'k', DELIMITER};
+    (void) ri_comm_rx_frame_feed (next, sizeof (next));
+    TEST_ASSERT_EQUAL (1U, m_frames);
+    TEST_ASSERT_EQUAL (2U, m_frame_length);
+    TEST_ASSERT_EQUAL_MEMORY ("ok", m_frame_copy, 2U);
+    TEST_ASSERT (RD_SUCCESS == ri_comm_rx_frame_stats_get (&stats));
+    TEST_ASSERT_EQUAL (1U, stats.oversize);
+}
+
+void test_ri_comm_rx_frame_full_buffer_fits (void)
+{
+    uint8_t rx[RI_COMM_RX_FRAME_SIZE + 1U];
+    memset (rx, 'x', sizeof (rx));
+    rx[RI_COMM_RX_FRAME_SIZE] = DELIMITER;
+    m_auto_release = true;
+    (void) ri_comm_rx_frame_feed (rx, sizeof (rx));
+    TEST_ASSERT_EQUAL (1U, m_frames);
+    TEST_ASSERT_EQUAL (RI_COMM_RX_FRAME_SIZE, m_frame_length);
+}
+
+void test_ri_comm_rx_frame_idle_line (void)
+{
+    uint8_t rx[8] = {0x01, DELIMITER, 0x03};
+    init_mode (RI_COMM_RX_FRAME_IDLE, true);
+    const size_t length = crc_frame (rx, 3U);
+    m_auto_release = true;
+    // Nothing received, timer not needed.
+    TEST_ASSERT_FALSE (ri_comm_rx_frame_idle());
+    TEST_ASSERT (ri_comm_rx_frame_feed (rx, 2U));
+    TEST_ASSERT_FALSE (ri_comm_rx_frame_feed (&rx[2], 1U));
+    // Bytes since previous timeout.
+    TEST_ASSERT (ri_comm_rx_frame_idle());
+    TEST_ASSERT_FALSE (ri_comm_rx_frame_feed (&rx[3], length - 3U));
+    TEST_ASSERT (ri_comm_rx_frame_idle());
+    TEST_ASSERT_EQUAL (0U, m_frames);
+    // Line idle for a whole period, delimiter byte is payload in idle mode.
+    TEST_ASSERT_FALSE (ri_comm_rx_frame_idle());
+    TEST_ASSERT_EQUAL (1U, m_frames);
+    TEST_ASSERT_EQUAL (3U, m_frame_length);
+    TEST_ASSERT_EQUAL_MEMORY (rx, m_frame_copy, 3U);
+    // Next frame starts timer again.
+    TEST_ASSERT (ri_comm_rx_frame_feed (rx, length));
+}
+
+void test_ri_comm_rx_frame_idle_overrun (void)
+{
+    const uint8_t rx[] = {'a', 'b'};
+    ri_comm_rx_frame_stats_t stats = { 0 };
+    init_mode (RI_COMM_RX_FRAME_IDLE, false);
+
+    for (uint8_t ii = 0; ii < 3U; ii++)
+    {
+        TEST_ASSERT (ri_comm_rx_frame_feed (rx, sizeof (rx)));
+        TEST_ASSERT (ri_comm_rx_frame_idle());
+        TEST_ASSERT_FALSE (ri_comm_rx_frame_idle());
+    }
+
+    TEST_ASSERT_EQUAL (2U, m_frames);
+    TEST_ASSERT (RD_SUCCESS == ri_comm_rx_frame_stats_get (&stats));
+    TEST_ASSERT_EQUAL (1U, stats.overruns);
+}
@@ -0,0 +1,197 @@
+#include "unity.h"
+
+#include "ruuvi_driver_enabled_modules.h"
+#include "ruuvi_driver_error.h"
+#include "ruuvi_interface_communication_radio.h"
+#include "ruuvi_interface_communication_scan_schedule.h"
+
+#include <string.h>
+
+#define WINDOW_MS (1000U)
+
+static ri_comm_scan_schedule_t m_schedule;
+
+static void schedule_init (const uint8_t w1m, const uint8_t w2m, const uint8_t wcoded,
+                           const bool adaptive)
+{
+    const ri_comm_scan_schedule_init_t init =
+    {
+        .weight_1m = w1m,
+        .weight_2m = w2m,
+        .weight_coded = wcoded,
+        .adaptive = adaptive
+    };
+    TEST_ASSERT (RD_SUCCESS == ri_comm_scan_schedule_init (&m_schedule, &init));
+}
+
+/** @brief Run windows, each PHY receives given reports per window. */
+static void run_windows (const uint32_t windows, const uint32_t reports_1m,
+                         const uint32_t reports_2m, const uint32_t reports_coded,
+                         uint32_t counts[RI_COMM_SCAN_SCHEDULE_PHYS])
+{
+    for (uint32_t ii = 0; ii < windows; ii++)
+    {
+        ri_radio_modulation_t modulation = RI_RADIO_BLE_1MBPS;
+        uint32_t reports = 0;
+        TEST_ASSERT (RD_SUCCESS == ri_comm_scan_schedule_next (&m_schedule, &modulation));
+
+        if (RI_RADIO_BLE_1MBPS == modulation)
+        {
+            reports = reports_1m;
+            counts[0]++;
+        }
+        else if (RI_RADIO_BLE_2MBPS == modulation)
+        {
+            reports = reports_2m;
+            counts[1]++;
+        }
+        else
+        {
+            TEST_ASSERT (RI_RADIO_BLE_125KBPS == modulation);
+            reports = reports_coded;
+            counts[2]++;
+        }
+
+        TEST_ASSERT (RD_SUCCESS == ri_comm_scan_schedule_window_done (&m_schedule, reports,
+                     WINDOW_MS));
+    }
+}
+
+void setUp (void)
+{
+    memset (&m_schedule, 0, sizeof (m_schedule));
+}
+
+void tearDown (void)
+{
+}
+
+void test_ri_comm_scan_schedule_init_errors (void)
+{
+    const ri_comm_scan_schedule_init_t init = { 0 };
+    TEST_ASSERT (RD_ERROR_NULL == ri_comm_scan_schedule_init (NULL, &init));
+    TEST_ASSERT (RD_ERROR_NULL == ri_comm_scan_schedule_init (&m_schedule, NULL));
+    TEST_ASSERT (RD_ERROR_INVALID_PARAM == ri_comm_scan_schedule_init (&m_schedule, &init));
+}
+
+void test_ri_comm_scan_schedule_call_errors (void)
+{
+    ri_radio_modulation_t modulation = RI_RADIO_BLE_1MBPS;
+    ri_comm_scan_schedule_stats_t stats = { 0 };
+    schedule_init (1U, 1U, 1U, false);
+    TEST_ASSERT (RD_ERROR_NULL == ri_comm_scan_schedule_next (NULL, &modulation));
+    TEST_ASSERT (RD_ERROR_NULL == ri_comm_scan_schedule_next (&m_schedule, NULL));
+    TEST_ASSERT (RD_ERROR_NULL == ri_comm_scan_schedule_window_done (NULL, 0U, WINDOW_MS));
+    // No window selected.
+    TEST_ASSERT (RD_ERROR_INVALID_STATE == ri_comm_scan_schedule_window_done (&m_schedule,
+                 0U, WINDOW_MS));
+    TEST_ASSERT (RD_SUCCESS == ri_comm_scan_schedule_next (&m_schedule, &modulation));
+    TEST_ASSERT (RD_ERROR_INVALID_PARAM == ri_comm_scan_schedule_window_done (&m_schedule,
+                 0U, 0U));
+    TEST_ASSERT (RD_ERROR_NULL == ri_comm_scan_schedule_stats_get (NULL, RI_RADIO_BLE_1MBPS,
+                 &stats));
+    TEST_ASSERT (RD_ERROR_NULL == ri_comm_scan_schedule_stats_get (&m_schedule,
+                 RI_RADIO_BLE_1MBPS, NULL));
+    TEST_ASSERT (RD_ERROR_INVALID_PARAM == ri_comm_scan_schedule_stats_get (&m_schedule,
+                 (ri_radio_modulation_t) (RI_RADIO_BLE_2MBPS + 1), &stats));
+}
+
+void test_ri_comm_scan_schedule_weights_interleaved (void)
+{
+    const ri_radio_modulation_t expected[] =
+    {
+        RI_RADIO_BLE_1MBPS, RI_RADIO_BLE_2MBPS, RI_RADIO_BLE_125KBPS, RI_RADIO_BLE_1MBPS,
+        RI_RADIO_BLE_1MBPS, RI_RADIO_BLE_2MBPS, RI_RADIO_BLE_125KBPS, RI_RADIO_BLE_1MBPS
+    };
+    schedule_init (2U, 1U, 1U, false);
+
+    for (size_t ii = 0; ii < (sizeof (expected) / sizeof (expected[0])); ii++)
+    {
+        ri_radio_modulation_t modulation = RI_RADIO_BLE_2MBPS;
+        TEST_ASSERT (RD_SUCCESS == ri_comm_scan_schedule_next (&m_schedule, &modulation));
+        TEST_ASSERT_EQUAL (expected[ii], modulation);
+        TEST_ASSERT (RD_SUCCESS == ri_comm_scan_schedule_window_done (&m_schedule, 1U,
+                     WINDOW_MS));
+    }
+}
+
+void test_ri_comm_scan_schedule_disabled_phy_not_scanned (void)
+{
+    uint32_t counts[RI_COMM_SCAN_SCHEDULE_PHYS] = {0};
+    ri_comm_scan_schedule_stats_t stats = { 0 };
+    schedule_init (0U, 0U, 5U, true);
+    run_windows (20U, 10U, 10U, 0U, counts);
+    TEST_ASSERT_EQUAL (0U, counts[0]);
+    TEST_ASSERT_EQUAL (0U, counts[1]);
+    TEST_ASSERT_EQUAL (20U, counts[2]);
+    TEST_ASSERT (RD_SUCCESS == ri_comm_scan_schedule_stats_get (&m_schedule,
+                 RI_RADIO_BLE_125KBPS, &stats));
+    TEST_ASSERT_EQUAL (20U, stats.windows);
+    TEST_ASSERT_EQUAL (20U * WINDOW_MS, stats.scan_ms);
+    // No reports at all, configured weight is kept.
+    TEST_ASSERT_EQUAL (5U, stats.share);
+}
+
+void test_ri_comm_scan_schedule_static_ignores_yield (void)
+{
+    uint32_t counts[RI_COMM_SCAN_SCHEDULE_PHYS] = {0};
+    schedule_init (1U, 1U, 1U, false);
+    run_windows (30U, 100U, 0U, 0U, counts);
+    TEST_ASSERT_EQUAL (10U, counts[0]);
+    TEST_ASSERT_EQUAL (10U, counts[1]);
+    TEST_ASSERT_EQUAL (10U, counts[2]);
+}
+
+void test_ri_comm_scan_schedule_adaptive_follows_yield (void)
+{
+    uint32_t counts[RI_COMM_SCAN_SCHEDULE_PHYS] = {0};
+    ri_comm_scan_schedule_stats_t stats_1m = { 0 };
+    ri_comm_scan_schedule_stats_t stats_coded = { 0 };
+    schedule_init (1U, 1U, 1U, true);
+    // Dense 1M fleet, a few long range tags, nothing on 2M.
+    run_windows (300U, 40U, 0U, 10U, counts);
+    TEST_ASSERT (RD_SUCCESS == ri_comm_scan_schedule_stats_get (&m_schedule,
+                 RI_RADIO_BLE_1MBPS, &stats_1m));
+    TEST_ASSERT (RD_SUCCESS == ri_comm_scan_schedule_stats_get (&m_schedule,
+                 RI_RADIO_BLE_125KBPS, &stats_coded));
+    TEST_ASSERT_EQUAL (RI_COMM_SCAN_SCHEDULE_MAX_SHARE, stats_1m.share);
+    TEST_ASSERT_EQUAL (RI_COMM_SCAN_SCHEDULE_MAX_SHARE / 4U, stats_coded.share);
+    // Configured weight is below floor, PHY without reports keeps it.
+    TEST_ASSERT (counts[0] > (3U * counts[2]));
+    TEST_ASSERT (counts[1] < 10U);
+    TEST_ASSERT (counts[2] > counts[1]);
+    // Beats static 1:1:1 split which would receive 100 reports per 3 windows.
+    TEST_ASSERT ( (stats_1m.reports + stats_coded.reports) > (300U * 50U / 3U) * 2U);
+}
+
+void test_ri_comm_scan_schedule_adaptive_keeps_floor (void)
+{
+    uint32_t counts[RI_COMM_SCAN_SCHEDULE_PHYS] = {0};
+    ri_comm_scan_schedule_stats_t stats = { 0 };
+    schedule_init (100U, 100U, 100U, true);
+    run_windows (300U, 50U, 0U, 0U, counts);
+    TEST_ASSERT (RD_SUCCESS == ri_comm_scan_schedule_stats_get (&m_schedule,
+                 RI_RADIO_BLE_2MBPS, &stats));
+    TEST_ASSERT_EQUAL (RI_COMM_SCAN_SCHEDULE_MIN_SHARE, stats.share);
+    TEST_ASSERT (counts[1] > 10U);
+    // Tags appear on Coded PHY, its share grows to match 1M.
+    run_windows (300U, 50U, 0U, 50U, counts);
+    TEST_ASSERT (RD_SUCCESS == ri_comm_scan_schedule_stats_get (&m_schedule,
+                 RI_RADIO_BLE_125KBPS, &stats));
+    TEST_ASSERT (stats.share > (RI_COMM_SCAN_SCHEDULE_MAX_SHARE * 9U / 10U));
+}
+
+void test_ri_comm_scan_schedule_adaptive_weights_priority (void)
+{
+    ri_comm_scan_schedule_stats_t stats = { 0 };
+    uint32_t counts[RI_COMM_SCAN_SCHEDULE_PHYS] = {0};
+    // Coded PHY reports are worth twice as much to application.
+    schedule_init (50U, 0U, 100U, true);
+    run_windows (100U, 20U, 0U, 20U, counts);
+    TEST_ASSERT (RD_SUCCESS == ri_comm_scan_schedule_stats_get (&m_schedule,
+                 RI_RADIO_BLE_1MBPS, &stats));
+    TEST_ASSERT_EQUAL (RI_COMM_SCAN_SCHEDULE_MAX_SHARE / 2U, stats.share);
+    TEST_ASSERT (RD_SUCCESS == ri_comm_scan_schedule_stats_get (&m_schedule,
+                 RI_RADIO_BLE_125KBPS, &stats));
+    TEST_ASSERT_EQUAL (RI_COMM_SCAN_SCHEDULE_MAX_SHARE, stats.share);
+}
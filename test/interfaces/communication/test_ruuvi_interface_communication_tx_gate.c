@@ -0,0 +1,437 @@
+#include "unity.h"
+
+#include "ruuvi_driver_enabled_modules.h"
+#include "ruuvi_driver_error.h"
+#include "ruuvi_interface_atomic.h"
+#include "ruuvi_interface_communication_rotation.h"
+#include "ruuvi_interface_communication_tx_gate.h"
+
+#include <string.h>
+
+#define QUEUE_LENGTH      (4U)
+#define STRESS_ROUNDS     (20000U)
+#define STRESS_SEEDS      (8U)
+
+static bool queue_pending (void);
+static rd_status_t queue_start (void);
+static rd_status_t slot_next (const bool first);
+static bool slot_halt (void);
+
+static ri_comm_tx_gate_t m_gate;
+static ri_comm_rotation_t m_rotation;
+static uint32_t m_queue[QUEUE_LENGTH];
+static size_t m_head;
+static size_t m_count;
+static uint32_t m_next_id;
+static uint32_t m_queued;
+static uint32_t m_started;
+static uint32_t m_dropped;
+static uint32_t m_double_starts;
+static uint32_t m_on_air_id;
+static bool m_on_air;
+static bool m_on_air_slot;        //!< Message on air is a rotation slot.
+static uint32_t m_slots_started;
+static uint32_t m_halted_queued;  //!< Queued messages stopped by rotation.
+static uint32_t m_misrouted;      //!< Terminations handled by wrong owner.
+static bool m_terminate_in_halt;
+static uint32_t m_fail_start;
+static bool m_writer_active;
+static bool m_preempt;
+static bool m_in_isr;
+static uint32_t m_seed;
+
+static uint32_t rand_next (void)
+{
+    m_seed = (m_seed * 1103515245U) + 12345U;
+    return (m_seed >> 16U) & 0x7FFFU;
+}
+
+static bool queue_push (void)
+{
+    bool pushed = false;
+
+    if (QUEUE_LENGTH > m_count)
+    {
+        m_queue[ (m_head + m_count) % QUEUE_LENGTH] = m_next_id++;
+        m_count++;
+        m_queued++;
+        pushed = true;
+    }
+
+    return pushed;
+}
+
+static void simulated_isr (void);
+
+/** @brief Interrupt may preempt caller here. */
+static void preemption_point (void)
+{
+    if (m_preempt && !m_in_isr && (0U == (rand_next() % 3U)))
+    {
+        m_in_isr = true;
+        simulated_isr();
+        m_in_isr = false;
+    }
+}
+
+bool ri_atomic_flag (ri_atomic_t * const flag, const bool set)
+{
+    bool success = false;
+    preemption_point();
+
+    // Interrupts are not preempted by thread, check-and-set is atomic here.
+    if (*flag != set)
+    {
+        *flag = set;
+        success = true;
+    }
+
+    preemption_point();
+    return success;
+}
+
+static bool queue_pending (void)
+{
+    preemption_point();
+    return (0U != m_count);
+}
+
+static rd_status_t queue_start (void)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if (m_on_air)
+    {
+        m_double_starts++;
+    }
+
+    preemption_point();
+
+    if (m_writer_active)
+    {
+        err_code |= RD_ERROR_BUSY;
+    }
+    else if (0U == m_count)
+    {
+        err_code |= RD_ERROR_NOT_FOUND;
+    }
+    else
+    {
+        const uint32_t id = m_queue[m_head];
+        m_head = (m_head + 1U) % QUEUE_LENGTH;
+        m_count--;
+        preemption_point();
+
+        if ( (0U != m_fail_start) && (0U == (rand_next() % m_fail_start)))
+        {
+            m_dropped++;
+            err_code |= RD_ERROR_INTERNAL;
+        }
+        else
+        {
+            m_on_air = true;
+            m_on_air_id = id;
+            m_started++;
+        }
+    }
+
+    return err_code;
+}
+
+static rd_status_t slot_next (const bool first)
+{
+    if (m_on_air)
+    {
+        m_double_starts++;
+    }
+
+    preemption_point();
+    m_on_air = true;
+    m_on_air_slot = true;
+    m_slots_started++;
+    return RD_SUCCESS;
+}
+
+static void on_terminated (void);
+
+static bool slot_halt (void)
+{
+    bool stopped = false;
+
+    if (m_terminate_in_halt)
+    {
+        m_terminate_in_halt = false;
+        m_in_isr = true;
+        on_terminated();
+        m_in_isr = false;
+    }
+
+    preemption_point();
+
+    if (m_on_air)
+    {
+        m_halted_queued += m_on_air_slot ? 0U : 1U;
+        m_on_air = false;
+        m_on_air_slot = false;
+        stopped = true;
+    }
+
+    return stopped;
+}
+
+/** @brief Advertisement terminated. */
+static void on_terminated (void)
+{
+    if (m_on_air)
+    {
+        const bool was_slot = m_on_air_slot;
+        m_on_air = false;
+        m_on_air_slot = false;
+
+        if (RD_ERROR_NOT_FOUND == ri_comm_rotation_terminated (&m_rotation))
+        {
+            m_misrouted += was_slot ? 1U : 0U;
+            ri_comm_tx_gate_release (&m_gate);
+            (void) ri_comm_tx_gate_kick (&m_gate);
+        }
+        else
+        {
+            m_misrouted += was_slot ? 0U : 1U;
+        }
+    }
+}
+
+/** @brief Termination event or a send from interrupt context. */
+static void simulated_isr (void)
+{
+    if (0U == (rand_next() % 2U))
+    {
+        on_terminated();
+    }
+    else if (queue_push())
+    {
+        (void) ri_comm_tx_gate_kick (&m_gate);
+    }
+    else
+    {
+        // Queue full, send fails.
+    }
+}
+
+/** @brief Queued message is either on air or owner of gate picks it up. */
+static void assert_no_stall (void)
+{
+    TEST_ASSERT ( (0U == m_count) || ri_comm_tx_gate_is_busy (&m_gate));
+    TEST_ASSERT (m_on_air == ri_comm_tx_gate_is_busy (&m_gate));
+}
+
+static void stress (const uint32_t seed, const uint32_t fail_start, const bool rotate)
+{
+    setUp();
+    m_seed = seed;
+    m_fail_start = fail_start;
+    m_preempt = true;
+
+    for (uint32_t round = 0; round < STRESS_ROUNDS; round++)
+    {
+        const uint32_t action = rand_next() % (rotate ? 8U : 2U);
+
+        if (0U == action)
+        {
+            if (queue_push())
+            {
+                (void) ri_comm_tx_gate_kick (&m_gate);
+            }
+        }
+        else if (1U == action)
+        {
+            m_in_isr = true;
+            on_terminated();
+            m_in_isr = false;
+        }
+        else if (2U == action)
+        {
+            (void) ri_comm_rotation_start (&m_rotation);
+        }
+        else if (3U == action)
+        {
+            TEST_ASSERT (RD_SUCCESS == ri_comm_rotation_stop (&m_rotation));
+            TEST_ASSERT_FALSE (ri_comm_rotation_is_running (&m_rotation));
+        }
+        else
+        {
+            // Interrupts outnumber thread calls, rotation turns keep ending.
+            m_in_isr = true;
+            on_terminated();
+            m_in_isr = false;
+        }
+
+        assert_no_stall();
+    }
+
+    m_preempt = false;
+    TEST_ASSERT (RD_SUCCESS == ri_comm_rotation_stop (&m_rotation));
+
+    while (m_on_air)
+    {
+        on_terminated();
+    }
+
+    TEST_ASSERT_EQUAL (0U, m_double_starts);
+    TEST_ASSERT_EQUAL (0U, m_halted_queued);
+    TEST_ASSERT_EQUAL (0U, m_misrouted);
+    TEST_ASSERT_EQUAL (0U, m_count);
+    TEST_ASSERT_EQUAL (m_queued, m_started + m_dropped);
+    TEST_ASSERT (m_started > (STRESS_ROUNDS / 8U));
+    TEST_ASSERT_FALSE (ri_comm_tx_gate_is_busy (&m_gate));
+}
+
+void setUp (void)
+{
+    memset (&m_gate, 0, sizeof (m_gate));
+    m_gate.pending = queue_pending;
+    m_gate.start = queue_start;
+    memset (&m_rotation, 0, sizeof (m_rotation));
+    m_rotation.p_gate = &m_gate;
+    m_rotation.next = slot_next;
+    m_rotation.halt = slot_halt;
+    m_head = 0;
+    m_count = 0;
+    m_next_id = 0;
+    m_queued = 0;
+    m_started = 0;
+    m_dropped = 0;
+    m_double_starts = 0;
+    m_on_air = false;
+    m_on_air_id = 0;
+    m_on_air_slot = false;
+    m_slots_started = 0;
+    m_halted_queued = 0;
+    m_misrouted = 0;
+    m_terminate_in_halt = false;
+    m_fail_start = 0;
+    m_writer_active = false;
+    m_preempt = false;
+    m_in_isr = false;
+}
+
+void tearDown (void)
+{
+}
+
+void test_ri_comm_tx_gate_kick_null (void)
+{
+    TEST_ASSERT (RD_ERROR_NULL == ri_comm_tx_gate_kick (NULL));
+    m_gate.start = NULL;
+    TEST_ASSERT (RD_ERROR_NULL == ri_comm_tx_gate_kick (&m_gate));
+    TEST_ASSERT_FALSE (ri_comm_tx_gate_acquire (NULL));
+    TEST_ASSERT_FALSE (ri_comm_tx_gate_is_busy (NULL));
+    ri_comm_tx_gate_release (NULL);
+}
+
+void test_ri_comm_tx_gate_kick_empty (void)
+{
+    TEST_ASSERT (RD_SUCCESS == ri_comm_tx_gate_kick (&m_gate));
+    TEST_ASSERT_FALSE (ri_comm_tx_gate_is_busy (&m_gate));
+    TEST_ASSERT_EQUAL (0U, m_started);
+}
+
+void test_ri_comm_tx_gate_starts_in_order (void)
+{
+    queue_push();
+    queue_push();
+    TEST_ASSERT (RD_SUCCESS == ri_comm_tx_gate_kick (&m_gate));
+    TEST_ASSERT (ri_comm_tx_gate_is_busy (&m_gate));
+    TEST_ASSERT_EQUAL (0U, m_on_air_id);
+    // Busy, second message waits for termination.
+    TEST_ASSERT (RD_SUCCESS == ri_comm_tx_gate_kick (&m_gate));
+    TEST_ASSERT_EQUAL (1U, m_started);
+    on_terminated();
+    TEST_ASSERT_EQUAL (2U, m_started);
+    TEST_ASSERT_EQUAL (1U, m_on_air_id);
+    on_terminated();
+    TEST_ASSERT_FALSE (ri_comm_tx_gate_is_busy (&m_gate));
+    TEST_ASSERT_EQUAL (0U, m_double_starts);
+}
+
+void test_ri_comm_tx_gate_failed_start_drops_and_continues (void)
+{
+    queue_push();
+    queue_push();
+    queue_push();
+    m_fail_start = 1U;
+    TEST_ASSERT (RD_ERROR_INTERNAL == ri_comm_tx_gate_kick (&m_gate));
+    TEST_ASSERT_EQUAL (3U, m_dropped);
+    TEST_ASSERT_EQUAL (0U, m_count);
+    TEST_ASSERT_FALSE (ri_comm_tx_gate_is_busy (&m_gate));
+}
+
+void test_ri_comm_tx_gate_acquire_blocks_queue (void)
+{
+    TEST_ASSERT (ri_comm_tx_gate_acquire (&m_gate));
+    TEST_ASSERT_FALSE (ri_comm_tx_gate_acquire (&m_gate));
+    queue_push();
+    TEST_ASSERT (RD_SUCCESS == ri_comm_tx_gate_kick (&m_gate));
+    TEST_ASSERT_EQUAL (0U, m_started);
+    ri_comm_tx_gate_release (&m_gate);
+    TEST_ASSERT (RD_SUCCESS == ri_comm_tx_gate_kick (&m_gate));
+    TEST_ASSERT_EQUAL (1U, m_started);
+}
+
+void test_ri_comm_tx_gate_busy_start_left_to_writer (void)
+{
+    queue_push();
+    m_writer_active = true;
+    // Start blocked by preempted writer, gate is freed without spinning.
+    TEST_ASSERT (RD_SUCCESS == ri_comm_tx_gate_kick (&m_gate));
+    TEST_ASSERT_FALSE (ri_comm_tx_gate_is_busy (&m_gate));
+    TEST_ASSERT_EQUAL (1U, m_count);
+    m_writer_active = false;
+    TEST_ASSERT (RD_SUCCESS == ri_comm_tx_gate_kick (&m_gate));
+    TEST_ASSERT_EQUAL (1U, m_started);
+}
+
+void test_ri_comm_tx_gate_stress_interleaved (void)
+{
+    for (uint32_t seed = 1U; seed <= STRESS_SEEDS; seed++)
+    {
+        stress (seed, 0U, false);
+    }
+}
+
+void test_ri_comm_tx_gate_stress_with_failures (void)
+{
+    for (uint32_t seed = 1U; seed <= STRESS_SEEDS; seed++)
+    {
+        stress (seed * 7919U, 5U, false);
+    }
+}
+
+void test_ri_comm_tx_gate_rotation_stop_preempted_by_terminate (void)
+{
+    TEST_ASSERT (RD_SUCCESS == ri_comm_rotation_start (&m_rotation));
+    queue_push();
+    TEST_ASSERT (RD_SUCCESS == ri_comm_tx_gate_kick (&m_gate));
+    TEST_ASSERT_EQUAL (0U, m_started);
+    // Slot terminates after stop request but before halt.
+    m_terminate_in_halt = true;
+    TEST_ASSERT (RD_SUCCESS == ri_comm_rotation_stop (&m_rotation));
+    TEST_ASSERT_FALSE (ri_comm_rotation_is_running (&m_rotation));
+    TEST_ASSERT_EQUAL (1U, m_slots_started);
+    TEST_ASSERT_EQUAL (0U, m_halted_queued);
+    TEST_ASSERT_EQUAL (1U, m_started);
+    TEST_ASSERT (m_on_air);
+    on_terminated();
+    TEST_ASSERT_FALSE (ri_comm_tx_gate_is_busy (&m_gate));
+    TEST_ASSERT_EQUAL (0U, m_double_starts);
+    TEST_ASSERT_EQUAL (0U, m_misrouted);
+}
+
+void test_ri_comm_tx_gate_stress_with_rotation (void)
+{
+    for (uint32_t seed = 1U; seed <= STRESS_SEEDS; seed++)
+    {
+        stress (seed * 104729U, 0U, true);
+        TEST_ASSERT (m_slots_started > 0U);
+    }
+}
@@ -0,0 +1,515 @@
+#include "unity.h"
+
+#include "ruuvi_driver_enabled_modules.h"
+#include "ruuvi_driver_error.h"
+#include "ruuvi_interface_aes.h"
+#include "ruuvi_interface_aes_ctr.h"
+
+#include <string.h>
+
+static uint8_t m_sbox[256];
+static size_t m_ecb_calls;
+static size_t m_ecb_blocks;
+static rd_status_t m_ecb_error;
+
+static uint8_t xtime (const uint8_t x)
+{
+    return (uint8_t) ( (x << 1U) ^ ( (x & 0x80U) ? 0x1BU : 0x00U));
+}
+
+static uint8_t rotl8 (const uint8_t x, const uint8_t shift)
+{
+    return (uint8_t) ( (x << shift) | (x >> (8U - shift)));
+}
+
+/** Generate S-box from multiplicative inverse and affine transform, FIPS-197 5.1.1. */
+static void sbox_init (void)
+{
+    uint8_t p = 1;
+    uint8_t q = 1;
+
+    do
+    {
+        p = (uint8_t) (p ^ xtime (p));
+        q ^= (uint8_t) (q << 1U);
+        q ^= (uint8_t) (q << 2U);
+        q ^= (uint8_t) (q << 4U);
+
+        if (q & 0x80U)
+        {
+            q ^= 0x09U;
+        }
+
+        m_sbox[p] = (uint8_t) (q ^ rotl8 (q, 1) ^ rotl8 (q, 2) ^ rotl8 (q, 3)
+                               ^ rotl8 (q, 4) ^ 0x63U);
+    } while (1U != p);
+
+    m_sbox[0] = 0x63U;
+}
+
+/** Reference AES-128 block encryption, FIPS-197. */
+static void ref_aes_block (const uint8_t * const key, const uint8_t * const in, uint8_t * const out)
+{
+    uint8_t rk[176];
+    uint8_t s[16];
+    uint8_t rcon = 1;
+    memcpy (rk, key, 16);
+
+    for (size_t ii = 16; ii < 176; ii += 4)
+    {
+        uint8_t t[4] = { rk[ii - 4], rk[ii - 3], rk[ii - 2], rk[ii - 1] };
+
+        if (0U == (ii % 16U))
+        {
+            const uint8_t t0 = t[0];
+            t[0] = (uint8_t) (m_sbox[t[1]] ^ rcon);
+            t[1] = m_sbox[t[2]];
+            t[2] = m_sbox[t[3]];
+            t[3] = m_sbox[t0];
+            rcon = xtime (rcon);
+        }
+
+        for (size_t jj = 0; jj < 4; jj++)
+        {
+            rk[ii + jj] = (uint8_t) (rk[ii + jj - 16] ^ t[jj]);
+        }
+    }
+
+    for (size_t ii = 0; ii < 16; ii++)
+    {
+        s[ii] = (uint8_t) (in[ii] ^ rk[ii]);
+    }
+
+    for (size_t round = 1; round <= 10; round++)
+    {
+        uint8_t t[16];
+
+        // SubBytes and ShiftRows.
+        for (size_t ii = 0; ii < 16; ii++)
+        {
+            t[ii] = m_sbox[s[ (ii + 4U * (ii % 4U)) % 16U]];
+        }
+
+        // MixColumns except in last round.
+        for (size_t col = 0; col < 16; col += 4)
+        {
+            const uint8_t a0 = t[col];
+            const uint8_t a1 = t[col + 1];
+            const uint8_t a2 = t[col + 2];
+            const uint8_t a3 = t[col + 3];
+
+            if (10U > round)
+            {
+                const uint8_t all = (uint8_t) (a0 ^ a1 ^ a2 ^ a3);
+                t[col]     ^= (uint8_t) (all ^ xtime ( (uint8_t) (a0 ^ a1)));
+                t[col + 1] ^= (uint8_t) (all ^ xtime ( (uint8_t) (a1 ^ a2)));
+                t[col + 2] ^= (uint8_t) (all ^ xtime ( (uint8_t) (a2 ^ a3)));
+                t[col + 3] ^= (uint8_t) (all ^ xtime ( (uint8_t) (a3 ^ a0)));
+            }
+        }
+
+        for (size_t ii = 0; ii < 16; ii++)
+        {
+            s[ii] = (uint8_t) (t[ii] ^ rk[round * 16U + ii]);
+        }
+    }
+
+    memcpy (out, s, 16);
+}
+
+rd_status_t ri_aes_ecb_128_encrypt (const uint8_t * const cleartext,
+                                    uint8_t * const ciphertext,
+                                    const uint8_t * const key,
+                                    const size_t data_length)
+{
+    m_ecb_calls++;
+
+    if (RD_SUCCESS == m_ecb_error)
+    {
+        for (size_t ii = 0; ii < data_length; ii += 16)
+        {
+            ref_aes_block (key, cleartext + ii, ciphertext + ii);
+            m_ecb_blocks++;
+        }
+    }
+
+    return m_ecb_error;
+}
+
+static const uint8_t m_sp800_key[16] =
+{
+    0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6, 0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c
+};
+
+static const uint8_t m_sp800_counter[16] =
+{
+    0xf0, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8, 0xf9, 0xfa, 0xfb, 0xfc, 0xfd, 0xfe, 0xff
+};
+
+static const uint8_t m_sp800_plain[64] =
+{
+    0x6b, 0xc1, 0xbe, 0xe2, 0x2e, 0x40, 0x9f, 0x96, 0xe9, 0x3d, 0x7e, 0x11, 0x73, 0x93, 0x17, 0x2a,
+    0xae, 0x2d, 0x8a, 0x57, 0x1e, 0x03, 0xac, 0x9c, 0x9e, 0xb7, 0x6f, 0xac, 0x45, 0xaf, 0x8e, 0x51,
+    0x30, 0xc8, 0x1c, 0x46, 0xa3, 0x5c, 0xe4, 0x11, 0xe5, 0xfb, 0xc1, 0x19, 0x1a, 0x0a, 0x52, 0xef,
+    0xf6, 0x9f, 0x24, 0x45, 0xdf, 0x4f, 0x9b, 0x17, 0xad, 0x2b, 0x41, 0x7b, 0xe6, 0x6c, 0x37, 0x10
+};
+
+/** NIST SP 800-38A F.5.1 CTR-AES128.Encrypt. */
+static const uint8_t m_sp800_cipher[64] =
+{
+    0x87, 0x4d, 0x61, 0x91, 0xb6, 0x20, 0xe3, 0x26, 0x1b, 0xef, 0x68, 0x64, 0x99, 0x0d, 0xb6, 0xce,
+    0x98, 0x06, 0xf6, 0x6b, 0x79, 0x70, 0xfd, 0xff, 0x86, 0x17, 0x18, 0x7b, 0xb9, 0xff, 0xfd, 0xff,
+    0x5a, 0xe4, 0xdf, 0x3e, 0xdb, 0xd5, 0xd3, 0x5e, 0x5b, 0x4f, 0x09, 0x02, 0x0d, 0xb0, 0x3e, 0xab,
+    0x1e, 0x03, 0x1d, 0xda, 0x2f, 0xbe, 0x03, 0xd1, 0x79, 0x21, 0x70, 0xa0, 0xf3, 0x00, 0x9c, 0xee
+};
+
+static const uint8_t m_rfc3610_key[16] =
+{
+    0xc0, 0xc1, 0xc2, 0xc3, 0xc4, 0xc5, 0xc6, 0xc7, 0xc8, 0xc9, 0xca, 0xcb, 0xcc, 0xcd, 0xce, 0xcf
+};
+
+static const uint8_t m_rfc3610_nonce[13] =
+{
+    0x00, 0x00, 0x00, 0x03, 0x02, 0x01, 0x00, 0xa0, 0xa1, 0xa2, 0xa3, 0xa4, 0xa5
+};
+
+static const uint8_t m_rfc3610_aad[8] = { 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07 };
+
+static const uint8_t m_rfc3610_plain[23] =
+{
+    0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x10, 0x11, 0x12, 0x13,
+    0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e
+};
+
+/** RFC 3610 Packet Vector #1. */
+static const uint8_t m_rfc3610_cipher[23] =
+{
+    0x58, 0x8c, 0x97, 0x9a, 0x61, 0xc6, 0x63, 0xd2, 0xf0, 0x66, 0xd0, 0xc2,
+    0xc0, 0xf9, 0x89, 0x80, 0x6d, 0x5f, 0x6b, 0x61, 0xda, 0xc3, 0x84
+};
+
+static const uint8_t m_rfc3610_tag[8] = { 0x17, 0xe8, 0xd1, 0x2c, 0xfd, 0xf9, 0x26, 0xe0 };
+
+void setUp (void)
+{
+    sbox_init();
+    m_ecb_calls = 0;
+    m_ecb_blocks = 0;
+    m_ecb_error = RD_SUCCESS;
+}
+
+void tearDown (void)
+{
+}
+
+void test_reference_aes_fips197 (void)
+{
+    const uint8_t key[16] =
+    {
+        0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f
+    };
+    const uint8_t plain[16] =
+    {
+        0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff
+    };
+    const uint8_t expect[16] =
+    {
+        0x69, 0xc4, 0xe0, 0xd8, 0x6a, 0x7b, 0x04, 0x30, 0xd8, 0xcd, 0xb7, 0x80, 0x70, 0xb4, 0xc5, 0x5a
+    };
+    uint8_t out[16];
+    ref_aes_block (key, plain, out);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY (expect, out, sizeof (out));
+}
+
+void test_ri_aes_ctr_sp800_38a (void)
+{
+    ri_aes_ctr_t ctx;
+    uint8_t out[64];
+    TEST_ASSERT (RD_SUCCESS == ri_aes_ctr_init (&ctx, m_sp800_key, m_sp800_counter));
+    TEST_ASSERT (RD_SUCCESS == ri_aes_ctr_crypt (&ctx, m_sp800_plain, out, sizeof (out)));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY (m_sp800_cipher, out, sizeof (out));
+}
+
+void test_ri_aes_ctr_decrypt_in_place (void)
+{
+    ri_aes_ctr_t ctx;
+    uint8_t data[64];
+    memcpy (data, m_sp800_cipher, sizeof (data));
+    TEST_ASSERT (RD_SUCCESS == ri_aes_ctr_init (&ctx, m_sp800_key, m_sp800_counter));
+    TEST_ASSERT (RD_SUCCESS == ri_aes_ctr_crypt (&ctx, data, data, sizeof (data)));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY (m_sp800_plain, data, sizeof (data));
+}
+
+void test_ri_aes_ctr_stream_split (void)
+{
+    ri_aes_ctr_t ctx;
+    uint8_t out[64];
+    const size_t splits[] = { 1, 7, 16, 3, 21, 16 };
+    size_t done = 0;
+    TEST_ASSERT (RD_SUCCESS == ri_aes_ctr_init (&ctx, m_sp800_key, m_sp800_counter));
+
+    for (size_t ii = 0; ii < (sizeof (splits) / sizeof (splits[0])); ii++)
+    {
+        TEST_ASSERT (RD_SUCCESS == ri_aes_ctr_crypt (&ctx, m_sp800_plain + done, out + done,
+                     splits[ii]));
+        done += splits[ii];
+    }
+
+    TEST_ASSERT_EQUAL (sizeof (out), done);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY (m_sp800_cipher, out, sizeof (out));
+}
+
+void test_ri_aes_ctr_precompute_hot_path_no_aes (void)
+{
+    ri_aes_ctr_t ctx;
+    uint8_t out[RI_AES_CTR_KEYSTREAM_BLOCKS * RI_AES_BLOCK_SIZE];
+    TEST_ASSERT (RD_SUCCESS == ri_aes_ctr_init (&ctx, m_sp800_key, m_sp800_counter));
+    TEST_ASSERT (RD_SUCCESS == ri_aes_ctr_precompute (&ctx));
+    TEST_ASSERT_EQUAL (1, m_ecb_calls);
+    TEST_ASSERT_EQUAL (sizeof (out), ri_aes_ctr_available (&ctx));
+    TEST_ASSERT (RD_SUCCESS == ri_aes_ctr_crypt (&ctx, m_sp800_plain, out, sizeof (out)));
+    TEST_ASSERT_EQUAL (1, m_ecb_calls);
+    TEST_ASSERT_EQUAL (0, ri_aes_ctr_available (&ctx));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY (m_sp800_cipher, out, sizeof (out));
+}
+
+void test_ri_aes_ctr_precompute_tops_up (void)
+{
+    ri_aes_ctr_t ctx;
+    uint8_t out[64];
+    TEST_ASSERT (RD_SUCCESS == ri_aes_ctr_init (&ctx, m_sp800_key, m_sp800_counter));
+    TEST_ASSERT (RD_SUCCESS == ri_aes_ctr_precompute (&ctx));
+    TEST_ASSERT (RD_SUCCESS == ri_aes_ctr_crypt (&ctx, m_sp800_plain, out, 20));
+    TEST_ASSERT (RD_SUCCESS == ri_aes_ctr_precompute (&ctx));
+    TEST_ASSERT_EQUAL (RI_AES_CTR_KEYSTREAM_BLOCKS * RI_AES_BLOCK_SIZE - 4U,
+                       ri_aes_ctr_available (&ctx));
+    TEST_ASSERT (RD_SUCCESS == ri_aes_ctr_crypt (&ctx, m_sp800_plain + 20, out + 20, 44));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY (m_sp800_cipher, out, sizeof (out));
+    TEST_ASSERT_EQUAL (m_ecb_blocks, 5);
+}
+
+void test_ri_aes_ctr_underrun_generates_needed_blocks (void)
+{
+    ri_aes_ctr_t ctx;
+    uint8_t out[20];
+    TEST_ASSERT (RD_SUCCESS == ri_aes_ctr_init (&ctx, m_sp800_key, m_sp800_counter));
+    TEST_ASSERT (RD_SUCCESS == ri_aes_ctr_crypt (&ctx, m_sp800_plain, out, sizeof (out)));
+    TEST_ASSERT_EQUAL (2, m_ecb_blocks);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY (m_sp800_cipher, out, sizeof (out));
+}
+
+void test_ri_aes_ctr_counter_wraps (void)
+{
+    ri_aes_ctr_t ctx;
+    uint8_t counter[16];
+    uint8_t out[32];
+    uint8_t expect[16];
+    const uint8_t zero[32] = {0};
+    const uint8_t wrapped[16] =
+    {
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
+    };
+    memset (counter, 0, sizeof (counter));
+    memset (counter + 8, 0xFF, 8);
+    TEST_ASSERT (RD_SUCCESS == ri_aes_ctr_init (&ctx, m_sp800_key, counter));
+    TEST_ASSERT (RD_SUCCESS == ri_aes_ctr_crypt (&ctx, zero, out, sizeof (out)));
+    ref_aes_block (m_sp800_key, wrapped, expect);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY (expect, out + 16, sizeof (expect));
+}
+
+void test_ri_aes_ctr_ecb_error (void)
+{
+    ri_aes_ctr_t ctx;
+    uint8_t out[16];
+    TEST_ASSERT (RD_SUCCESS == ri_aes_ctr_init (&ctx, m_sp800_key, m_sp800_counter));
+    m_ecb_error = RD_ERROR_INTERNAL;
+    TEST_ASSERT (RD_ERROR_INTERNAL == ri_aes_ctr_crypt (&ctx, m_sp800_plain, out, sizeof (out)));
+    TEST_ASSERT (RD_ERROR_INTERNAL == ri_aes_ctr_precompute (&ctx));
+    TEST_ASSERT_EQUAL (0, ri_aes_ctr_available (&ctx));
+    // Counter is not consumed by failed calls.
+    m_ecb_error = RD_SUCCESS;
+    TEST_ASSERT (RD_SUCCESS == ri_aes_ctr_crypt (&ctx, m_sp800_plain, out, sizeof (out)));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY (m_sp800_cipher, out, sizeof (out));
+}
+
+void test_ri_aes_ctr_null (void)
+{
+    ri_aes_ctr_t ctx;
+    uint8_t out[16];
+    TEST_ASSERT (RD_ERROR_NULL == ri_aes_ctr_init (NULL, m_sp800_key, m_sp800_counter));
+    TEST_ASSERT (RD_ERROR_NULL == ri_aes_ctr_init (&ctx, NULL, m_sp800_counter));
+    TEST_ASSERT (RD_ERROR_NULL == ri_aes_ctr_init (&ctx, m_sp800_key, NULL));
+    TEST_ASSERT (RD_SUCCESS == ri_aes_ctr_init (&ctx, m_sp800_key, m_sp800_counter));
+    TEST_ASSERT (RD_ERROR_NULL == ri_aes_ctr_precompute (NULL));
+    TEST_ASSERT (RD_ERROR_NULL == ri_aes_ctr_crypt (NULL, m_sp800_plain, out, sizeof (out)));
+    TEST_ASSERT (RD_ERROR_NULL == ri_aes_ctr_crypt (&ctx, NULL, out, sizeof (out)));
+    TEST_ASSERT (RD_ERROR_NULL == ri_aes_ctr_crypt (&ctx, m_sp800_plain, NULL, sizeof (out)));
+    TEST_ASSERT_EQUAL (0, ri_aes_ctr_available (NULL));
+}
+
+void test_ri_aes_ccm_rfc3610 (void)
+{
+    ri_aes_ccm_t ctx;
+    uint8_t out[sizeof (m_rfc3610_plain)];
+    uint8_t tag[sizeof (m_rfc3610_tag)];
+    TEST_ASSERT (RD_SUCCESS == ri_aes_ccm_init (&ctx, m_rfc3610_key, m_rfc3610_nonce));
+    TEST_ASSERT (RD_SUCCESS == ri_aes_ccm_encrypt (&ctx, m_rfc3610_aad, sizeof (m_rfc3610_aad),
+                 m_rfc3610_plain, out, sizeof (out),
+                 tag, sizeof (tag)));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY (m_rfc3610_cipher, out, sizeof (out));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY (m_rfc3610_tag, tag, sizeof (tag));
+}
+
+void test_ri_aes_ccm_precomputed_in_place (void)
+{
+    ri_aes_ccm_t ctx;
+    uint8_t data[sizeof (m_rfc3610_plain)];
+    uint8_t tag[sizeof (m_rfc3610_tag)];
+    memcpy (data, m_rfc3610_plain, sizeof (data));
+    TEST_ASSERT (RD_SUCCESS == ri_aes_ccm_init (&ctx, m_rfc3610_key, m_rfc3610_nonce));
+    TEST_ASSERT (RD_SUCCESS == ri_aes_ccm_precompute (&ctx));
+    m_ecb_blocks = 0;
+    TEST_ASSERT (RD_SUCCESS == ri_aes_ccm_encrypt (&ctx, m_rfc3610_aad, sizeof (m_rfc3610_aad),
+                 data, data, sizeof (data),
+                 tag, sizeof (tag)));
+    // Only CBC-MAC blocks: B0, additional data and two payload blocks.
+    TEST_ASSERT_EQUAL (4, m_ecb_blocks);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY (m_rfc3610_cipher, data, sizeof (data));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY (m_rfc3610_tag, tag, sizeof (tag));
+}
+
+void test_ri_aes_ctr_uninit_clears_key (void)
+{
+    ri_aes_ctr_t ctx;
+    const ri_aes_ctr_t zero = {0};
+    TEST_ASSERT (RD_SUCCESS == ri_aes_ctr_init (&ctx, m_sp800_key, m_sp800_counter));
+    TEST_ASSERT (RD_SUCCESS == ri_aes_ctr_precompute (&ctx));
+    ri_aes_ctr_uninit (&ctx);
+    TEST_ASSERT_EQUAL_MEMORY (&zero, &ctx, sizeof (ctx));
+    ri_aes_ctr_uninit (NULL);
+}
+
+void test_ri_aes_ccm_encrypt_clears_key (void)
+{
+    ri_aes_ccm_t ctx;
+    const ri_aes_ctr_t zero = {0};
+    uint8_t out[sizeof (m_rfc3610_plain)];
+    uint8_t tag[sizeof (m_rfc3610_tag)];
+    TEST_ASSERT (RD_SUCCESS == ri_aes_ccm_init (&ctx, m_rfc3610_key, m_rfc3610_nonce));
+    TEST_ASSERT (RD_SUCCESS == ri_aes_ccm_precompute (&ctx));
+    TEST_ASSERT (RD_SUCCESS == ri_aes_ccm_encrypt (&ctx, m_rfc3610_aad, sizeof (m_rfc3610_aad),
+                 m_rfc3610_plain, out, sizeof (out),
+                 tag, sizeof (tag)));
+    TEST_ASSERT_EQUAL_MEMORY (&zero, &ctx.ctr, sizeof (ctx.ctr));
+}
+
+void test_ri_aes_ccm_decrypt_clears_key (void)
+{
+    ri_aes_ccm_t ctx;
+    const ri_aes_ctr_t zero = {0};
+    uint8_t out[sizeof (m_rfc3610_cipher)];
+    TEST_ASSERT (RD_SUCCESS == ri_aes_ccm_init (&ctx, m_rfc3610_key, m_rfc3610_nonce));
+    TEST_ASSERT (RD_ERROR_INVALID_DATA == ri_aes_ccm_decrypt (&ctx, NULL, 0,
+                 m_rfc3610_cipher, out, sizeof (out),
+                 m_rfc3610_tag, sizeof (m_rfc3610_tag)));
+    TEST_ASSERT_EQUAL_MEMORY (&zero, &ctx.ctr, sizeof (ctx.ctr));
+}
+
+void test_ri_aes_ccm_decrypt (void)
+{
+    ri_aes_ccm_t ctx;
+    uint8_t out[sizeof (m_rfc3610_cipher)];
+    TEST_ASSERT (RD_SUCCESS == ri_aes_ccm_init (&ctx, m_rfc3610_key, m_rfc3610_nonce));
+    TEST_ASSERT (RD_SUCCESS == ri_aes_ccm_decrypt (&ctx, m_rfc3610_aad, sizeof (m_rfc3610_aad),
+                 m_rfc3610_cipher, out, sizeof (out),
+                 m_rfc3610_tag, sizeof (m_rfc3610_tag)));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY (m_rfc3610_plain, out, sizeof (out));
+}
+
+void test_ri_aes_ccm_decrypt_tampered (void)
+{
+    ri_aes_ccm_t ctx;
+    uint8_t data[sizeof (m_rfc3610_cipher)];
+    const uint8_t zero[sizeof (m_rfc3610_cipher)] = {0};
+    memcpy (data, m_rfc3610_cipher, sizeof (data));
+    data[5] ^= 0x01U;
+    TEST_ASSERT (RD_SUCCESS == ri_aes_ccm_init (&ctx, m_rfc3610_key, m_rfc3610_nonce));
+    TEST_ASSERT (RD_ERROR_INVALID_DATA == ri_aes_ccm_decrypt (&ctx, m_rfc3610_aad,
+                 sizeof (m_rfc3610_aad),
+                 data, data, sizeof (data),
+                 m_rfc3610_tag, sizeof (m_rfc3610_tag)));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY (zero, data, sizeof (data));
+}
+
+void test_ri_aes_ccm_round_trip_no_aad (void)
+{
+    ri_aes_ccm_t ctx;
+    uint8_t cipher[40];
+    uint8_t plain[40];
+    uint8_t tag[16];
+
+    for (size_t ii = 0; ii < sizeof (plain); ii++)
+    {
+        plain[ii] = (uint8_t) ii;
+    }
+
+    TEST_ASSERT (RD_SUCCESS == ri_aes_ccm_init (&ctx, m_rfc3610_key, m_rfc3610_nonce));
+    TEST_ASSERT (RD_SUCCESS == ri_aes_ccm_encrypt (&ctx, NULL, 0, plain, cipher,
+                 sizeof (cipher), tag, sizeof (tag)));
+    TEST_ASSERT (RD_SUCCESS == ri_aes_ccm_init (&ctx, m_rfc3610_key, m_rfc3610_nonce));
+    TEST_ASSERT (RD_SUCCESS == ri_aes_ccm_decrypt (&ctx, NULL, 0, cipher, cipher,
+                 sizeof (cipher), tag, sizeof (tag)));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY (plain, cipher, sizeof (plain));
+}
+
+void test_ri_aes_ccm_nonce_single_use (void)
+{
+    ri_aes_ccm_t ctx;
+    uint8_t out[sizeof (m_rfc3610_plain)];
+    uint8_t tag[8];
+    TEST_ASSERT (RD_SUCCESS == ri_aes_ccm_init (&ctx, m_rfc3610_key, m_rfc3610_nonce));
+    TEST_ASSERT (RD_SUCCESS == ri_aes_ccm_encrypt (&ctx, NULL, 0, m_rfc3610_plain, out,
+                 sizeof (out), tag, sizeof (tag)));
+    TEST_ASSERT (RD_ERROR_INVALID_STATE == ri_aes_ccm_encrypt (&ctx, NULL, 0, m_rfc3610_plain,
+                 out, sizeof (out), tag, sizeof (tag)));
+    TEST_ASSERT (RD_ERROR_INVALID_STATE == ri_aes_ccm_precompute (&ctx));
+}
+
+void test_ri_aes_ccm_invalid_length (void)
+{
+    ri_aes_ccm_t ctx;
+    uint8_t out[sizeof (m_rfc3610_plain)];
+    uint8_t tag[16];
+    TEST_ASSERT (RD_SUCCESS == ri_aes_ccm_init (&ctx, m_rfc3610_key, m_rfc3610_nonce));
+    TEST_ASSERT (RD_ERROR_INVALID_LENGTH == ri_aes_ccm_encrypt (&ctx, NULL, 0, m_rfc3610_plain,
+                 out, sizeof (out), tag, 3));
+    TEST_ASSERT (RD_ERROR_INVALID_LENGTH == ri_aes_ccm_encrypt (&ctx, NULL, 0, m_rfc3610_plain,
+                 out, sizeof (out), tag, 7));
+    TEST_ASSERT (RD_ERROR_INVALID_LENGTH == ri_aes_ccm_encrypt (&ctx, NULL, 0, m_rfc3610_plain,
+                 out, sizeof (out), tag, 18));
+    TEST_ASSERT (RD_ERROR_INVALID_LENGTH == ri_aes_ccm_encrypt (&ctx, m_rfc3610_aad,
+                 RI_AES_CCM_MAX_AAD + 1U, m_rfc3610_plain, out, sizeof (out), tag, 8));
+    TEST_ASSERT (RD_ERROR_INVALID_LENGTH == ri_aes_ccm_encrypt (&ctx, NULL, 0, m_rfc3610_plain,
+                 out, RI_AES_CCM_MAX_LENGTH + 1U, tag, 8));
+}
+
+void test_ri_aes_ccm_null (void)
+{
+    ri_aes_ccm_t ctx;
+    uint8_t out[sizeof (m_rfc3610_plain)];
+    uint8_t tag[8];
+    TEST_ASSERT (RD_ERROR_NULL == ri_aes_ccm_init (NULL, m_rfc3610_key, m_rfc3610_nonce));
+    TEST_ASSERT (RD_ERROR_NULL == ri_aes_ccm_init (&ctx, NULL, m_rfc3610_nonce));
+    TEST_ASSERT (RD_ERROR_NULL == ri_aes_ccm_init (&ctx, m_rfc3610_key, NULL));
+    TEST_ASSERT (RD_SUCCESS == ri_aes_ccm_init (&ctx, m_rfc3610_key, m_rfc3610_nonce));
+    TEST_ASSERT (RD_ERROR_NULL == ri_aes_ccm_precompute (NULL));
+    TEST_ASSERT (RD_ERROR_NULL == ri_aes_ccm_encrypt (&ctx, NULL, 8, m_rfc3610_plain, out,
+                 sizeof (out), tag, sizeof (tag)));
+    TEST_ASSERT (RD_ERROR_NULL == ri_aes_ccm_encrypt (&ctx, NULL, 0, NULL, out,
+                 sizeof (out), tag, sizeof (tag)));
+    TEST_ASSERT (RD_ERROR_NULL == ri_aes_ccm_encrypt (&ctx, NULL, 0, m_rfc3610_plain, out,
+                 sizeof (out), NULL, sizeof (tag)));
+    // Authentication only.
+    TEST_ASSERT (RD_SUCCESS == ri_aes_ccm_encrypt (&ctx, m_rfc3610_aad, sizeof (m_rfc3610_aad),
+                 NULL, NULL, 0, tag, sizeof (tag)));
+}
@@ -0,0 +1,128 @@
+#include "unity.h"
+
+#include "ruuvi_driver_enabled_modules.h"
+#include "ruuvi_interface_adc_ntc.h"
+#include "mock_ruuvi_driver_error.h"
+#include "mock_ruuvi_driver_sensor.h"
+#include "mock_ruuvi_interface_adc_mcu.h"
+#include "mock_ruuvi_interface_yield.h"
+
+#define TEST_STEPS       (100000U) //!< Number of ratios checked over 0 ... 1.
+#define K_TO_C           (273.15)
+
+void setUp (void)
+{
+}
+
+void tearDown (void)
+{
+}
+
+/**
+ * Reference natural logarithm, evaluated at runtime without libm.
+ * Argument is halved or doubled into [1, 2) and remainder is expanded
+ * with atanh series until terms vanish.
+ */
+static double ref_ln (double x)
+{
+    const double ln2 = 0.693147180559945309;
+    double result = 0.0;
+
+    while (x >= 2.0)
+    {
+        x /= 2.0;
+        result += ln2;
+    }
+
+    while (x < 1.0)
+    {
+        x *= 2.0;
+        result -= ln2;
+    }
+
+    const double z = (x - 1.0) / (x + 1.0);
+    double term = z;
+
+    for (uint32_t n = 1; n < 200; n += 2)
+    {
+        result += 2.0 * term / (double) n;
+        term *= z * z;
+    }
+
+    return result;
+}
+
+/** Exact Beta equation with default constants. */
+static double ref_temperature (const double ratio)
+{
+    const double rt = (double) RI_ADC_NTC_BALANCE * ratio / (1.0 - ratio);
+    const double t0 = (double) RI_ADC_NTC_DEFAULT_TEMP + K_TO_C;
+    return (1.0 / ( (1.0 / t0) + (ref_ln (rt / (double) RI_ADC_NTC_DEFAULT_RES)
+                                  / (double) RI_ADC_NTC_DEFAULT_BETA))) - K_TO_C;
+}
+
+static double max_error (const double min_c, const double max_c)
+{
+    double worst = 0.0;
+
+    for (uint32_t ii = 1; ii < TEST_STEPS; ii++)
+    {
+        const float ratio = (float) ii / (float) TEST_STEPS;
+        const double exact = ref_temperature ( (double) ratio);
+
+        if ( (exact >= min_c) && (exact <= max_c))
+        {
+            double error = (double) ri_adc_ntc_ratio_to_temperature (ratio) - exact;
+            error = (error < 0.0) ? -error : error;
+            worst = (error > worst) ? error : worst;
+        }
+    }
+
+    return worst;
+}
+
+void test_ri_adc_ntc_ratio_to_temperature_calibration_point (void)
+{
+    // Divider is balanced at calibration temperature.
+    TEST_ASSERT_FLOAT_WITHIN (0.01F, RI_ADC_NTC_DEFAULT_TEMP,
+                              ri_adc_ntc_ratio_to_temperature (0.5F));
+}
+
+void test_ri_adc_ntc_ratio_to_temperature_error_full_range (void)
+{
+    TEST_ASSERT (0.35 > max_error (-40.0, 125.0));
+}
+
+void test_ri_adc_ntc_ratio_to_temperature_error_typical_range (void)
+{
+    TEST_ASSERT (0.05 > max_error (-20.0, 85.0));
+}
+
+void test_ri_adc_ntc_ratio_to_temperature_monotonic (void)
+{
+    float previous = ri_adc_ntc_ratio_to_temperature (0.0F);
+
+    for (uint32_t ii = 1; ii <= TEST_STEPS; ii++)
+    {
+        const float current = ri_adc_ntc_ratio_to_temperature ( (float) ii / (float) TEST_STEPS);
+        TEST_ASSERT (current <= previous);
+        previous = current;
+    }
+}
+
+void test_ri_adc_ntc_ratio_to_temperature_clamped (void)
+{
+    const float hot = ri_adc_ntc_ratio_to_temperature (0.0F);
+    const float cold = ri_adc_ntc_ratio_to_temperature (1.0F);
+    TEST_ASSERT (hot > 150.0F);
+    TEST_ASSERT (cold < -50.0F);
+    TEST_ASSERT_EQUAL_FLOAT (hot, ri_adc_ntc_ratio_to_temperature (0.001F));
+    TEST_ASSERT_EQUAL_FLOAT (cold, ri_adc_ntc_ratio_to_temperature (0.999F));
+}
+
+void test_ri_adc_ntc_ratio_to_temperature_invalid (void)
+{
+    TEST_ASSERT_FLOAT_IS_NAN (ri_adc_ntc_ratio_to_temperature (-0.01F));
+    TEST_ASSERT_FLOAT_IS_NAN (ri_adc_ntc_ratio_to_temperature (1.01F));
+    TEST_ASSERT_FLOAT_IS_NAN (ri_adc_ntc_ratio_to_temperature (RD_FLOAT_INVALID));
+}
@@ -0,0 +1,210 @@
+#include "unity.h"
+
+#include "ruuvi_driver_enabled_modules.h"
+#include "ruuvi_interface_log.h"
+#include "mock_ruuvi_driver_error.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCHMARK_ROUNDS (100000U)
+
+static char m_last_log[RD_LOG_BUFFER_SIZE];
+static char m_log_history[4 * RD_LOG_BUFFER_SIZE];
+static ri_log_severity_t m_last_severity;
+static size_t m_log_calls;
+
+void ri_log (const ri_log_severity_t severity,
+             const char * const message)
+{
+    m_last_severity = severity;
+    strncpy (m_last_log, message, sizeof (m_last_log) - 1);
+    strncat (m_log_history, message, sizeof (m_log_history) - strlen (m_log_history) - 1);
+    m_log_calls++;
+}
+
+void setUp (void)
+{
+    rd_error_check_Ignore();
+    memset (m_last_log, 0, sizeof (m_last_log));
+    memset (m_log_history, 0, sizeof (m_log_history));
+    m_last_severity = RI_LOG_LEVEL_NONE;
+    m_log_calls = 0;
+
+    for (ri_log_module_t ii = 0; ii < RI_LOG_MODULE_COUNT; ii++)
+    {
+        ri_log_module_level_set (ii, RI_LOG_LEVEL_DEBUG);
+    }
+}
+
+void tearDown (void)
+{
+}
+
+void test_ri_log_module_default_passes_all (void)
+{
+    ri_log_module (RI_LOG_MODULE_SENSOR, RI_LOG_LEVEL_DEBUG, "debug");
+    TEST_ASSERT_EQUAL (1, m_log_calls);
+    TEST_ASSERT_EQUAL (RI_LOG_LEVEL_DEBUG, m_last_severity);
+    TEST_ASSERT_EQUAL_STRING ("debug", m_last_log);
+}
+
+void test_ri_log_module_level_filters (void)
+{
+    rd_status_t err_code = ri_log_module_level_set (RI_LOG_MODULE_GATT,
+                           RI_LOG_LEVEL_WARNING);
+    TEST_ASSERT (RD_SUCCESS == err_code);
+    ri_log_module (RI_LOG_MODULE_GATT, RI_LOG_LEVEL_INFO, "info");
+    ri_log_module (RI_LOG_MODULE_GATT, RI_LOG_LEVEL_DEBUG, "debug");
+    TEST_ASSERT_EQUAL (0, m_log_calls);
+    ri_log_module (RI_LOG_MODULE_GATT, RI_LOG_LEVEL_WARNING, "warning");
+    ri_log_module (RI_LOG_MODULE_GATT, RI_LOG_LEVEL_ERROR, "error");
+    TEST_ASSERT_EQUAL (2, m_log_calls);
+    TEST_ASSERT_EQUAL_STRING ("error", m_last_log);
+}
+
+void test_ri_log_module_level_is_per_module (void)
+{
+    ri_log_module_level_set (RI_LOG_MODULE_ADV, RI_LOG_LEVEL_NONE);
+    ri_log_module (RI_LOG_MODULE_ADV, RI_LOG_LEVEL_ERROR, "adv");
+    ri_log_module (RI_LOG_MODULE_UART, RI_LOG_LEVEL_DEBUG, "uart");
+    TEST_ASSERT_EQUAL (1, m_log_calls);
+    TEST_ASSERT_EQUAL_STRING ("uart", m_last_log);
+}
+
+void test_ri_log_module_level_get (void)
+{
+    TEST_ASSERT_EQUAL (RI_LOG_LEVEL_DEBUG,
+                       ri_log_module_level_get (RI_LOG_MODULE_FLASH));
+    ri_log_module_level_set (RI_LOG_MODULE_FLASH, RI_LOG_LEVEL_INFO);
+    TEST_ASSERT_EQUAL (RI_LOG_LEVEL_INFO,
+                       ri_log_module_level_get (RI_LOG_MODULE_FLASH));
+    ri_log_module_level_set (RI_LOG_MODULE_FLASH, RI_LOG_LEVEL_NONE);
+    TEST_ASSERT_EQUAL (RI_LOG_LEVEL_NONE,
+                       ri_log_module_level_get (RI_LOG_MODULE_FLASH));
+}
+
+void test_ri_log_module_invalid_param (void)
+{
+    TEST_ASSERT (RD_ERROR_INVALID_PARAM == ri_log_module_level_set (RI_LOG_MODULE_COUNT,
+                 RI_LOG_LEVEL_INFO));
+    TEST_ASSERT (RD_ERROR_INVALID_PARAM == ri_log_module_level_set (RI_LOG_MODULE_SENSOR,
+                 RI_LOG_LEVEL_DEBUG + 1));
+    TEST_ASSERT_EQUAL (RI_LOG_LEVEL_NONE, ri_log_module_level_get (RI_LOG_MODULE_COUNT));
+    ri_log_module (RI_LOG_MODULE_COUNT, RI_LOG_LEVEL_ERROR, "unknown");
+    TEST_ASSERT_EQUAL (0, m_log_calls);
+}
+
+void test_ri_log_module_macro_compiled_out (void)
+{
+    RI_LOG_MODULE (RI_LOG_MODULE_SENSOR, RI_LOG_LEVEL_WARNING, RI_LOG_LEVEL_DEBUG, "debug");
+    TEST_ASSERT_EQUAL (0, m_log_calls);
+    RI_LOG_MODULE (RI_LOG_MODULE_SENSOR, RI_LOG_LEVEL_WARNING, RI_LOG_LEVEL_ERROR, "error");
+    TEST_ASSERT_EQUAL (1, m_log_calls);
+}
+
+void test_ri_log_module_hex (void)
+{
+    const uint8_t bytes[] = {0xAB, 0x01};
+    ri_log_module_hex (RI_LOG_MODULE_SENSOR, RI_LOG_LEVEL_INFO, bytes, sizeof (bytes));
+    TEST_ASSERT_EQUAL_STRING ("AB:01", m_last_log);
+    ri_log_module_level_set (RI_LOG_MODULE_SENSOR, RI_LOG_LEVEL_ERROR);
+    ri_log_module_hex (RI_LOG_MODULE_SENSOR, RI_LOG_LEVEL_INFO, bytes, sizeof (bytes));
+    TEST_ASSERT_EQUAL (1, m_log_calls);
+}
+
+void test_ri_error_to_string_success (void)
+{
+    char str[32];
+    size_t written = ri_error_to_string (RD_SUCCESS, str, sizeof (str));
+    TEST_ASSERT_EQUAL_STRING ("SUCCESS", str);
+    TEST_ASSERT_EQUAL (strlen ("SUCCESS"), written);
+}
+
+void test_ri_error_to_string_single (void)
+{
+    char str[32];
+    ri_error_to_string (RD_ERROR_NOT_ACKNOWLEDGED, str, sizeof (str));
+    TEST_ASSERT_EQUAL_STRING ("NOT ACKNOWLEDGED", str);
+    ri_error_to_string (RD_ERROR_FATAL, str, sizeof (str));
+    TEST_ASSERT_EQUAL_STRING ("FATAL", str);
+}
+
+void test_ri_error_to_string_multiple (void)
+{
+    char str[64];
+    size_t written = ri_error_to_string (RD_ERROR_FATAL | RD_ERROR_NULL | RD_ERROR_INTERNAL,
+                                         str, sizeof (str));
+    TEST_ASSERT_EQUAL_STRING ("FATAL, NULL, INTERNAL", str);
+    TEST_ASSERT_EQUAL (strlen (str), written);
+}
+
+void test_ri_error_to_string_unknown (void)
+{
+    char str[32];
+    ri_error_to_string ( (1U << 25U), str, sizeof (str));
+    TEST_ASSERT_EQUAL_STRING ("UNKNOWN", str);
+}
+
+void test_ri_error_to_string_truncated (void)
+{
+    char str[8];
+    size_t written = ri_error_to_string (RD_ERROR_INVALID_STATE | RD_ERROR_BUSY,
+                                         str, sizeof (str));
+    TEST_ASSERT_EQUAL_STRING ("BUSY, I", str);
+    TEST_ASSERT_EQUAL (sizeof (str) - 1, written);
+}
+
+void test_ri_error_to_string_null (void)
+{
+    TEST_ASSERT_EQUAL (0, ri_error_to_string (RD_ERROR_INTERNAL, NULL, 10));
+}
+
+void test_ri_log_hex_too_long_not_logged (void)
+{
+    uint8_t bytes[RD_LOG_BUFFER_SIZE] = {0};
+    ri_log_hex (RI_LOG_LEVEL_INFO, bytes, sizeof (bytes));
+    TEST_ASSERT_EQUAL (0, m_log_calls);
+}
+
+void test_ri_log_sensor_configuration (void)
+{
+    const rd_sensor_configuration_t config =
+    {
+        .samplerate = 10,
+        .resolution = RD_SENSOR_CFG_DEFAULT,
+        .scale = RD_SENSOR_CFG_MAX,
+        .dsp_function = RD_SENSOR_DSP_LOW_PASS,
+        .dsp_parameter = 4,
+        .mode = RD_SENSOR_CFG_CONTINUOUS
+    };
+    ri_log_sensor_configuration (RI_LOG_LEVEL_INFO, &config, "g");
+    TEST_ASSERT_EQUAL (5, m_log_calls);
+    TEST_ASSERT_EQUAL_STRING ("Sample rate: 10 Hz\r\n"
+                              "Resolution:  DEFAULT bits\r\n"
+                              "Scale:       MAX g\r\n"
+                              "DSP:         Lowpass x 4\r\n"
+                              "Mode:        CONTINUOUS\r\n", m_log_history);
+}
+
+void test_ri_error_to_string_benchmark (void)
+{
+    char str[RD_LOG_BUFFER_SIZE];
+    char report[64];
+    size_t written = 0;
+    const clock_t start = clock();
+
+    for (uint32_t ii = 0; ii < BENCHMARK_ROUNDS; ii++)
+    {
+        written += ri_error_to_string (RD_ERROR_FATAL | RD_ERROR_TIMEOUT | RD_ERROR_NULL
+                                       | RD_ERROR_INVALID_PARAM, str, sizeof (str));
+    }
+
+    const double elapsed_ns = ( (double) (clock() - start) * 1e9) / CLOCKS_PER_SEC;
+    TEST_ASSERT_EQUAL (BENCHMARK_ROUNDS * strlen ("FATAL, NULL, TIMEOUT, INVALID_PARAM"),
+                       written);
+    snprintf (report, sizeof (report), "ri_error_to_string: %.1f ns/call",
+              elapsed_ns / BENCHMARK_ROUNDS);
+    TEST_MESSAGE (report);
+}
@@ -0,0 +1,159 @@
+#include "unity.h"
+
+#include "ruuvi_driver_enabled_modules.h"
+#include "ruuvi_driver_error.h"
+#include "ruuvi_interface_log_ring.h"
+#include "mock_ruuvi_interface_atomic.h"
+
+#include <stdio.h>
+#include <string.h>
+
+static bool m_lock_fails;
+
+static bool atomic_flag_fake (ri_atomic_t * const flag, const bool set,
+                              int cmock_num_calls)
+{
+    bool success = false;
+
+    if (!m_lock_fails && (*flag != set))
+    {
+        *flag = set;
+        success = true;
+    }
+
+    return success;
+}
+
+void setUp (void)
+{
+    ri_atomic_flag_StubWithCallback (&atomic_flag_fake);
+    m_lock_fails = false;
+    ri_log_ring_uninit();
+    ri_log_ring_init (RI_LOG_LEVEL_INFO);
+    ri_log_ring_clear();
+}
+
+void tearDown (void)
+{
+    ri_log_ring_uninit();
+}
+
+void test_ri_log_ring_write_peek_consume (void)
+{
+    ri_log_ring_entry_t entry;
+    ri_log_ring_write (RI_LOG_LEVEL_INFO, "first");
+    ri_log_ring_write (RI_LOG_LEVEL_ERROR, "second");
+    TEST_ASSERT (RD_SUCCESS == ri_log_ring_peek (&entry));
+    TEST_ASSERT_EQUAL (0, entry.seq);
+    TEST_ASSERT_EQUAL (RI_LOG_LEVEL_INFO, entry.severity);
+    TEST_ASSERT_EQUAL_STRING ("first", entry.text);
+    TEST_ASSERT (RD_SUCCESS == ri_log_ring_consume());
+    TEST_ASSERT (RD_SUCCESS == ri_log_ring_peek (&entry));
+    TEST_ASSERT_EQUAL (1, entry.seq);
+    TEST_ASSERT_EQUAL_STRING ("second", entry.text);
+    TEST_ASSERT (RD_SUCCESS == ri_log_ring_consume());
+    TEST_ASSERT (RD_ERROR_NOT_FOUND == ri_log_ring_peek (&entry));
+    TEST_ASSERT (RD_ERROR_NOT_FOUND == ri_log_ring_consume());
+}
+
+void test_ri_log_ring_severity_filter (void)
+{
+    ri_log_ring_stats_t stats;
+    ri_log_ring_write (RI_LOG_LEVEL_DEBUG, "debug");
+    ri_log_ring_stats_get (&stats);
+    TEST_ASSERT_EQUAL (0, stats.unread);
+}
+
+void test_ri_log_ring_truncates (void)
+{
+    char long_msg[RI_LOG_RING_ENTRY_SIZE * 2];
+    ri_log_ring_entry_t entry;
+    memset (long_msg, 'a', sizeof (long_msg) - 1);
+    long_msg[sizeof (long_msg) - 1] = '\0';
+    ri_log_ring_write (RI_LOG_LEVEL_INFO, long_msg);
+    ri_log_ring_peek (&entry);
+    TEST_ASSERT_EQUAL (RI_LOG_RING_ENTRY_SIZE - 1, strlen (entry.text));
+}
+
+void test_ri_log_ring_overrun (void)
+{
+    ri_log_ring_stats_t stats;
+    ri_log_ring_entry_t entry;
+    char msg[16];
+
+    for (uint32_t ii = 0; ii < (RI_LOG_RING_LENGTH + 3U); ii++)
+    {
+        snprintf (msg, sizeof (msg), "msg %lu", (unsigned long) ii);
+        ri_log_ring_write (RI_LOG_LEVEL_INFO, msg);
+    }
+
+    ri_log_ring_stats_get (&stats);
+    TEST_ASSERT_EQUAL (RI_LOG_RING_LENGTH, stats.unread);
+    TEST_ASSERT_EQUAL (3, stats.overrun);
+    TEST_ASSERT_EQUAL (RI_LOG_RING_LENGTH + 3U, stats.next_seq);
+    ri_log_ring_peek (&entry);
+    TEST_ASSERT_EQUAL (3, entry.seq);
+    TEST_ASSERT_EQUAL_STRING ("msg 3", entry.text);
+}
+
+void test_ri_log_ring_dropped_on_busy (void)
+{
+    ri_log_ring_stats_t stats;
+    ri_log_ring_entry_t entry;
+    m_lock_fails = true;
+    ri_log_ring_write (RI_LOG_LEVEL_INFO, "lost");
+    TEST_ASSERT (RD_ERROR_BUSY == ri_log_ring_peek (&entry));
+    m_lock_fails = false;
+    ri_log_ring_stats_get (&stats);
+    TEST_ASSERT_EQUAL (1, stats.dropped);
+    TEST_ASSERT_EQUAL (0, stats.unread);
+}
+
+void test_ri_log_ring_survives_reboot (void)
+{
+    ri_log_ring_stats_t stats;
+    ri_log_ring_entry_t entry;
+    ri_log_ring_write (RI_LOG_LEVEL_ERROR, "before reset");
+    // Simulate soft reset: RAM contents are kept, module state is not.
+    ri_log_ring_uninit();
+    TEST_ASSERT (RD_SUCCESS == ri_log_ring_init (RI_LOG_LEVEL_INFO));
+    ri_log_ring_stats_get (&stats);
+    TEST_ASSERT_EQUAL (1, stats.boot_count);
+    TEST_ASSERT_EQUAL (2, stats.unread);
+    ri_log_ring_peek (&entry);
+    TEST_ASSERT_EQUAL_STRING ("before reset", entry.text);
+    ri_log_ring_consume();
+    ri_log_ring_peek (&entry);
+    TEST_ASSERT_EQUAL (RI_LOG_LEVEL_NONE, entry.severity);
+    TEST_ASSERT_EQUAL_STRING ("Reboot 1, dropped 0, overrun 0\r\n", entry.text);
+}
+
+void test_ri_log_ring_clear (void)
+{
+    ri_log_ring_stats_t stats;
+    ri_log_ring_write (RI_LOG_LEVEL_ERROR, "before reset");
+    ri_log_ring_uninit();
+    ri_log_ring_init (RI_LOG_LEVEL_INFO);
+    ri_log_ring_clear();
+    ri_log_ring_stats_get (&stats);
+    TEST_ASSERT_EQUAL (0, stats.boot_count);
+    TEST_ASSERT_EQUAL (0, stats.unread);
+    TEST_ASSERT_EQUAL (0, stats.next_seq);
+}
+
+void test_ri_log_ring_not_init (void)
+{
+    ri_log_ring_entry_t entry;
+    ri_log_ring_stats_t stats;
+    ri_log_ring_uninit();
+    TEST_ASSERT (RD_ERROR_INVALID_STATE == ri_log_ring_peek (&entry));
+    TEST_ASSERT (RD_ERROR_INVALID_STATE == ri_log_ring_consume());
+    TEST_ASSERT (RD_ERROR_INVALID_STATE == ri_log_ring_stats_get (&stats));
+}
+
+void test_ri_log_ring_null (void)
+{
+    TEST_ASSERT (RD_ERROR_NULL == ri_log_ring_peek (NULL));
+    TEST_ASSERT (RD_ERROR_NULL == ri_log_ring_stats_get (NULL));
+    TEST_ASSERT (RD_ERROR_INVALID_PARAM == ri_log_ring_init (RI_LOG_LEVEL_DEBUG + 1));
+}
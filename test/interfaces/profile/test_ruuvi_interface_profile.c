@@ -0,0 +1,141 @@
+#include "unity.h"
+
+#include "ruuvi_driver_enabled_modules.h"
+#include "ruuvi_driver_error.h"
+#include "ruuvi_interface_profile.h"
+#include "mock_ruuvi_interface_atomic.h"
+
+#include <string.h>
+
+static uint32_t m_ticks;
+static ri_atomic_t * m_p_lock;
+
+RI_PROFILE_ZONE_DEF (m_zone_a, "a");
+RI_PROFILE_ZONE_DEF (m_zone_b, "b");
+
+static bool atomic_flag_fake (ri_atomic_t * const flag, const bool set,
+                              int cmock_num_calls)
+{
+    bool success = false;
+    m_p_lock = flag;
+
+    if (*flag != set)
+    {
+        *flag = set;
+        success = true;
+    }
+
+    return success;
+}
+
+uint32_t ri_profile_ticks_get (void)
+{
+    return m_ticks;
+}
+
+uint32_t ri_profile_ticks_per_us (void)
+{
+    return 1;
+}
+
+static void run_zone_a (const uint32_t duration)
+{
+    RI_PROFILE_ENTER (m_zone_a);
+    m_ticks += duration;
+    RI_PROFILE_EXIT (m_zone_a);
+}
+
+static size_t zone_count (void)
+{
+    size_t count = 0;
+
+    for (const ri_profile_zone_t * p_zone = ri_profile_zone_next (NULL);
+            NULL != p_zone; p_zone = ri_profile_zone_next (p_zone))
+    {
+        count++;
+    }
+
+    return count;
+}
+
+void setUp (void)
+{
+    ri_atomic_flag_StubWithCallback (&atomic_flag_fake);
+    m_ticks = 0;
+    ri_profile_reset();
+}
+
+void tearDown (void)
+{
+}
+
+void test_ri_profile_zone_record_stats (void)
+{
+    run_zone_a (10);
+    run_zone_a (30);
+    run_zone_a (20);
+    TEST_ASSERT_EQUAL (3, m_zone_a.calls);
+    TEST_ASSERT_EQUAL (10, m_zone_a.min_ticks);
+    TEST_ASSERT_EQUAL (30, m_zone_a.max_ticks);
+    TEST_ASSERT_EQUAL (60, m_zone_a.total_ticks);
+}
+
+void test_ri_profile_zone_record_tick_wrap (void)
+{
+    m_ticks = UINT32_MAX - 4U;
+    run_zone_a (10);
+    TEST_ASSERT_EQUAL (1, m_zone_a.calls);
+    TEST_ASSERT_EQUAL (10, m_zone_a.max_ticks);
+}
+
+void test_ri_profile_zone_registered_once (void)
+{
+    run_zone_a (1);
+    const size_t count = zone_count();
+    run_zone_a (1);
+    TEST_ASSERT_EQUAL (count, zone_count());
+    TEST_ASSERT (m_zone_a.registered);
+}
+
+void test_ri_profile_zone_next_lists_all (void)
+{
+    bool found_a = false;
+    bool found_b = false;
+    run_zone_a (1);
+    ri_profile_zone_record (&m_zone_b, m_ticks);
+
+    for (const ri_profile_zone_t * p_zone = ri_profile_zone_next (NULL);
+            NULL != p_zone; p_zone = ri_profile_zone_next (p_zone))
+    {
+        found_a |= (&m_zone_a == p_zone);
+        found_b |= (&m_zone_b == p_zone);
+    }
+
+    TEST_ASSERT (found_a);
+    TEST_ASSERT (found_b);
+}
+
+void test_ri_profile_zone_record_null (void)
+{
+    ri_profile_zone_record (NULL, 0);
+}
+
+void test_ri_profile_reset (void)
+{
+    run_zone_a (10);
+    TEST_ASSERT (RD_SUCCESS == ri_profile_reset());
+    TEST_ASSERT_EQUAL (0, m_zone_a.calls);
+    TEST_ASSERT_EQUAL (0, m_zone_a.total_ticks);
+    TEST_ASSERT_EQUAL (0, m_zone_a.max_ticks);
+    TEST_ASSERT_EQUAL (UINT32_MAX, m_zone_a.min_ticks);
+    TEST_ASSERT (m_zone_a.registered);
+}
+
+void test_ri_profile_reset_busy (void)
+{
+    run_zone_a (10);
+    *m_p_lock = true;
+    TEST_ASSERT (RD_ERROR_BUSY == ri_profile_reset());
+    *m_p_lock = false;
+    TEST_ASSERT_EQUAL (1, m_zone_a.calls);
+}
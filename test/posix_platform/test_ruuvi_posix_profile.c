@@ -0,0 +1,73 @@
+#define _POSIX_C_SOURCE 199309L //!< nanosleep
+#include "unity.h"
+
+#include "ruuvi_driver_enabled_modules.h"
+#include "ruuvi_driver_error.h"
+#include "ruuvi_interface_profile.h"
+#include "ruuvi_posix_profile.h"
+#include "mock_ruuvi_interface_atomic.h"
+
+#include <time.h>
+
+#define SLEEP_NS (2000000L) //!< 2 ms.
+
+RI_PROFILE_ZONE_DEF (m_zone_sleep, "sleep");
+
+static bool atomic_flag_fake (ri_atomic_t * const flag, const bool set,
+                              int cmock_num_calls)
+{
+    bool success = false;
+
+    if (*flag != set)
+    {
+        *flag = set;
+        success = true;
+    }
+
+    return success;
+}
+
+static void sleep_ns (const long ns)
+{
+    const struct timespec ts = { .tv_sec = 0, .tv_nsec = ns };
+    (void) nanosleep (&ts, NULL);
+}
+
+void setUp (void)
+{
+    ri_atomic_flag_StubWithCallback (&atomic_flag_fake);
+    TEST_ASSERT (RD_SUCCESS == ri_profile_init());
+    TEST_ASSERT (RD_SUCCESS == ri_profile_reset());
+}
+
+void tearDown (void)
+{
+}
+
+void test_ruuvi_posix_profile_ticks_per_us (void)
+{
+    TEST_ASSERT_EQUAL (RUUVI_POSIX_PROFILE_TICKS_PER_US, ri_profile_ticks_per_us());
+}
+
+void test_ruuvi_posix_profile_ticks_advance (void)
+{
+    const uint32_t start = ri_profile_ticks_get();
+    sleep_ns (SLEEP_NS);
+    const uint32_t elapsed = ri_profile_ticks_get() - start;
+    TEST_ASSERT (elapsed >= (uint32_t) SLEEP_NS);
+}
+
+void test_ruuvi_posix_profile_zone_measures_time (void)
+{
+    for (uint8_t ii = 0; ii < 3U; ii++)
+    {
+        RI_PROFILE_ENTER (m_zone_sleep);
+        sleep_ns (SLEEP_NS);
+        RI_PROFILE_EXIT (m_zone_sleep);
+    }
+
+    TEST_ASSERT_EQUAL (3U, m_zone_sleep.calls);
+    TEST_ASSERT (m_zone_sleep.min_ticks >= (uint32_t) SLEEP_NS);
+    TEST_ASSERT (m_zone_sleep.max_ticks >= m_zone_sleep.min_ticks);
+    TEST_ASSERT (m_zone_sleep.total_ticks >= (3ULL * SLEEP_NS));
+}
@@ -9,10 +9,14 @@
 #include "mock_ruuvi_interface_atomic.h"
 #include "mock_ruuvi_interface_log.h"
 #include "mock_ruuvi_driver_sensor.h"
+#include "mock_ruuvi_task_energy.h"
 
 static volatile ri_atomic_t m_true = true;
 static volatile ri_atomic_t m_false = false;
 
+static size_t m_init_cycles;
+static size_t m_scan_samples;
+
 static float m_valid_data[2] = {2.8F, 0.6F};
 static rd_sensor_data_t m_adc_data =
 {
@@ -26,6 +30,7 @@ static rd_sensor_data_t m_adc_data =
 void setUp (void)
 {
     rd_status_t err_code = RD_SUCCESS;
+    rt_energy_state_set_IgnoreAndReturn (RD_SUCCESS);
     ri_atomic_flag_ExpectAnyArgsAndReturn (true);
     ri_atomic_flag_ReturnThruPtr_flag (&m_true);
     ri_adc_init_ExpectAnyArgsAndReturn (RD_SUCCESS);
@@ -447,4 +452,168 @@ void test_adc_ratiometric_configuration_null (void)
     float sample;
     err_code = rt_adc_ratiometric_sample (NULL, RI_ADC_AIN0, &sample);
     TEST_ASSERT (RD_ERROR_NULL == err_code);
-}
\ No newline at end of file
+}
+static rd_status_t init_counter (ri_adc_config_t * p_config, int cmock_num_calls)
+{
+    m_init_cycles++;
+    return RD_SUCCESS;
+}
+
+static rd_status_t scan_raw_fill (int16_t * const p_data, const size_t num_samples,
+                                  int cmock_num_calls)
+{
+    for (size_t ii = 0; ii < num_samples; ii++)
+    {
+        p_data[ii] = (int16_t) (1000 * (ii + 1));
+    }
+
+    m_scan_samples = num_samples;
+    return RD_SUCCESS;
+}
+
+static rd_status_t raw_to_absolute_fake (uint8_t channel_num, ri_adc_get_data_t * p_config,
+        const int16_t raw, float * p_data, int cmock_num_calls)
+{
+    *p_data = (float) raw / 1000.0F;
+    return RD_SUCCESS;
+}
+
+static rd_status_t raw_to_ratio_fake (uint8_t channel_num, ri_adc_get_data_t * p_config,
+                                      const int16_t raw, float * p_data, int cmock_num_calls)
+{
+    *p_data = (float) raw / 10000.0F;
+    return RD_SUCCESS;
+}
+
+/**
+ * @brief Release ADC reserved in setUp and expect one scan power cycle.
+ */
+static void scan_cycle_expect (const size_t channels)
+{
+    tearDown();
+    m_init_cycles = 0;
+    m_scan_samples = 0;
+    ri_atomic_flag_ExpectAnyArgsAndReturn (true);
+    ri_atomic_flag_ReturnThruPtr_flag (&m_true);
+    ri_adc_init_StubWithCallback (&init_counter);
+
+    for (size_t ii = 0; ii < channels; ii++)
+    {
+        ri_adc_mcu_is_valid_ch_ExpectAndReturn (ii, true);
+        ri_adc_configure_ExpectAnyArgsAndReturn (RD_SUCCESS);
+    }
+
+    ri_adc_scan_raw_StubWithCallback (&scan_raw_fill);
+    ri_adc_raw_to_absolute_StubWithCallback (&raw_to_absolute_fake);
+    ri_adc_raw_to_ratio_StubWithCallback (&raw_to_ratio_fake);
+    ri_adc_stop_ExpectAnyArgsAndReturn (RD_SUCCESS);
+    ri_adc_uninit_ExpectAnyArgsAndReturn (RD_SUCCESS);
+    ri_atomic_flag_ExpectAnyArgsAndReturn (true);
+    ri_atomic_flag_ReturnThruPtr_flag (&m_false);
+}
+
+void test_rt_adc_scan_one_init_cycle (void)
+{
+    float battery;
+    float ntc;
+    float photo;
+    float vdd;
+    const rt_adc_scan_input_t inputs[] =
+    {
+        { .handle = RI_ADC_AINVDD, .mode = ABSOLUTE,    .p_result = &battery },
+        { .handle = RI_ADC_AIN1,   .mode = RATIOMETRIC, .p_result = &ntc },
+        { .handle = RI_ADC_AIN2,   .mode = ABSOLUTE,    .p_result = &photo }
+    };
+    scan_cycle_expect (3);
+    TEST_ASSERT (RD_SUCCESS == rt_adc_scan (inputs, 3));
+    TEST_ASSERT_EQUAL (1, m_init_cycles);
+    TEST_ASSERT_EQUAL (3, m_scan_samples);
+    TEST_ASSERT_EQUAL_FLOAT (1.0F, battery);
+    TEST_ASSERT_EQUAL_FLOAT (0.2F, ntc);
+    TEST_ASSERT_EQUAL_FLOAT (3.0F, photo);
+    TEST_ASSERT (!rt_adc_is_init());
+    TEST_ASSERT (RD_SUCCESS == rt_adc_vdd_get (&vdd));
+    TEST_ASSERT_EQUAL_FLOAT (1.0F, vdd);
+}
+
+void test_rt_adc_scan_shared_handle (void)
+{
+    float volts;
+    float ratio;
+    const rt_adc_scan_input_t inputs[] =
+    {
+        { .handle = RI_ADC_AIN3, .mode = ABSOLUTE,    .p_result = &volts },
+        { .handle = RI_ADC_AIN3, .mode = RATIOMETRIC, .p_result = &ratio }
+    };
+    scan_cycle_expect (1);
+    TEST_ASSERT (RD_SUCCESS == rt_adc_scan (inputs, 2));
+    TEST_ASSERT_EQUAL (1, m_init_cycles);
+    TEST_ASSERT_EQUAL (1, m_scan_samples);
+    TEST_ASSERT_EQUAL_FLOAT (1.0F, volts);
+    TEST_ASSERT_EQUAL_FLOAT (0.1F, ratio);
+}
+
+void test_rt_adc_scan_null (void)
+{
+    const rt_adc_scan_input_t inputs[] =
+    {
+        { .handle = RI_ADC_AIN1, .mode = ABSOLUTE, .p_result = NULL }
+    };
+    TEST_ASSERT (RD_ERROR_NULL == rt_adc_scan (NULL, 1));
+    TEST_ASSERT (RD_ERROR_NULL == rt_adc_scan (inputs, 1));
+}
+
+void test_rt_adc_scan_invalid_param (void)
+{
+    float sample = 0.0F;
+    const rt_adc_scan_input_t gnd[] =
+    {
+        { .handle = RI_ADC_GND, .mode = ABSOLUTE, .p_result = &sample }
+    };
+    const rt_adc_scan_input_t out_of_range[] =
+    {
+        { .handle = RI_ADC_CH_NUM, .mode = ABSOLUTE, .p_result = &sample }
+    };
+    TEST_ASSERT (RD_ERROR_INVALID_PARAM == rt_adc_scan (gnd, 0));
+    TEST_ASSERT (RD_ERROR_INVALID_PARAM == rt_adc_scan (gnd, RI_ADC_CH_NUM + 1));
+    TEST_ASSERT (RD_ERROR_INVALID_PARAM == rt_adc_scan (gnd, 1));
+    TEST_ASSERT (RD_ERROR_INVALID_PARAM == rt_adc_scan (out_of_range, 1));
+    TEST_ASSERT_FLOAT_IS_NAN (sample);
+}
+
+void test_rt_adc_scan_busy (void)
+{
+    float sample = 0.0F;
+    const rt_adc_scan_input_t inputs[] =
+    {
+        { .handle = RI_ADC_AIN1, .mode = ABSOLUTE, .p_result = &sample }
+    };
+    // ADC was reserved in setUp.
+    ri_atomic_flag_ExpectAnyArgsAndReturn (false);
+    TEST_ASSERT (RD_ERROR_INVALID_STATE == rt_adc_scan (inputs, 1));
+    TEST_ASSERT_FLOAT_IS_NAN (sample);
+    TEST_ASSERT (rt_adc_is_init());
+}
+
+void test_rt_adc_scan_error_releases_adc (void)
+{
+    float sample = 0.0F;
+    const rt_adc_scan_input_t inputs[] =
+    {
+        { .handle = RI_ADC_AIN1, .mode = ABSOLUTE, .p_result = &sample }
+    };
+    tearDown();
+    ri_atomic_flag_ExpectAnyArgsAndReturn (true);
+    ri_atomic_flag_ReturnThruPtr_flag (&m_true);
+    ri_adc_init_ExpectAnyArgsAndReturn (RD_SUCCESS);
+    ri_adc_mcu_is_valid_ch_ExpectAndReturn (0, true);
+    ri_adc_configure_ExpectAnyArgsAndReturn (RD_SUCCESS);
+    ri_adc_scan_raw_ExpectAnyArgsAndReturn (RD_ERROR_INVALID_STATE);
+    ri_adc_stop_ExpectAnyArgsAndReturn (RD_SUCCESS);
+    ri_adc_uninit_ExpectAnyArgsAndReturn (RD_SUCCESS);
+    ri_atomic_flag_ExpectAnyArgsAndReturn (true);
+    ri_atomic_flag_ReturnThruPtr_flag (&m_false);
+    TEST_ASSERT (RD_ERROR_INVALID_STATE == rt_adc_scan (inputs, 1));
+    TEST_ASSERT_FLOAT_IS_NAN (sample);
+    TEST_ASSERT (!rt_adc_is_init());
+}
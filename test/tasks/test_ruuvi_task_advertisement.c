@@ -10,6 +10,8 @@
 #include "ruuvi_driver_enabled_modules.h"
 #include "ruuvi_task_advertisement.h"
 #include "ruuvi_driver_error.h"
+#include "ruuvi_interface_communication_radio.h"
+#include "ruuvi_interface_communication_scan_schedule.h"
 
 #include "mock_ruuvi_task_gatt.h"
 #include "mock_ruuvi_interface_communication_ble_advertising.h"
@@ -22,6 +24,7 @@
 #define ADV_PWR_DBM     (0)
 #define ADV_MANU_ID     (0xFFFFU)
 #define SEND_COUNT_MAX (10U)
+#define GAP_PHY_1MBPS   (0x01U) //!< BLE_GAP_PHY_1MBPS of report.
 
 static uint32_t send_count = 0;
 static uint32_t read_count = 0;
@@ -69,6 +72,32 @@ rd_status_t on_scan_isr (const ri_comm_evt_t evt, void * p_data, size_t data_len
 }
 
 static ri_comm_channel_t m_mock_channel;
+static ri_comm_channel_t * m_adv_channel; //!< Channel of task, captured on init.
+static uint32_t m_scan_received;
+static uint32_t m_scan_timeouts;
+static const ri_adv_scan_t * m_scan_last; //!< Last report delivered to application.
+
+static rd_status_t adv_init_capture (ri_comm_channel_t * const channel,
+                                     int cmock_num_calls)
+{
+    *channel = m_mock_channel;
+    m_adv_channel = channel;
+    return RD_SUCCESS;
+}
+
+static rd_status_t on_scan_count (const ri_comm_evt_t evt, void * p_data,
+                                  size_t data_len)
+{
+    m_scan_received += (RI_COMM_RECEIVED == evt) ? 1U : 0U;
+    m_scan_timeouts += (RI_COMM_TIMEOUT == evt) ? 1U : 0U;
+
+    if (RI_COMM_RECEIVED == evt)
+    {
+        m_scan_last = (const ri_adv_scan_t *) p_data;
+    }
+
+    return RD_SUCCESS;
+}
 
 
 void setUp (void)
@@ -410,6 +439,105 @@ void test_rt_adv_send_data_excess_size_25 (void)
     TEST_ASSERT (RD_ERROR_DATA_SIZE == err_code);
 }
 
+void test_rt_adv_update_data_in_place (void)
+{
+    ri_comm_message_t message = { 0 };
+    message.data_length = 24;
+    ri_adv_data_update_ExpectAndReturn (&message, RD_SUCCESS);
+    TEST_ASSERT (RD_SUCCESS == rt_adv_update_data (&message));
+    TEST_ASSERT (0 == send_count);
+}
+
+void test_rt_adv_update_data_not_advertising (void)
+{
+    ri_comm_message_t message = { 0 };
+    message.data_length = 10;
+    ri_adv_data_update_ExpectAndReturn (&message, RD_ERROR_INVALID_STATE);
+    TEST_ASSERT (RD_SUCCESS == rt_adv_update_data (&message));
+    TEST_ASSERT (1 == send_count);
+}
+
+void test_rt_adv_update_data_type_changed (void)
+{
+    ri_comm_message_t message = { 0 };
+    message.data_length = 10;
+    ri_adv_data_update_ExpectAndReturn (&message, RD_ERROR_INVALID_PARAM);
+    TEST_ASSERT (RD_SUCCESS == rt_adv_update_data (&message));
+    TEST_ASSERT (1 == send_count);
+}
+
+void test_rt_adv_update_data_stack_error (void)
+{
+    ri_comm_message_t message = { 0 };
+    message.data_length = 10;
+    ri_adv_data_update_ExpectAndReturn (&message, RD_ERROR_INTERNAL);
+    TEST_ASSERT (RD_ERROR_INTERNAL == rt_adv_update_data (&message));
+    TEST_ASSERT (0 == send_count);
+}
+
+void test_rt_adv_update_data_errors (void)
+{
+    ri_comm_message_t message = { 0 };
+    message.data_length = 25;
+    TEST_ASSERT (RD_ERROR_NULL == rt_adv_update_data (NULL));
+    TEST_ASSERT (RD_ERROR_DATA_SIZE == rt_adv_update_data (&message));
+    tearDown();
+    message.data_length = 10;
+    TEST_ASSERT (RD_ERROR_INVALID_STATE == rt_adv_update_data (&message));
+}
+
+void test_rt_adv_rotation_set_ok (void)
+{
+    ri_comm_message_t message = { 0 };
+    message.data_length = 24;
+    ri_adv_rotation_slot_set_ExpectAndReturn (2U, &message, 3U, RI_RADIO_BLE_125KBPS,
+            RD_SUCCESS);
+    TEST_ASSERT (RD_SUCCESS == rt_adv_rotation_set (2U, &message, 3U, RI_RADIO_BLE_125KBPS));
+}
+
+void test_rt_adv_rotation_set_slot_busy (void)
+{
+    ri_comm_message_t message = { 0 };
+    message.data_length = 10;
+    ri_adv_rotation_slot_set_ExpectAndReturn (0U, &message, 1U, RI_RADIO_BLE_1MBPS,
+            RD_ERROR_BUSY);
+    TEST_ASSERT (RD_ERROR_BUSY == rt_adv_rotation_set (0U, &message, 1U, RI_RADIO_BLE_1MBPS));
+}
+
+void test_rt_adv_rotation_set_errors (void)
+{
+    ri_comm_message_t message = { 0 };
+    message.data_length = 25;
+    TEST_ASSERT (RD_ERROR_NULL == rt_adv_rotation_set (0U, NULL, 1U, RI_RADIO_BLE_1MBPS));
+    TEST_ASSERT (RD_ERROR_DATA_SIZE == rt_adv_rotation_set (0U, &message, 1U,
+                 RI_RADIO_BLE_1MBPS));
+    tearDown();
+    message.data_length = 10;
+    TEST_ASSERT (RD_ERROR_INVALID_STATE == rt_adv_rotation_set (0U, &message, 1U,
+                 RI_RADIO_BLE_1MBPS));
+}
+
+void test_rt_adv_rotation_start_stop (void)
+{
+    ri_adv_rotation_start_ExpectAndReturn (RD_SUCCESS);
+    TEST_ASSERT (RD_SUCCESS == rt_adv_rotation_start());
+    ri_adv_rotation_stop_ExpectAndReturn (RD_SUCCESS);
+    TEST_ASSERT (RD_SUCCESS == rt_adv_rotation_stop());
+}
+
+void test_rt_adv_rotation_start_no_slots (void)
+{
+    ri_adv_rotation_start_ExpectAndReturn (RD_ERROR_INVALID_STATE);
+    TEST_ASSERT (RD_ERROR_INVALID_STATE == rt_adv_rotation_start());
+}
+
+void test_rt_adv_rotation_not_init (void)
+{
+    tearDown();
+    TEST_ASSERT (RD_ERROR_INVALID_STATE == rt_adv_rotation_start());
+    TEST_ASSERT (RD_ERROR_INVALID_STATE == rt_adv_rotation_stop());
+}
+
 /** @brief Start advertising BLE GATT connection
  *
  *  This function configures the primary advertisement to be SCANNABLE_CONNECTABLE and
@@ -541,3 +669,169 @@ void test_rt_adv_scan_stop_not_init (void)
     err_code |= rt_adv_scan_stop ();
     TEST_ASSERT (RD_ERROR_INVALID_STATE == err_code);
 }
+
+void test_rt_adv_scan_schedule_start_ok (void)
+{
+    const ri_comm_scan_schedule_init_t schedule =
+    {
+        .weight_1m = 1U,
+        .weight_2m = 0U,
+        .weight_coded = 3U,
+        .adaptive = true
+    };
+    ri_comm_scan_schedule_stats_t stats = { 0 };
+    ri_adv_scan_phy_start_ExpectAndReturn (1000U, 1000U, RI_RADIO_BLE_125KBPS, RD_SUCCESS);
+    TEST_ASSERT (RD_SUCCESS == rt_adv_scan_schedule_start (&schedule, 1000U, on_scan_isr));
+    TEST_ASSERT (RD_SUCCESS == rt_adv_scan_schedule_stats_get (RI_RADIO_BLE_125KBPS,
+                 &stats));
+    TEST_ASSERT_EQUAL (3U, stats.share);
+    TEST_ASSERT_EQUAL (0U, stats.windows);
+    TEST_ASSERT (RD_ERROR_NULL == rt_adv_scan_schedule_stats_get (RI_RADIO_BLE_1MBPS, NULL));
+    ri_adv_scan_stop_ExpectAndReturn (RD_SUCCESS);
+    TEST_ASSERT (RD_SUCCESS == rt_adv_scan_stop());
+}
+
+void test_rt_adv_scan_schedule_start_not_supported (void)
+{
+    const ri_comm_scan_schedule_init_t schedule =
+    {
+        .weight_coded = 1U
+    };
+    ri_adv_scan_phy_start_ExpectAndReturn (1000U, 1000U, RI_RADIO_BLE_125KBPS,
+                                           RD_ERROR_NOT_SUPPORTED);
+    TEST_ASSERT (RD_ERROR_NOT_SUPPORTED == rt_adv_scan_schedule_start (&schedule, 1000U,
+                 on_scan_isr));
+}
+
+void test_rt_adv_scan_schedule_start_errors (void)
+{
+    const ri_comm_scan_schedule_init_t schedule =
+    {
+        .weight_1m = 1U
+    };
+    const ri_comm_scan_schedule_init_t disabled = { 0 };
+    TEST_ASSERT (RD_ERROR_NULL == rt_adv_scan_schedule_start (NULL, 1000U, on_scan_isr));
+    TEST_ASSERT (RD_ERROR_NULL == rt_adv_scan_schedule_start (&schedule, 1000U, NULL));
+    TEST_ASSERT (RD_ERROR_INVALID_PARAM == rt_adv_scan_schedule_start (&schedule, 0U,
+                 on_scan_isr));
+    TEST_ASSERT (RD_ERROR_INVALID_PARAM == rt_adv_scan_schedule_start (&disabled, 1000U,
+                 on_scan_isr));
+    tearDown();
+    TEST_ASSERT (RD_ERROR_INVALID_STATE == rt_adv_scan_schedule_start (&schedule, 1000U,
+                 on_scan_isr));
+}
+
+/** @brief Initialize again, capturing channel which the driver calls. */
+static void init_capture_channel (void)
+{
+    const ri_radio_channels_t channels =
+    {
+        .channel_37 = 1,
+        .channel_38 = 1,
+        .channel_39 = 1
+    };
+    rt_adv_init_t init = {0};
+    int8_t power = ADV_PWR_DBM;
+    tearDown();
+    mock_init (&m_mock_channel);
+    ri_adv_init_StubWithCallback (&adv_init_capture);
+    ri_adv_rx_ble_phy_enabled_set_Expect (false, false, false);
+    ri_adv_rx_set_max_advertisement_data_length_Expect (0);
+    ri_adv_tx_interval_set_ExpectAndReturn (ADV_INTERVAL_MS, RD_SUCCESS);
+    ri_adv_tx_power_set_ExpectWithArrayAndReturn (&power, sizeof (power), RD_SUCCESS);
+    ri_adv_type_set_ExpectAndReturn (NONCONNECTABLE_NONSCANNABLE, RD_SUCCESS);
+    ri_adv_manufacturer_id_set_ExpectAndReturn (ADV_MANU_ID, RD_SUCCESS);
+    ri_adv_channels_set_ExpectAndReturn (channels, RD_SUCCESS);
+    init.adv_interval_ms = ADV_INTERVAL_MS;
+    init.adv_pwr_dbm = ADV_PWR_DBM;
+    init.manufacturer_id = ADV_MANU_ID;
+    init.channels = channels;
+    TEST_ASSERT (RD_SUCCESS == rt_adv_init (&init));
+    TEST_ASSERT_NOT_NULL (m_adv_channel);
+    m_scan_received = 0;
+    m_scan_timeouts = 0;
+    m_scan_last = NULL;
+}
+
+void test_rt_adv_scan_schedule_isr_chains_windows (void)
+{
+    const ri_comm_scan_schedule_init_t schedule =
+    {
+        .weight_1m = 1U,
+        .weight_coded = 1U
+    };
+    ri_adv_scan_t scan = { 0 };
+    ri_comm_scan_schedule_stats_t stats = { 0 };
+    init_capture_channel();
+    ri_adv_scan_phy_start_ExpectAndReturn (100U, 100U, RI_RADIO_BLE_1MBPS, RD_SUCCESS);
+    TEST_ASSERT (RD_SUCCESS == rt_adv_scan_schedule_start (&schedule, 100U, on_scan_count));
+    TEST_ASSERT (RD_SUCCESS == m_adv_channel->on_evt (RI_COMM_RECEIVED, &scan, sizeof (scan)));
+    TEST_ASSERT (RD_SUCCESS == m_adv_channel->on_evt (RI_COMM_RECEIVED, &scan, sizeof (scan)));
+    // Timeout of window starts next one instead of reaching application.
+    ri_adv_scan_phy_start_ExpectAndReturn (100U, 100U, RI_RADIO_BLE_125KBPS, RD_SUCCESS);
+    TEST_ASSERT (RD_SUCCESS == m_adv_channel->on_evt (RI_COMM_TIMEOUT, NULL, 0));
+    TEST_ASSERT (RD_SUCCESS == m_adv_channel->on_evt (RI_COMM_RECEIVED, &scan, sizeof (scan)));
+    ri_adv_scan_phy_start_ExpectAndReturn (100U, 100U, RI_RADIO_BLE_1MBPS, RD_SUCCESS);
+    TEST_ASSERT (RD_SUCCESS == m_adv_channel->on_evt (RI_COMM_TIMEOUT, NULL, 0));
+    TEST_ASSERT_EQUAL (3U, m_scan_received);
+    TEST_ASSERT_EQUAL (0U, m_scan_timeouts);
+    TEST_ASSERT (RD_SUCCESS == rt_adv_scan_schedule_stats_get (RI_RADIO_BLE_1MBPS, &stats));
+    TEST_ASSERT_EQUAL (1U, stats.windows);
+    TEST_ASSERT_EQUAL (2U, stats.reports);
+    // Window is scanned on each of 3 channels.
+    TEST_ASSERT_EQUAL (300U, stats.scan_ms);
+    TEST_ASSERT (RD_SUCCESS == rt_adv_scan_schedule_stats_get (RI_RADIO_BLE_125KBPS,
+                 &stats));
+    TEST_ASSERT_EQUAL (1U, stats.windows);
+    TEST_ASSERT_EQUAL (1U, stats.reports);
+    ri_adv_scan_stop_ExpectAndReturn (RD_SUCCESS);
+    TEST_ASSERT (RD_SUCCESS == rt_adv_scan_stop());
+}
+
+void test_rt_adv_scan_schedule_isr_next_start_fails (void)
+{
+    const ri_comm_scan_schedule_init_t schedule =
+    {
+        .weight_2m = 1U
+    };
+    init_capture_channel();
+    ri_adv_scan_phy_start_ExpectAndReturn (100U, 100U, RI_RADIO_BLE_2MBPS, RD_SUCCESS);
+    TEST_ASSERT (RD_SUCCESS == rt_adv_scan_schedule_start (&schedule, 100U, on_scan_count));
+    ri_adv_scan_phy_start_ExpectAndReturn (100U, 100U, RI_RADIO_BLE_2MBPS,
+                                           RD_ERROR_INTERNAL);
+    TEST_ASSERT (RD_ERROR_INTERNAL == m_adv_channel->on_evt (RI_COMM_TIMEOUT, NULL, 0));
+    TEST_ASSERT_EQUAL (1U, m_scan_timeouts);
+    // Schedule has ended, timeouts reach application.
+    TEST_ASSERT (RD_SUCCESS == m_adv_channel->on_evt (RI_COMM_TIMEOUT, NULL, 0));
+    TEST_ASSERT_EQUAL (2U, m_scan_timeouts);
+}
+
+void test_rt_adv_scan_schedule_isr_1m_extended_report (void)
+{
+    const ri_comm_scan_schedule_init_t schedule =
+    {
+        .weight_1m = 1U
+    };
+    // 48-byte payload on 1 MBit/s is extended with 1 MBit/s secondary PHY.
+    ri_adv_scan_t scan =
+    {
+        .data_len = 48U,
+        .primary_phy = GAP_PHY_1MBPS,
+        .secondary_phy = GAP_PHY_1MBPS
+    };
+    ri_comm_scan_schedule_stats_t stats = { 0 };
+    init_capture_channel();
+    ri_adv_scan_phy_start_ExpectAndReturn (100U, 100U, RI_RADIO_BLE_1MBPS, RD_SUCCESS);
+    TEST_ASSERT (RD_SUCCESS == rt_adv_scan_schedule_start (&schedule, 100U, on_scan_count));
+    TEST_ASSERT (RD_SUCCESS == m_adv_channel->on_evt (RI_COMM_RECEIVED, &scan, sizeof (scan)));
+    TEST_ASSERT_EQUAL (1U, m_scan_received);
+    TEST_ASSERT_EQUAL_PTR (&scan, m_scan_last);
+    TEST_ASSERT_EQUAL (GAP_PHY_1MBPS, m_scan_last->secondary_phy);
+    ri_adv_scan_phy_start_ExpectAndReturn (100U, 100U, RI_RADIO_BLE_1MBPS, RD_SUCCESS);
+    TEST_ASSERT (RD_SUCCESS == m_adv_channel->on_evt (RI_COMM_TIMEOUT, NULL, 0));
+    TEST_ASSERT (RD_SUCCESS == rt_adv_scan_schedule_stats_get (RI_RADIO_BLE_1MBPS, &stats));
+    TEST_ASSERT_EQUAL (1U, stats.windows);
+    TEST_ASSERT_EQUAL (1U, stats.reports);
+    ri_adv_scan_stop_ExpectAndReturn (RD_SUCCESS);
+    TEST_ASSERT (RD_SUCCESS == rt_adv_scan_stop());
+}
@@ -0,0 +1,433 @@
+#include "unity.h"
+
+#include "ruuvi_driver_enabled_modules.h"
+#include "ruuvi_driver_error.h"
+#include "ruuvi_driver_sensor.h"
+#include "ruuvi_interface_communication_radio.h"
+#include "ruuvi_task_battery.h"
+#include "mock_ruuvi_interface_scheduler.h"
+#include "mock_ruuvi_task_adc.h"
+
+#include <string.h>
+
+static ri_radio_activity_interrupt_fp_t m_radio_cb;
+static size_t m_radio_chained;
+static uint64_t m_now_ms;
+static float m_rest_v;
+static float m_load_v;
+static ruuvi_scheduler_event_handler_t m_scheduled;
+static uint32_t m_puts;
+static bool m_read_in_update;       //!< Read statistics while they are updated.
+static rd_status_t m_update_read_status;
+
+void ri_radio_activity_callback_set (const ri_radio_activity_interrupt_fp_t handler)
+{
+    // Interface does not overwrite existing callback.
+    if ( (NULL == handler) || (NULL == m_radio_cb))
+    {
+        m_radio_cb = handler;
+    }
+}
+
+ri_radio_activity_interrupt_fp_t ri_radio_activity_callback_get (void)
+{
+    return m_radio_cb;
+}
+
+static rd_status_t event_put (const void * const p_event_data,
+                              const uint16_t event_size,
+                              const ruuvi_scheduler_event_handler_t handler,
+                              int cmock_num_calls)
+{
+    m_puts++;
+    m_scheduled = handler;
+    return RD_SUCCESS;
+}
+
+static void scheduler_execute (void)
+{
+    ruuvi_scheduler_event_handler_t handler = m_scheduled;
+    m_scheduled = NULL;
+
+    if (NULL != handler)
+    {
+        handler (NULL, 0);
+    }
+}
+
+static uint64_t test_timestamp (void)
+{
+    if (m_read_in_update)
+    {
+        // Interrupt preempts update of statistics.
+        rt_battery_stats_t stats;
+        m_update_read_status = rt_battery_stats_get (&stats);
+    }
+
+    return m_now_ms;
+}
+
+static void app_radio_cb (const ri_radio_activity_evt_t evt)
+{
+    m_radio_chained++;
+}
+
+static rd_status_t rest_voltage_get (rd_sensor_data_t * const data, int cmock_num_calls)
+{
+    const rd_sensor_data_fields_t voltage = {.datas.voltage_v = 1};
+    rd_sensor_data_set (data, voltage, m_rest_v);
+    return RD_SUCCESS;
+}
+
+static rd_status_t rest_voltage_fail (rd_sensor_data_t * const data, int cmock_num_calls)
+{
+    return RD_ERROR_INTERNAL;
+}
+
+/** Run one radio activity with given resting and loaded voltage. */
+static void radio_activity (const float rest_v, const float load_v)
+{
+    m_rest_v = rest_v;
+    m_load_v = load_v;
+    rt_adc_vdd_prepare_ExpectAnyArgsAndReturn (RD_SUCCESS);
+    rt_adc_voltage_get_StubWithCallback (&rest_voltage_get);
+    rt_adc_vdd_sample_ExpectAndReturn (RD_SUCCESS);
+    rt_adc_vdd_get_ExpectAnyArgsAndReturn (RD_SUCCESS);
+    rt_adc_vdd_get_ReturnThruPtr_vdd (&m_load_v);
+    m_radio_cb (RI_RADIO_BEFORE);
+    scheduler_execute();
+    m_radio_cb (RI_RADIO_AFTER);
+    scheduler_execute();
+}
+
+void setUp (void)
+{
+    m_radio_cb = NULL;
+    m_radio_chained = 0;
+    m_now_ms = 1000;
+    m_scheduled = NULL;
+    m_puts = 0;
+    m_read_in_update = false;
+    m_update_read_status = RD_SUCCESS;
+    ri_scheduler_event_put_StubWithCallback (&event_put);
+    rd_sensor_timestamp_function_set (&test_timestamp);
+    TEST_ASSERT (RD_SUCCESS == rt_battery_init (true));
+}
+
+void tearDown (void)
+{
+    rt_battery_uninit();
+    rd_sensor_timestamp_function_set (NULL);
+}
+
+void test_rt_battery_init_twice (void)
+{
+    TEST_ASSERT (RD_ERROR_INVALID_STATE == rt_battery_init (true));
+    TEST_ASSERT (rt_battery_is_init());
+}
+
+void test_rt_battery_init_installs_callback (void)
+{
+    TEST_ASSERT (&rt_battery_radio_activity_handler == m_radio_cb);
+}
+
+void test_rt_battery_init_not_owner (void)
+{
+    rt_battery_uninit();
+    m_radio_cb = NULL;
+    TEST_ASSERT (RD_SUCCESS == rt_battery_init (false));
+    TEST_ASSERT (NULL == m_radio_cb);
+    m_radio_cb = &rt_battery_radio_activity_handler;
+    radio_activity (3.0F, 2.9F);
+    rt_battery_uninit();
+    TEST_ASSERT (&rt_battery_radio_activity_handler == m_radio_cb);
+}
+
+void test_rt_battery_uninit_restores_chain (void)
+{
+    rt_battery_radio_activity_chain (&app_radio_cb);
+    rt_battery_uninit();
+    TEST_ASSERT (&app_radio_cb == m_radio_cb);
+    TEST_ASSERT (!rt_battery_is_init());
+}
+
+void test_rt_battery_uninit_releases_prepared_adc (void)
+{
+    rt_adc_vdd_prepare_ExpectAnyArgsAndReturn (RD_SUCCESS);
+    rt_adc_voltage_get_StubWithCallback (&rest_voltage_get);
+    m_radio_cb (RI_RADIO_BEFORE);
+    scheduler_execute();
+    rt_adc_uninit_ExpectAndReturn (RD_SUCCESS);
+    rt_battery_uninit();
+}
+
+void test_rt_battery_init_callback_installed (void)
+{
+    rt_battery_uninit();
+    m_radio_cb = &app_radio_cb;
+    TEST_ASSERT (RD_ERROR_INVALID_STATE == rt_battery_init (true));
+    TEST_ASSERT (!rt_battery_is_init());
+    TEST_ASSERT (RD_SUCCESS == rt_battery_init (false));
+    TEST_ASSERT (&app_radio_cb == m_radio_cb);
+}
+
+void test_rt_battery_uninit_keeps_replaced_callback (void)
+{
+    ri_radio_activity_callback_set (NULL);
+    ri_radio_activity_callback_set (&app_radio_cb);
+    rt_battery_uninit();
+    TEST_ASSERT (&app_radio_cb == m_radio_cb);
+}
+
+void test_rt_battery_interrupt_only_queues (void)
+{
+    // No ADC calls are expected in radio interrupt.
+    m_radio_cb (RI_RADIO_BEFORE);
+    TEST_ASSERT_EQUAL (1, m_puts);
+    TEST_ASSERT (NULL != m_scheduled);
+}
+
+void test_rt_battery_queued_once (void)
+{
+    rt_battery_stats_t stats;
+    // Radio turns off before scheduler runs, resting VDD is missing.
+    m_radio_cb (RI_RADIO_BEFORE);
+    m_radio_cb (RI_RADIO_AFTER);
+    TEST_ASSERT_EQUAL (1, m_puts);
+    scheduler_execute();
+    TEST_ASSERT (RD_SUCCESS == rt_battery_stats_get (&stats));
+    TEST_ASSERT_EQUAL (0, stats.samples);
+    TEST_ASSERT_EQUAL (1, stats.skipped);
+    radio_activity (3.0F, 2.9F);
+    TEST_ASSERT_EQUAL (3, m_puts);
+    TEST_ASSERT (RD_SUCCESS == rt_battery_stats_get (&stats));
+    TEST_ASSERT_EQUAL (1, stats.samples);
+}
+
+void test_rt_battery_stats_single (void)
+{
+    rt_battery_stats_t stats;
+    m_now_ms = 5000;
+    radio_activity (3.0F, 2.8F);
+    TEST_ASSERT (RD_SUCCESS == rt_battery_stats_get (&stats));
+    TEST_ASSERT_EQUAL (1, stats.samples);
+    TEST_ASSERT_EQUAL (0, stats.skipped);
+    TEST_ASSERT_EQUAL_FLOAT (2.8F, stats.last_v);
+    TEST_ASSERT_EQUAL_FLOAT (2.8F, stats.min_v);
+    TEST_ASSERT_EQUAL_FLOAT (2.8F, stats.average_v);
+    TEST_ASSERT_FLOAT_WITHIN (0.001F, 0.2F, stats.droop_v);
+    TEST_ASSERT_FLOAT_WITHIN (0.001F, 0.2F, stats.max_droop_v);
+    TEST_ASSERT_EQUAL (5000, stats.timestamp_ms);
+}
+
+void test_rt_battery_stats_running (void)
+{
+    rt_battery_stats_t stats;
+    radio_activity (3.0F, 2.9F);
+    radio_activity (3.0F, 2.6F);
+    radio_activity (2.9F, 2.8F);
+    TEST_ASSERT (RD_SUCCESS == rt_battery_stats_get (&stats));
+    TEST_ASSERT_EQUAL (3, stats.samples);
+    TEST_ASSERT_EQUAL_FLOAT (2.8F, stats.last_v);
+    TEST_ASSERT_EQUAL_FLOAT (2.6F, stats.min_v);
+    TEST_ASSERT_FLOAT_WITHIN (0.001F, 2.7667F, stats.average_v);
+    TEST_ASSERT_FLOAT_WITHIN (0.001F, 0.1F, stats.droop_v);
+    TEST_ASSERT_FLOAT_WITHIN (0.001F, 0.4F, stats.max_droop_v);
+}
+
+void test_rt_battery_stats_average_window (void)
+{
+    rt_battery_stats_t stats;
+
+    for (size_t ii = 0; ii < RT_BATTERY_AVERAGE_WINDOW; ii++)
+    {
+        radio_activity (3.0F, 3.0F);
+    }
+
+    radio_activity (3.0F, 3.0F - RT_BATTERY_AVERAGE_WINDOW * 0.01F);
+    TEST_ASSERT (RD_SUCCESS == rt_battery_stats_get (&stats));
+    TEST_ASSERT_FLOAT_WITHIN (0.0001F, 2.99F, stats.average_v);
+}
+
+void test_rt_battery_adc_busy_skipped (void)
+{
+    rt_battery_stats_t stats;
+    rt_adc_vdd_prepare_ExpectAnyArgsAndReturn (RD_ERROR_INVALID_STATE);
+    m_radio_cb (RI_RADIO_BEFORE);
+    scheduler_execute();
+    m_radio_cb (RI_RADIO_AFTER);
+    scheduler_execute();
+    TEST_ASSERT (RD_SUCCESS == rt_battery_stats_get (&stats));
+    TEST_ASSERT_EQUAL (0, stats.samples);
+    TEST_ASSERT_EQUAL (1, stats.skipped);
+    TEST_ASSERT_FLOAT_IS_NAN (stats.last_v);
+}
+
+void test_rt_battery_sample_error_skipped (void)
+{
+    rt_battery_stats_t stats;
+    rt_adc_vdd_prepare_ExpectAnyArgsAndReturn (RD_SUCCESS);
+    rt_adc_voltage_get_StubWithCallback (&rest_voltage_get);
+    rt_adc_vdd_sample_ExpectAndReturn (RD_SUCCESS);
+    rt_adc_vdd_get_ExpectAnyArgsAndReturn (RD_ERROR_INVALID_STATE);
+    m_radio_cb (RI_RADIO_BEFORE);
+    scheduler_execute();
+    m_radio_cb (RI_RADIO_AFTER);
+    scheduler_execute();
+    TEST_ASSERT (RD_SUCCESS == rt_battery_stats_get (&stats));
+    TEST_ASSERT_EQUAL (0, stats.samples);
+    TEST_ASSERT_EQUAL (1, stats.skipped);
+}
+
+void test_rt_battery_rest_error_skipped (void)
+{
+    rt_battery_stats_t stats;
+    rt_adc_vdd_prepare_ExpectAnyArgsAndReturn (RD_SUCCESS);
+    rt_adc_voltage_get_StubWithCallback (&rest_voltage_fail);
+    rt_adc_uninit_ExpectAndReturn (RD_SUCCESS);
+    m_radio_cb (RI_RADIO_BEFORE);
+    scheduler_execute();
+    m_radio_cb (RI_RADIO_AFTER);
+    scheduler_execute();
+    TEST_ASSERT (RD_SUCCESS == rt_battery_stats_get (&stats));
+    TEST_ASSERT_EQUAL (0, stats.samples);
+    TEST_ASSERT_EQUAL (1, stats.skipped);
+    TEST_ASSERT_FLOAT_IS_NAN (stats.max_droop_v);
+    // Next activity is sampled normally.
+    radio_activity (3.0F, 2.9F);
+    TEST_ASSERT (RD_SUCCESS == rt_battery_stats_get (&stats));
+    TEST_ASSERT_EQUAL (1, stats.samples);
+    TEST_ASSERT_EQUAL_FLOAT (0.1F, stats.max_droop_v);
+}
+
+void test_rt_battery_unpaired_after_ignored (void)
+{
+    rt_battery_stats_t stats;
+    m_radio_cb (RI_RADIO_AFTER);
+    TEST_ASSERT_EQUAL (0, m_puts);
+    TEST_ASSERT (RD_SUCCESS == rt_battery_stats_get (&stats));
+    TEST_ASSERT_EQUAL (0, stats.samples);
+    TEST_ASSERT_EQUAL (0, stats.skipped);
+}
+
+void test_rt_battery_chain_called (void)
+{
+    rt_battery_radio_activity_chain (&app_radio_cb);
+    radio_activity (3.0F, 2.9F);
+    TEST_ASSERT_EQUAL (2, m_radio_chained);
+}
+
+void test_rt_battery_reset (void)
+{
+    rt_battery_stats_t stats;
+    radio_activity (3.0F, 2.5F);
+    rt_battery_reset();
+    radio_activity (3.0F, 2.9F);
+    TEST_ASSERT (RD_SUCCESS == rt_battery_stats_get (&stats));
+    TEST_ASSERT_EQUAL (1, stats.samples);
+    TEST_ASSERT_EQUAL_FLOAT (2.9F, stats.min_v);
+}
+
+void test_rt_battery_stats_get_preempted_update (void)
+{
+    rt_battery_stats_t stats;
+    m_read_in_update = true;
+    radio_activity (3.0F, 2.9F);
+    // Reader in interrupt does not wait for update it preempted.
+    TEST_ASSERT (RD_ERROR_BUSY == m_update_read_status);
+    m_read_in_update = false;
+    TEST_ASSERT (RD_SUCCESS == rt_battery_stats_get (&stats));
+    TEST_ASSERT_EQUAL (1, stats.samples);
+}
+
+void test_rt_battery_stats_get_errors (void)
+{
+    rt_battery_stats_t stats;
+    TEST_ASSERT (RD_ERROR_NULL == rt_battery_stats_get (NULL));
+    rt_battery_uninit();
+    TEST_ASSERT (RD_ERROR_INVALID_STATE == rt_battery_stats_get (&stats));
+}
+
+void test_rt_battery_sensor_init (void)
+{
+    rd_sensor_t sensor;
+    TEST_ASSERT (RD_SUCCESS == rt_battery_sensor_init (&sensor, RD_BUS_NONE, 0));
+    TEST_ASSERT (1 == sensor.provides.datas.voltage_v);
+    TEST_ASSERT (RD_SUCCESS == rt_battery_sensor_uninit (&sensor, RD_BUS_NONE, 0));
+    TEST_ASSERT (RD_ERROR_NULL == rt_battery_sensor_init (NULL, RD_BUS_NONE, 0));
+    rt_battery_uninit();
+    TEST_ASSERT (RD_ERROR_INVALID_STATE == rt_battery_sensor_init (&sensor, RD_BUS_NONE, 0));
+}
+
+void test_rt_battery_sensor_data_get (void)
+{
+    rd_sensor_t sensor;
+    rd_sensor_data_t data = {0};
+    float values[1] = {RD_FLOAT_INVALID};
+    uint8_t dsp = RD_SENSOR_DSP_LOW_PASS;
+    uint8_t parameter = 4;
+    data.data = values;
+    data.fields.datas.voltage_v = 1;
+    TEST_ASSERT (RD_SUCCESS == rt_battery_sensor_init (&sensor, RD_BUS_NONE, 0));
+    TEST_ASSERT (RD_SUCCESS == sensor.data_get (&data));
+    TEST_ASSERT_FLOAT_IS_NAN (values[0]);
+    m_now_ms = 2000;
+    radio_activity (3.0F, 2.8F);
+    radio_activity (3.0F, 2.6F);
+    TEST_ASSERT (RD_SUCCESS == sensor.data_get (&data));
+    TEST_ASSERT_EQUAL_FLOAT (2.6F, values[0]);
+    TEST_ASSERT_EQUAL (2000, data.timestamp_ms);
+    TEST_ASSERT (RD_SUCCESS == sensor.dsp_set (&dsp, &parameter));
+    TEST_ASSERT_EQUAL (RD_SENSOR_CFG_DEFAULT, parameter);
+    TEST_ASSERT (RD_SUCCESS == sensor.data_get (&data));
+    TEST_ASSERT_EQUAL_FLOAT (2.7F, values[0]);
+}
+
+void test_rt_battery_sensor_dsp_not_supported (void)
+{
+    rd_sensor_t sensor;
+    uint8_t dsp = RD_SENSOR_DSP_HIGH_PASS;
+    uint8_t parameter = 1;
+    TEST_ASSERT (RD_SUCCESS == rt_battery_sensor_init (&sensor, RD_BUS_NONE, 0));
+    TEST_ASSERT (RD_ERROR_NOT_SUPPORTED == sensor.dsp_set (&dsp, &parameter));
+}
+
+void test_rt_battery_sensor_sleep_pauses (void)
+{
+    rd_sensor_t sensor;
+    rt_battery_stats_t stats;
+    uint8_t mode = RD_SENSOR_CFG_SLEEP;
+    TEST_ASSERT (RD_SUCCESS == rt_battery_sensor_init (&sensor, RD_BUS_NONE, 0));
+    TEST_ASSERT (RD_SUCCESS == sensor.mode_set (&mode));
+    m_radio_cb (RI_RADIO_BEFORE);
+    m_radio_cb (RI_RADIO_AFTER);
+    TEST_ASSERT_EQUAL (0, m_puts);
+    TEST_ASSERT (RD_SUCCESS == rt_battery_stats_get (&stats));
+    TEST_ASSERT_EQUAL (0, stats.samples);
+    mode = RD_SENSOR_CFG_DEFAULT;
+    TEST_ASSERT (RD_SUCCESS == sensor.mode_set (&mode));
+    TEST_ASSERT_EQUAL (RD_SENSOR_CFG_CONTINUOUS, mode);
+    radio_activity (3.0F, 2.9F);
+    TEST_ASSERT (RD_SUCCESS == rt_battery_stats_get (&stats));
+    TEST_ASSERT_EQUAL (1, stats.samples);
+}
+
+void test_rt_battery_sensor_configuration (void)
+{
+    rd_sensor_t sensor;
+    rd_sensor_configuration_t config =
+    {
+        .dsp_function  = RD_SENSOR_DSP_LOW_PASS,
+        .dsp_parameter = RD_SENSOR_CFG_DEFAULT,
+        .mode          = RD_SENSOR_CFG_CONTINUOUS,
+        .resolution    = RD_SENSOR_CFG_DEFAULT,
+        .samplerate    = RD_SENSOR_CFG_DEFAULT,
+        .scale         = RD_SENSOR_CFG_DEFAULT
+    };
+    TEST_ASSERT (RD_SUCCESS == rt_battery_sensor_init (&sensor, RD_BUS_NONE, 0));
+    TEST_ASSERT (RD_SUCCESS == sensor.configuration_set (&sensor, &config));
+    memset (&config, 0, sizeof (config));
+    TEST_ASSERT (RD_SUCCESS == sensor.configuration_get (&sensor, &config));
+    TEST_ASSERT_EQUAL (RD_SENSOR_DSP_LOW_PASS, config.dsp_function);
+    TEST_ASSERT_EQUAL (RD_SENSOR_CFG_CONTINUOUS, config.mode);
+}
@@ -122,3 +122,70 @@ void test_rt_com_get_id_str_null (void)
     err_code = rt_com_get_id_str (NULL, 18);
     TEST_ASSERT (RD_ERROR_NULL == err_code);
 }
+
+static char m_sent[64];
+static size_t m_sent_len;
+static size_t m_send_capacity;
+
+static rd_status_t mock_send (ri_comm_message_t * const msg)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if (0U == m_send_capacity)
+    {
+        err_code |= RD_ERROR_NO_MEM;
+    }
+    else
+    {
+        TEST_ASSERT (msg->data_length <= RI_COMM_MESSAGE_MAX_LENGTH);
+        TEST_ASSERT_EQUAL (1, msg->repeat_count);
+        memcpy (m_sent + m_sent_len, msg->data, msg->data_length);
+        m_sent_len += msg->data_length;
+        m_send_capacity--;
+    }
+
+    return err_code;
+}
+
+static void send_reset (const size_t capacity)
+{
+    memset (m_sent, 0, sizeof (m_sent));
+    m_sent_len = 0;
+    m_send_capacity = capacity;
+}
+
+void test_rt_com_send_chunked_ok (void)
+{
+    const char data[] = "0123456789abcdefghijklmnopqrstuvwxyzABCDEFGHIJ";
+    size_t offset = 0;
+    send_reset (SIZE_MAX);
+    rd_status_t err_code = rt_com_send_chunked (&mock_send, data, sizeof (data) - 1U,
+                           &offset);
+    TEST_ASSERT (RD_SUCCESS == err_code);
+    TEST_ASSERT_EQUAL (sizeof (data) - 1U, offset);
+    TEST_ASSERT_EQUAL_STRING (data, m_sent);
+}
+
+void test_rt_com_send_chunked_resume (void)
+{
+    const char data[] = "0123456789abcdefghijklmnopqrstuvwxyzABCDEFGHIJ";
+    size_t offset = 0;
+    send_reset (1);
+    rd_status_t err_code = rt_com_send_chunked (&mock_send, data, sizeof (data) - 1U,
+                           &offset);
+    TEST_ASSERT (RD_ERROR_NO_MEM == err_code);
+    TEST_ASSERT_EQUAL (RI_COMM_MESSAGE_MAX_LENGTH, offset);
+    m_send_capacity = SIZE_MAX;
+    err_code = rt_com_send_chunked (&mock_send, data, sizeof (data) - 1U, &offset);
+    TEST_ASSERT (RD_SUCCESS == err_code);
+    TEST_ASSERT_EQUAL_STRING (data, m_sent);
+}
+
+void test_rt_com_send_chunked_null (void)
+{
+    const char data[] = "abc";
+    size_t offset = 0;
+    TEST_ASSERT (RD_ERROR_NULL == rt_com_send_chunked (NULL, data, 3, &offset));
+    TEST_ASSERT (RD_ERROR_NULL == rt_com_send_chunked (&mock_send, NULL, 3, &offset));
+    TEST_ASSERT (RD_ERROR_NULL == rt_com_send_chunked (&mock_send, data, 3, NULL));
+}
@@ -0,0 +1,245 @@
+#include "unity.h"
+
+#include "ruuvi_driver_enabled_modules.h"
+#include "ruuvi_driver_error.h"
+#include "ruuvi_interface_communication_radio.h"
+#include "ruuvi_interface_rtc.h"
+#include "ruuvi_interface_yield.h"
+#include "ruuvi_task_energy.h"
+#include "mock_ruuvi_driver_sensor.h"
+
+#include <string.h>
+
+static uint64_t m_now_ms;
+static ri_yield_state_ind_fp_t m_yield_ind;
+static ri_radio_activity_interrupt_fp_t m_radio_cb;
+static size_t m_yield_chained;
+static size_t m_radio_chained;
+
+static const rt_energy_profile_t m_profile =
+{
+    .current_ua =
+    {
+        [RT_ENERGY_CPU]     = { [RT_ENERGY_STATE_SLEEP] = 2.0F, [RT_ENERGY_STATE_ACTIVE] = 3000.0F },
+        [RT_ENERGY_RADIO]   = { [RT_ENERGY_STATE_SLEEP] = 0.0F, [RT_ENERGY_STATE_ACTIVE] = 6000.0F },
+        [RT_ENERGY_SENSORS] = { [RT_ENERGY_STATE_SLEEP] = 1.0F, [RT_ENERGY_STATE_ACTIVE] = 10.0F },
+        [RT_ENERGY_ADC]     = { [RT_ENERGY_STATE_SLEEP] = 0.0F, [RT_ENERGY_STATE_ACTIVE] = 700.0F }
+    }
+};
+
+uint64_t ri_rtc_millis (void)
+{
+    return m_now_ms;
+}
+
+void ri_yield_indication_set (const ri_yield_state_ind_fp_t indication)
+{
+    m_yield_ind = indication;
+}
+
+void ri_radio_activity_callback_set (const ri_radio_activity_interrupt_fp_t handler)
+{
+    // Interface does not overwrite existing callback.
+    if ( (NULL == handler) || (NULL == m_radio_cb))
+    {
+        m_radio_cb = handler;
+    }
+}
+
+ri_radio_activity_interrupt_fp_t ri_radio_activity_callback_get (void)
+{
+    return m_radio_cb;
+}
+
+static void app_yield_ind (const bool active)
+{
+    m_yield_chained++;
+}
+
+static void app_radio_cb (const ri_radio_activity_evt_t evt)
+{
+    m_radio_chained++;
+}
+
+void setUp (void)
+{
+    m_now_ms = 1000;
+    m_yield_ind = NULL;
+    m_radio_cb = NULL;
+    m_yield_chained = 0;
+    m_radio_chained = 0;
+    TEST_ASSERT (RD_SUCCESS == rt_energy_init (&m_profile));
+}
+
+void tearDown (void)
+{
+    rt_energy_uninit();
+}
+
+void test_rt_energy_init_null (void)
+{
+    rt_energy_uninit();
+    TEST_ASSERT (RD_ERROR_NULL == rt_energy_init (NULL));
+    TEST_ASSERT (!rt_energy_is_init());
+}
+
+void test_rt_energy_init_twice (void)
+{
+    TEST_ASSERT (RD_ERROR_INVALID_STATE == rt_energy_init (&m_profile));
+}
+
+void test_rt_energy_init_installs_callbacks (void)
+{
+    TEST_ASSERT (NULL != m_yield_ind);
+    TEST_ASSERT (NULL != m_radio_cb);
+}
+
+void test_rt_energy_uninit_restores_chain (void)
+{
+    rt_energy_yield_indication_chain (&app_yield_ind);
+    rt_energy_radio_activity_chain (&app_radio_cb);
+    rt_energy_uninit();
+    TEST_ASSERT (&app_yield_ind == m_yield_ind);
+    TEST_ASSERT (&app_radio_cb == m_radio_cb);
+    TEST_ASSERT (!rt_energy_is_init());
+}
+
+void test_rt_energy_init_callback_installed (void)
+{
+    rt_energy_uninit();
+    m_radio_cb = &app_radio_cb;
+    TEST_ASSERT (RD_ERROR_INVALID_STATE == rt_energy_init (&m_profile));
+    TEST_ASSERT (!rt_energy_is_init());
+    TEST_ASSERT (&app_radio_cb == m_radio_cb);
+}
+
+void test_rt_energy_uninit_keeps_replaced_callback (void)
+{
+    ri_radio_activity_callback_set (NULL);
+    ri_radio_activity_callback_set (&app_radio_cb);
+    rt_energy_uninit();
+    TEST_ASSERT (&app_radio_cb == m_radio_cb);
+}
+
+void test_rt_energy_cpu_yield (void)
+{
+    rt_energy_report_t report;
+    m_now_ms += 100;
+    m_yield_ind (false);
+    m_now_ms += 900;
+    m_yield_ind (true);
+    m_now_ms += 50;
+    TEST_ASSERT (RD_SUCCESS == rt_energy_report_get (&report));
+    TEST_ASSERT_EQUAL (1050, report.elapsed_ms);
+    TEST_ASSERT_EQUAL (150, report.state_ms[RT_ENERGY_CPU][RT_ENERGY_STATE_ACTIVE]);
+    TEST_ASSERT_EQUAL (900, report.state_ms[RT_ENERGY_CPU][RT_ENERGY_STATE_SLEEP]);
+}
+
+void test_rt_energy_radio_activity (void)
+{
+    rt_energy_report_t report;
+    m_radio_cb (RI_RADIO_BEFORE);
+    m_now_ms += 3;
+    m_radio_cb (RI_RADIO_AFTER);
+    m_now_ms += 997;
+    TEST_ASSERT (RD_SUCCESS == rt_energy_report_get (&report));
+    TEST_ASSERT_EQUAL (3, report.state_ms[RT_ENERGY_RADIO][RT_ENERGY_STATE_ACTIVE]);
+    TEST_ASSERT_EQUAL (997, report.state_ms[RT_ENERGY_RADIO][RT_ENERGY_STATE_SLEEP]);
+}
+
+void test_rt_energy_callbacks_chained (void)
+{
+    rt_energy_yield_indication_chain (&app_yield_ind);
+    rt_energy_radio_activity_chain (&app_radio_cb);
+    m_yield_ind (false);
+    m_yield_ind (true);
+    m_radio_cb (RI_RADIO_BEFORE);
+    TEST_ASSERT_EQUAL (2, m_yield_chained);
+    TEST_ASSERT_EQUAL (1, m_radio_chained);
+}
+
+void test_rt_energy_sensor_modes (void)
+{
+    rt_energy_report_t report;
+    const int sensor_a = 0;
+    const int sensor_b = 0;
+    rt_energy_sensor_mode_set (&sensor_a, RD_SENSOR_CFG_CONTINUOUS);
+    rt_energy_sensor_mode_set (&sensor_b, RD_SENSOR_CFG_SLEEP);
+    m_now_ms += 100;
+    rt_energy_sensor_mode_set (&sensor_a, RD_SENSOR_CFG_SINGLE);
+    m_now_ms += 100;
+    TEST_ASSERT (RD_SUCCESS == rt_energy_report_get (&report));
+    TEST_ASSERT_EQUAL (100, report.state_ms[RT_ENERGY_SENSORS][RT_ENERGY_STATE_ACTIVE]);
+    TEST_ASSERT_EQUAL (300, report.state_ms[RT_ENERGY_SENSORS][RT_ENERGY_STATE_SLEEP]);
+}
+
+void test_rt_energy_sensor_slots_full (void)
+{
+    rt_energy_report_t report;
+    int sensors[RT_ENERGY_SENSOR_SLOTS + 1U];
+
+    for (size_t ii = 0; ii < (RT_ENERGY_SENSOR_SLOTS + 1U); ii++)
+    {
+        rt_energy_sensor_mode_set (&sensors[ii], RD_SENSOR_CFG_CONTINUOUS);
+    }
+
+    m_now_ms += 10;
+    TEST_ASSERT (RD_SUCCESS == rt_energy_report_get (&report));
+    TEST_ASSERT_EQUAL (10 * RT_ENERGY_SENSOR_SLOTS,
+                       report.state_ms[RT_ENERGY_SENSORS][RT_ENERGY_STATE_ACTIVE]);
+}
+
+void test_rt_energy_state_set_adc (void)
+{
+    rt_energy_report_t report;
+    TEST_ASSERT (RD_SUCCESS == rt_energy_state_set (RT_ENERGY_ADC, RT_ENERGY_STATE_ACTIVE));
+    m_now_ms += 5;
+    TEST_ASSERT (RD_SUCCESS == rt_energy_state_set (RT_ENERGY_ADC, RT_ENERGY_STATE_SLEEP));
+    TEST_ASSERT (RD_SUCCESS == rt_energy_report_get (&report));
+    TEST_ASSERT_EQUAL (5, report.state_ms[RT_ENERGY_ADC][RT_ENERGY_STATE_ACTIVE]);
+}
+
+void test_rt_energy_state_set_invalid (void)
+{
+    TEST_ASSERT (RD_ERROR_INVALID_PARAM == rt_energy_state_set (RT_ENERGY_SENSORS,
+                 RT_ENERGY_STATE_ACTIVE));
+    TEST_ASSERT (RD_ERROR_INVALID_PARAM == rt_energy_state_set (RT_ENERGY_ADC,
+                 RT_ENERGY_STATE_COUNT));
+    rt_energy_uninit();
+    TEST_ASSERT (RD_ERROR_INVALID_STATE == rt_energy_state_set (RT_ENERGY_ADC,
+                 RT_ENERGY_STATE_ACTIVE));
+}
+
+void test_rt_energy_report_uah (void)
+{
+    rt_energy_report_t report;
+    // One hour: CPU active 36 s, radio active 3.6 s.
+    m_now_ms += 36000;
+    m_yield_ind (false);
+    m_radio_cb (RI_RADIO_BEFORE);
+    m_now_ms += 3600;
+    m_radio_cb (RI_RADIO_AFTER);
+    m_now_ms += 3600000 - 36000 - 3600;
+    TEST_ASSERT (RD_SUCCESS == rt_energy_report_get (&report));
+    TEST_ASSERT_FLOAT_WITHIN (0.01F, 30.0F + 1.98F, report.subsystem_uah[RT_ENERGY_CPU]);
+    TEST_ASSERT_FLOAT_WITHIN (0.01F, 6.0F, report.subsystem_uah[RT_ENERGY_RADIO]);
+    TEST_ASSERT_FLOAT_WITHIN (0.01F, 0.0F, report.subsystem_uah[RT_ENERGY_ADC]);
+    TEST_ASSERT_FLOAT_WITHIN (0.01F, 37.98F, report.total_uah);
+    TEST_ASSERT_FLOAT_WITHIN (0.01F, 37.98F, report.uah_per_hour);
+}
+
+void test_rt_energy_reset (void)
+{
+    rt_energy_report_t report;
+    m_now_ms += 500;
+    rt_energy_reset();
+    m_now_ms += 20;
+    TEST_ASSERT (RD_SUCCESS == rt_energy_report_get (&report));
+    TEST_ASSERT_EQUAL (20, report.elapsed_ms);
+    TEST_ASSERT_EQUAL (20, report.state_ms[RT_ENERGY_CPU][RT_ENERGY_STATE_ACTIVE]);
+}
+
+void test_rt_energy_report_get_null (void)
+{
+    TEST_ASSERT (RD_ERROR_NULL == rt_energy_report_get (NULL));
+}
@@ -10,6 +10,7 @@
 void setUp (void)
 {
     ri_log_Ignore();
+    ri_log_module_Ignore();
     ri_error_to_string_IgnoreAndReturn (0);
 }
 
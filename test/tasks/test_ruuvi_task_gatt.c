@@ -12,6 +12,7 @@
 #include "mock_ruuvi_interface_communication_ble_gatt.h"
 #include "mock_ruuvi_interface_communication_radio.h"
 #include "mock_ruuvi_interface_log.h"
+#include "mock_ruuvi_interface_rtc.h"
 
 #include <string.h>
 
@@ -25,31 +26,51 @@ static const char m_name[] = "Ceedling";
 
 #define SEND_COUNT_MAX (10U)
 
+static uint32_t m_send_limit;        //!< Sends accepted before returning m_send_error.
+static rd_status_t m_send_error;
+static uint8_t m_sent_ids[SEND_COUNT_MAX + RT_GATT_TX_QUEUE_LENGTH];
+static uint64_t m_millis;
+static uint32_t m_throttle_count;
+static uint32_t m_resume_count;
+
 rd_status_t mock_send (ri_comm_message_t * const p_msg)
 {
     rd_status_t err_code = RD_SUCCESS;
-    static bool extra_error = false;
 
-    if (send_count < SEND_COUNT_MAX)
+    if (send_count < m_send_limit)
     {
+        if (send_count < sizeof (m_sent_ids))
+        {
+            m_sent_ids[send_count] = p_msg->data[0];
+        }
+
         send_count++;
     }
     else
     {
-        if (!extra_error)
-        {
-            err_code |= RD_ERROR_RESOURCES;
-            extra_error = true;
-        }
-        else
-        {
-            err_code |= RD_ERROR_INTERNAL;
-        }
+        err_code |= m_send_error;
     }
 
     return err_code;
 }
 
+static bool atomic_flag_fake (ri_atomic_t * const flag, const bool set, int cmock_num_calls)
+{
+    const bool was_set = (0U != *flag);
+    *flag = set;
+    return set ? !was_set : was_set;
+}
+
+static uint64_t rtc_millis_fake (int cmock_num_calls)
+{
+    return m_millis;
+}
+
+static void on_backpressure_isr (const bool throttle)
+{
+    throttle ? m_throttle_count++ : m_resume_count++;
+}
+
 rd_status_t mock_read (ri_comm_message_t * const p_msg)
 {
     read_count++;
@@ -99,7 +120,13 @@ void setUp (void)
     rd_status_t err_code = RD_SUCCESS;
     ri_log_Ignore();
     ri_log_hex_Ignore();
+    ri_log_module_Ignore();
+    ri_log_module_hex_Ignore();
     ri_error_to_string_IgnoreAndReturn (RD_SUCCESS);
+    ri_atomic_flag_StubWithCallback (&atomic_flag_fake);
+    ri_rtc_millis_StubWithCallback (&rtc_millis_fake);
+    m_send_limit = SEND_COUNT_MAX;
+    m_send_error = RD_ERROR_RESOURCES;
     rt_adv_is_init_ExpectAndReturn (true);
     ri_gatt_init_ExpectAndReturn (RD_SUCCESS);
     err_code |= rt_gatt_init (m_name);
@@ -116,6 +143,10 @@ void tearDown (void)
     m_discon_cb = false;
     m_tx_cb = false;
     m_rx_cb = false;
+    m_millis = 0;
+    m_throttle_count = 0;
+    m_resume_count = 0;
+    memset (m_sent_ids, 0, sizeof (m_sent_ids));
     rt_gatt_mock_state_reset();
     TEST_ASSERT (!rt_gatt_is_init());
 }
@@ -430,11 +461,13 @@ void test_rt_gatt_send_asynchronous_no_mem()
     rt_gatt_on_nus_isr (RI_COMM_CONNECTED,
                         NULL, 0);
 
-    for (uint32_t ii = 0; ii <= SEND_COUNT_MAX; ii++)
+    for (uint32_t ii = 0; ii < (SEND_COUNT_MAX + RT_GATT_TX_QUEUE_LENGTH); ii++)
     {
         err_code |= rt_gatt_send_asynchronous (&msg);
     }
 
+    TEST_ASSERT (RD_SUCCESS == err_code);
+    err_code |= rt_gatt_send_asynchronous (&msg);
     TEST_ASSERT (SEND_COUNT_MAX == send_count);
     TEST_ASSERT (RD_ERROR_NO_MEM == err_code);
 }
@@ -442,11 +475,13 @@ void test_rt_gatt_send_asynchronous_no_mem()
 void test_rt_gatt_send_asynchronous_unknown_error()
 {
     rd_status_t err_code = RD_SUCCESS;
+    rt_gatt_tx_stats_t stats = { 0 };
     ri_comm_message_t msg = { 0 };
     msg.data_length = 11;
     test_rt_gatt_nus_init_ok();
     rt_gatt_on_nus_isr (RI_COMM_CONNECTED,
                         NULL, 0);
+    m_send_error = RD_ERROR_INTERNAL;
 
     for (uint32_t ii = 0; ii < SEND_COUNT_MAX; ii++)
     {
@@ -455,6 +490,175 @@ void test_rt_gatt_send_asynchronous_unknown_error()
 
     err_code = rt_gatt_send_asynchronous (&msg);
     TEST_ASSERT (RD_ERROR_INTERNAL == err_code);
+    // Failed message is dropped and doesn't block queue.
+    TEST_ASSERT (RD_SUCCESS == rt_gatt_tx_stats_get (&stats));
+    TEST_ASSERT (0U == stats.depth);
+    TEST_ASSERT (1U == stats.dropped);
+}
+
+static void send_ids (const uint8_t first, const uint8_t count)
+{
+    ri_comm_message_t msg = { 0 };
+    msg.data_length = 1;
+
+    for (uint8_t ii = 0; ii < count; ii++)
+    {
+        msg.data[0] = first + ii;
+        TEST_ASSERT (RD_SUCCESS == rt_gatt_send_asynchronous (&msg));
+    }
+}
+
+void test_rt_gatt_send_asynchronous_drains_on_sent()
+{
+    test_rt_gatt_nus_init_ok();
+    rt_gatt_on_nus_isr (RI_COMM_CONNECTED, NULL, 0);
+    m_send_limit = 2U;
+    send_ids (0U, 5U);
+    TEST_ASSERT (2U == send_count);
+    m_send_limit = 4U;
+    rt_gatt_on_nus_isr (RI_COMM_SENT, NULL, 0);
+    TEST_ASSERT (4U == send_count);
+    m_send_limit = SEND_COUNT_MAX;
+    rt_gatt_on_nus_isr (RI_COMM_SENT, NULL, 0);
+    TEST_ASSERT (5U == send_count);
+
+    // Queue keeps order of messages.
+    for (uint8_t ii = 0; ii < 5U; ii++)
+    {
+        TEST_ASSERT (ii == m_sent_ids[ii]);
+    }
+}
+
+void test_rt_gatt_send_asynchronous_busy_retried()
+{
+    test_rt_gatt_nus_init_ok();
+    rt_gatt_on_nus_isr (RI_COMM_CONNECTED, NULL, 0);
+    m_send_limit = 0U;
+    m_send_error = RD_ERROR_BUSY;
+    send_ids (0U, 2U);
+    TEST_ASSERT (0U == send_count);
+    m_send_limit = SEND_COUNT_MAX;
+    rt_gatt_on_nus_isr (RI_COMM_SENT, NULL, 0);
+    TEST_ASSERT (2U == send_count);
+}
+
+static ri_gatt_bulk_done_fp m_bulk_done;
+static size_t m_bulk_done_calls;
+
+static rd_status_t bulk_send_fake (const ri_comm_segment_t * const p_segments,
+                                   const size_t segment_count,
+                                   const ri_gatt_bulk_done_fp on_done,
+                                   int cmock_num_calls)
+{
+    m_bulk_done = on_done;
+    return RD_SUCCESS;
+}
+
+static void on_bulk_done (const rd_status_t result, const size_t sent)
+{
+    m_bulk_done_calls++;
+    TEST_ASSERT (RD_SUCCESS == result);
+    TEST_ASSERT (14U == sent);
+}
+
+void test_rt_gatt_bulk_send_resumes_queue()
+{
+    const uint8_t data[14] = { 0 };
+    const ri_comm_segment_t segment = { data, sizeof (data) };
+    m_bulk_done_calls = 0;
+    test_rt_gatt_nus_init_ok();
+    TEST_ASSERT (RD_ERROR_INVALID_STATE == rt_gatt_bulk_send (&segment, 1U, &on_bulk_done));
+    rt_gatt_on_nus_isr (RI_COMM_CONNECTED, NULL, 0);
+    ri_gatt_nus_bulk_is_active_ExpectAndReturn (false);
+    ri_gatt_nus_bulk_send_StubWithCallback (&bulk_send_fake);
+    TEST_ASSERT (RD_SUCCESS == rt_gatt_bulk_send (&segment, 1U, &on_bulk_done));
+    // Messages wait while bulk transfer holds the link.
+    m_send_limit = 0U;
+    m_send_error = RD_ERROR_BUSY;
+    send_ids (0U, 2U);
+    TEST_ASSERT (0U == send_count);
+    // Last chunk was queued to stack, queue drains without a TX event.
+    m_send_limit = SEND_COUNT_MAX;
+    m_bulk_done (RD_SUCCESS, sizeof (data));
+    TEST_ASSERT (2U == send_count);
+    TEST_ASSERT (1U == m_bulk_done_calls);
+}
+
+void test_rt_gatt_bulk_send_busy()
+{
+    const uint8_t data[14] = { 0 };
+    const ri_comm_segment_t segment = { data, sizeof (data) };
+    test_rt_gatt_nus_init_ok();
+    rt_gatt_on_nus_isr (RI_COMM_CONNECTED, NULL, 0);
+    ri_gatt_nus_bulk_is_active_ExpectAndReturn (true);
+    TEST_ASSERT (RD_ERROR_BUSY == rt_gatt_bulk_send (&segment, 1U, &on_bulk_done));
+}
+
+void test_rt_gatt_tx_backpressure()
+{
+    test_rt_gatt_nus_init_ok();
+    rt_gatt_set_on_tx_backpressure_isr (&on_backpressure_isr);
+    rt_gatt_on_nus_isr (RI_COMM_CONNECTED, NULL, 0);
+    m_send_limit = 0U;
+    send_ids (0U, RT_GATT_TX_HIGH_WATER - 1U);
+    TEST_ASSERT (0U == m_throttle_count);
+    send_ids (0U, 1U);
+    TEST_ASSERT (1U == m_throttle_count);
+    send_ids (0U, RT_GATT_TX_QUEUE_LENGTH - RT_GATT_TX_HIGH_WATER);
+    TEST_ASSERT (1U == m_throttle_count);
+    TEST_ASSERT (0U == m_resume_count);
+    // Drain to just above low watermark.
+    m_send_limit = RT_GATT_TX_QUEUE_LENGTH - RT_GATT_TX_LOW_WATER - 1U;
+    rt_gatt_on_nus_isr (RI_COMM_SENT, NULL, 0);
+    TEST_ASSERT (0U == m_resume_count);
+    m_send_limit++;
+    rt_gatt_on_nus_isr (RI_COMM_SENT, NULL, 0);
+    TEST_ASSERT (1U == m_resume_count);
+}
+
+void test_rt_gatt_tx_stats_stall_time()
+{
+    rt_gatt_tx_stats_t stats = { 0 };
+    test_rt_gatt_nus_init_ok();
+    rt_gatt_on_nus_isr (RI_COMM_CONNECTED, NULL, 0);
+    m_send_limit = 1U;
+    m_millis = 1000U;
+    send_ids (0U, 3U);
+    m_millis = 1030U;
+    TEST_ASSERT (RD_SUCCESS == rt_gatt_tx_stats_get (&stats));
+    TEST_ASSERT (2U == stats.depth);
+    TEST_ASSERT (2U == stats.depth_max);
+    TEST_ASSERT (3U == stats.queued);
+    TEST_ASSERT (1U == stats.stalls);
+    TEST_ASSERT (30U == stats.stall_ms);
+    m_millis = 1050U;
+    m_send_limit = SEND_COUNT_MAX;
+    rt_gatt_on_nus_isr (RI_COMM_SENT, NULL, 0);
+    m_millis = 2000U;
+    TEST_ASSERT (RD_SUCCESS == rt_gatt_tx_stats_get (&stats));
+    TEST_ASSERT (0U == stats.depth);
+    TEST_ASSERT (50U == stats.stall_ms);
+    TEST_ASSERT (RD_ERROR_NULL == rt_gatt_tx_stats_get (NULL));
+}
+
+void test_rt_gatt_tx_flushed_on_disconnect()
+{
+    rt_gatt_tx_stats_t stats = { 0 };
+    test_rt_gatt_nus_init_ok();
+    rt_gatt_set_on_tx_backpressure_isr (&on_backpressure_isr);
+    rt_gatt_on_nus_isr (RI_COMM_CONNECTED, NULL, 0);
+    m_send_limit = 0U;
+    send_ids (0U, RT_GATT_TX_QUEUE_LENGTH);
+    rt_gatt_on_nus_isr (RI_COMM_DISCONNECTED, NULL, 0);
+    TEST_ASSERT (1U == m_resume_count);
+    TEST_ASSERT (RD_SUCCESS == rt_gatt_tx_stats_get (&stats));
+    TEST_ASSERT (0U == stats.depth);
+    TEST_ASSERT (RT_GATT_TX_QUEUE_LENGTH == stats.dropped);
+    // Queue is usable again on reconnection.
+    m_send_limit = SEND_COUNT_MAX;
+    rt_gatt_on_nus_isr (RI_COMM_CONNECTED, NULL, 0);
+    send_ids (0U, 1U);
+    TEST_ASSERT (1U == send_count);
 }
 
 void test_rt_gatt_callbacks_ok()
@@ -537,4 +741,201 @@ void test_rt_gatt_uninit_adv_ongoing (void)
     rt_adv_is_init_ExpectAndReturn (true);
     rd_status_t err_code = rt_gatt_uninit();
     TEST_ASSERT (RD_ERROR_INVALID_STATE == err_code);
-}
\ No newline at end of file
+}
+static const rt_gatt_autotune_config_t m_autotune_config =
+{
+    .turbo_tx_depth = 3U,
+    .turbo_rx_messages = 4U,
+    .standard_idle_ms = 2000U,
+    .low_power_idle_ms = 10000U,
+    .min_switch_interval_ms = 1000U
+};
+
+static void autotune_connect (const rt_gatt_autotune_config_t * const p_config)
+{
+    test_rt_gatt_nus_init_ok();
+    rt_gatt_on_nus_isr (RI_COMM_CONNECTED, NULL, 0);
+    TEST_ASSERT (RD_SUCCESS == rt_gatt_autotune_start (p_config));
+}
+
+void test_rt_gatt_autotune_start_errors (void)
+{
+    rt_gatt_autotune_config_t config = m_autotune_config;
+    TEST_ASSERT (RD_ERROR_NULL == rt_gatt_autotune_start (NULL));
+    config.low_power_idle_ms = config.standard_idle_ms - 1U;
+    TEST_ASSERT (RD_ERROR_INVALID_PARAM == rt_gatt_autotune_start (&config));
+    rt_gatt_mock_state_reset();
+    TEST_ASSERT (RD_ERROR_INVALID_STATE == rt_gatt_autotune_start (&m_autotune_config));
+}
+
+void test_rt_gatt_autotune_turbo_on_tx_then_idle (void)
+{
+    rt_gatt_autotune_stats_t stats = { 0 };
+    autotune_connect (&m_autotune_config);
+    m_send_limit = 0U;
+    send_ids (0U, 3U);
+    ri_gatt_params_request_ExpectAndReturn (RI_GATT_TURBO, 0, RD_SUCCESS);
+    TEST_ASSERT (RD_SUCCESS == rt_gatt_autotune_process());
+    m_send_limit = SEND_COUNT_MAX;
+    rt_gatt_on_nus_isr (RI_COMM_SENT, NULL, 0);
+    m_millis = 1500U;
+    TEST_ASSERT (RD_SUCCESS == rt_gatt_autotune_process());
+    m_millis = 2000U;
+    ri_gatt_params_request_ExpectAndReturn (RI_GATT_STANDARD, 0, RD_SUCCESS);
+    TEST_ASSERT (RD_SUCCESS == rt_gatt_autotune_process());
+    m_millis = 10000U;
+    ri_gatt_params_request_ExpectAndReturn (RI_GATT_LOW_POWER, 0, RD_SUCCESS);
+    TEST_ASSERT (RD_SUCCESS == rt_gatt_autotune_process());
+    m_millis = 12000U;
+    TEST_ASSERT (RD_SUCCESS == rt_gatt_autotune_process());
+    TEST_ASSERT (RD_SUCCESS == rt_gatt_autotune_stats_get (&stats));
+    TEST_ASSERT (RI_GATT_LOW_POWER == stats.profile);
+    TEST_ASSERT (3U == stats.switches);
+    TEST_ASSERT (2000U == stats.time_ms[RI_GATT_TURBO]);
+    TEST_ASSERT (8000U == stats.time_ms[RI_GATT_STANDARD]);
+    TEST_ASSERT (2000U == stats.time_ms[RI_GATT_LOW_POWER]);
+    TEST_ASSERT (RD_ERROR_NULL == rt_gatt_autotune_stats_get (NULL));
+}
+
+void test_rt_gatt_autotune_turbo_on_rx (void)
+{
+    autotune_connect (&m_autotune_config);
+
+    for (size_t ii = 0; ii < 3U; ii++)
+    {
+        rt_gatt_on_nus_isr (RI_COMM_RECEIVED, NULL, 0);
+    }
+
+    TEST_ASSERT (RD_SUCCESS == rt_gatt_autotune_process());
+    m_millis = 100U;
+
+    for (size_t ii = 0; ii < 4U; ii++)
+    {
+        rt_gatt_on_nus_isr (RI_COMM_RECEIVED, NULL, 0);
+    }
+
+    ri_gatt_params_request_ExpectAndReturn (RI_GATT_TURBO, 0, RD_SUCCESS);
+    TEST_ASSERT (RD_SUCCESS == rt_gatt_autotune_process());
+}
+
+void test_rt_gatt_autotune_rate_limited (void)
+{
+    rt_gatt_autotune_stats_t stats = { 0 };
+    rt_gatt_autotune_config_t config = m_autotune_config;
+    config.standard_idle_ms = 500U;
+    config.min_switch_interval_ms = 5000U;
+    autotune_connect (&config);
+    m_send_limit = 0U;
+    send_ids (0U, 3U);
+    ri_gatt_params_request_ExpectAndReturn (RI_GATT_TURBO, 0, RD_SUCCESS);
+    TEST_ASSERT (RD_SUCCESS == rt_gatt_autotune_process());
+    m_send_limit = SEND_COUNT_MAX;
+    rt_gatt_on_nus_isr (RI_COMM_SENT, NULL, 0);
+    m_millis = 1000U;
+    TEST_ASSERT (RD_SUCCESS == rt_gatt_autotune_process());
+    m_millis = 4999U;
+    TEST_ASSERT (RD_SUCCESS == rt_gatt_autotune_process());
+    m_millis = 5000U;
+    ri_gatt_params_request_ExpectAndReturn (RI_GATT_STANDARD, 0, RD_SUCCESS);
+    TEST_ASSERT (RD_SUCCESS == rt_gatt_autotune_process());
+    TEST_ASSERT (RD_SUCCESS == rt_gatt_autotune_stats_get (&stats));
+    TEST_ASSERT (2U == stats.deferred);
+    TEST_ASSERT (2U == stats.switches);
+}
+
+void test_rt_gatt_autotune_low_power_wakes_on_traffic (void)
+{
+    autotune_connect (&m_autotune_config);
+    m_millis = 10000U;
+    ri_gatt_params_request_ExpectAndReturn (RI_GATT_LOW_POWER, 0, RD_SUCCESS);
+    TEST_ASSERT (RD_SUCCESS == rt_gatt_autotune_process());
+    m_millis = 20000U;
+    send_ids (0U, 1U);
+    ri_gatt_params_request_ExpectAndReturn (RI_GATT_STANDARD, 0, RD_SUCCESS);
+    TEST_ASSERT (RD_SUCCESS == rt_gatt_autotune_process());
+}
+
+void test_rt_gatt_autotune_request_fails (void)
+{
+    rt_gatt_autotune_stats_t stats = { 0 };
+    autotune_connect (&m_autotune_config);
+    m_send_limit = 0U;
+    send_ids (0U, 3U);
+    ri_gatt_params_request_ExpectAndReturn (RI_GATT_TURBO, 0, RD_ERROR_INVALID_STATE);
+    TEST_ASSERT (RD_ERROR_INVALID_STATE == rt_gatt_autotune_process());
+    TEST_ASSERT (RD_SUCCESS == rt_gatt_autotune_stats_get (&stats));
+    TEST_ASSERT (RI_GATT_STANDARD == stats.profile);
+    TEST_ASSERT (0U == stats.switches);
+}
+
+void test_rt_gatt_autotune_not_connected (void)
+{
+    rt_gatt_autotune_stats_t stats = { 0 };
+    test_rt_gatt_nus_init_ok();
+    TEST_ASSERT (RD_SUCCESS == rt_gatt_autotune_start (&m_autotune_config));
+    m_millis = 20000U;
+    TEST_ASSERT (RD_SUCCESS == rt_gatt_autotune_process());
+    TEST_ASSERT (RD_SUCCESS == rt_gatt_autotune_stats_get (&stats));
+    TEST_ASSERT (0U == stats.time_ms[RI_GATT_STANDARD]);
+    rt_gatt_autotune_stop();
+}
+
+static void on_link_isr (const ri_gatt_link_t * const p_link)
+{
+}
+
+void test_rt_gatt_set_on_link_isr (void)
+{
+    ri_gatt_link_cb_set_Expect (&on_link_isr);
+    rt_gatt_set_on_link_isr (&on_link_isr);
+}
+
+void test_rt_gatt_throughput_get_ok (void)
+{
+    rt_gatt_throughput_t throughput = { 0 };
+    ri_gatt_link_t link =
+    {
+        .att_mtu = 247U,
+        .data_length = 251U,
+        .tx_phy = RI_RADIO_BLE_2MBPS,
+        .rx_phy = RI_RADIO_BLE_2MBPS,
+        .conn_interval_us = 15000U,
+        .tx_bytes = 12000U,
+        .rx_bytes = 100U
+    };
+    m_millis = 1000U;
+    test_rt_gatt_nus_init_ok();
+    rt_gatt_on_nus_isr (RI_COMM_CONNECTED, NULL, 0);
+    m_millis = 5000U;
+    ri_gatt_link_get_ExpectAnyArgsAndReturn (RD_SUCCESS);
+    ri_gatt_link_get_ReturnThruPtr_p_link (&link);
+    TEST_ASSERT (RD_SUCCESS == rt_gatt_throughput_get (&throughput));
+    TEST_ASSERT (247U == throughput.link.att_mtu);
+    TEST_ASSERT (RI_RADIO_BLE_2MBPS == throughput.link.tx_phy);
+    TEST_ASSERT (4000U == throughput.connected_ms);
+    TEST_ASSERT (3000U == throughput.tx_bytes_per_second);
+    TEST_ASSERT (25U == throughput.rx_bytes_per_second);
+}
+
+void test_rt_gatt_throughput_get_just_connected (void)
+{
+    rt_gatt_throughput_t throughput = { 0 };
+    ri_gatt_link_t link = { .tx_bytes = 20U };
+    test_rt_gatt_nus_init_ok();
+    rt_gatt_on_nus_isr (RI_COMM_CONNECTED, NULL, 0);
+    ri_gatt_link_get_ExpectAnyArgsAndReturn (RD_SUCCESS);
+    ri_gatt_link_get_ReturnThruPtr_p_link (&link);
+    TEST_ASSERT (RD_SUCCESS == rt_gatt_throughput_get (&throughput));
+    TEST_ASSERT (0U == throughput.tx_bytes_per_second);
+}
+
+void test_rt_gatt_throughput_get_errors (void)
+{
+    rt_gatt_throughput_t throughput = { 0 };
+    TEST_ASSERT (RD_ERROR_NULL == rt_gatt_throughput_get (NULL));
+    test_rt_gatt_nus_init_ok();
+    TEST_ASSERT (RD_ERROR_INVALID_STATE == rt_gatt_throughput_get (&throughput));
+    rt_gatt_on_nus_isr (RI_COMM_CONNECTED, NULL, 0);
+    ri_gatt_link_get_ExpectAnyArgsAndReturn (RD_ERROR_INVALID_STATE);
+    TEST_ASSERT (RD_ERROR_INVALID_STATE == rt_gatt_throughput_get (&throughput));
+}
@@ -0,0 +1,274 @@
+#include "unity.h"
+
+#include "ruuvi_driver_enabled_modules.h"
+#include "ruuvi_interface_aes.h"
+#include "ruuvi_interface_aes_ctr.h"
+#include "ruuvi_task_keystream.h"
+#include "mock_ruuvi_driver_error.h"
+#include "mock_ruuvi_interface_scheduler.h"
+
+#include <string.h>
+
+#define POOL_BYTES (RI_AES_CTR_KEYSTREAM_BLOCKS * RI_AES_BLOCK_SIZE)
+
+static ruuvi_scheduler_event_handler_t m_scheduled;
+static size_t m_puts;
+static rd_status_t m_put_result;
+static size_t m_ecb_blocks;
+
+static const uint8_t m_key_a[16] =
+{
+    0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f
+};
+static const uint8_t m_key_b[16] =
+{
+    0xa0, 0xa1, 0xa2, 0xa3, 0xa4, 0xa5, 0xa6, 0xa7, 0xa8, 0xa9, 0xaa, 0xab, 0xac, 0xad, 0xae, 0xaf
+};
+static const uint8_t m_counter[16] = {0};
+
+/** Stand-in block cipher, keystream block is counter XOR key. */
+rd_status_t ri_aes_ecb_128_encrypt (const uint8_t * const cleartext,
+                                    uint8_t * const ciphertext,
+                                    const uint8_t * const key,
+                                    const size_t data_length)
+{
+    for (size_t ii = 0; ii < data_length; ii++)
+    {
+        ciphertext[ii] = cleartext[ii] ^ key[ii % 16U];
+    }
+
+    m_ecb_blocks += data_length / 16U;
+    return RD_SUCCESS;
+}
+
+static rd_status_t event_put (const void * const p_event_data,
+                              const uint16_t event_size,
+                              const ruuvi_scheduler_event_handler_t handler,
+                              int cmock_num_calls)
+{
+    m_puts++;
+
+    if (RD_SUCCESS == m_put_result)
+    {
+        m_scheduled = handler;
+    }
+
+    return m_put_result;
+}
+
+static void scheduler_execute (void)
+{
+    ruuvi_scheduler_event_handler_t handler = m_scheduled;
+    m_scheduled = NULL;
+
+    if (NULL != handler)
+    {
+        handler (NULL, 0);
+    }
+}
+
+/** Expected output for zero input at given stream position with counter starting at 0. */
+static uint8_t expected (const uint8_t * const key, const size_t position)
+{
+    const uint8_t counter_lsb = (uint8_t) (position / 16U);
+    const size_t index = position % 16U;
+    return (uint8_t) ( ( (15U == index) ? counter_lsb : 0U) ^ key[index]);
+}
+
+void setUp (void)
+{
+    m_scheduled = NULL;
+    m_puts = 0;
+    m_put_result = RD_SUCCESS;
+    m_ecb_blocks = 0;
+    rd_error_check_Ignore();
+    ri_scheduler_event_put_StubWithCallback (&event_put);
+    TEST_ASSERT (RD_SUCCESS == rt_keystream_init());
+}
+
+void tearDown (void)
+{
+    rt_keystream_uninit();
+}
+
+void test_rt_keystream_init_twice (void)
+{
+    TEST_ASSERT (RD_ERROR_INVALID_STATE == rt_keystream_init());
+    TEST_ASSERT (rt_keystream_is_init());
+}
+
+void test_rt_keystream_open_schedules_refill (void)
+{
+    uint8_t stream;
+    rt_keystream_stats_t stats;
+    TEST_ASSERT (RD_SUCCESS == rt_keystream_open (m_key_a, m_counter, &stream));
+    TEST_ASSERT (NULL != m_scheduled);
+    scheduler_execute();
+    TEST_ASSERT_EQUAL (RI_AES_CTR_KEYSTREAM_BLOCKS, m_ecb_blocks);
+    TEST_ASSERT (RD_SUCCESS == rt_keystream_stats_get (stream, &stats));
+    TEST_ASSERT_EQUAL (1, stats.refills);
+}
+
+void test_rt_keystream_crypt_hit_no_aes (void)
+{
+    uint8_t stream;
+    uint8_t data[POOL_BYTES] = {0};
+    rt_keystream_stats_t stats;
+    TEST_ASSERT (RD_SUCCESS == rt_keystream_open (m_key_a, m_counter, &stream));
+    scheduler_execute();
+    m_ecb_blocks = 0;
+    TEST_ASSERT (RD_SUCCESS == rt_keystream_crypt (stream, data, data, sizeof (data)));
+    TEST_ASSERT_EQUAL (0, m_ecb_blocks);
+
+    for (size_t ii = 0; ii < sizeof (data); ii++)
+    {
+        TEST_ASSERT_EQUAL_HEX8 (expected (m_key_a, ii), data[ii]);
+    }
+
+    TEST_ASSERT (RD_SUCCESS == rt_keystream_stats_get (stream, &stats));
+    TEST_ASSERT_EQUAL (1, stats.hits);
+    TEST_ASSERT_EQUAL (0, stats.underruns);
+    TEST_ASSERT_EQUAL (sizeof (data), stats.bytes);
+}
+
+void test_rt_keystream_crypt_underrun_fallback (void)
+{
+    uint8_t stream;
+    uint8_t data[POOL_BYTES + 5U] = {0};
+    rt_keystream_stats_t stats;
+    TEST_ASSERT (RD_SUCCESS == rt_keystream_open (m_key_a, m_counter, &stream));
+    scheduler_execute();
+    TEST_ASSERT (RD_SUCCESS == rt_keystream_crypt (stream, data, data, sizeof (data)));
+
+    for (size_t ii = 0; ii < sizeof (data); ii++)
+    {
+        TEST_ASSERT_EQUAL_HEX8 (expected (m_key_a, ii), data[ii]);
+    }
+
+    TEST_ASSERT (RD_SUCCESS == rt_keystream_stats_get (stream, &stats));
+    TEST_ASSERT_EQUAL (0, stats.hits);
+    TEST_ASSERT_EQUAL (1, stats.underruns);
+}
+
+void test_rt_keystream_refill_continues_stream (void)
+{
+    uint8_t stream;
+    uint8_t data[3U * POOL_BYTES] = {0};
+    TEST_ASSERT (RD_SUCCESS == rt_keystream_open (m_key_a, m_counter, &stream));
+
+    for (size_t ii = 0; ii < sizeof (data); ii += 10U)
+    {
+        const size_t length = ( (sizeof (data) - ii) < 10U) ? (sizeof (data) - ii) : 10U;
+        scheduler_execute();
+        TEST_ASSERT (RD_SUCCESS == rt_keystream_crypt (stream, data + ii, data + ii, length));
+    }
+
+    for (size_t ii = 0; ii < sizeof (data); ii++)
+    {
+        TEST_ASSERT_EQUAL_HEX8 (expected (m_key_a, ii), data[ii]);
+    }
+}
+
+void test_rt_keystream_single_refill_pending (void)
+{
+    uint8_t stream;
+    uint8_t data[4] = {0};
+    TEST_ASSERT (RD_SUCCESS == rt_keystream_open (m_key_a, m_counter, &stream));
+    TEST_ASSERT (RD_SUCCESS == rt_keystream_crypt (stream, data, data, sizeof (data)));
+    TEST_ASSERT (RD_SUCCESS == rt_keystream_crypt (stream, data, data, sizeof (data)));
+    TEST_ASSERT_EQUAL (1, m_puts);
+    scheduler_execute();
+    TEST_ASSERT (RD_SUCCESS == rt_keystream_crypt (stream, data, data, sizeof (data)));
+    TEST_ASSERT_EQUAL (2, m_puts);
+}
+
+void test_rt_keystream_scheduler_full_retried (void)
+{
+    uint8_t stream;
+    uint8_t data[4] = {0};
+    m_put_result = RD_ERROR_NO_MEM;
+    TEST_ASSERT (RD_SUCCESS == rt_keystream_open (m_key_a, m_counter, &stream));
+    TEST_ASSERT (NULL == m_scheduled);
+    m_put_result = RD_SUCCESS;
+    TEST_ASSERT (RD_SUCCESS == rt_keystream_crypt (stream, data, data, sizeof (data)));
+    TEST_ASSERT (NULL != m_scheduled);
+    TEST_ASSERT_EQUAL (2, m_puts);
+}
+
+void test_rt_keystream_streams_independent (void)
+{
+    uint8_t stream_a;
+    uint8_t stream_b;
+    uint8_t data_a[20] = {0};
+    uint8_t data_b[20] = {0};
+    TEST_ASSERT (RD_SUCCESS == rt_keystream_open (m_key_a, m_counter, &stream_a));
+    TEST_ASSERT (RD_SUCCESS == rt_keystream_open (m_key_b, m_counter, &stream_b));
+    TEST_ASSERT (stream_a != stream_b);
+    scheduler_execute();
+    TEST_ASSERT (RD_SUCCESS == rt_keystream_crypt (stream_a, data_a, data_a, sizeof (data_a)));
+    TEST_ASSERT (RD_SUCCESS == rt_keystream_crypt (stream_b, data_b, data_b, sizeof (data_b)));
+
+    for (size_t ii = 0; ii < sizeof (data_a); ii++)
+    {
+        TEST_ASSERT_EQUAL_HEX8 (expected (m_key_a, ii), data_a[ii]);
+        TEST_ASSERT_EQUAL_HEX8 (expected (m_key_b, ii), data_b[ii]);
+    }
+}
+
+void test_rt_keystream_open_all_used (void)
+{
+    uint8_t stream;
+
+    for (size_t ii = 0; ii < RT_KEYSTREAM_STREAMS; ii++)
+    {
+        TEST_ASSERT (RD_SUCCESS == rt_keystream_open (m_key_a, m_counter, &stream));
+    }
+
+    TEST_ASSERT (RD_ERROR_NO_MEM == rt_keystream_open (m_key_a, m_counter, &stream));
+    TEST_ASSERT (RD_SUCCESS == rt_keystream_close (0));
+    TEST_ASSERT (RD_SUCCESS == rt_keystream_open (m_key_a, m_counter, &stream));
+    TEST_ASSERT_EQUAL (0, stream);
+}
+
+void test_rt_keystream_closed_stream (void)
+{
+    uint8_t stream;
+    uint8_t data[4] = {0};
+    rt_keystream_stats_t stats;
+    TEST_ASSERT (RD_SUCCESS == rt_keystream_open (m_key_a, m_counter, &stream));
+    TEST_ASSERT (RD_SUCCESS == rt_keystream_close (stream));
+    TEST_ASSERT (RD_ERROR_INVALID_PARAM == rt_keystream_close (stream));
+    TEST_ASSERT (RD_ERROR_INVALID_PARAM == rt_keystream_crypt (stream, data, data, sizeof (data)));
+    TEST_ASSERT (RD_ERROR_INVALID_PARAM == rt_keystream_stats_get (stream, &stats));
+    TEST_ASSERT (RD_ERROR_INVALID_PARAM == rt_keystream_close (RT_KEYSTREAM_STREAMS));
+}
+
+void test_rt_keystream_null (void)
+{
+    uint8_t stream;
+    uint8_t data[4] = {0};
+    TEST_ASSERT (RD_ERROR_NULL == rt_keystream_open (NULL, m_counter, &stream));
+    TEST_ASSERT (RD_ERROR_NULL == rt_keystream_open (m_key_a, NULL, &stream));
+    TEST_ASSERT (RD_ERROR_NULL == rt_keystream_open (m_key_a, m_counter, NULL));
+    TEST_ASSERT (RD_SUCCESS == rt_keystream_open (m_key_a, m_counter, &stream));
+    TEST_ASSERT (RD_ERROR_NULL == rt_keystream_crypt (stream, NULL, data, sizeof (data)));
+    TEST_ASSERT (RD_ERROR_NULL == rt_keystream_crypt (stream, data, NULL, sizeof (data)));
+    TEST_ASSERT (RD_ERROR_NULL == rt_keystream_stats_get (stream, NULL));
+}
+
+void test_rt_keystream_not_init (void)
+{
+    uint8_t stream;
+    rt_keystream_uninit();
+    TEST_ASSERT (RD_ERROR_INVALID_STATE == rt_keystream_open (m_key_a, m_counter, &stream));
+    TEST_ASSERT (RD_ERROR_INVALID_STATE == rt_keystream_refill());
+}
+
+void test_rt_keystream_uninit_with_refill_queued (void)
+{
+    uint8_t stream;
+    TEST_ASSERT (RD_SUCCESS == rt_keystream_open (m_key_a, m_counter, &stream));
+    rt_keystream_uninit();
+    scheduler_execute();
+    TEST_ASSERT_EQUAL (0, m_ecb_blocks);
+}
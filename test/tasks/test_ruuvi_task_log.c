@@ -0,0 +1,128 @@
+#include "unity.h"
+
+#include "ruuvi_driver_enabled_modules.h"
+#include "ruuvi_driver_error.h"
+#include "ruuvi_interface_communication.h"
+#include "ruuvi_interface_log_ring.h"
+#include "ruuvi_task_communication.h"
+#include "ruuvi_task_log.h"
+#include "mock_ruuvi_interface_communication_radio.h"
+#include "mock_ruuvi_interface_communication.h"
+#include "mock_ruuvi_interface_atomic.h"
+
+#include <string.h>
+
+static char m_sent[512];
+static size_t m_sent_len;
+static size_t m_sends;
+static size_t m_send_capacity;
+
+static bool atomic_flag_fake (ri_atomic_t * const flag, const bool set,
+                              int cmock_num_calls)
+{
+    bool success = false;
+
+    if (*flag != set)
+    {
+        *flag = set;
+        success = true;
+    }
+
+    return success;
+}
+
+static rd_status_t mock_send (ri_comm_message_t * const msg)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if (m_sends >= m_send_capacity)
+    {
+        err_code |= RD_ERROR_NO_MEM;
+    }
+    else
+    {
+        TEST_ASSERT (msg->data_length <= RI_COMM_MESSAGE_MAX_LENGTH);
+        TEST_ASSERT_EQUAL (1, msg->repeat_count);
+        memcpy (m_sent + m_sent_len, msg->data, msg->data_length);
+        m_sent_len += msg->data_length;
+        m_sends++;
+    }
+
+    return err_code;
+}
+
+void setUp (void)
+{
+    ri_atomic_flag_StubWithCallback (&atomic_flag_fake);
+    memset (m_sent, 0, sizeof (m_sent));
+    m_sent_len = 0;
+    m_sends = 0;
+    m_send_capacity = SIZE_MAX;
+    ri_log_ring_uninit();
+    ri_log_ring_init (RI_LOG_LEVEL_DEBUG);
+    ri_log_ring_clear();
+}
+
+void tearDown (void)
+{
+    ri_log_ring_uninit();
+}
+
+void test_rt_log_dump_ok (void)
+{
+    ri_log_ring_write (RI_LOG_LEVEL_ERROR, "Fatal\r\n");
+    ri_log_ring_write (RI_LOG_LEVEL_DEBUG, "Debug\r\n");
+    TEST_ASSERT (RD_SUCCESS == rt_log_dump (&mock_send));
+    TEST_ASSERT_EQUAL_STRING ("0 E: Fatal\r\n1 D: Debug\r\n", m_sent);
+    TEST_ASSERT_EQUAL (2, m_sends);
+}
+
+void test_rt_log_dump_empty (void)
+{
+    TEST_ASSERT (RD_SUCCESS == rt_log_dump (&mock_send));
+    TEST_ASSERT_EQUAL (0, m_sends);
+}
+
+void test_rt_log_dump_long_message_split (void)
+{
+    char msg[RI_LOG_RING_ENTRY_SIZE];
+    memset (msg, 'x', sizeof (msg) - 1);
+    msg[sizeof (msg) - 1] = '\0';
+    ri_log_ring_write (RI_LOG_LEVEL_INFO, msg);
+    TEST_ASSERT (RD_SUCCESS == rt_log_dump (&mock_send));
+    TEST_ASSERT_EQUAL (strlen ("0 I: ") + strlen (msg), m_sent_len);
+    TEST_ASSERT ( ( (m_sent_len + RI_COMM_MESSAGE_MAX_LENGTH - 1)
+                    / RI_COMM_MESSAGE_MAX_LENGTH) == m_sends);
+}
+
+void test_rt_log_dump_resume (void)
+{
+    char msg[RI_LOG_RING_ENTRY_SIZE];
+    char expected[128];
+    ri_log_ring_stats_t stats;
+    memset (msg, 'y', sizeof (msg) - 1);
+    msg[sizeof (msg) - 1] = '\0';
+    ri_log_ring_write (RI_LOG_LEVEL_WARNING, msg);
+    ri_log_ring_write (RI_LOG_LEVEL_WARNING, "next");
+    m_send_capacity = 1;
+    TEST_ASSERT (RD_ERROR_NO_MEM == rt_log_dump (&mock_send));
+    ri_log_ring_stats_get (&stats);
+    TEST_ASSERT_EQUAL (2, stats.unread);
+    m_send_capacity = SIZE_MAX;
+    TEST_ASSERT (RD_SUCCESS == rt_log_dump (&mock_send));
+    snprintf (expected, sizeof (expected), "0 W: %s1 W: next", msg);
+    TEST_ASSERT_EQUAL_STRING (expected, m_sent);
+    ri_log_ring_stats_get (&stats);
+    TEST_ASSERT_EQUAL (0, stats.unread);
+}
+
+void test_rt_log_dump_null (void)
+{
+    TEST_ASSERT (RD_ERROR_NULL == rt_log_dump (NULL));
+}
+
+void test_rt_log_dump_not_init (void)
+{
+    ri_log_ring_uninit();
+    TEST_ASSERT (RD_ERROR_INVALID_STATE == rt_log_dump (&mock_send));
+}
@@ -0,0 +1,169 @@
+#include "unity.h"
+
+#include "ruuvi_driver_enabled_modules.h"
+#include "ruuvi_driver_error.h"
+#include "ruuvi_interface_communication.h"
+#include "ruuvi_interface_profile.h"
+#include "ruuvi_task_communication.h"
+#include "ruuvi_task_profile.h"
+#include "mock_ruuvi_interface_communication_radio.h"
+#include "mock_ruuvi_interface_communication.h"
+#include "mock_ruuvi_interface_atomic.h"
+
+#include <string.h>
+
+static char m_sent[512];
+static size_t m_sent_len;
+static size_t m_send_capacity;
+static uint32_t m_ticks;
+
+RI_PROFILE_ZONE_DEF (m_zone_fast, "fast");
+RI_PROFILE_ZONE_DEF (m_zone_slow_with_a_long_name, "slow zone with a long name");
+
+static bool atomic_flag_fake (ri_atomic_t * const flag, const bool set,
+                              int cmock_num_calls)
+{
+    bool success = false;
+
+    if (*flag != set)
+    {
+        *flag = set;
+        success = true;
+    }
+
+    return success;
+}
+
+uint32_t ri_profile_ticks_get (void)
+{
+    return m_ticks;
+}
+
+uint32_t ri_profile_ticks_per_us (void)
+{
+    return 64;
+}
+
+static rd_status_t mock_send (ri_comm_message_t * const msg)
+{
+    rd_status_t err_code = RD_SUCCESS;
+
+    if (0U == m_send_capacity)
+    {
+        err_code |= RD_ERROR_NO_MEM;
+    }
+    else
+    {
+        TEST_ASSERT (msg->data_length <= RI_COMM_MESSAGE_MAX_LENGTH);
+        memcpy (m_sent + m_sent_len, msg->data, msg->data_length);
+        m_sent_len += msg->data_length;
+        m_send_capacity--;
+    }
+
+    return err_code;
+}
+
+static void run_zones (void)
+{
+    // Zones register in order of first use.
+    {
+        RI_PROFILE_ENTER (m_zone_fast);
+        m_ticks += 32;
+        RI_PROFILE_EXIT (m_zone_fast);
+    }
+    {
+        RI_PROFILE_ENTER (m_zone_fast);
+        m_ticks += 96;
+        RI_PROFILE_EXIT (m_zone_fast);
+    }
+    {
+        RI_PROFILE_ENTER (m_zone_slow_with_a_long_name);
+        m_ticks += 6400;
+        RI_PROFILE_EXIT (m_zone_slow_with_a_long_name);
+    }
+}
+
+static const char m_expected[] =
+    "zone: calls min/avg/max us\r\n"
+    "fast: 2 0.5/1.0/1.5\r\n"
+    "slow zone with a long name: 1 100.0/100.0/100.0\r\n";
+
+void setUp (void)
+{
+    ri_atomic_flag_StubWithCallback (&atomic_flag_fake);
+    memset (m_sent, 0, sizeof (m_sent));
+    m_sent_len = 0;
+    m_send_capacity = SIZE_MAX;
+    m_ticks = 0;
+    ri_profile_reset();
+    run_zones();
+}
+
+void tearDown (void)
+{
+}
+
+void test_rt_profile_report_ok (void)
+{
+    TEST_ASSERT (RD_SUCCESS == rt_profile_report (&mock_send));
+    TEST_ASSERT_EQUAL_STRING (m_expected, m_sent);
+}
+
+void test_rt_profile_report_twice (void)
+{
+    TEST_ASSERT (RD_SUCCESS == rt_profile_report (&mock_send));
+    memset (m_sent, 0, sizeof (m_sent));
+    m_sent_len = 0;
+    TEST_ASSERT (RD_SUCCESS == rt_profile_report (&mock_send));
+    TEST_ASSERT_EQUAL_STRING (m_expected, m_sent);
+}
+
+void test_rt_profile_report_resume (void)
+{
+    rd_status_t err_code = RD_SUCCESS;
+    size_t rounds = 0;
+
+    do
+    {
+        m_send_capacity = 1;
+        err_code = rt_profile_report (&mock_send);
+        rounds++;
+    } while ( (RD_ERROR_NO_MEM == err_code) && (rounds < 100U));
+
+    TEST_ASSERT (RD_SUCCESS == err_code);
+    TEST_ASSERT (rounds > 3U);
+    TEST_ASSERT_EQUAL_STRING (m_expected, m_sent);
+}
+
+void test_rt_profile_report_resume_keeps_pending_line (void)
+{
+    // Send header and first zone, and first part of second zone.
+    const size_t header_len = strlen ("zone: calls min/avg/max us\r\n");
+    const size_t fast_len = strlen ("fast: 2 0.5/1.0/1.5\r\n");
+    m_send_capacity = ( (header_len + RI_COMM_MESSAGE_MAX_LENGTH - 1U)
+                        / RI_COMM_MESSAGE_MAX_LENGTH)
+                      + ( (fast_len + RI_COMM_MESSAGE_MAX_LENGTH - 1U)
+                          / RI_COMM_MESSAGE_MAX_LENGTH)
+                      + 1U;
+    TEST_ASSERT (RD_ERROR_NO_MEM == rt_profile_report (&mock_send));
+    RI_PROFILE_ENTER (m_zone_slow_with_a_long_name);
+    m_ticks += 64000;
+    RI_PROFILE_EXIT (m_zone_slow_with_a_long_name);
+    m_send_capacity = SIZE_MAX;
+    TEST_ASSERT (RD_SUCCESS == rt_profile_report (&mock_send));
+    TEST_ASSERT_EQUAL_STRING (m_expected, m_sent);
+}
+
+void test_rt_profile_report_no_calls (void)
+{
+    ri_profile_reset();
+    TEST_ASSERT (RD_SUCCESS == rt_profile_report (&mock_send));
+    TEST_ASSERT_EQUAL_STRING ("zone: calls min/avg/max us\r\n"
+                              "fast: 0 -/-/-\r\n"
+                              "slow zone with a long name: 0 -/-/-\r\n", m_sent);
+}
+
+void test_rt_profile_report_null (void)
+{
+    TEST_ASSERT (RD_ERROR_NULL == rt_profile_report (NULL));
+}
@@ -3,12 +3,17 @@
 #include "ruuvi_task_sensor.h"
 #include "mock_ruuvi_driver_sensor.h"
 #include "mock_ruuvi_interface_log.h"
+#include "mock_ruuvi_task_energy.h"
 #include "mock_ruuvi_task_flash.h"
+#include "mock_ruuvi_task_sensor_dsp.h"
 
 void setUp (void)
 {
     ri_log_Ignore();
+    ri_log_module_Ignore();
+    ri_log_module_hex_Ignore();
     ri_log_sensor_configuration_Ignore();
+    rt_energy_sensor_mode_set_Ignore();
 }
 
 void tearDown (void)
@@ -21,6 +26,12 @@ rd_status_t mock_configuration_ok (const rd_sensor_t * const p_sensor,
     return RD_SUCCESS;
 }
 
+static rd_status_t mock_data_get (rd_sensor_data_t * const p_data)
+{
+    p_data->valid.bitfield |= RD_SENSOR_TEMP_FIELD.bitfield;
+    return RD_SUCCESS;
+}
+
 rd_status_t mock_configuration_error (const rd_sensor_t * const p_sensor,
                                       rd_sensor_configuration_t * const p_configuration)
 {
@@ -92,3 +103,47 @@ void test_rt_sensor_configure_sensor_not_innit (void)
     err_code = rt_sensor_configure (&ctx);
     TEST_ASSERT (RD_ERROR_INVALID_STATE == err_code);
 }
+
+void test_rt_sensor_data_get_dsp (void)
+{
+    rd_status_t err_code = RD_SUCCESS;
+    rt_sensor_dsp_t dsp = {0};
+    rd_sensor_data_t data = {0};
+    rt_sensor_ctx_t ctx =
+    {
+        .sensor = { .data_get = mock_data_get },
+        .p_dsp = &dsp
+    };
+    data.fields.bitfield = RD_SENSOR_TEMP_FIELD.bitfield | RD_SENSOR_HUMI_FIELD.bitfield;
+    data.valid = RD_SENSOR_HUMI_FIELD;
+    rd_sensor_is_init_ExpectAndReturn (& (ctx.sensor), true);
+    rt_sensor_dsp_process_ExpectAndReturn (&dsp, &data, RD_SENSOR_TEMP_FIELD, RD_SUCCESS);
+    err_code = rt_sensor_data_get (&ctx, &data);
+    TEST_ASSERT (RD_SUCCESS == err_code);
+}
+
+void test_rt_sensor_data_get_no_dsp (void)
+{
+    rd_status_t err_code = RD_SUCCESS;
+    rd_sensor_data_t data = {0};
+    rt_sensor_ctx_t ctx =
+    {
+        .sensor = { .data_get = mock_data_get }
+    };
+    rd_sensor_is_init_ExpectAndReturn (& (ctx.sensor), true);
+    err_code = rt_sensor_data_get (&ctx, &data);
+    TEST_ASSERT (RD_SUCCESS == err_code);
+}
+
+void test_rt_sensor_data_get_errors (void)
+{
+    rd_sensor_data_t data = {0};
+    rt_sensor_ctx_t ctx =
+    {
+        .sensor = { .data_get = mock_data_get }
+    };
+    TEST_ASSERT (RD_ERROR_NULL == rt_sensor_data_get (NULL, &data));
+    TEST_ASSERT (RD_ERROR_NULL == rt_sensor_data_get (&ctx, NULL));
+    rd_sensor_is_init_ExpectAndReturn (& (ctx.sensor), false);
+    TEST_ASSERT (RD_ERROR_INVALID_STATE == rt_sensor_data_get (&ctx, &data));
+}
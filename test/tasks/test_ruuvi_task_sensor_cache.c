@@ -0,0 +1,222 @@
+#include "unity.h"
+
+#include "ruuvi_driver_enabled_modules.h"
+#include "ruuvi_driver_error.h"
+#include "ruuvi_driver_sensor.h"
+#include "ruuvi_task_sensor_cache.h"
+
+#include <string.h>
+
+static rd_sensor_t m_sensor;
+static rt_sensor_cache_t m_cache;
+static uint64_t m_now_ms;
+static size_t m_reads;
+static float m_temperature;
+static rd_status_t m_read_result;
+
+static uint64_t test_timestamp (void)
+{
+    return m_now_ms;
+}
+
+/** Sensor which converts on every read, like ADC drivers with autorefresh. */
+static rd_status_t sensor_data_get (rd_sensor_data_t * const p_data)
+{
+    rd_sensor_data_t provided = {0};
+    float values[2];
+    provided.timestamp_ms = m_now_ms;
+    provided.fields.datas.temperature_c = 1;
+    provided.fields.datas.humidity_rh = 1;
+    provided.data = values;
+    rd_sensor_data_set (&provided, RD_SENSOR_TEMP_FIELD, m_temperature);
+    rd_sensor_data_set (&provided, RD_SENSOR_HUMI_FIELD, 50.0F);
+    m_reads++;
+
+    if (RD_SUCCESS == m_read_result)
+    {
+        rd_sensor_data_populate (p_data, &provided, p_data->fields);
+    }
+
+    return m_read_result;
+}
+
+static void data_init (rd_sensor_data_t * const p_data, float * const values,
+                       const rd_sensor_data_fields_t fields)
+{
+    memset (p_data, 0, sizeof (rd_sensor_data_t));
+    p_data->fields = fields;
+    p_data->data = values;
+
+    for (size_t ii = 0; ii < rd_sensor_data_fieldcount (p_data); ii++)
+    {
+        values[ii] = RD_FLOAT_INVALID;
+    }
+}
+
+void setUp (void)
+{
+    m_now_ms = 1000;
+    m_reads = 0;
+    m_temperature = 20.0F;
+    m_read_result = RD_SUCCESS;
+    rd_sensor_timestamp_function_set (&test_timestamp);
+    memset (&m_sensor, 0, sizeof (m_sensor));
+    m_sensor.data_get = &sensor_data_get;
+    m_sensor.provides.datas.temperature_c = 1;
+    m_sensor.provides.datas.humidity_rh = 1;
+    TEST_ASSERT (RD_SUCCESS == rt_sensor_cache_init (&m_cache, &m_sensor, 100));
+}
+
+void tearDown (void)
+{
+    rd_sensor_timestamp_function_set (NULL);
+}
+
+void test_rt_sensor_cache_first_read_miss (void)
+{
+    rd_sensor_data_t data;
+    float values[1];
+    data_init (&data, values, RD_SENSOR_TEMP_FIELD);
+    TEST_ASSERT (RD_SUCCESS == rt_sensor_cache_data_get (&m_cache, &data));
+    TEST_ASSERT_EQUAL (1, m_reads);
+    TEST_ASSERT_EQUAL (1, m_cache.misses);
+    TEST_ASSERT_EQUAL_FLOAT (20.0F, values[0]);
+    TEST_ASSERT_EQUAL (1000, data.timestamp_ms);
+    TEST_ASSERT (data.valid.datas.temperature_c);
+}
+
+void test_rt_sensor_cache_fresh_hit (void)
+{
+    rd_sensor_data_t data;
+    float values[1];
+    data_init (&data, values, RD_SENSOR_TEMP_FIELD);
+    TEST_ASSERT (RD_SUCCESS == rt_sensor_cache_data_get (&m_cache, &data));
+    m_temperature = 25.0F;
+    m_now_ms += 100;
+    data_init (&data, values, RD_SENSOR_TEMP_FIELD);
+    TEST_ASSERT (RD_SUCCESS == rt_sensor_cache_data_get (&m_cache, &data));
+    TEST_ASSERT_EQUAL (1, m_reads);
+    TEST_ASSERT_EQUAL (1, m_cache.hits);
+    TEST_ASSERT_EQUAL_FLOAT (20.0F, values[0]);
+    TEST_ASSERT_EQUAL (1000, data.timestamp_ms);
+}
+
+void test_rt_sensor_cache_stale_miss (void)
+{
+    rd_sensor_data_t data;
+    float values[1];
+    data_init (&data, values, RD_SENSOR_TEMP_FIELD);
+    TEST_ASSERT (RD_SUCCESS == rt_sensor_cache_data_get (&m_cache, &data));
+    m_temperature = 25.0F;
+    m_now_ms += 101;
+    data_init (&data, values, RD_SENSOR_TEMP_FIELD);
+    TEST_ASSERT (RD_SUCCESS == rt_sensor_cache_data_get (&m_cache, &data));
+    TEST_ASSERT_EQUAL (2, m_reads);
+    TEST_ASSERT_EQUAL (2, m_cache.misses);
+    TEST_ASSERT_EQUAL_FLOAT (25.0F, values[0]);
+}
+
+void test_rt_sensor_cache_shared_between_fields (void)
+{
+    rd_sensor_data_t temperature;
+    rd_sensor_data_t humidity;
+    float t_values[1];
+    float h_values[1];
+    data_init (&temperature, t_values, RD_SENSOR_TEMP_FIELD);
+    data_init (&humidity, h_values, RD_SENSOR_HUMI_FIELD);
+    TEST_ASSERT (RD_SUCCESS == rt_sensor_cache_data_get (&m_cache, &temperature));
+    TEST_ASSERT (RD_SUCCESS == rt_sensor_cache_data_get (&m_cache, &humidity));
+    TEST_ASSERT_EQUAL (1, m_reads);
+    TEST_ASSERT_EQUAL_FLOAT (20.0F, t_values[0]);
+    TEST_ASSERT_EQUAL_FLOAT (50.0F, h_values[0]);
+}
+
+void test_rt_sensor_cache_keeps_valid_fields (void)
+{
+    rd_sensor_data_t data;
+    float values[2];
+    const rd_sensor_data_fields_t fields =
+    {
+        .bitfield = RD_SENSOR_TEMP_FIELD.bitfield | RD_SENSOR_HUMI_FIELD.bitfield
+    };
+    data_init (&data, values, fields);
+    // Temperature from a more accurate sensor.
+    rd_sensor_data_set (&data, RD_SENSOR_TEMP_FIELD, 21.5F);
+    TEST_ASSERT (RD_SUCCESS == rt_sensor_cache_data_get (&m_cache, &data));
+    TEST_ASSERT_EQUAL_FLOAT (21.5F, rd_sensor_data_parse (&data, RD_SENSOR_TEMP_FIELD));
+    TEST_ASSERT_EQUAL_FLOAT (50.0F, rd_sensor_data_parse (&data, RD_SENSOR_HUMI_FIELD));
+}
+
+void test_rt_sensor_cache_zero_age_same_millisecond (void)
+{
+    rd_sensor_data_t data;
+    float values[1];
+    TEST_ASSERT (RD_SUCCESS == rt_sensor_cache_init (&m_cache, &m_sensor, 0));
+    data_init (&data, values, RD_SENSOR_TEMP_FIELD);
+    TEST_ASSERT (RD_SUCCESS == rt_sensor_cache_data_get (&m_cache, &data));
+    data_init (&data, values, RD_SENSOR_TEMP_FIELD);
+    TEST_ASSERT (RD_SUCCESS == rt_sensor_cache_data_get (&m_cache, &data));
+    TEST_ASSERT_EQUAL (1, m_reads);
+    m_now_ms++;
+    data_init (&data, values, RD_SENSOR_TEMP_FIELD);
+    TEST_ASSERT (RD_SUCCESS == rt_sensor_cache_data_get (&m_cache, &data));
+    TEST_ASSERT_EQUAL (2, m_reads);
+}
+
+void test_rt_sensor_cache_error_not_cached (void)
+{
+    rd_sensor_data_t data;
+    float values[1];
+    m_read_result = RD_ERROR_INVALID_STATE;
+    data_init (&data, values, RD_SENSOR_TEMP_FIELD);
+    TEST_ASSERT (RD_ERROR_INVALID_STATE == rt_sensor_cache_data_get (&m_cache, &data));
+    TEST_ASSERT (!data.valid.datas.temperature_c);
+    m_read_result = RD_SUCCESS;
+    TEST_ASSERT (RD_SUCCESS == rt_sensor_cache_data_get (&m_cache, &data));
+    TEST_ASSERT_EQUAL (2, m_reads);
+    TEST_ASSERT_EQUAL_FLOAT (20.0F, values[0]);
+}
+
+void test_rt_sensor_cache_invalidate (void)
+{
+    rd_sensor_data_t data;
+    float values[1];
+    data_init (&data, values, RD_SENSOR_TEMP_FIELD);
+    TEST_ASSERT (RD_SUCCESS == rt_sensor_cache_data_get (&m_cache, &data));
+    rt_sensor_cache_invalidate (&m_cache);
+    data_init (&data, values, RD_SENSOR_TEMP_FIELD);
+    TEST_ASSERT (RD_SUCCESS == rt_sensor_cache_data_get (&m_cache, &data));
+    TEST_ASSERT_EQUAL (2, m_reads);
+}
+
+void test_rt_sensor_cache_clock_reset_miss (void)
+{
+    rd_sensor_data_t data;
+    float values[1];
+    data_init (&data, values, RD_SENSOR_TEMP_FIELD);
+    TEST_ASSERT (RD_SUCCESS == rt_sensor_cache_data_get (&m_cache, &data));
+    m_now_ms = 10;
+    data_init (&data, values, RD_SENSOR_TEMP_FIELD);
+    TEST_ASSERT (RD_SUCCESS == rt_sensor_cache_data_get (&m_cache, &data));
+    TEST_ASSERT_EQUAL (2, m_reads);
+}
+
+void test_rt_sensor_cache_init_errors (void)
+{
+    rd_sensor_t wide = m_sensor;
+    wide.provides.bitfield = 0xFFFFFFFFU;
+    TEST_ASSERT (RD_ERROR_NULL == rt_sensor_cache_init (NULL, &m_sensor, 100));
+    TEST_ASSERT (RD_ERROR_NULL == rt_sensor_cache_init (&m_cache, NULL, 100));
+    TEST_ASSERT (RD_ERROR_NO_MEM == rt_sensor_cache_init (&m_cache, &wide, 100));
+}
+
+void test_rt_sensor_cache_data_get_errors (void)
+{
+    rd_sensor_data_t data;
+    float values[1];
+    rt_sensor_cache_t empty = {0};
+    data_init (&data, values, RD_SENSOR_TEMP_FIELD);
+    TEST_ASSERT (RD_ERROR_NULL == rt_sensor_cache_data_get (NULL, &data));
+    TEST_ASSERT (RD_ERROR_NULL == rt_sensor_cache_data_get (&m_cache, NULL));
+    TEST_ASSERT (RD_ERROR_INVALID_STATE == rt_sensor_cache_data_get (&empty, &data));
+}
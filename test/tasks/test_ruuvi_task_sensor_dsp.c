@@ -0,0 +1,228 @@
+#include "unity.h"
+
+#include "ruuvi_driver_enabled_modules.h"
+#include "ruuvi_driver_error.h"
+#include "ruuvi_driver_sensor.h"
+#include "ruuvi_task_sensor_dsp.h"
+
+#include <string.h>
+
+#define DSP_MAX_C (((1L << 22U) - 1L) * 0.01F) //!< Largest quantized temperature.
+
+static rt_sensor_dsp_t m_dsp;
+static rd_sensor_data_t m_data;
+static float m_values[2];
+
+static rt_sensor_dsp_config_t temperature_config (const uint8_t function)
+{
+    rt_sensor_dsp_config_t config =
+    {
+        .field = RD_SENSOR_TEMP_FIELD,
+        .dsp_function = function,
+        .iir_shift = 1U,
+        .os_samples = 4U,
+        .median_window = 3U,
+        .resolution = 0.01F
+    };
+    return config;
+}
+
+/** Filter one temperature sample, return output or NaN if output is not valid. */
+static float filter (const float temperature)
+{
+    memset (&m_data, 0, sizeof (m_data));
+    m_data.fields.bitfield = RD_SENSOR_TEMP_FIELD.bitfield | RD_SENSOR_HUMI_FIELD.bitfield;
+    m_data.data = m_values;
+    rd_sensor_data_set (&m_data, RD_SENSOR_TEMP_FIELD, temperature);
+    rd_sensor_data_set (&m_data, RD_SENSOR_HUMI_FIELD, 40.0F);
+    TEST_ASSERT (RD_SUCCESS == rt_sensor_dsp_process (&m_dsp, &m_data, m_data.fields));
+    return m_data.valid.datas.temperature_c ?
+           rd_sensor_data_parse (&m_data, RD_SENSOR_TEMP_FIELD) : RD_FLOAT_INVALID;
+}
+
+static void dsp_init (const uint8_t function)
+{
+    const rt_sensor_dsp_config_t config = temperature_config (function);
+    TEST_ASSERT (RD_SUCCESS == rt_sensor_dsp_init (&m_dsp, &config, 1U));
+}
+
+void setUp (void)
+{
+    memset (&m_dsp, 0, sizeof (m_dsp));
+}
+
+void tearDown (void)
+{
+}
+
+void test_rt_sensor_dsp_passthrough_quantizes (void)
+{
+    dsp_init (RD_SENSOR_DSP_LAST);
+    TEST_ASSERT_FLOAT_WITHIN (0.0001F, 21.23F, filter (21.234F));
+    TEST_ASSERT_FLOAT_WITHIN (0.0001F, -5.24F, filter (-5.236F));
+    TEST_ASSERT_EQUAL_FLOAT (40.0F, rd_sensor_data_parse (&m_data, RD_SENSOR_HUMI_FIELD));
+}
+
+void test_rt_sensor_dsp_low_pass_step (void)
+{
+    dsp_init (RD_SENSOR_DSP_LOW_PASS);
+    TEST_ASSERT_FLOAT_WITHIN (0.001F, 20.0F, filter (20.0F));
+    TEST_ASSERT_FLOAT_WITHIN (0.001F, 21.0F, filter (22.0F));
+    TEST_ASSERT_FLOAT_WITHIN (0.001F, 21.5F, filter (22.0F));
+    TEST_ASSERT_FLOAT_WITHIN (0.001F, 21.75F, filter (22.0F));
+}
+
+void test_rt_sensor_dsp_low_pass_negative (void)
+{
+    dsp_init (RD_SENSOR_DSP_LOW_PASS);
+    TEST_ASSERT_FLOAT_WITHIN (0.001F, 0.0F, filter (0.0F));
+    TEST_ASSERT_FLOAT_WITHIN (0.001F, -10.0F, filter (-20.0F));
+    TEST_ASSERT_FLOAT_WITHIN (0.001F, -15.0F, filter (-20.0F));
+}
+
+void test_rt_sensor_dsp_high_pass_removes_offset (void)
+{
+    dsp_init (RD_SENSOR_DSP_HIGH_PASS);
+    TEST_ASSERT_FLOAT_WITHIN (0.001F, 0.0F, filter (20.0F));
+    TEST_ASSERT_FLOAT_WITHIN (0.001F, 1.0F, filter (22.0F));
+    TEST_ASSERT_FLOAT_WITHIN (0.001F, 0.5F, filter (22.0F));
+    TEST_ASSERT_FLOAT_WITHIN (0.001F, 0.25F, filter (22.0F));
+}
+
+void test_rt_sensor_dsp_oversampling_decimates (void)
+{
+    dsp_init (RD_SENSOR_DSP_OS);
+    TEST_ASSERT_FLOAT_IS_NAN (filter (20.0F));
+    TEST_ASSERT (m_data.valid.datas.humidity_rh);
+    TEST_ASSERT_FLOAT_IS_NAN (filter (21.0F));
+    TEST_ASSERT_FLOAT_IS_NAN (filter (22.0F));
+    TEST_ASSERT_FLOAT_WITHIN (0.001F, 21.5F, filter (23.0F));
+    TEST_ASSERT_FLOAT_IS_NAN (filter (10.0F));
+}
+
+void test_rt_sensor_dsp_median_removes_spike (void)
+{
+    dsp_init (RT_SENSOR_DSP_MEDIAN);
+    TEST_ASSERT_FLOAT_WITHIN (0.001F, 20.0F, filter (20.0F));
+    TEST_ASSERT_FLOAT_WITHIN (0.001F, 20.0F, filter (20.1F));
+    TEST_ASSERT_FLOAT_WITHIN (0.001F, 20.1F, filter (85.0F));
+    TEST_ASSERT_FLOAT_WITHIN (0.001F, 20.2F, filter (20.2F));
+    TEST_ASSERT_FLOAT_WITHIN (0.001F, 20.3F, filter (20.3F));
+    TEST_ASSERT_FLOAT_WITHIN (0.001F, 20.2F, filter (-40.0F));
+}
+
+void test_rt_sensor_dsp_median_duplicates (void)
+{
+    dsp_init (RT_SENSOR_DSP_MEDIAN);
+
+    for (size_t ii = 0; ii < 10U; ii++)
+    {
+        TEST_ASSERT_FLOAT_WITHIN (0.001F, 5.0F, filter (5.0F));
+    }
+
+    TEST_ASSERT_FLOAT_WITHIN (0.001F, 5.0F, filter (6.0F));
+    TEST_ASSERT_FLOAT_WITHIN (0.001F, 6.0F, filter (6.0F));
+}
+
+void test_rt_sensor_dsp_chain (void)
+{
+    dsp_init (RT_SENSOR_DSP_MEDIAN | RD_SENSOR_DSP_OS | RD_SENSOR_DSP_LOW_PASS);
+    const float trace[] = { 20.0F, 20.0F, 99.0F, 20.0F, 22.0F, 22.0F, 22.0F, 22.0F };
+    float output = RD_FLOAT_INVALID;
+
+    for (size_t ii = 0; ii < 4U; ii++)
+    {
+        output = filter (trace[ii]);
+    }
+
+    // Spike removed by median before averaging.
+    TEST_ASSERT_FLOAT_WITHIN (0.001F, 20.0F, output);
+
+    for (size_t ii = 4U; ii < 8U; ii++)
+    {
+        output = filter (trace[ii]);
+    }
+
+    // Step to 22 is averaged and low pass halves it.
+    TEST_ASSERT_FLOAT_WITHIN (0.001F, 21.0F, output);
+}
+
+void test_rt_sensor_dsp_fields_filter (void)
+{
+    dsp_init (RD_SENSOR_DSP_OS);
+    memset (&m_data, 0, sizeof (m_data));
+    m_data.fields = RD_SENSOR_TEMP_FIELD;
+    m_data.data = m_values;
+    rd_sensor_data_set (&m_data, RD_SENSOR_TEMP_FIELD, 20.0F);
+    TEST_ASSERT (RD_SUCCESS == rt_sensor_dsp_process (&m_dsp, &m_data, RD_SENSOR_HUMI_FIELD));
+    TEST_ASSERT (m_data.valid.datas.temperature_c);
+    TEST_ASSERT_EQUAL_FLOAT (20.0F, m_values[0]);
+}
+
+void test_rt_sensor_dsp_reset (void)
+{
+    dsp_init (RD_SENSOR_DSP_LOW_PASS);
+    (void) filter (20.0F);
+    rt_sensor_dsp_reset (&m_dsp);
+    TEST_ASSERT_FLOAT_WITHIN (0.001F, 30.0F, filter (30.0F));
+}
+
+void test_rt_sensor_dsp_saturates (void)
+{
+    dsp_init (RD_SENSOR_DSP_HIGH_PASS);
+    (void) filter (-1.0e9F);
+    TEST_ASSERT (filter (1.0e9F) > 0.0F);
+}
+
+void test_rt_sensor_dsp_full_scale_step (void)
+{
+    dsp_init (RD_SENSOR_DSP_LOW_PASS);
+    TEST_ASSERT_FLOAT_WITHIN (0.01F, -DSP_MAX_C, filter (-DSP_MAX_C));
+    TEST_ASSERT_FLOAT_WITHIN (0.01F, 0.0F, filter (DSP_MAX_C));
+    TEST_ASSERT_FLOAT_WITHIN (0.01F, DSP_MAX_C / 2.0F, filter (DSP_MAX_C));
+    memset (&m_dsp, 0, sizeof (m_dsp));
+    dsp_init (RD_SENSOR_DSP_HIGH_PASS);
+    TEST_ASSERT_FLOAT_WITHIN (0.01F, 0.0F, filter (-DSP_MAX_C));
+    TEST_ASSERT_FLOAT_WITHIN (0.01F, DSP_MAX_C, filter (DSP_MAX_C));
+    TEST_ASSERT_FLOAT_WITHIN (0.01F, DSP_MAX_C / 2.0F, filter (DSP_MAX_C));
+    TEST_ASSERT_FLOAT_WITHIN (0.01F, -0.75F * DSP_MAX_C, filter (-DSP_MAX_C));
+}
+
+void test_rt_sensor_dsp_init_errors (void)
+{
+    rt_sensor_dsp_config_t config = temperature_config (RD_SENSOR_DSP_LOW_PASS);
+    rt_sensor_dsp_config_t configs[RT_SENSOR_DSP_FIELDS + 1U] = {0};
+    TEST_ASSERT (RD_ERROR_NULL == rt_sensor_dsp_init (NULL, &config, 1U));
+    TEST_ASSERT (RD_ERROR_NULL == rt_sensor_dsp_init (&m_dsp, NULL, 1U));
+    TEST_ASSERT (RD_ERROR_NO_MEM == rt_sensor_dsp_init (&m_dsp, configs,
+                 RT_SENSOR_DSP_FIELDS + 1U));
+    config.dsp_function = RD_SENSOR_DSP_LOW_PASS | RD_SENSOR_DSP_HIGH_PASS;
+    TEST_ASSERT (RD_ERROR_INVALID_PARAM == rt_sensor_dsp_init (&m_dsp, &config, 1U));
+    config.dsp_function = (1U << 7U);
+    TEST_ASSERT (RD_ERROR_NOT_SUPPORTED == rt_sensor_dsp_init (&m_dsp, &config, 1U));
+    config = temperature_config (RD_SENSOR_DSP_LOW_PASS);
+    config.iir_shift = RT_SENSOR_DSP_IIR_SHIFT_MAX + 1U;
+    TEST_ASSERT (RD_ERROR_INVALID_PARAM == rt_sensor_dsp_init (&m_dsp, &config, 1U));
+    config = temperature_config (RD_SENSOR_DSP_OS);
+    config.os_samples = 1U;
+    TEST_ASSERT (RD_ERROR_INVALID_PARAM == rt_sensor_dsp_init (&m_dsp, &config, 1U));
+    config = temperature_config (RT_SENSOR_DSP_MEDIAN);
+    config.median_window = 4U;
+    TEST_ASSERT (RD_ERROR_INVALID_PARAM == rt_sensor_dsp_init (&m_dsp, &config, 1U));
+    config.median_window = RT_SENSOR_DSP_MEDIAN_MAX + 2U;
+    TEST_ASSERT (RD_ERROR_INVALID_PARAM == rt_sensor_dsp_init (&m_dsp, &config, 1U));
+    config = temperature_config (RD_SENSOR_DSP_LAST);
+    config.resolution = 0.0F;
+    TEST_ASSERT (RD_ERROR_INVALID_PARAM == rt_sensor_dsp_init (&m_dsp, &config, 1U));
+    config = temperature_config (RD_SENSOR_DSP_LAST);
+    config.field.bitfield = RD_SENSOR_TEMP_FIELD.bitfield | RD_SENSOR_HUMI_FIELD.bitfield;
+    TEST_ASSERT (RD_ERROR_INVALID_PARAM == rt_sensor_dsp_init (&m_dsp, &config, 1U));
+}
+
+void test_rt_sensor_dsp_process_null (void)
+{
+    dsp_init (RD_SENSOR_DSP_LAST);
+    TEST_ASSERT (RD_ERROR_NULL == rt_sensor_dsp_process (NULL, &m_data, RD_SENSOR_TEMP_FIELD));
+    TEST_ASSERT (RD_ERROR_NULL == rt_sensor_dsp_process (&m_dsp, NULL, RD_SENSOR_TEMP_FIELD));
+    rt_sensor_dsp_reset (NULL);
+}
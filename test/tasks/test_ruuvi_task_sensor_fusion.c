@@ -0,0 +1,285 @@
+#include "unity.h"
+
+#include "ruuvi_driver_enabled_modules.h"
+#include "ruuvi_driver_error.h"
+#include "ruuvi_driver_sensor.h"
+#include "ruuvi_task_sensor_fusion.h"
+
+#include <string.h>
+
+static rd_sensor_t m_fused;
+static rd_sensor_t m_precise;
+static rd_sensor_t m_combo;
+static rd_sensor_t * m_backends[2];
+static rd_status_t m_precise_result;
+static size_t m_precise_reads;
+static size_t m_combo_reads;
+static uint8_t m_precise_rate;
+static uint8_t m_combo_rate;
+static uint8_t m_precise_mode;
+static uint8_t m_combo_mode;
+
+static rd_status_t backend_uninit (rd_sensor_t * const p_sensor, const rd_bus_t bus,
+                                   const uint8_t handle)
+{
+    return RD_SUCCESS;
+}
+
+/** Temperature-only sensor with better accuracy. */
+static rd_status_t precise_data_get (rd_sensor_data_t * const p_data)
+{
+    rd_sensor_data_t provided = {0};
+    float values[1];
+    provided.timestamp_ms = 1000;
+    provided.fields = RD_SENSOR_TEMP_FIELD;
+    provided.data = values;
+    rd_sensor_data_set (&provided, RD_SENSOR_TEMP_FIELD, 21.5F);
+    m_precise_reads++;
+
+    if (RD_SUCCESS == m_precise_result)
+    {
+        rd_sensor_data_populate (p_data, &provided, p_data->fields);
+    }
+
+    return m_precise_result;
+}
+
+/** Temperature and humidity sensor. */
+static rd_status_t combo_data_get (rd_sensor_data_t * const p_data)
+{
+    rd_sensor_data_t provided = {0};
+    float values[2];
+    provided.timestamp_ms = 1005;
+    provided.fields.bitfield = RD_SENSOR_TEMP_FIELD.bitfield | RD_SENSOR_HUMI_FIELD.bitfield;
+    provided.data = values;
+    rd_sensor_data_set (&provided, RD_SENSOR_TEMP_FIELD, 20.0F);
+    rd_sensor_data_set (&provided, RD_SENSOR_HUMI_FIELD, 45.0F);
+    m_combo_reads++;
+    rd_sensor_data_populate (p_data, &provided, p_data->fields);
+    return RD_SUCCESS;
+}
+
+/** Precise sensor supports only 1 Hz. */
+static rd_status_t precise_samplerate_set (uint8_t * samplerate)
+{
+    m_precise_rate = 1;
+    *samplerate = m_precise_rate;
+    return RD_SUCCESS;
+}
+
+static rd_status_t precise_samplerate_get (uint8_t * samplerate)
+{
+    *samplerate = m_precise_rate;
+    return RD_SUCCESS;
+}
+
+static rd_status_t combo_samplerate_set (uint8_t * samplerate)
+{
+    m_combo_rate = *samplerate;
+    return RD_SUCCESS;
+}
+
+static rd_status_t combo_samplerate_get (uint8_t * samplerate)
+{
+    *samplerate = m_combo_rate;
+    return RD_SUCCESS;
+}
+
+static rd_status_t precise_mode_set (uint8_t * mode)
+{
+    m_precise_mode = *mode;
+    return RD_SUCCESS;
+}
+
+static rd_status_t combo_mode_set (uint8_t * mode)
+{
+    m_combo_mode = *mode;
+    return (RD_SENSOR_CFG_SINGLE == *mode) ? RD_ERROR_NOT_SUPPORTED : RD_SUCCESS;
+}
+
+static void data_init (rd_sensor_data_t * const p_data, float * const values,
+                       const rd_sensor_data_fields_t fields)
+{
+    memset (p_data, 0, sizeof (rd_sensor_data_t));
+    p_data->fields = fields;
+    p_data->data = values;
+
+    for (size_t ii = 0; ii < rd_sensor_data_fieldcount (p_data); ii++)
+    {
+        values[ii] = RD_FLOAT_INVALID;
+    }
+}
+
+void setUp (void)
+{
+    m_precise_result = RD_SUCCESS;
+    m_precise_reads = 0;
+    m_combo_reads = 0;
+    m_precise_rate = 0;
+    m_combo_rate = 0;
+    m_precise_mode = 0;
+    m_combo_mode = 0;
+    rd_sensor_initialize (&m_precise);
+    rd_sensor_initialize (&m_combo);
+    m_precise.uninit = &backend_uninit;
+    m_precise.provides = RD_SENSOR_TEMP_FIELD;
+    m_precise.data_get = &precise_data_get;
+    m_precise.samplerate_set = &precise_samplerate_set;
+    m_precise.samplerate_get = &precise_samplerate_get;
+    m_precise.mode_set = &precise_mode_set;
+    m_combo.uninit = &backend_uninit;
+    m_combo.provides.bitfield = RD_SENSOR_TEMP_FIELD.bitfield | RD_SENSOR_HUMI_FIELD.bitfield;
+    m_combo.data_get = &combo_data_get;
+    m_combo.samplerate_set = &combo_samplerate_set;
+    m_combo.samplerate_get = &combo_samplerate_get;
+    m_combo.mode_set = &combo_mode_set;
+    m_backends[0] = &m_precise;
+    m_backends[1] = &m_combo;
+    TEST_ASSERT (RD_SUCCESS == rt_sensor_fusion_backends_set (m_backends, 2));
+    TEST_ASSERT (RD_SUCCESS == rt_sensor_fusion_init (&m_fused, RD_BUS_NONE, 0));
+}
+
+void tearDown (void)
+{
+    rt_sensor_fusion_uninit (&m_fused, RD_BUS_NONE, 0);
+}
+
+void test_rt_sensor_fusion_init_provides_union (void)
+{
+    TEST_ASSERT (rd_sensor_is_init (&m_fused));
+    TEST_ASSERT (m_fused.provides.datas.temperature_c);
+    TEST_ASSERT (m_fused.provides.datas.humidity_rh);
+    TEST_ASSERT (!m_fused.provides.datas.pressure_pa);
+}
+
+void test_rt_sensor_fusion_data_get_priority (void)
+{
+    rd_sensor_data_t data;
+    float values[2];
+    const rd_sensor_data_fields_t fields =
+    {
+        .bitfield = RD_SENSOR_TEMP_FIELD.bitfield | RD_SENSOR_HUMI_FIELD.bitfield
+    };
+    data_init (&data, values, fields);
+    TEST_ASSERT (RD_SUCCESS == m_fused.data_get (&data));
+    TEST_ASSERT_EQUAL_FLOAT (21.5F, rd_sensor_data_parse (&data, RD_SENSOR_TEMP_FIELD));
+    TEST_ASSERT_EQUAL_FLOAT (45.0F, rd_sensor_data_parse (&data, RD_SENSOR_HUMI_FIELD));
+    TEST_ASSERT_EQUAL (fields.bitfield, data.valid.bitfield);
+    // Timestamp of first backend which filled fields.
+    TEST_ASSERT_EQUAL (1000, data.timestamp_ms);
+}
+
+void test_rt_sensor_fusion_data_get_skips_unneeded (void)
+{
+    rd_sensor_data_t data;
+    float values[1];
+    data_init (&data, values, RD_SENSOR_TEMP_FIELD);
+    TEST_ASSERT (RD_SUCCESS == m_fused.data_get (&data));
+    TEST_ASSERT_EQUAL (1, m_precise_reads);
+    TEST_ASSERT_EQUAL (0, m_combo_reads);
+    TEST_ASSERT_EQUAL_FLOAT (21.5F, values[0]);
+}
+
+void test_rt_sensor_fusion_data_get_fallback (void)
+{
+    rd_sensor_data_t data;
+    float values[1];
+    m_precise_result = RD_ERROR_INVALID_STATE;
+    data_init (&data, values, RD_SENSOR_TEMP_FIELD);
+    TEST_ASSERT (RD_ERROR_INVALID_STATE == m_fused.data_get (&data));
+    TEST_ASSERT_EQUAL (1, m_combo_reads);
+    TEST_ASSERT_EQUAL_FLOAT (20.0F, values[0]);
+    TEST_ASSERT (data.valid.datas.temperature_c);
+    TEST_ASSERT_EQUAL (1005, data.timestamp_ms);
+}
+
+void test_rt_sensor_fusion_data_get_keeps_valid (void)
+{
+    rd_sensor_data_t data;
+    float values[1];
+    data_init (&data, values, RD_SENSOR_TEMP_FIELD);
+    rd_sensor_data_set (&data, RD_SENSOR_TEMP_FIELD, 30.0F);
+    TEST_ASSERT (RD_SUCCESS == m_fused.data_get (&data));
+    TEST_ASSERT_EQUAL (0, m_precise_reads);
+    TEST_ASSERT_EQUAL_FLOAT (30.0F, values[0]);
+}
+
+void test_rt_sensor_fusion_data_get_null (void)
+{
+    TEST_ASSERT (RD_ERROR_NULL == m_fused.data_get (NULL));
+}
+
+void test_rt_sensor_fusion_samplerate_first_backend (void)
+{
+    uint8_t rate = 10;
+    TEST_ASSERT (RD_SUCCESS == m_fused.samplerate_set (&rate));
+    TEST_ASSERT_EQUAL (10, m_combo_rate);
+    TEST_ASSERT_EQUAL (1, m_precise_rate);
+    TEST_ASSERT_EQUAL (1, rate);
+    rate = 0;
+    TEST_ASSERT (RD_SUCCESS == m_fused.samplerate_get (&rate));
+    TEST_ASSERT_EQUAL (1, rate);
+}
+
+void test_rt_sensor_fusion_mode_all_backends (void)
+{
+    uint8_t mode = RD_SENSOR_CFG_CONTINUOUS;
+    TEST_ASSERT (RD_SUCCESS == m_fused.mode_set (&mode));
+    TEST_ASSERT_EQUAL (RD_SENSOR_CFG_CONTINUOUS, m_precise_mode);
+    TEST_ASSERT_EQUAL (RD_SENSOR_CFG_CONTINUOUS, m_combo_mode);
+}
+
+void test_rt_sensor_fusion_mode_error_combined (void)
+{
+    uint8_t mode = RD_SENSOR_CFG_SINGLE;
+    TEST_ASSERT (RD_ERROR_NOT_SUPPORTED == m_fused.mode_set (&mode));
+    TEST_ASSERT_EQUAL (RD_SENSOR_CFG_SINGLE, m_precise_mode);
+}
+
+void test_rt_sensor_fusion_setup_null (void)
+{
+    TEST_ASSERT (RD_ERROR_NULL == m_fused.samplerate_set (NULL));
+    TEST_ASSERT (RD_ERROR_NULL == m_fused.samplerate_get (NULL));
+    TEST_ASSERT (RD_ERROR_NULL == m_fused.dsp_set (NULL, NULL));
+}
+
+void test_rt_sensor_fusion_unsupported_setup (void)
+{
+    uint8_t scale = 2;
+    TEST_ASSERT (RD_ERROR_NOT_INITIALIZED == m_fused.scale_set (&scale));
+}
+
+void test_rt_sensor_fusion_double_init (void)
+{
+    rd_sensor_t other;
+    TEST_ASSERT (RD_ERROR_INVALID_STATE == rt_sensor_fusion_init (&other, RD_BUS_NONE, 0));
+    TEST_ASSERT (RD_ERROR_INVALID_STATE == rt_sensor_fusion_backends_set (m_backends, 2));
+}
+
+void test_rt_sensor_fusion_uninit (void)
+{
+    TEST_ASSERT (RD_SUCCESS == rt_sensor_fusion_uninit (&m_fused, RD_BUS_NONE, 0));
+    TEST_ASSERT (!rd_sensor_is_init (&m_fused));
+    TEST_ASSERT (rd_sensor_is_init (&m_precise));
+    TEST_ASSERT (RD_ERROR_NULL == rt_sensor_fusion_uninit (NULL, RD_BUS_NONE, 0));
+}
+
+void test_rt_sensor_fusion_backends_set_errors (void)
+{
+    rd_sensor_t wide = m_combo;
+    rd_sensor_t uninit;
+    rd_sensor_t * backends[RT_SENSOR_FUSION_BACKENDS + 1U] = {0};
+    TEST_ASSERT (RD_SUCCESS == rt_sensor_fusion_uninit (&m_fused, RD_BUS_NONE, 0));
+    rd_sensor_initialize (&uninit);
+    wide.provides.bitfield = 0xFFFFFFFFU;
+    TEST_ASSERT (RD_ERROR_NULL == rt_sensor_fusion_backends_set (NULL, 1));
+    TEST_ASSERT (RD_ERROR_INVALID_PARAM == rt_sensor_fusion_backends_set (backends, 0));
+    TEST_ASSERT (RD_ERROR_INVALID_PARAM == rt_sensor_fusion_backends_set (backends,
+                 RT_SENSOR_FUSION_BACKENDS + 1U));
+    TEST_ASSERT (RD_ERROR_NULL == rt_sensor_fusion_backends_set (backends, 1));
+    backends[0] = &uninit;
+    TEST_ASSERT (RD_ERROR_INVALID_STATE == rt_sensor_fusion_backends_set (backends, 1));
+    backends[0] = &wide;
+    TEST_ASSERT (RD_ERROR_NO_MEM == rt_sensor_fusion_backends_set (backends, 1));
+    TEST_ASSERT (RD_ERROR_NULL == rt_sensor_fusion_init (NULL, RD_BUS_NONE, 0));
+}
@@ -0,0 +1,353 @@
+#include "unity.h"
+
+#include "ruuvi_driver_enabled_modules.h"
+#include "ruuvi_driver_error.h"
+#include "ruuvi_driver_sensor.h"
+#include "ruuvi_task_sensor_rate.h"
+
+#include <string.h>
+
+/** One recorded sample of temperature and expected interval after it. */
+typedef struct
+{
+    uint64_t timestamp_ms;
+    float temperature;
+    uint32_t interval_ms;
+} env_trace_t;
+
+/** One recorded sample of acceleration and expected interval after it. */
+typedef struct
+{
+    uint64_t timestamp_ms;
+    float x;
+    float y;
+    float z;
+    uint32_t interval_ms;
+} acc_trace_t;
+
+static rd_sensor_t m_sensor;
+static rt_sensor_rate_t m_rate;
+static uint8_t m_mode;
+static uint8_t m_samplerate;
+static size_t m_mode_calls;
+static size_t m_single_calls;
+static size_t m_samplerate_calls;
+static rd_status_t m_samplerate_result;
+static uint64_t m_now_ms;
+static float m_temperature;
+
+static rd_status_t sensor_mode_set (uint8_t * mode)
+{
+    m_mode = *mode;
+    m_mode_calls++;
+    m_single_calls += (RD_SENSOR_CFG_SINGLE == *mode) ? 1U : 0U;
+    return RD_SUCCESS;
+}
+
+static rd_status_t sensor_samplerate_set (uint8_t * samplerate)
+{
+    rd_status_t err_code = m_samplerate_result;
+
+    if (RD_SENSOR_CFG_SLEEP != m_mode)
+    {
+        err_code |= RD_ERROR_INVALID_STATE;
+    }
+
+    m_samplerate = *samplerate;
+    m_samplerate_calls++;
+    return err_code;
+}
+
+static rd_status_t sensor_data_get (rd_sensor_data_t * const p_data)
+{
+    rd_sensor_data_t provided = {0};
+    float values[1];
+    provided.timestamp_ms = m_now_ms;
+    provided.fields = RD_SENSOR_TEMP_FIELD;
+    provided.data = values;
+    rd_sensor_data_set (&provided, RD_SENSOR_TEMP_FIELD, m_temperature);
+    rd_sensor_data_populate (p_data, &provided, p_data->fields);
+    return RD_SUCCESS;
+}
+
+static rt_sensor_rate_config_t env_config (void)
+{
+    rt_sensor_rate_config_t config =
+    {
+        .min_interval_ms = 1000U,
+        .max_interval_ms = 8000U,
+        .settle_samples = 2U,
+        .hysteresis = 0.5F,
+        .fields = RD_SENSOR_TEMP_FIELD,
+        .thresholds = { 0.01F }
+    };
+    return config;
+}
+
+static rt_sensor_rate_config_t acc_config (void)
+{
+    rt_sensor_rate_config_t config =
+    {
+        .min_interval_ms = 10U,
+        .max_interval_ms = 100U,
+        .settle_samples = 4U,
+        .hysteresis = 0.25F,
+        .fields = {
+            .bitfield = RD_SENSOR_ACC_X_FIELD.bitfield | RD_SENSOR_ACC_Y_FIELD.bitfield
+            | RD_SENSOR_ACC_Z_FIELD.bitfield
+        },
+        .thresholds = { 2.0F, 2.0F, 2.0F }
+    };
+    return config;
+}
+
+static void env_feed (const uint64_t timestamp_ms, const float temperature,
+                      const rd_sensor_data_fields_t valid)
+{
+    rd_sensor_data_t data = {0};
+    float values[1] = {RD_FLOAT_INVALID};
+    data.fields = RD_SENSOR_TEMP_FIELD;
+    data.data = values;
+    rd_sensor_data_set (&data, RD_SENSOR_TEMP_FIELD, temperature);
+    data.valid = valid;
+    data.timestamp_ms = timestamp_ms;
+    TEST_ASSERT (RD_SUCCESS == rt_sensor_rate_update (&m_rate, &data));
+}
+
+static void env_trace_run (const env_trace_t * const trace, const size_t length)
+{
+    for (size_t ii = 0; ii < length; ii++)
+    {
+        env_feed (trace[ii].timestamp_ms, trace[ii].temperature, RD_SENSOR_TEMP_FIELD);
+        TEST_ASSERT_EQUAL_UINT32 (trace[ii].interval_ms, rt_sensor_rate_interval_get (&m_rate));
+    }
+}
+
+static void acc_trace_run (const acc_trace_t * const trace, const size_t length)
+{
+    for (size_t ii = 0; ii < length; ii++)
+    {
+        rd_sensor_data_t data = {0};
+        float values[3];
+        data.fields = acc_config().fields;
+        data.data = values;
+        data.timestamp_ms = trace[ii].timestamp_ms;
+        rd_sensor_data_set (&data, RD_SENSOR_ACC_X_FIELD, trace[ii].x);
+        rd_sensor_data_set (&data, RD_SENSOR_ACC_Y_FIELD, trace[ii].y);
+        rd_sensor_data_set (&data, RD_SENSOR_ACC_Z_FIELD, trace[ii].z);
+        TEST_ASSERT (RD_SUCCESS == rt_sensor_rate_update (&m_rate, &data));
+        TEST_ASSERT_EQUAL_UINT32 (trace[ii].interval_ms, rt_sensor_rate_interval_get (&m_rate));
+    }
+}
+
+void setUp (void)
+{
+    m_mode = RD_SENSOR_CFG_SLEEP;
+    m_samplerate = 0;
+    m_mode_calls = 0;
+    m_single_calls = 0;
+    m_samplerate_calls = 0;
+    m_samplerate_result = RD_SUCCESS;
+    m_now_ms = 1000;
+    m_temperature = 20.0F;
+    rd_sensor_initialize (&m_sensor);
+    m_sensor.provides.bitfield = RD_SENSOR_TEMP_FIELD.bitfield | acc_config().fields.bitfield;
+    m_sensor.mode_set = &sensor_mode_set;
+    m_sensor.samplerate_set = &sensor_samplerate_set;
+    m_sensor.data_get = &sensor_data_get;
+}
+
+void tearDown (void)
+{
+}
+
+void test_rt_sensor_rate_init_slow_sleeps (void)
+{
+    const rt_sensor_rate_config_t config = env_config();
+    TEST_ASSERT (RD_SUCCESS == rt_sensor_rate_init (&m_rate, &m_sensor, &config));
+    TEST_ASSERT_EQUAL_UINT32 (8000U, rt_sensor_rate_interval_get (&m_rate));
+    TEST_ASSERT_EQUAL (RD_SENSOR_CFG_SLEEP, m_mode);
+    TEST_ASSERT_EQUAL (0, m_samplerate_calls);
+}
+
+void test_rt_sensor_rate_init_fast_continuous (void)
+{
+    const rt_sensor_rate_config_t config = acc_config();
+    TEST_ASSERT (RD_SUCCESS == rt_sensor_rate_init (&m_rate, &m_sensor, &config));
+    TEST_ASSERT_EQUAL_UINT32 (100U, rt_sensor_rate_interval_get (&m_rate));
+    TEST_ASSERT_EQUAL (10, m_samplerate);
+    TEST_ASSERT_EQUAL (RD_SENSOR_CFG_CONTINUOUS, m_mode);
+}
+
+void test_rt_sensor_rate_env_step_trace (void)
+{
+    // Stable room, window opened at 24 s, temperature settles by 34 s.
+    const env_trace_t trace[] =
+    {
+        {  8000, 20.00F, 8000 },
+        { 16000, 20.00F, 8000 },
+        { 24000, 20.02F, 8000 },
+        { 32000, 19.00F, 1000 },
+        { 33000, 18.80F, 1000 },
+        { 34000, 18.79F, 1000 },
+        { 35000, 18.79F, 1000 },
+        { 36000, 18.79F, 2000 },
+        { 38000, 18.79F, 2000 },
+        { 40000, 18.79F, 4000 },
+        { 44000, 18.79F, 4000 },
+        { 48000, 18.79F, 8000 },
+        { 56000, 18.79F, 8000 },
+    };
+    const rt_sensor_rate_config_t config = env_config();
+    TEST_ASSERT (RD_SUCCESS == rt_sensor_rate_init (&m_rate, &m_sensor, &config));
+    env_trace_run (trace, sizeof (trace) / sizeof (trace[0]));
+}
+
+void test_rt_sensor_rate_hysteresis_holds (void)
+{
+    // Drift of 0.007 C/s is between hysteresis and threshold.
+    const env_trace_t trace[] =
+    {
+        {  1000, 20.000F, 8000 },
+        {  9000, 21.000F, 1000 },
+        { 10000, 21.007F, 1000 },
+        { 11000, 21.014F, 1000 },
+        { 12000, 21.014F, 1000 },
+        { 13000, 21.021F, 1000 },
+        { 14000, 21.021F, 1000 },
+        { 15000, 21.021F, 2000 },
+    };
+    const rt_sensor_rate_config_t config = env_config();
+    TEST_ASSERT (RD_SUCCESS == rt_sensor_rate_init (&m_rate, &m_sensor, &config));
+    env_trace_run (trace, sizeof (trace) / sizeof (trace[0]));
+}
+
+void test_rt_sensor_rate_accelerometer_tap_trace (void)
+{
+    // Device at rest, tapped at 150 ms, at rest again from 170 ms.
+    const acc_trace_t trace[] =
+    {
+        {   0, 0.00F, 0.00F, 1.00F, 100 },
+        { 100, 0.00F, 0.01F, 1.00F, 100 },
+        { 150, 0.80F, 0.00F, 1.40F, 10 },
+        { 160, 0.10F, 0.02F, 0.90F, 10 },
+        { 170, 0.00F, 0.01F, 1.00F, 10 },
+        { 180, 0.00F, 0.01F, 1.00F, 10 },
+        { 190, 0.00F, 0.01F, 1.00F, 10 },
+        { 200, 0.00F, 0.01F, 1.00F, 10 },
+        { 210, 0.00F, 0.01F, 1.00F, 20 },
+    };
+    const rt_sensor_rate_config_t config = acc_config();
+    TEST_ASSERT (RD_SUCCESS == rt_sensor_rate_init (&m_rate, &m_sensor, &config));
+    acc_trace_run (trace, sizeof (trace) / sizeof (trace[0]));
+    TEST_ASSERT_EQUAL (50, m_samplerate);
+    TEST_ASSERT_EQUAL (RD_SENSOR_CFG_CONTINUOUS, m_mode);
+}
+
+void test_rt_sensor_rate_invalid_timestamp_restarts (void)
+{
+    const rt_sensor_rate_config_t config = env_config();
+    TEST_ASSERT (RD_SUCCESS == rt_sensor_rate_init (&m_rate, &m_sensor, &config));
+    env_feed (1000, 20.0F, RD_SENSOR_TEMP_FIELD);
+    env_feed (RD_SENSOR_INVALID_TIMSTAMP, 30.0F, RD_SENSOR_TEMP_FIELD);
+    env_feed (2000, 40.0F, RD_SENSOR_TEMP_FIELD);
+    env_feed (1500, 50.0F, RD_SENSOR_TEMP_FIELD);
+    TEST_ASSERT_EQUAL_UINT32 (8000U, rt_sensor_rate_interval_get (&m_rate));
+    env_feed (2500, 60.0F, RD_SENSOR_TEMP_FIELD);
+    TEST_ASSERT_EQUAL_UINT32 (1000U, rt_sensor_rate_interval_get (&m_rate));
+}
+
+void test_rt_sensor_rate_invalid_field_ignored (void)
+{
+    const rd_sensor_data_fields_t none = {0};
+    const rt_sensor_rate_config_t config = env_config();
+    TEST_ASSERT (RD_SUCCESS == rt_sensor_rate_init (&m_rate, &m_sensor, &config));
+    env_feed (1000, 20.0F, RD_SENSOR_TEMP_FIELD);
+    env_feed (2000, 30.0F, none);
+    env_feed (3000, 40.0F, RD_SENSOR_TEMP_FIELD);
+    TEST_ASSERT_EQUAL_UINT32 (8000U, rt_sensor_rate_interval_get (&m_rate));
+}
+
+void test_rt_sensor_rate_sample_single (void)
+{
+    rd_sensor_data_t data = {0};
+    float values[1];
+    const rt_sensor_rate_config_t config = env_config();
+    TEST_ASSERT (RD_SUCCESS == rt_sensor_rate_init (&m_rate, &m_sensor, &config));
+    data.fields = RD_SENSOR_TEMP_FIELD;
+    data.data = values;
+    TEST_ASSERT (RD_SUCCESS == rt_sensor_rate_sample (&m_rate, &data));
+    TEST_ASSERT_EQUAL (1, m_single_calls);
+    TEST_ASSERT_EQUAL_FLOAT (20.0F, values[0]);
+    memset (&data, 0, sizeof (data));
+    data.fields = RD_SENSOR_TEMP_FIELD;
+    data.data = values;
+    m_now_ms += 8000;
+    m_temperature = 22.0F;
+    TEST_ASSERT (RD_SUCCESS == rt_sensor_rate_sample (&m_rate, &data));
+    TEST_ASSERT_EQUAL (2, m_single_calls);
+    TEST_ASSERT_EQUAL_UINT32 (1000U, rt_sensor_rate_interval_get (&m_rate));
+}
+
+void test_rt_sensor_rate_sample_continuous (void)
+{
+    rd_sensor_data_t data = {0};
+    float values[1];
+    rt_sensor_rate_config_t config = env_config();
+    config.min_interval_ms = 100U;
+    config.max_interval_ms = 500U;
+    TEST_ASSERT (RD_SUCCESS == rt_sensor_rate_init (&m_rate, &m_sensor, &config));
+    m_mode_calls = 0;
+    data.fields = RD_SENSOR_TEMP_FIELD;
+    data.data = values;
+    TEST_ASSERT (RD_SUCCESS == rt_sensor_rate_sample (&m_rate, &data));
+    TEST_ASSERT_EQUAL (0, m_mode_calls);
+    TEST_ASSERT_EQUAL (2, m_samplerate);
+}
+
+void test_rt_sensor_rate_apply_error (void)
+{
+    const rt_sensor_rate_config_t config = acc_config();
+    m_samplerate_result = RD_ERROR_NOT_SUPPORTED;
+    TEST_ASSERT (RD_ERROR_NOT_SUPPORTED == rt_sensor_rate_init (&m_rate, &m_sensor,
+                 &config));
+}
+
+void test_rt_sensor_rate_init_errors (void)
+{
+    rt_sensor_rate_config_t config = env_config();
+    TEST_ASSERT (RD_ERROR_NULL == rt_sensor_rate_init (NULL, &m_sensor, &config));
+    TEST_ASSERT (RD_ERROR_NULL == rt_sensor_rate_init (&m_rate, NULL, &config));
+    TEST_ASSERT (RD_ERROR_NULL == rt_sensor_rate_init (&m_rate, &m_sensor, NULL));
+    config.min_interval_ms = 9000U;
+    TEST_ASSERT (RD_ERROR_INVALID_PARAM == rt_sensor_rate_init (&m_rate, &m_sensor,
+                 &config));
+    config = env_config();
+    config.min_interval_ms = 1U;
+    TEST_ASSERT (RD_ERROR_INVALID_PARAM == rt_sensor_rate_init (&m_rate, &m_sensor,
+                 &config));
+    config = env_config();
+    config.hysteresis = 1.5F;
+    TEST_ASSERT (RD_ERROR_INVALID_PARAM == rt_sensor_rate_init (&m_rate, &m_sensor,
+                 &config));
+    config = env_config();
+    config.thresholds[0] = 0.0F;
+    TEST_ASSERT (RD_ERROR_INVALID_PARAM == rt_sensor_rate_init (&m_rate, &m_sensor,
+                 &config));
+    config = env_config();
+    config.fields = RD_SENSOR_PRES_FIELD;
+    TEST_ASSERT (RD_ERROR_NOT_SUPPORTED == rt_sensor_rate_init (&m_rate, &m_sensor,
+                 &config));
+    config.fields.bitfield = 0xFFFFFFFFU;
+    TEST_ASSERT (RD_ERROR_NO_MEM == rt_sensor_rate_init (&m_rate, &m_sensor, &config));
+    TEST_ASSERT_EQUAL (0, m_mode_calls);
+}
+
+void test_rt_sensor_rate_null (void)
+{
+    rd_sensor_data_t data = {0};
+    TEST_ASSERT (RD_ERROR_NULL == rt_sensor_rate_update (NULL, &data));
+    TEST_ASSERT (RD_ERROR_NULL == rt_sensor_rate_update (&m_rate, NULL));
+    TEST_ASSERT (RD_ERROR_NULL == rt_sensor_rate_sample (NULL, &data));
+    TEST_ASSERT_EQUAL_UINT32 (0U, rt_sensor_rate_interval_get (NULL));
+}